@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "MicroBenchmarks.h"
+
+#include "../bitfighter_test/BitStreamOpsForTesting.h"
+
+#include "tnlPlatform.h"
+
+#include <stdlib.h>
+
+namespace Zap
+{
+
+
+// Roughly the shape of a Ship::packUpdate() for a moving ship: a run of flags, a position and velocity, and a few
+// small ints and enums
+static void packShipLikeUpdate(BitStream &stream, U32 seed)
+{
+   stream.writeFlag(false);                        // Team
+   if(stream.writeFlag((seed & 0x1F) == 0))        // Loadout
+   {
+      for(S32 i = 0; i < 2; i++)
+         stream.writeEnum(seed % 9, 9);
+      for(S32 i = 0; i < 3; i++)
+         stream.writeEnum(seed % 11, 11);
+   }
+
+   if(!stream.writeFlag(false))                    // Exploded
+   {
+      if(stream.writeFlag((seed & 0x7) == 0))
+      {
+         stream.writeFlag(false);
+         if(stream.writeFlag(true))
+            stream.writeInt(seed & 0xF, 4);
+      }
+      if(stream.writeFlag(true))
+         stream.writeFloat(0.75f, 6);
+   }
+
+   stream.writeFlag(false);                        // Warp
+   stream.writeFlag(false);                        // Teleport
+
+   if(stream.writeFlag(true))                      // Position
+   {
+      stream.writeRangedU32(seed % 3000, 0, 4095);
+      stream.writeRangedU32((seed >> 3) % 3000, 0, 4095);
+      stream.writeSignedFloat(0.3f, 10);
+      stream.writeSignedFloat(-0.6f, 10);
+   }
+
+   if(stream.writeFlag(true))                      // Move
+   {
+      stream.writeSignedFloat(0.25f, 8);
+      stream.writeSignedFloat(-1, 8);
+      stream.writeInt(seed & 0x1FF, 9);
+      stream.writeFlag(false);
+      stream.writeFlag(true);
+   }
+
+   stream.writeRangedU32(seed & 0xFF, 0, 255);      // Energy
+   stream.writeInt(seed & 0x3F, 6);                // Module activity
+}
+
+
+// Times packing ship-like updates into packets, then the same mix of random writes word-at-a-time and through
+// writeBits()
+void writeBitStreamReport(FILE *f)
+{
+   const S32 Updates = 200000;
+
+   PacketStream stream;
+   U32 totalBits = 0;
+
+   S64 start = Platform::getHighPrecisionTimerValue();
+
+   for(S32 i = 0; i < Updates; i++)
+   {
+      // A packet's worth of updates, then start again
+      if(stream.getBitPosition() > 8 * 1000)
+      {
+         totalBits += stream.getBitPosition();
+         stream.resetForWrite();
+      }
+
+      packShipLikeUpdate(stream, U32(i) * 2654435761u);
+   }
+
+   totalBits += stream.getBitPosition();
+
+   F64 packMs = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+
+   srand(1234);
+
+   Vector<BitStreamOp> ops;
+   getRandomOps(100, ops);
+
+   const S32 Rounds = 20000;
+   U8 buffer[1024];
+
+   start = Platform::getHighPrecisionTimerValue();
+   for(S32 i = 0; i < Rounds; i++)
+   {
+      BitStream opStream(buffer, sizeof(buffer));
+      writeOpsBitByBit(opStream, ops);
+   }
+   F64 bitByBitMs = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+
+   start = Platform::getHighPrecisionTimerValue();
+   for(S32 i = 0; i < Rounds; i++)
+   {
+      BitStream opStream(buffer, sizeof(buffer));
+      writeOps(opStream, ops);
+   }
+   F64 wordMs = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+
+   fprintf(f, "{\n  \"shipUpdates\": %d,\n  \"shipUpdateBytes\": %u,\n  \"shipUpdateMs\": %.3f,\n"
+              "  \"randomWrites\": %d,\n  \"writeBitsMs\": %.3f,\n  \"wordAtATimeMs\": %.3f\n}\n",
+           Updates, totalBits / 8, packMs, Rounds * ops.size(), bitByBitMs, wordMs);
+}
+
+
+};
@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "MicroBenchmarks.h"
+
+#include "../bitfighter_test/LevelFilesForTesting.h"
+#include "../bitfighter_test/TestUtils.h"
+
+#include "BotNavMeshZone.h"
+#include "ServerGame.h"
+
+#include "tnlPlatform.h"
+
+namespace Zap
+{
+
+
+// Milliseconds to route every query, reusing pathFinder so later queries can come from its cache
+static F64 timeQueries(BotPathFinder &pathFinder, const Vector<BotNavMeshZone *> &zones, const Vector<pair<S32, S32> > &queries)
+{
+   Vector<Point> path;
+
+   S64 start = Platform::getHighPrecisionTimerValue();
+
+   for(S32 i = 0; i < queries.size(); i++)
+      pathFinder.findPath(queries[i].first, queries[i].second, zones[queries[i].second]->getCenter(), path);
+
+   return Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+}
+
+
+// Times 1000 random queries on each test level with plain A*, then with the cache, the cluster search and the
+// next hop table
+void writePathFinderReport(FILE *f)
+{
+   const S32 queryCount = 1000;
+
+   Vector<string> levels = getLevels().first;
+   bool first = true;
+
+   fprintf(f, "{\n  \"queries\": %d,\n  \"levels\": [", queryCount);
+
+   for(S32 i = 0; i < levels.size(); i++)
+   {
+      GamePair gamePair(levels[i], 0);
+      ServerGame *serverGame = gamePair.server;
+
+      const Vector<BotNavMeshZone *> &zones = serverGame->getBotZoneList();
+      if(zones.size() == 0)
+         continue;
+
+      Vector<pair<S32, S32> > queries;
+      getRandomPairs(zones.size(), queryCount, queries);
+
+      S64 start = Platform::getHighPrecisionTimerValue();
+      for(S32 j = 0; j < queries.size(); j++)
+         AStar::findPath(&zones, queries[j].first, queries[j].second, zones[queries[j].second]->getCenter());
+      F64 plainMs = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+
+      BotPathFinder pathFinder;
+      pathFinder.reset(&zones);
+      pathFinder.setUseClusters(false);
+      F64 cachedMs = timeQueries(pathFinder, zones, queries);
+
+      pathFinder.setUseClusters(true);
+      F64 clusteredMs = timeQueries(pathFinder, zones, queries);
+      S32 clusterCount = pathFinder.getClusterCount();
+
+      start = Platform::getHighPrecisionTimerValue();
+      pathFinder.reset(&zones, true);
+      pathFinder.waitForNextHopTable();
+      F64 tableBuildMs = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+
+      F64 tableMs = timeQueries(pathFinder, zones, queries);
+
+      fprintf(f, "%s\n    {\"level\": %d, \"zones\": %d, \"aStarMs\": %.3f, \"cachedMs\": %.3f, \"clusteredMs\": %.3f, "
+                 "\"clusters\": %d, \"nextHopTableMs\": %.3f, \"nextHopTableBuildMs\": %.3f}",
+              first ? "" : ",", i, zones.size(), plainMs, cachedMs, clusteredMs, clusterCount, tableMs, tableBuildMs);
+      first = false;
+   }
+
+   fprintf(f, "\n  ]\n}\n");
+}
+
+
+};
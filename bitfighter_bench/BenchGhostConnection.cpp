@@ -0,0 +1,61 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "MicroBenchmarks.h"
+
+#include "../bitfighter_test/LevelFilesForTesting.h"
+#include "../bitfighter_test/TestUtils.h"
+
+#include "ServerGame.h"
+#include "gameNetInterface.h"
+
+#include "tnlPlatform.h"
+
+#ifdef TNL_OS_WIN32
+#  include <windows.h>     // For ARRAYSIZE def
+#endif
+
+namespace Zap
+{
+
+
+// Average time the server spends writing packets for its one client when every ghost has a pending update
+static F64 benchmarkWritePacket(S32 itemCount, S32 ticks)
+{
+   GamePair gamePair(getLevelCodeWithItems(itemCount), 1);
+   ServerGame *serverGame = gamePair.server;
+
+   gamePair.idle(33, 100);    // Let the initial ghosting flood settle down
+
+   serverGame->getNetInterface()->resetPacketPhaseStats();
+
+   for(S32 i = 0; i < ticks; i++)
+   {
+      dirtyAllItems(serverGame);
+      gamePair.idle(33);
+   }
+
+   const NetInterface::PacketPhaseStats &stats = serverGame->getNetInterface()->getPacketPhaseStats();
+
+   return stats.packetsSent > 0 ? stats.writeMs / stats.packetsSent : 0;
+}
+
+
+void writeGhostConnectionReport(FILE *f)
+{
+   const S32 ghostCounts[] = { 100, 500, 1000, 2000, 5000 };
+   const S32 ticks = 50;
+
+   fprintf(f, "{\n  \"ticks\": %d,\n  \"runs\": [", ticks);
+
+   for(U32 i = 0; i < ARRAYSIZE(ghostCounts); i++)
+      fprintf(f, "%s\n    {\"dirtyGhosts\": %d, \"msPerPacket\": %.4f}", i == 0 ? "" : ",",
+              ghostCounts[i], benchmarkWritePacket(ghostCounts[i], ticks));
+
+   fprintf(f, "\n  ]\n}\n");
+}
+
+
+};
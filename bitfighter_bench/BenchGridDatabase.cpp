@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "MicroBenchmarks.h"
+
+#include "../bitfighter_test/GridWorldForTesting.h"
+
+#include "BfObject.h"
+
+#include "tnlPlatform.h"
+
+namespace Zap
+{
+
+
+// Times a typical server tick: everything moves, then every player does a scope-sized query and a few
+// collision-sized queries, and every projectile checks what it might hit.
+static F64 benchmarkBackend(GridDatabase::BucketBackend backend, S32 ticks)
+{
+   GridTestWorld world(backend);
+   GridTestRandom random(42);
+   Vector<DatabaseObject *> found;
+
+   S64 start = Platform::getHighPrecisionTimerValue();
+
+   for(S32 tick = 0; tick < ticks; tick++)
+   {
+      world.tick(random);
+
+      for(S32 i = 0; i < world.mMovers.size(); i++)
+      {
+         GridTestObject *obj = world.mMovers[i];
+
+         if(isShipType(obj->getObjectTypeNumber()))
+         {
+            found.clear();
+            world.mDatabase->findObjects((TestFunc)isAnyObjectType, found, Rect(obj->mPos, 800));
+
+            found.clear();
+            world.mDatabase->findObjects((TestFunc)isCollideableType, found, Rect(obj->mPos, 64));
+         }
+         else
+         {
+            found.clear();
+            world.mDatabase->findObjects((TestFunc)isWeaponCollideableType, found, Rect(obj->mPos, 32));
+         }
+      }
+   }
+
+   return Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+}
+
+
+void writeGridDatabaseReport(FILE *f)
+{
+   const S32 ticks = 100;
+
+   F64 linkedTime = benchmarkBackend(GridDatabase::LinkedListBuckets, ticks);
+   F64 arrayTime  = benchmarkBackend(GridDatabase::ArrayBuckets,      ticks);
+
+   fprintf(f, "{\n  \"players\": %d,\n  \"projectiles\": %d,\n  \"ticks\": %d,\n  \"backends\": [\n",
+           (S32)GridTestWorld::PlayerCount, (S32)GridTestWorld::ProjectileCount, ticks);
+   fprintf(f, "    {\"name\": \"LinkedListBuckets\", \"ms\": %.3f},\n", linkedTime);
+   fprintf(f, "    {\"name\": \"ArrayBuckets\", \"ms\": %.3f}\n  ]\n}\n", arrayTime);
+}
+
+
+};
@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "MicroBenchmarks.h"
+
+#include "../bitfighter_test/PolygonsForTesting.h"
+
+#include "GeomUtils.h"
+#include "PolygonEdges.h"
+
+#include "tnlPlatform.h"
+
+namespace Zap
+{
+
+
+// Times the Point based functions against each kernel set on wall sized polygons, the way
+// MoveObject::findFirstCollision() and projectiles use them
+void writeKernelReport(FILE *f)
+{
+   const S32 polygonCount = 200;
+   const S32 testCount = 200;
+
+   EdgeTestRandom random(7);
+
+   Vector<Vector<Point> > polygons;
+   Vector<PolygonEdges> edges;
+   Vector<Point> starts, deltas;
+
+   polygons.resize(polygonCount);
+   edges.resize(polygonCount);
+
+   for(S32 i = 0; i < polygonCount; i++)
+   {
+      makePolygon(random, polygons[i]);
+      edges[i].set(polygons[i]);
+   }
+
+   for(S32 i = 0; i < testCount; i++)
+   {
+      starts.push_back(Point(random.readF(-400, 400), random.readF(-400, 400)));
+      deltas.push_back(Point(random.readF(-300, 300), random.readF(-300, 300)));
+   }
+
+   Point point;
+   F32 fraction;
+   S32 hits = 0;      // Keeps the optimizer honest
+
+   S64 start = Platform::getHighPrecisionTimerValue();
+   for(S32 i = 0; i < polygonCount; i++)
+      for(S32 j = 0; j < testCount; j++)
+      {
+         hits += PolygonSweptCircleIntersect(polygons[i].address(), polygons[i].size(), starts[j], deltas[j], 10, point, fraction);
+         hits += polygonIntersectsSegmentDetailed(polygons[i].address(), polygons[i].size(), true, starts[j], starts[j] + deltas[j], fraction, point);
+      }
+   F64 pointTime = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+
+   fprintf(f, "{\n  \"polygons\": %d,\n  \"tests\": %d,\n  \"kernels\": [", polygonCount, testCount);
+   fprintf(f, "\n    {\"name\": \"Point\", \"ms\": %.3f}", pointTime);
+
+   PolygonEdges::KernelSet defaultKernelSet = PolygonEdges::getKernelSet();
+
+   for(S32 kernelSet = PolygonEdges::ScalarKernels; kernelSet <= PolygonEdges::getBestKernelSet(); kernelSet++)
+   {
+      PolygonEdges::setKernelSet((PolygonEdges::KernelSet)kernelSet);
+
+      start = Platform::getHighPrecisionTimerValue();
+      for(S32 i = 0; i < polygonCount; i++)
+         for(S32 j = 0; j < testCount; j++)
+         {
+            hits += PolygonSweptCircleIntersect(edges[i], starts[j], deltas[j], 10, point, fraction);
+            hits += polygonIntersectsSegmentDetailed(edges[i], starts[j], starts[j] + deltas[j], fraction, point);
+         }
+      F64 time = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+
+      fprintf(f, ",\n    {\"name\": ");
+      writeJsonString(f, PolygonEdges::getKernelSetName((PolygonEdges::KernelSet)kernelSet));
+      fprintf(f, ", \"ms\": %.3f}", time);
+   }
+
+   PolygonEdges::setKernelSet(defaultKernelSet);
+
+   fprintf(f, "\n  ],\n  \"hits\": %d\n}\n", hits);
+}
+
+
+};
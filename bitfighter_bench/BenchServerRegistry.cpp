@@ -0,0 +1,40 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "MicroBenchmarks.h"
+
+#include "../bitfighter_test/ServerListsForTesting.h"
+
+#include "tnlPlatform.h"
+
+namespace Zap
+{
+
+
+// 10,000 clients re-querying a master while servers come and go; reports how long the queries took and how much
+// was sent, compared with sending everyone the whole list
+void writeServerListReport(FILE *f)
+{
+   const S32 clientCount = 10000;
+   const S32 serverCount = 500;
+   const S32 rounds = 10;
+   const S32 churnPerRound = 20;
+
+   ServerListChurn churn(clientCount, serverCount);
+
+   S64 start = Platform::getHighPrecisionTimerValue();
+
+   for(S32 round = 0; round < rounds; round++)
+      churn.runRound(round, churnPerRound);
+
+   F64 elapsed = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+
+   fprintf(f, "{\n  \"clients\": %d,\n  \"servers\": %d,\n  \"rounds\": %d,\n  \"ms\": %.3f,\n"
+              "  \"sentEntries\": %lld,\n  \"fullListEntries\": %lld\n}\n",
+           clientCount, serverCount, rounds, elapsed, (long long)churn.mSentEntries, (long long)churn.mFullEntries);
+}
+
+
+};
@@ -0,0 +1,40 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "MicroBenchmarks.h"
+
+#include "../bitfighter_test/SocketsForTesting.h"
+
+namespace Zap
+{
+
+
+static void writeLoopbackRun(FILE *f, const char *name, bool batched, S32 rounds, bool last)
+{
+   F64 ms = 0;
+   bool ok = sendOverLoopback(batched, rounds, ms);
+   S32 packets = rounds * LoopbackPacketsPerRound;
+
+   fprintf(f, "    {\"name\": \"%s\", \"ok\": %s, \"ms\": %.3f, \"packetsPerSecond\": %.0f}%s\n",
+           name, ok ? "true" : "false", ms, ms > 0 ? packets * 1000 / ms : 0, last ? "" : ",");
+}
+
+
+// How much batching buys us when sending and receiving game packets
+void writeLoopbackReport(FILE *f)
+{
+   const S32 rounds = 2000;
+
+   fprintf(f, "{\n  \"packets\": %d,\n  \"packetSize\": %d,\n  \"runs\": [\n", rounds * LoopbackPacketsPerRound,
+           LoopbackPacketSize);
+
+   writeLoopbackRun(f, "OneAtATime", false, rounds, false);
+   writeLoopbackRun(f, "Batched",    true,  rounds, true);
+
+   fprintf(f, "  ]\n}\n");
+}
+
+
+};
@@ -0,0 +1,31 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _MICRO_BENCHMARKS_H_
+#define _MICRO_BENCHMARKS_H_
+
+#include <stdio.h>
+#include <string>
+
+namespace Zap
+{
+
+using namespace std;
+
+// Each of these times one part of the game on its own, rather than running a server, and writes what it found to f
+// as JSON.  They use the same helpers the test suite checks the code with, so they time what the tests check.
+void writeBitStreamReport(FILE *f);
+void writeGhostConnectionReport(FILE *f);
+void writeGridDatabaseReport(FILE *f);
+void writeKernelReport(FILE *f);
+void writeLoopbackReport(FILE *f);
+void writePathFinderReport(FILE *f);
+void writeServerListReport(FILE *f);
+
+void writeJsonString(FILE *f, const string &str);
+
+};
+
+#endif
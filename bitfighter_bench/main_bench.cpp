@@ -0,0 +1,419 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+// Bitfighter server benchmark
+//
+// Hosts a level in process, the same way the test suite does, adds some bots and some simulated clients, and runs the
+// server for a fixed number of ticks.  Then reports, as JSON, how long each phase of the server's tick took (from the
+// tick profiler) and how much was sent to each client.  Run it from the exe folder, like bitfighter_test.
+//
+// The simulated clients are full ClientGames, which expect the video system to be set up even though the benchmark
+// never draws anything.  So we use SDL's dummy video driver, and no display is needed; set SDL_VIDEODRIVER to use a
+// real one instead.
+//
+//    bitfighter_bench [-level <file>] [-bots <n>] [-clients <n>] [-ticks <n>] [-tickms <n>] [-warmup <n>]
+//                     [-output <file>] [-max-tick-p99 <ms>]
+//    bitfighter_bench <micro benchmark> [-output <file>]
+//
+// With -max-tick-p99, exits with an error if the 99th percentile server tick took longer than that, so the
+// benchmark can be used as a regression check.
+//
+// Micro benchmarks (see MicroBenchmarks below) run no server; each times one part of the game on its own, such as
+// -kernels for the PolygonEdges collision kernels, and reports that instead.
+
+#define BF_TEST
+
+#include "MicroBenchmarks.h"
+
+#include "../bitfighter_test/TestUtils.h"
+
+#include "ClientGame.h"
+#include "DisplayManager.h"
+#include "FontManager.h"
+#include "GameManager.h"
+#include "GameSettings.h"
+#include "ServerGame.h"
+#include "VideoSystem.h"
+#include "gameConnection.h"
+#include "gameType.h"
+#include "physfs.hpp"
+
+#include "stringUtils.h"
+
+#include "tnlProfiler.h"
+
+#include "SDL.h"
+
+#ifdef TNL_OS_WIN32
+#  include <windows.h>     // For ARRAYSIZE def
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace Zap
+{
+void exitToOs()            { TNLAssert(false, "Should never be called!"); }
+void exitToOs(S32 errcode) { TNLAssert(false, "Should never be called!"); }
+}
+
+using namespace Zap;
+
+
+// Used when no -level is given: two teams in a walled arena with a few obstacles for the bots to find their way around
+static const char *DefaultLevelCode =
+   "LevelFormat 2\n"
+   "GameType 10 8\n"
+   "LevelName \"Bench Arena\"\n"
+   "LevelDescription \"Built in level for bitfighter_bench\"\n"
+   "LevelCredits bitfighter_bench\n"
+   "GridSize 255\n"
+   "Team Blue 0 0 1\n"
+   "Team Red 1 0 0\n"
+   "Specials\n"
+   "MinPlayers\n"
+   "MaxPlayers\n"
+   "BarrierMaker 50 -6 -6 6 -6 6 6 -6 6 -6 -6\n"
+   "BarrierMaker 40 -3 -1 -1 -1\n"
+   "BarrierMaker 40 1 1 3 1\n"
+   "BarrierMaker 40 0 -4 0 -2\n"
+   "BarrierMaker 40 0 2 0 4\n"
+   "Spawn 0 -5 -5\n"
+   "Spawn 0 -5 5\n"
+   "Spawn 1 5 5\n"
+   "Spawn 1 5 -5\n"
+   "RepairItem -2 3\n"
+   "RepairItem 2 -3\n"
+   "EnergyItem 0 0\n";
+
+
+// Benchmarks that time one part of the game on its own, rather than running a server
+struct MicroBenchmark
+{
+   const char *option;
+   const char *description;
+   bool hostsGames;              // Needs the same setup, and environment, as a server run
+   void (*writeReport)(FILE *f);
+};
+
+static const MicroBenchmark MicroBenchmarks[] = {
+   { "-bitstream",  "Time packing ship-like updates, and word-at-a-time writes against writeBits()",   false, writeBitStreamReport },
+   { "-ghosts",     "Time writing packets with a growing number of dirty ghosts",                      true,  writeGhostConnectionReport },
+   { "-griddb",     "Time GridDatabase searches with each bucket backend",                             false, writeGridDatabaseReport },
+   { "-kernels",    "Time the PolygonEdges collision kernels against the Point functions",             false, writeKernelReport },
+   { "-loopback",   "Time sending packets over loopback one at a time and in batches",                 false, writeLoopbackReport },
+   { "-pathfinder", "Time bot routing with plain A*, the path cache, clusters and the next hop table", true,  writePathFinderReport },
+   { "-serverlist", "Time 10,000 clients keeping their server lists up to date from a master",         false, writeServerListReport },
+};
+
+
+struct BenchOptions
+{
+   string levelFile;     // Empty for DefaultLevelCode
+   S32 bots;
+   S32 clients;
+   S32 ticks;
+   S32 tickMs;
+   S32 warmupTicks;      // Ticks run before we start measuring
+   string outputFile;    // Empty for stdout
+   F64 maxTickP99Ms;     // 0 for no limit
+   const MicroBenchmark *microBenchmark;     // NULL to run a server
+};
+
+
+static void usage()
+{
+   printf("Usage: bitfighter_bench [options]\n\n"
+          "  -level <file>        Level file to host (default is a small built in arena)\n"
+          "  -bots <n>            Bots to add (default 8)\n"
+          "  -clients <n>         Simulated clients to connect (default 4)\n"
+          "  -ticks <n>           Server ticks to measure (default 2000)\n"
+          "  -tickms <n>          Milliseconds of game time per tick (default 10)\n"
+          "  -warmup <n>          Ticks to run before measuring (default 100)\n"
+          "  -output <file>       Write the report here rather than to stdout\n"
+          "  -max-tick-p99 <ms>   Fail if the 99th percentile server tick took longer than this\n\n"
+          "Micro benchmarks, run instead of a server:\n\n");
+
+   for(U32 i = 0; i < ARRAYSIZE(MicroBenchmarks); i++)
+      printf("  %-20s %s\n", MicroBenchmarks[i].option, MicroBenchmarks[i].description);
+
+   printf("\n");
+}
+
+
+static const MicroBenchmark *findMicroBenchmark(const char *option)
+{
+   for(U32 i = 0; i < ARRAYSIZE(MicroBenchmarks); i++)
+      if(!strcmp(option, MicroBenchmarks[i].option))
+         return &MicroBenchmarks[i];
+
+   return NULL;
+}
+
+
+static bool parseOptions(int argc, char **argv, BenchOptions &options)
+{
+   options.bots = 8;
+   options.clients = 4;
+   options.ticks = 2000;
+   options.tickMs = 10;
+   options.warmupTicks = 100;
+   options.maxTickP99Ms = 0;
+   options.microBenchmark = NULL;
+
+   for(S32 i = 1; i < argc; i++)
+   {
+      const char *arg = argv[i];
+      bool hasValue = i + 1 < argc;
+
+      if(!strcmp(arg, "-level") && hasValue)
+         options.levelFile = argv[++i];
+      else if(!strcmp(arg, "-bots") && hasValue)
+         options.bots = atoi(argv[++i]);
+      else if(!strcmp(arg, "-clients") && hasValue)
+         options.clients = atoi(argv[++i]);
+      else if(!strcmp(arg, "-ticks") && hasValue)
+         options.ticks = atoi(argv[++i]);
+      else if(!strcmp(arg, "-tickms") && hasValue)
+         options.tickMs = atoi(argv[++i]);
+      else if(!strcmp(arg, "-warmup") && hasValue)
+         options.warmupTicks = atoi(argv[++i]);
+      else if(!strcmp(arg, "-output") && hasValue)
+         options.outputFile = argv[++i];
+      else if(!strcmp(arg, "-max-tick-p99") && hasValue)
+         options.maxTickP99Ms = atof(argv[++i]);
+      else if(findMicroBenchmark(arg))
+         options.microBenchmark = findMicroBenchmark(arg);
+      else
+         return false;
+   }
+
+   return options.bots >= 0 && options.clients >= 0 && options.ticks > 0 && options.tickMs > 0 && options.warmupTicks >= 0;
+}
+
+
+// Same setup main_test.cpp does for the test suite; ClientGames need all of it
+static void initialize()
+{
+   // Unless told otherwise, run without a display.  The dummy driver can't make an OpenGL window, so
+   // VideoSystem::init() will complain, but we never render, so it doesn't matter.
+   SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+
+   InputCodeManager::initializeKeyNames();
+   RenderManager::init();
+   GameSettings settings;
+   FontManager::initialize(settings.get(), false);
+   VideoSystem::init();
+   PhysFS::init("");
+   VideoSystem::actualizeScreenMode(&settings, false, false);
+   GameManager::initialize();
+   DisplayManager::initialize();
+}
+
+
+void Zap::writeJsonString(FILE *f, const string &str)
+{
+   fputc('"', f);
+
+   for(U32 i = 0; i < str.length(); i++)
+   {
+      if(str[i] == '"' || str[i] == '\\')
+         fputc('\\', f);
+
+      if(U8(str[i]) >= ' ')
+         fputc(str[i], f);
+   }
+
+   fputc('"', f);
+}
+
+
+struct ClientBytes
+{
+   string name;
+   U32 startBytes;      // What the server had sent the client when we started measuring
+   U32 bytesSent;
+};
+
+
+static GameConnection *getServerConnection(ServerGame *server, const string &name)
+{
+   ClientInfo *clientInfo = server->findClientInfo(name.c_str());
+   return clientInfo ? clientInfo->getConnection() : NULL;
+}
+
+
+static void writeReport(FILE *f, const BenchOptions &options, const string &levelName, F64 wallMs,
+                        const Vector<Profiler::PhaseStats> &phases, const Vector<ClientBytes> &clients)
+{
+   fprintf(f, "{\n  \"level\": ");
+   writeJsonString(f, levelName);
+   fprintf(f, ",\n  \"bots\": %d,\n  \"clients\": %d,\n  \"ticks\": %d,\n  \"tickMs\": %d,\n  \"wallMs\": %.3f,\n",
+           options.bots, options.clients, options.ticks, options.tickMs, wallMs);
+
+   fprintf(f, "  \"phases\": [");
+   for(S32 i = 0; i < phases.size(); i++)
+   {
+      fprintf(f, "%s\n    {\"name\": ", i == 0 ? "" : ",");
+      writeJsonString(f, phases[i].name);
+      fprintf(f, ", \"count\": %u, \"totalMs\": %.3f, \"perTickMs\": %.4f, \"p50Ms\": %.4f, \"p99Ms\": %.4f, \"maxMs\": %.4f}",
+              phases[i].count, phases[i].totalMs, phases[i].totalMs / options.ticks,
+              phases[i].p50Ms, phases[i].p99Ms, phases[i].maxMs);
+   }
+   fprintf(f, "\n  ],\n");
+
+   fprintf(f, "  \"clientBytes\": [");
+   for(S32 i = 0; i < clients.size(); i++)
+   {
+      fprintf(f, "%s\n    {\"name\": ", i == 0 ? "" : ",");
+      writeJsonString(f, clients[i].name);
+      fprintf(f, ", \"bytesSent\": %u, \"bytesPerTick\": %.2f}", clients[i].bytesSent, F64(clients[i].bytesSent) / options.ticks);
+   }
+   fprintf(f, "\n  ]\n}\n");
+}
+
+
+// Returns stdout if there's no -output, or NULL if the file can't be written
+static FILE *openOutput(const BenchOptions &options)
+{
+   if(options.outputFile == "")
+      return stdout;
+
+   FILE *f = fopen(options.outputFile.c_str(), "w");
+   if(!f)
+      fprintf(stderr, "Could not write %s\n", options.outputFile.c_str());
+
+   return f;
+}
+
+
+// Hosts the level with bots and simulated clients, and reports how long each phase of the server's tick took.
+// Returns the exit code.
+static S32 runServerBenchmark(const BenchOptions &options, const string &levelCode, FILE *f)
+{
+   // We add the bots ourselves; don't let the server balance teams with more
+   GameSettingsPtr settings = GameSettingsPtr(new GameSettings());
+   settings->setSetting(IniKey::AddRobots, No);
+
+   S32 exitCode = 0;
+
+   GamePair gamePair(settings, levelCode);
+   ServerGame *server = gamePair.server;
+   server->setAutoLeveling(false);
+
+   Vector<ClientBytes> clients;
+   for(S32 i = 0; i < options.clients; i++)
+   {
+      ClientBytes client;
+      client.name = "BenchPlayer" + itos(i);
+      gamePair.addClient(client.name);
+      clients.push_back(client);
+   }
+
+   for(S32 i = 0; i < options.bots; i++)
+      server->addBot(Vector<string>(), ClientInfo::ClassRobotAddedByAddbots);
+
+   GamePair::idle(options.tickMs, options.warmupTicks);
+
+   for(S32 i = 0; i < clients.size(); i++)
+   {
+      GameConnection *conn = getServerConnection(server, clients[i].name);
+      clients[i].startBytes = conn ? conn->mPacketSendBytesTotal : 0;
+   }
+
+   // Room for everything the run will record; a tick opens a few dozen scopes, plus a couple per client and per bot.
+   // Very long runs only keep their last few million scopes.
+   const U32 MaxEvents = 4 * 1024 * 1024;
+   Profiler::setEventsPerThread(min(U32(options.ticks) * (64 + 4 * (options.clients + options.bots)), MaxEvents));
+   Profiler::clear();
+
+   S64 startTime = Platform::getHighPrecisionTimerValue();
+
+   // Only the server is profiled; the clients are here to be sent to, not to be measured
+   for(S32 i = 0; i < options.ticks; i++)
+   {
+      Profiler::setEnabled(true);
+      GameManager::idleServerGame(options.tickMs);
+      Profiler::setEnabled(false);
+
+      GameManager::idleClientGames(options.tickMs);
+   }
+
+   F64 wallMs = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - startTime);
+
+   for(S32 i = 0; i < clients.size(); i++)
+   {
+      GameConnection *conn = getServerConnection(server, clients[i].name);
+      clients[i].bytesSent = conn ? conn->mPacketSendBytesTotal - clients[i].startBytes : 0;
+   }
+
+   Vector<Profiler::PhaseStats> phases;
+   Profiler::getPhaseStats(U32(wallMs) + 1000, phases);
+
+   writeReport(f, options, server->getGameType()->getLevelName(), wallMs, phases, clients);
+
+   if(options.maxTickP99Ms > 0)
+      for(S32 i = 0; i < phases.size(); i++)
+         if(!strcmp(phases[i].name, "ServerGame::idle") && phases[i].p99Ms > options.maxTickP99Ms)
+         {
+            fprintf(stderr, "FAILED: p99 server tick took %.3fms, limit is %.3fms\n", phases[i].p99Ms, options.maxTickP99Ms);
+            exitCode = 1;
+         }
+
+   return exitCode;
+}
+
+
+int main(int argc, char **argv)
+{
+   BenchOptions options;
+   if(!parseOptions(argc, argv, options))
+   {
+      usage();
+      return 1;
+   }
+
+   string levelCode = DefaultLevelCode;
+   if(options.levelFile != "" && !readFile(options.levelFile, levelCode))
+   {
+      fprintf(stderr, "Could not read level file %s\n", options.levelFile.c_str());
+      return 1;
+   }
+
+   bool hostsGames = !options.microBenchmark || options.microBenchmark->hostsGames;
+
+   if(hostsGames && (!fileExists("robots") || !fileExists("scripts")))
+   {
+      fprintf(stderr, "FAILED: Invalid environment! Run this from the exe folder, with everything from 'resources/' copied into it\n");
+      return 1;
+   }
+
+   // Find out now if we can't write the report, before we've set anything up or spent time running
+   FILE *f = openOutput(options);
+   if(!f)
+      return 1;
+
+   if(hostsGames)
+      initialize();
+
+   S32 exitCode = 0;
+
+   if(options.microBenchmark)
+      options.microBenchmark->writeReport(f);
+   else
+      exitCode = runServerBenchmark(options, levelCode, f);
+
+   if(f != stdout)
+      fclose(f);
+
+   if(hostsGames)
+   {
+      FontManager::cleanup();
+      DisplayManager::cleanup();
+   }
+
+   return exitCode;
+}
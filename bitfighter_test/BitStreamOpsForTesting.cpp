@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "BitStreamOpsForTesting.h"
+
+#include <stdlib.h>
+
+namespace Zap
+{
+
+
+static U32 randomU32()
+{
+   return (U32(rand() & 0xFFFF) << 16) | U32(rand() & 0xFFFF);
+}
+
+
+void getRandomOps(S32 count, Vector<BitStreamOp> &ops)
+{
+   for(S32 i = 0; i < count; i++)
+   {
+      BitStreamOp op;
+      op.type = OpType(rand() % OpTypeCount);
+      op.bitCount = U8(rand() % 33);
+      op.value = op.bitCount == 32 ? randomU32() : randomU32() & ((1 << op.bitCount) - 1);
+      op.rangeStart = 0;
+      op.rangeEnd = 0;
+      op.floatValue = 0;
+
+      if(op.type == OpFlag)
+         op.value = rand() & 1;
+
+      else if(op.type == OpRanged)
+      {
+         op.rangeStart = randomU32() >> (rand() % 31 + 1);
+         op.rangeEnd = op.rangeStart + (randomU32() >> (rand() % 31 + 1));
+         op.value = op.rangeStart + (op.rangeEnd == op.rangeStart ? 0 : randomU32() % (op.rangeEnd - op.rangeStart));
+      }
+
+      else if(op.type == OpSignedFloat)
+      {
+         op.bitCount = U8(rand() % 23 + 2);    // Wider than an F32 mantissa, and 1.0 no longer fits
+         op.floatValue = F32(rand() % 2001 - 1000) / 1000;
+      }
+
+      ops.push_back(op);
+   }
+}
+
+
+void writeOps(BitStream &stream, const Vector<BitStreamOp> &ops)
+{
+   for(S32 i = 0; i < ops.size(); i++)
+   {
+      const BitStreamOp &op = ops[i];
+
+      if(op.type == OpInt)
+         stream.writeInt(op.value, op.bitCount);
+      else if(op.type == OpFlag)
+         stream.writeFlag(op.value != 0);
+      else if(op.type == OpRanged)
+         stream.writeRangedU32(op.value, op.rangeStart, op.rangeEnd);
+      else
+         stream.writeSignedFloat(op.floatValue, op.bitCount);
+   }
+}
+
+
+void writeOpsBitByBit(BitStream &stream, const Vector<BitStreamOp> &ops)
+{
+   for(S32 i = 0; i < ops.size(); i++)
+   {
+      const BitStreamOp &op = ops[i];
+
+      U32 value = op.value;
+      U32 bitCount = op.bitCount;
+
+      if(op.type == OpFlag)
+         bitCount = 1;
+      else if(op.type == OpRanged)
+      {
+         value = op.value - op.rangeStart;
+         bitCount = getNextBinLog2(op.rangeEnd - op.rangeStart + 1);
+      }
+      else if(op.type == OpSignedFloat)
+         value = U32(S32(op.floatValue * ((1 << (op.bitCount - 1)) - 1)));
+
+      value = convertHostToLEndian(value);
+      stream.writeBits(bitCount, &value);
+   }
+}
+
+
+};
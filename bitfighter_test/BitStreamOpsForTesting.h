@@ -0,0 +1,47 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _BIT_STREAM_OPS_FOR_TESTING_H_
+#define _BIT_STREAM_OPS_FOR_TESTING_H_
+
+#include "tnlBitStream.h"
+#include "tnlVector.h"
+
+namespace Zap
+{
+using namespace TNL;
+
+
+// What each write in the BitStream fuzz test will do
+enum OpType {
+   OpInt,
+   OpFlag,
+   OpRanged,
+   OpSignedFloat,
+   OpTypeCount
+};
+
+struct BitStreamOp
+{
+   OpType type;
+   U8 bitCount;
+   U32 value;
+   U32 rangeStart;      // For OpRanged
+   U32 rangeEnd;
+   F32 floatValue;      // For OpSignedFloat
+};
+
+
+// A random mix of writes; uses rand(), so seed it first for a repeatable mix
+void getRandomOps(S32 count, Vector<BitStreamOp> &ops);
+
+void writeOps(BitStream &stream, const Vector<BitStreamOp> &ops);
+
+// The way these were written before the word-at-a-time paths: everything through writeBits()
+void writeOpsBitByBit(BitStream &stream, const Vector<BitStreamOp> &ops);
+
+};
+
+#endif
@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "GridWorldForTesting.h"
+
+#include "BfObject.h"
+
+namespace Zap
+{
+
+
+GridTestObject::GridTestObject(U8 typeNumber, S32 index, const Point &pos, F32 radius)
+{
+   mObjectTypeNumber = typeNumber;
+   mIndex = index;
+   mPos = pos;
+   mRadius = radius;
+   setExtent(Rect(pos, radius));
+}
+
+
+void GridTestObject::moveTo(const Point &pos)
+{
+   mPos = pos;
+   setExtent(Rect(pos, mRadius));
+}
+
+
+bool GridTestObject::getCollisionCircle(U32 stateIndex, Point &point, F32 &radius) const
+{
+   point = mPos;
+   radius = mRadius;
+   return true;
+}
+
+
+GridTestWorld::GridTestWorld(GridDatabase::BucketBackend backend)
+{
+   GridDatabase::BucketBackend oldBackend = GridDatabase::getDefaultBucketBackend();
+   GridDatabase::setDefaultBucketBackend(backend);
+   mDatabase = new GridDatabase();
+   GridDatabase::setDefaultBucketBackend(oldBackend);
+
+   GridTestRandom random(1234);
+
+   for(S32 i = 0; i < WallCount; i++)
+      add(BarrierTypeNumber, Point(random.readF(0, ArenaSize), random.readF(0, ArenaSize)), random.readF(50, 400), false);
+
+   for(S32 i = 0; i < ZoneCount; i++)
+      add(i % 2 ? LoadoutZoneTypeNumber : GoalZoneTypeNumber, Point(random.readF(0, ArenaSize), random.readF(0, ArenaSize)), 100, false);
+
+   for(S32 i = 0; i < PlayerCount; i++)
+      add(i % 8 ? PlayerShipTypeNumber : RobotShipTypeNumber, Point(random.readF(0, ArenaSize), random.readF(0, ArenaSize)), 24, true);
+
+   for(S32 i = 0; i < ProjectileCount; i++)
+   {
+      U8 type = i % 10 == 0 ? MineTypeNumber : i % 10 == 1 ? BurstTypeNumber : BulletTypeNumber;
+      add(type, Point(random.readF(0, ArenaSize), random.readF(0, ArenaSize)), 5, type != MineTypeNumber);
+   }
+}
+
+
+GridTestWorld::~GridTestWorld()
+{
+   delete mDatabase;    // Deletes all our objects as well
+}
+
+
+void GridTestWorld::add(U8 type, const Point &pos, F32 radius, bool moves)
+{
+   GridTestObject *obj = new GridTestObject(type, mObjects.size(), pos, radius);
+   obj->addToDatabase(mDatabase);
+   mObjects.push_back(obj);
+
+   if(moves)
+      mMovers.push_back(obj);
+}
+
+
+void GridTestWorld::tick(GridTestRandom &random)
+{
+   for(S32 i = 0; i < mMovers.size(); i++)
+   {
+      Point pos = mMovers[i]->mPos + Point(random.readF(-40, 40), random.readF(-40, 40));
+
+      if(pos.x < 0) pos.x += ArenaSize;
+      if(pos.y < 0) pos.y += ArenaSize;
+      if(pos.x > ArenaSize) pos.x -= ArenaSize;
+      if(pos.y > ArenaSize) pos.y -= ArenaSize;
+
+      mMovers[i]->moveTo(pos);
+   }
+}
+
+
+};
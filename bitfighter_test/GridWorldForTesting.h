@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _GRID_WORLD_FOR_TESTING_H_
+#define _GRID_WORLD_FOR_TESTING_H_
+
+#include "gridDB.h"
+#include "Point.h"
+
+#include "tnlTypes.h"
+#include "tnlVector.h"
+
+namespace Zap
+{
+
+using namespace TNL;
+
+
+// Minimal database object; the grid only cares about type numbers and extents
+class GridTestObject : public DatabaseObject
+{
+public:
+   S32 mIndex;
+   Point mPos;
+   F32 mRadius;
+
+   GridTestObject(U8 typeNumber, S32 index, const Point &pos, F32 radius);
+
+   void moveTo(const Point &pos);
+
+   // Lets line of sight searches hit us
+   bool getCollisionCircle(U32 stateIndex, Point &point, F32 &radius) const;
+};
+
+
+// Small deterministic generator so both backends see exactly the same world
+struct GridTestRandom
+{
+   U32 mState;
+
+   GridTestRandom(U32 seed) { mState = seed; }
+
+   F32 readF()
+   {
+      mState = mState * 1664525 + 1013904223;
+      return F32(mState >> 8) / F32(1 << 24);
+   }
+
+   F32 readF(F32 min, F32 max) { return min + (max - min) * readF(); }
+};
+
+
+// Arena is 4000 x 4000, which spans all 16 x 16 buckets without wrapping
+static const F32 ArenaSize = 4000;
+
+// Approximates a full 64 player game late in a match: walls around the edge and in the middle,
+// a handful of zones, ships scattered everywhere, and lots of bullets, mines and bursts in flight
+struct GridTestWorld
+{
+   enum {
+      PlayerCount = 64,
+      ProjectileCount = 1500,
+      WallCount = 40,
+      ZoneCount = 12,
+   };
+
+   GridDatabase *mDatabase;
+   Vector<GridTestObject *> mObjects;
+   Vector<GridTestObject *> mMovers;
+
+   GridTestWorld(GridDatabase::BucketBackend backend);
+   ~GridTestWorld();
+
+   void add(U8 type, const Point &pos, F32 radius, bool moves);
+
+   // Move everything that moves, wrapping around the arena
+   void tick(GridTestRandom &random);
+};
+
+};
+
+#endif
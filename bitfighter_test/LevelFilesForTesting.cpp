@@ -9,6 +9,8 @@
 #include "stringUtils.h"
 #include "tnlVector.h"
 
+#include <math.h>
+
 namespace Zap
 {
 
@@ -286,4 +288,24 @@ string getMultiTeamLevelCode(S32 teams)
    return code;
 }
 
+
+// Level with a single spawn and itemCount ResourceItems packed into a square around it, all well within the
+// scope of a ship sitting on the spawn
+string getLevelCodeWithItems(S32 itemCount)
+{
+   string levelCode = getGenericHeader() + "Spawn 0 0 0\n";
+
+   S32 side = S32(sqrt(F32(itemCount))) + 1;
+
+   for(S32 i = 0; i < itemCount; i++)
+   {
+      F32 x = ((i % side) - side / 2) * 0.04f;
+      F32 y = ((i / side) - side / 2) * 0.04f;
+
+      levelCode += "ResourceItem " + ftos(x) + " " + ftos(y) + "\n";
+   }
+
+   return levelCode;
+}
+
 };
\ No newline at end of file
@@ -0,0 +1,34 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "PolygonsForTesting.h"
+
+#include <math.h>
+
+namespace Zap
+{
+
+
+// Star shaped, so concave more often than not, with the odd repeated vertex to give us zero length edges.  Vertex
+// counts run from triangles up past several full SSE2 blocks, so every kernel width and the leftover edges all get used.
+void makePolygon(EdgeTestRandom &random, Vector<Point> &points)
+{
+   S32 vertexCount = random.readI(3, 40);
+   Point center(random.readF(-200, 200), random.readF(-200, 200));
+
+   points.clear();
+   for(S32 i = 0; i < vertexCount; i++)
+   {
+      F32 angle = FloatTau * i / vertexCount;
+      F32 radius = random.readF(20, 150);
+      points.push_back(center + Point(cos(angle) * radius, sin(angle) * radius));
+
+      if(random.readF() < 0.05f)
+         points.push_back(points.last());
+   }
+}
+
+
+};
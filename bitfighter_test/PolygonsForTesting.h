@@ -0,0 +1,42 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _POLYGONS_FOR_TESTING_H_
+#define _POLYGONS_FOR_TESTING_H_
+
+#include "Point.h"
+
+#include "tnlTypes.h"
+#include "tnlVector.h"
+
+namespace Zap
+{
+
+using namespace TNL;
+
+
+// Our own generator, so the same seed gives the same polygons on every platform
+struct EdgeTestRandom
+{
+   U32 mState;
+
+   EdgeTestRandom(U32 seed) { mState = seed; }
+
+   F32 readF()
+   {
+      mState = mState * 1664525 + 1013904223;
+      return F32(mState >> 8) / F32(1 << 24);
+   }
+
+   F32 readF(F32 min, F32 max) { return min + (max - min) * readF(); }
+   S32 readI(S32 min, S32 max) { return min + S32(readF() * (max - min + 1)) % (max - min + 1); }
+};
+
+
+void makePolygon(EdgeTestRandom &random, Vector<Point> &points);
+
+};
+
+#endif
@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "ServerListsForTesting.h"
+
+#include "tnlRandom.h"
+
+namespace Zap
+{
+
+
+IPAddress makeAddress(S32 serverId)
+{
+   IPAddress address;
+   address.netNum = serverId;
+   address.port = 28000;
+
+   return address;
+}
+
+
+void applyChanges(map<S32, IPAddress> &list, const Vector<IPAddress> &added, const Vector<S32> &addedIds,
+                  const Vector<S32> &removedIds)
+{
+   for(S32 i = 0; i < removedIds.size(); i++)
+      list.erase(removedIds[i]);
+
+   for(S32 i = 0; i < addedIds.size(); i++)
+      list[addedIds[i]] = added[i];
+}
+
+
+void getFullList(const ServerRegistry &registry, U32 protocol, bool hostMode, map<S32, IPAddress> &list)
+{
+   const Vector<IPAddress> *addresses;
+   const Vector<S32> *serverIds;
+   registry.getServers(protocol, hostMode, addresses, serverIds);
+
+   list.clear();
+
+   if(addresses)
+      for(S32 i = 0; i < serverIds->size(); i++)
+         list[serverIds->get(i)] = addresses->get(i);
+}
+
+
+bool sameServers(const map<S32, IPAddress> &a, const map<S32, IPAddress> &b)
+{
+   if(a.size() != b.size())
+      return false;
+
+   for(map<S32, IPAddress>::const_iterator i = a.begin(), j = b.begin(); i != a.end(); i++, j++)
+      if(i->first != j->first || i->second.netNum != j->second.netNum || i->second.port != j->second.port)
+         return false;
+
+   return true;
+}
+
+
+ServerListChurn::ServerListChurn(S32 clientCount, S32 serverCount)
+{
+   mNextServerId = 0;
+   mServerCount = serverCount;
+   mSentEntries = 0;
+   mFullEntries = 0;
+
+   for(S32 i = 0; i < serverCount; i++)
+   {
+      mRegistry.updateServer(mNextServerId, makeAddress(mNextServerId), 39, i % 10 == 0, true);
+      mLiveServers.push_back(mNextServerId);
+      mNextServerId++;
+   }
+
+   mClientLists.resize(clientCount);
+   mClientVersions.resize(clientCount);
+
+   for(S32 i = 0; i < clientCount; i++)
+      mClientVersions[i] = 0;
+}
+
+
+void ServerListChurn::runRound(S32 round, S32 churn)
+{
+   for(S32 i = 0; i < churn; i++)
+   {
+      S32 index = Random::readI(0, mLiveServers.size() - 1);
+      mRegistry.removeServer(mLiveServers[index]);
+      mLiveServers.erase_fast(index);
+
+      mRegistry.updateServer(mNextServerId, makeAddress(mNextServerId), 39, mNextServerId % 10 == 0, true);
+      mLiveServers.push_back(mNextServerId);
+      mNextServerId++;
+   }
+
+   Vector<IPAddress> added;
+   Vector<S32> addedIds, removedIds;
+
+   for(S32 i = 0; i < mClientLists.size(); i++)
+   {
+      if(round > 0 && (i + round) % 3 != 0)
+         continue;
+
+      if(!mRegistry.getChanges(39, false, mClientVersions[i], added, addedIds, removedIds))
+      {
+         getFullList(mRegistry, 39, false, mClientLists[i]);
+         mSentEntries += mClientLists[i].size();
+      }
+      else
+      {
+         applyChanges(mClientLists[i], added, addedIds, removedIds);
+         mSentEntries += addedIds.size() + removedIds.size();
+      }
+
+      mClientVersions[i] = mRegistry.getVersion();
+      mFullEntries += mServerCount;
+   }
+}
+
+
+};
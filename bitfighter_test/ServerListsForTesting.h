@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _SERVER_LISTS_FOR_TESTING_H_
+#define _SERVER_LISTS_FOR_TESTING_H_
+
+#include "../master/ServerRegistry.h"
+
+#include "tnlTypes.h"
+#include "tnlVector.h"
+
+#include <map>
+
+namespace Zap
+{
+
+using namespace Master;
+using namespace TNL;
+using namespace std;
+
+
+IPAddress makeAddress(S32 serverId);
+
+// What a client ends up with after applying a delta to the list it already had
+void applyChanges(map<S32, IPAddress> &list, const Vector<IPAddress> &added, const Vector<S32> &addedIds,
+                  const Vector<S32> &removedIds);
+
+void getFullList(const ServerRegistry &registry, U32 protocol, bool hostMode, map<S32, IPAddress> &list);
+bool sameServers(const map<S32, IPAddress> &a, const map<S32, IPAddress> &b);
+
+
+// Lots of clients re-querying a master while servers come and go, each keeping the list the master sent it
+struct ServerListChurn
+{
+   ServerRegistry mRegistry;
+   Vector<S32> mLiveServers;
+   S32 mNextServerId;
+   S32 mServerCount;
+
+   Vector<map<S32, IPAddress> > mClientLists;
+   Vector<U32> mClientVersions;
+
+   S64 mSentEntries;       // List entries the master sent
+   S64 mFullEntries;       // What it would have sent if every query got the whole list
+
+   ServerListChurn(S32 clientCount, S32 serverCount);
+
+   // Some servers leave and others arrive, then clients re-query; everyone checks in on the first round, after that
+   // a third of them do each round
+   void runRound(S32 round, S32 churn);
+};
+
+};
+
+#endif
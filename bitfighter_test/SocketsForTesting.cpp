@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "SocketsForTesting.h"
+
+#include "tnlUDP.h"
+#include "tnlPlatform.h"
+
+#include <string.h>
+
+namespace Zap
+{
+
+
+bool sendOverLoopback(bool batched, S32 rounds, F64 &ms)
+{
+   const S32 count = LoopbackPacketsPerRound;
+   const S32 size = LoopbackPacketSize;
+
+   Socket sender(Address("IP:127.0.0.1:0"));
+   Socket receiver(Address("IP:127.0.0.1:0"));
+
+   if(!sender.isValid() || !receiver.isValid())
+      return false;
+
+   Address destination = receiver.getBoundAddress();
+
+   U8 sendBuffers[count][size];
+   U8 recvBuffers[count][MaxPacketDataSize];
+   Socket::Datagram outgoing[count];
+   Socket::Datagram incoming[count];
+
+   for(S32 i = 0; i < count; i++)
+   {
+      memset(sendBuffers[i], i, size);
+
+      outgoing[i].address = destination;
+      outgoing[i].buffer = sendBuffers[i];
+      outgoing[i].capacity = size;
+      outgoing[i].size = size;
+
+      incoming[i].buffer = recvBuffers[i];
+      incoming[i].capacity = MaxPacketDataSize;
+      incoming[i].size = 0;
+   }
+
+   S32 nextSent = 0;
+   S32 nextReceived = 0;
+   bool ok = true;
+
+   S64 startTime = Platform::getHighPrecisionTimerValue();
+
+   for(S32 round = 0; round < rounds; round++)
+   {
+      for(S32 i = 0; i < count; i++)
+         writeU32ToBuffer(nextSent++, sendBuffers[i]);
+
+      if(batched)
+         ok &= sender.sendtoBatch(outgoing, count) == count;
+      else
+         for(S32 i = 0; i < count; i++)
+            ok &= sender.sendto(destination, sendBuffers[i], size) == NoError;
+
+      S32 received = 0;
+
+      while(received < count)
+      {
+         if(!receiver.waitForData(1000 * 1000))
+            return false;     // Packets went missing
+
+         if(batched)
+            received += receiver.recvfromBatch(incoming + received, count - received);
+         else
+            while(received < count && receiver.recvfrom(&incoming[received].address, incoming[received].buffer,
+                                                        incoming[received].capacity, &incoming[received].size) == NoError)
+               received++;
+      }
+
+      for(S32 i = 0; i < count; i++)
+         ok &= incoming[i].size == size && readU32FromBuffer(incoming[i].buffer) == U32(nextReceived++) &&
+               incoming[i].buffer[size - 1] == U8(i);
+   }
+
+   ms = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - startTime);
+
+   return ok;
+}
+
+
+};
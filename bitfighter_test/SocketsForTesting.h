@@ -0,0 +1,26 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _SOCKETS_FOR_TESTING_H_
+#define _SOCKETS_FOR_TESTING_H_
+
+#include "tnlTypes.h"
+
+namespace Zap
+{
+
+using namespace TNL;
+
+static const S32 LoopbackPacketsPerRound = 16;    // Few enough not to overflow the receive buffer before we get to them
+static const S32 LoopbackPacketSize = 200;
+
+
+// Sends rounds * LoopbackPacketsPerRound numbered packets over loopback, either a batch at a time or one at a time.
+// Returns true if they all arrived, in order and intact, and sets ms to the time taken.
+bool sendOverLoopback(bool batched, S32 rounds, F64 &ms);
+
+};
+
+#endif
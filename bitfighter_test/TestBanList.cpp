@@ -0,0 +1,140 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "BanList.h"
+
+#include "gtest/gtest.h"
+
+namespace Zap
+{
+
+// 20110131T123000, local time, in seconds since the epoch
+static const S64 BanStart = 1296477000;
+
+
+static Vector<string> makeBanLines(const char *first, const char *second = NULL)
+{
+   Vector<string> lines;
+   lines.push_back(first);
+
+   if(second)
+      lines.push_back(second);
+
+   return lines;
+}
+
+
+TEST(BanListTest, parseAddressRange)
+{
+   U32 net;
+   S32 prefixLength;
+
+   ASSERT_TRUE(BanList::parseAddressRange("*", net, prefixLength));
+   EXPECT_EQ(0, prefixLength);
+
+   ASSERT_TRUE(BanList::parseAddressRange("10.1.2.3", net, prefixLength));
+   EXPECT_EQ(32, prefixLength);
+   EXPECT_EQ(0x0A010203u, net);
+
+   ASSERT_TRUE(BanList::parseAddressRange("10.1.*", net, prefixLength));
+   EXPECT_EQ(16, prefixLength);
+   EXPECT_EQ(0x0A010000u, net);
+
+   ASSERT_TRUE(BanList::parseAddressRange("10.1.*.*", net, prefixLength));
+   EXPECT_EQ(16, prefixLength);
+
+   ASSERT_TRUE(BanList::parseAddressRange("10.1.2.3/24", net, prefixLength));
+   EXPECT_EQ(24, prefixLength);
+   EXPECT_EQ(0x0A010200u, net);
+
+   EXPECT_FALSE(BanList::parseAddressRange("10.1.2", net, prefixLength));
+   EXPECT_FALSE(BanList::parseAddressRange("10.*.2.3", net, prefixLength));
+   EXPECT_FALSE(BanList::parseAddressRange("10.1.2.256", net, prefixLength));
+   EXPECT_FALSE(BanList::parseAddressRange("10.1.2.3/33", net, prefixLength));
+   EXPECT_FALSE(BanList::parseAddressRange("10.1.*/8", net, prefixLength));
+   EXPECT_FALSE(BanList::parseAddressRange("bitfighter.org", net, prefixLength));
+}
+
+
+TEST(BanListTest, addressBans)
+{
+   BanList banList("");
+   banList.loadBanList(makeBanLines("10.1.2.3|*|20110131T123000|30", "192.168.*|*|20110131T123000|30"));
+   ASSERT_EQ(2, banList.getBanCount());
+
+   S64 now = BanStart + 60;
+
+   EXPECT_TRUE (banList.isBanned(Address("10.1.2.3:28000"), "bob", false, now));
+   EXPECT_FALSE(banList.isBanned(Address("10.1.2.4:28000"), "bob", false, now));
+   EXPECT_TRUE (banList.isBanned(Address("192.168.40.1:28000"), "bob", true, now));
+   EXPECT_FALSE(banList.isBanned(Address("192.169.40.1:28000"), "bob", true, now));
+
+   banList.loadBanList(makeBanLines("10.1.2.3/24|*|20110131T123000|30"));
+   EXPECT_TRUE (banList.isBanned(Address("10.1.2.200:28000"), "bob", false, now));
+   EXPECT_FALSE(banList.isBanned(Address("10.1.3.200:28000"), "bob", false, now));
+
+   // The text comes back out just as it went in
+   ASSERT_EQ(1, banList.banListToString().size());
+   EXPECT_EQ("10.1.2.3/24|*|20110131T123000|30", banList.banListToString()[0]);
+}
+
+
+TEST(BanListTest, nicknameBans)
+{
+   BanList banList("");
+   banList.loadBanList(makeBanLines("*|watusimoto|20110131T123000|30", "10.1.2.3|*NonAuthenticated|20110131T123000|30"));
+
+   S64 now = BanStart + 60;
+
+   EXPECT_TRUE (banList.isBanned(Address("1.2.3.4:28000"), "watusimoto", true, now));
+   EXPECT_FALSE(banList.isBanned(Address("1.2.3.4:28000"), "raptor", false, now));
+
+   // *NonAuthenticated is checked against the nickname like any other, so it doesn't stop anyone else
+   EXPECT_FALSE(banList.isBanned(Address("10.1.2.3:28000"), "raptor", false, now));
+   EXPECT_FALSE(banList.isBanned(Address("10.1.2.3:28000"), "raptor", true, now));
+}
+
+
+TEST(BanListTest, expiry)
+{
+   BanList banList("");
+   banList.loadBanList(makeBanLines("10.1.2.3|*|20110131T123000|30", "10.1.2.3|*|20110131T123000|60"));
+
+   Address address("10.1.2.3:28000");
+
+   EXPECT_TRUE(banList.isBanned(address, "bob", false, BanStart + 30 * 60));
+   EXPECT_EQ(2, banList.getBanCount());
+
+   // First one has run out, second is still going
+   EXPECT_TRUE(banList.isBanned(address, "bob", false, BanStart + 30 * 60 + 1));
+   EXPECT_EQ(1, banList.getBanCount());
+
+   EXPECT_FALSE(banList.isBanned(address, "bob", false, BanStart + 60 * 60 + 1));
+   EXPECT_EQ(0, banList.getBanCount());
+}
+
+
+TEST(BanListTest, addAndRemove)
+{
+   BanList banList("");
+   Address address("10.1.2.3:28000");
+
+   banList.addToBanList(address, 30);
+   banList.addPlayerNameToBanList("watusimoto", 30);
+   EXPECT_EQ(2, banList.getBanCount());
+
+   EXPECT_TRUE(banList.isBanned(address, "bob", false));
+   EXPECT_TRUE(banList.isBanned(Address("1.2.3.4:28000"), "watusimoto", false));
+
+   // Doesn't lift anything yet
+   banList.removeFromBanList(address);
+   EXPECT_EQ(2, banList.getBanCount());
+
+   EXPECT_TRUE(banList.isBanned(address, "bob", false));
+   EXPECT_TRUE(banList.isBanned(Address("1.2.3.4:28000"), "watusimoto", false));
+}
+
+
+};
@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "gtest/gtest.h"
+
+#include "BitStreamOpsForTesting.h"
+
+#include "tnlBitStream.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+namespace Zap
+{
+using namespace TNL;
+
+
+// Word-at-a-time writes must produce exactly the bytes writeBits() does, including leaving alone whatever was
+// already in the buffer past the last bit written, and reads must give back what was written
+TEST(BitStreamTest, wordAtATimeMatchesBitByBit)
+{
+   srand(1234);
+
+   const U32 BufferSize = 1024;
+
+   U8 buffer[BufferSize];
+   U8 reference[BufferSize];
+
+   for(S32 run = 0; run < 500; run++)
+   {
+      Vector<BitStreamOp> ops;
+      getRandomOps(rand() % 200, ops);
+
+      for(U32 i = 0; i < BufferSize; i++)
+         buffer[i] = reference[i] = U8(rand());
+
+      // Start partway into a byte sometimes
+      U32 startBit = rand() % 8;
+
+      BitStream stream(buffer, BufferSize);
+      BitStream referenceStream(reference, BufferSize);
+      stream.setBitPosition(startBit);
+      referenceStream.setBitPosition(startBit);
+
+      writeOps(stream, ops);
+      writeOpsBitByBit(referenceStream, ops);
+
+      ASSERT_EQ(referenceStream.getBitPosition(), stream.getBitPosition());
+      ASSERT_EQ(0, memcmp(buffer, reference, BufferSize)) << "Run " << run;
+
+      stream.setBitPosition(startBit);
+
+      for(S32 i = 0; i < ops.size(); i++)
+      {
+         const BitStreamOp &op = ops[i];
+
+         if(op.type == OpInt)
+            ASSERT_EQ(op.value, stream.readInt(op.bitCount));
+         else if(op.type == OpFlag)
+            ASSERT_EQ(op.value != 0, stream.readFlag());
+         else if(op.type == OpRanged)
+            ASSERT_EQ(op.value, stream.readRangedU32(op.rangeStart, op.rangeEnd));
+         else
+         {
+            F32 scale = F32((1 << (op.bitCount - 1)) - 1);
+            ASSERT_EQ(S32(op.floatValue * scale) / scale, stream.readSignedFloat(op.bitCount));
+         }
+      }
+
+      ASSERT_TRUE(stream.isValid());
+   }
+}
+
+
+// Writes that run right up to the end of the buffer have to fall back to writeBits(), and still get it right
+TEST(BitStreamTest, writesAtEndOfBuffer)
+{
+   U8 buffer[5];
+   U8 reference[5];
+
+   for(U32 startBit = 0; startBit < 8; startBit++)
+      for(U32 bitCount = 0; bitCount <= 32; bitCount++)
+      {
+         memset(buffer, 0xA5, sizeof(buffer));
+         memset(reference, 0xA5, sizeof(reference));
+
+         BitStream stream(buffer, sizeof(buffer));
+         BitStream referenceStream(reference, sizeof(reference));
+         stream.setBitPosition(startBit);
+         referenceStream.setBitPosition(startBit);
+
+         U32 value = 0x12345678 & (bitCount == 32 ? 0xFFFFFFFF : (1 << bitCount) - 1);
+         U32 leValue = convertHostToLEndian(value);
+
+         if(startBit + bitCount > sizeof(buffer) * 8)
+            continue;
+
+         stream.writeInt(value, U8(bitCount));
+         referenceStream.writeBits(bitCount, &leValue);
+
+         ASSERT_EQ(0, memcmp(buffer, reference, sizeof(buffer)));
+
+         stream.setBitPosition(startBit);
+         ASSERT_EQ(value, stream.readInt(U8(bitCount)));
+      }
+}
+
+
+};
@@ -0,0 +1,114 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "gtest/gtest.h"
+
+#include "BotNavMeshZone.h"
+#include "ServerGame.h"
+
+#include "LevelFilesForTesting.h"
+#include "TestUtils.h"
+
+
+namespace Zap
+{
+using namespace std;
+
+
+// Cached and hierarchical searches should find a route exactly when the plain search does, and the cached route
+// should be the plain one
+TEST(BotNavMeshTest, pathFinderMatchesAStar)
+{
+   Vector<string> levels = getLevels().first;
+
+   for(S32 i = 0; i < levels.size(); i++)
+   {
+      GamePair gamePair(levels[i], 0);
+      ServerGame *serverGame = gamePair.server;
+
+      const Vector<BotNavMeshZone *> &zones = serverGame->getBotZoneList();
+      if(zones.size() == 0)
+         continue;
+
+      BotPathFinder pathFinder;
+      pathFinder.reset(&zones);
+      pathFinder.setUseClusters(false);
+
+      BotPathFinder clusteredPathFinder;
+      clusteredPathFinder.reset(&zones);
+      clusteredPathFinder.setUseClusters(true);
+      EXPECT_GT(clusteredPathFinder.getClusterCount(), 0);
+
+      Vector<pair<S32, S32> > queries;
+      getRandomPairs(zones.size(), 100, queries);
+
+      for(S32 j = 0; j < queries.size(); j++)
+      {
+         Point target = zones[queries[j].second]->getCenter();
+         Vector<Point> expected = AStar::findPath(&zones, queries[j].first, queries[j].second, target);
+         Vector<Point> path;
+
+         // Twice, so the second comes from the cache
+         for(S32 k = 0; k < 2; k++)
+         {
+            pathFinder.findPath(queries[j].first, queries[j].second, target, path);
+            ASSERT_EQ(expected.size(), path.size());
+            for(S32 m = 0; m < path.size(); m++)
+               EXPECT_EQ(expected[m], path[m]);
+         }
+
+         clusteredPathFinder.findPath(queries[j].first, queries[j].second, target, path);
+         EXPECT_EQ(expected.size() > 0, path.size() > 0);
+      }
+
+      // A new nav mesh means starting over
+      EXPECT_GT(pathFinder.getCachedPathCount(), 0);
+      pathFinder.reset(&zones);
+      EXPECT_EQ(0, pathFinder.getCachedPathCount());
+   }
+}
+
+
+// Routes from the next hop table should reach the same places plain A* does
+TEST(BotNavMeshTest, nextHopTableMatchesAStar)
+{
+   Vector<string> levels = getLevels().first;
+
+   for(S32 i = 0; i < levels.size(); i++)
+   {
+      GamePair gamePair(levels[i], 0);
+      ServerGame *serverGame = gamePair.server;
+
+      const Vector<BotNavMeshZone *> &zones = serverGame->getBotZoneList();
+      if(zones.size() == 0)
+         continue;
+
+      BotPathFinder pathFinder;
+      pathFinder.reset(&zones, true);
+      ASSERT_TRUE(pathFinder.waitForNextHopTable());
+
+      Vector<pair<S32, S32> > queries;
+      getRandomPairs(zones.size(), 100, queries);
+
+      for(S32 j = 0; j < queries.size(); j++)
+      {
+         Point target = zones[queries[j].second]->getCenter();
+         Vector<Point> expected = AStar::findPath(&zones, queries[j].first, queries[j].second, target);
+         Vector<Point> path;
+
+         pathFinder.findPath(queries[j].first, queries[j].second, target, path);
+
+         ASSERT_EQ(expected.size() > 0, path.size() > 0);
+         if(path.size() > 0)
+         {
+            EXPECT_EQ(expected.first(), path.first());
+            EXPECT_EQ(expected.last(), path.last());
+         }
+      }
+   }
+}
+
+
+};
@@ -0,0 +1,194 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "TestUtils.h"
+
+#include "../zap/ServerGame.h"
+#include "../zap/robot.h"
+#include "../zap/luaLevelGenerator.h"
+#include "../zap/LuaWrapper.h"
+
+#include "tnlRandom.h"
+
+#include "gtest/gtest.h"
+
+namespace Zap
+{
+
+using namespace std;
+using namespace TNL;
+
+
+// While the world is locked, READ_ONLY methods run right away, but the rest wait for runDeferredCalls(), which makes
+// them in the order they were called
+TEST(BotTickSchedulerTest, deferredCalls)
+{
+   GamePair gamePair("", 0);
+
+   LuaLevelGenerator levelgen(gamePair.server);
+   levelgen.runScript(false);
+
+   luaW_setWorldLocked(true);
+
+   EXPECT_TRUE(levelgen.runString("item = TextItem.new({ point.new(0, 0), point.new(100, 0) }, 'first') "
+                                  "bf:addItem(item) "
+                                  "item:setText('second') "
+                                  "item:setText('third') "
+                                  "assert(item:getText() == 'first') "
+                                  "assert(#bf:findAllObjects(ObjType.TextItem) == 0)"));
+
+   luaW_setWorldLocked(false);
+
+   // Nothing has happened yet...
+   EXPECT_TRUE(levelgen.runString("assert(item:getText() == 'first') "
+                                  "assert(#bf:findAllObjects(ObjType.TextItem) == 0)"));
+
+   levelgen.runDeferredCalls();
+
+   // ...but now it has
+   EXPECT_TRUE(levelgen.runString("t = bf:findAllObjects(ObjType.TextItem) "
+                                  "assert(#t == 1) "
+                                  "assert(t[1]:getText() == 'third')"));
+
+   // Calls are only made once
+   EXPECT_TRUE(levelgen.runString("item:setText('fourth')"));
+   levelgen.runDeferredCalls();
+   EXPECT_TRUE(levelgen.runString("assert(item:getText() == 'fourth')"));
+}
+
+
+static GameSettingsPtr newBotWorkerSettings()
+{
+   GameSettingsPtr settings = GameSettingsPtr(new GameSettings());
+
+   settings->setSetting(IniKey::AddRobots, No);
+   settings->setSetting(IniKey::BotWorkers, U32(2));
+
+   return settings;
+}
+
+
+// Bots with Lua states of their own tick on the workers, and only see the changes they make once the tick is over
+TEST(BotTickSchedulerTest, tickOnWorkers)
+{
+   GamePair gamePair(newBotWorkerSettings());
+   ASSERT_EQ(U32(2), gamePair.server->getSettings()->getBotWorkerCount());
+
+   const S32 botCount = 6;
+   Vector<string> args;
+
+   for(S32 i = 0; i < botCount; i++)
+      gamePair.server->addBot(args, ClientInfo::ClassRobotAddedByAddbots);
+
+   ASSERT_EQ(botCount, gamePair.server->getRobotCount());
+
+   // Each bot gets a TextItem of its own to write to
+   LuaLevelGenerator levelgen(gamePair.server);
+   levelgen.runScript(false);
+
+   EXPECT_TRUE(levelgen.runString("for i = 1, " + itos(botCount) + " do "
+                                  "   local item = TextItem.new({ point.new(0, i * 100), point.new(100, i * 100) }, '0') "
+                                  "   item:setId(i) "
+                                  "   bf:addItem(item) "
+                                  "end"));
+
+   for(S32 i = 0; i < botCount; i++)
+      EXPECT_TRUE(gamePair.server->getBot(i)->runString(
+            "itemId = " + itos(i + 1) + " "
+            "ticks = 0 "
+            "sawChange = false "
+            "function onTick(deltaT) "
+            "   local item = bf:findObjectById(itemId) "
+            "   if item:getText() ~= tostring(ticks) then sawChange = true end "
+            "   ticks = ticks + 1 "
+            "   item:setText(tostring(ticks)) "
+            "   if item:getText() ~= tostring(ticks - 1) then sawChange = true end "
+            "end"));
+
+   gamePair.idle(10, 20);
+
+   for(S32 i = 0; i < botCount; i++)
+   {
+      Robot *bot = gamePair.server->getBot(i);
+
+      EXPECT_TRUE(bot->runString("assert(ticks > 0)")) << "Bot " << i << " never ticked";
+      EXPECT_TRUE(bot->runString("assert(not sawChange)")) << "Bot " << i << " saw a change during its tick";
+      EXPECT_TRUE(bot->runString("assert(bf:findObjectById(itemId):getText() == tostring(ticks))")) << "Bot " << i;
+   }
+}
+
+
+// math.random reads from one generator shared by every bot, so bots calling it on several workers at once must still
+// get good numbers, and leave the generator working afterwards
+TEST(BotTickSchedulerTest, randomOnWorkers)
+{
+   GamePair gamePair(newBotWorkerSettings());
+
+   const S32 botCount = 8;
+   Vector<string> args;
+
+   for(S32 i = 0; i < botCount; i++)
+      gamePair.server->addBot(args, ClientInfo::ClassRobotAddedByAddbots);
+
+   ASSERT_EQ(botCount, gamePair.server->getRobotCount());
+
+   for(S32 i = 0; i < botCount; i++)
+      EXPECT_TRUE(gamePair.server->getBot(i)->runString(
+            "ticks = 0 "
+            "badNumbers = 0 "
+            "seen = {} "
+            "function onTick(deltaT) "
+            "   ticks = ticks + 1 "
+            "   for i = 1, 500 do "
+            "      local f = math.random() "
+            "      local m = math.random(10) "
+            "      local n = math.random(5, 8) "
+            "      if f < 0 or f > 1 or m < 1 or m > 10 or n < 5 or n > 8 then badNumbers = badNumbers + 1 end "
+            "      seen[m] = true "
+            "   end "
+            "end"));
+
+   gamePair.idle(10, 20);
+
+   for(S32 i = 0; i < botCount; i++)
+   {
+      Robot *bot = gamePair.server->getBot(i);
+
+      EXPECT_TRUE(bot->runString("assert(ticks > 0)")) << "Bot " << i << " never ticked";
+      EXPECT_TRUE(bot->runString("assert(badNumbers == 0)")) << "Bot " << i;
+
+      // 500 rolls of a ten sided die a tick should turn up every face
+      EXPECT_TRUE(bot->runString("for i = 1, 10 do assert(seen[i]) end")) << "Bot " << i;
+   }
+
+   // Still fine on the main thread
+   for(S32 i = 0; i < 100; i++)
+   {
+      U32 value = Random::readI(1, 6);
+      EXPECT_TRUE(value >= 1 && value <= 6);
+   }
+}
+
+
+// A bot that fails while the world is locked can't be killed until it's unlocked, but it still gets killed
+TEST(BotTickSchedulerTest, errorOnWorker)
+{
+   GamePair gamePair(newBotWorkerSettings());
+
+   Vector<string> args;
+   gamePair.server->addBot(args, ClientInfo::ClassRobotAddedByAddbots);
+   gamePair.server->addBot(args, ClientInfo::ClassRobotAddedByAddbots);
+
+   ASSERT_EQ(2, gamePair.server->getRobotCount());
+
+   EXPECT_TRUE(gamePair.server->getBot(0)->runString("function onTick(deltaT) error('Ouch') end"));
+
+   gamePair.idle(20, 10);     // More than 100ms; removing bot from game has a 100ms delay
+
+   EXPECT_EQ(1, gamePair.server->getRobotCount());
+}
+
+
+};
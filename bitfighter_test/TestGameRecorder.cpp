@@ -0,0 +1,212 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "TestUtils.h"
+
+#include "../zap/GameRecorder.h"
+#include "../zap/GameRecorderPlayback.h"
+#include "../zap/ServerGame.h"
+#include "../zap/ClientGame.h"
+#include "../zap/stringUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+
+namespace Zap
+{
+
+using namespace std;
+using namespace TNL;
+
+
+static Vector<U8> readFile(const string &filename)
+{
+   Vector<U8> data;
+
+   FILE *file = fopen(filename.c_str(), "rb");
+   if(!file)
+      return data;
+
+   U8 buffer[4096];
+   size_t count;
+   while((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+      for(size_t i = 0; i < count; i++)
+         data.push_back(buffer[i]);
+
+   fclose(file);
+   return data;
+}
+
+
+static void writeFile(const string &filename, const Vector<U8> &data, S32 size)
+{
+   FILE *file = fopen(filename.c_str(), "wb");
+   ASSERT_TRUE(file != NULL);
+   fwrite(data.address(), 1, size, file);
+   fclose(file);
+}
+
+
+// Records a few keyframes' worth of a game, and returns the recording's path
+static string recordGame(GamePair &gamePair, S32 keyframeCount)
+{
+   GameRecorderServer *recorder = new GameRecorderServer(gamePair.server);
+   string filename = joindir(gamePair.server->getSettings()->getFolderManager()->getRecordDir(), recorder->mFileName);
+
+   // A little extra, so the last interval has something in it
+   const U32 timeDelta = 100;
+   S32 cycles = (keyframeCount * GameRecorderServer::KeyframeInterval + GameRecorderServer::KeyframeInterval / 2) / timeDelta;
+
+   for(S32 i = 0; i < cycles; i++)
+   {
+      gamePair.idle(timeDelta);
+      recorder->idle(timeDelta);
+   }
+
+   delete recorder;     // Writes the index, and waits for everything to get to disk
+
+   return filename;
+}
+
+
+static void expectSameKeyframes(const Vector<KeyframeIndexEntry> &expected, const Vector<KeyframeIndexEntry> &actual)
+{
+   ASSERT_EQ(expected.size(), actual.size());
+
+   for(S32 i = 0; i < expected.size(); i++)
+   {
+      EXPECT_EQ(expected[i].time,     actual[i].time)     << "Keyframe " << i;
+      EXPECT_EQ(expected[i].offset,   actual[i].offset)   << "Keyframe " << i;
+      EXPECT_EQ(expected[i].eventSeq, actual[i].eventSeq) << "Keyframe " << i;
+   }
+}
+
+
+// The index at the end of the file says where the keyframe markers are, and playback reads back what we wrote;
+// without the index, playback finds the same keyframes by walking the recording
+TEST(GameRecorderTest, keyframeIndex)
+{
+   GamePair gamePair;      // One client, so there are scores to resend at each keyframe
+   const S32 keyframeCount = 3;
+
+   string filename = recordGame(gamePair, keyframeCount);
+   Vector<U8> data = readFile(filename);
+   ASSERT_GT(data.size(), 4 + GameRecorderServer::IndexTrailerSize);
+
+   // Trailer
+   const U8 *trailer = &data[data.size() - GameRecorderServer::IndexTrailerSize];
+   U32 count = GameRecorderServer::readU32(&trailer[0]);
+   U32 totalTime = GameRecorderServer::readU32(&trailer[4]);
+
+   ASSERT_EQ(U32(GameRecorderServer::IndexMagic), GameRecorderServer::readU32(&trailer[8]));
+   ASSERT_EQ(U32(keyframeCount + 1), count);      // Plus the start of the recording
+   EXPECT_GE(totalTime, U32(keyframeCount * GameRecorderServer::KeyframeInterval));
+
+   // Index, which should point at each of the markers
+   S32 indexPos = data.size() - GameRecorderServer::IndexTrailerSize - count * GameRecorderServer::IndexEntrySize;
+   Vector<KeyframeIndexEntry> keyframes;
+
+   for(U32 i = 0; i < count; i++)
+   {
+      const U8 *entry = &data[indexPos + i * GameRecorderServer::IndexEntrySize];
+
+      KeyframeIndexEntry keyframe;
+      keyframe.time = GameRecorderServer::readU32(&entry[0]);
+      keyframe.offset = GameRecorderServer::readU32(&entry[4]);
+      keyframe.eventSeq = GameRecorderServer::readU32(&entry[8]);
+      keyframes.push_back(keyframe);
+   }
+
+   EXPECT_EQ(U32(0), keyframes[0].time);
+   EXPECT_EQ(U32(4), keyframes[0].offset);
+
+   for(S32 i = 1; i < keyframes.size(); i++)
+   {
+      EXPECT_GE(keyframes[i].time, keyframes[i - 1].time + GameRecorderServer::KeyframeInterval) << "Keyframe " << i;
+      EXPECT_GT(keyframes[i].eventSeq, keyframes[i - 1].eventSeq) << "Keyframe " << i;
+
+      ASSERT_LT(keyframes[i].offset + 3 + GameRecorderServer::KeyframeMarkerSize, U32(indexPos)) << "Keyframe " << i;
+      const U8 *marker = &data[keyframes[i].offset];
+
+      EXPECT_EQ(U32(GameRecorderServer::KeyframeMarker), (U32(marker[1] & 63) << 8) + marker[0]) << "Keyframe " << i;
+      EXPECT_EQ(keyframes[i].eventSeq, GameRecorderServer::readU32(&marker[3])) << "Keyframe " << i;
+   }
+
+   ClientGame *playbackGame = newClientGame();
+
+   // Playback reads the same index
+   {
+      GameRecorderPlayback playback(playbackGame, filename.c_str());
+      ASSERT_TRUE(playback.isValid());
+
+      EXPECT_EQ(totalTime, playback.mTotalTime);
+      expectSameKeyframes(keyframes, playback.getKeyframes());
+   }
+
+   // Same recording, cut off before the end marker, as when the game quits without finishing it
+   string unfinishedFilename = filename + ".unfinished";
+   writeFile(unfinishedFilename, data, indexPos - 3);
+
+   {
+      GameRecorderPlayback playback(playbackGame, unfinishedFilename.c_str());
+      ASSERT_TRUE(playback.isValid());
+
+      EXPECT_LE(playback.mTotalTime, totalTime);
+      EXPECT_GE(playback.mTotalTime, keyframes.last().time);
+      expectSameKeyframes(keyframes, playback.getKeyframes());
+   }
+
+   delete playbackGame;
+
+   remove(unfinishedFilename.c_str());
+   remove(filename.c_str());
+}
+
+
+// Seeking starts over from the last keyframe at or before the time, expecting the event that keyframe says comes next
+TEST(GameRecorderTest, seek)
+{
+   GamePair gamePair;
+   const S32 keyframeCount = 3;
+
+   string filename = recordGame(gamePair, keyframeCount);
+
+   ClientGame *playbackGame = newClientGame();
+   GameRecorderPlayback *playback = new GameRecorderPlayback(playbackGame, filename.c_str());
+   ASSERT_TRUE(playback->isValid());
+   playbackGame->setConnectionToServer(playback);     // playbackGame will delete it
+
+   const Vector<KeyframeIndexEntry> &keyframes = playback->getKeyframes();
+   ASSERT_EQ(keyframeCount + 1, keyframes.size());
+
+   // Play most of the way through, then work backwards, landing right on each keyframe
+   playback->seek(playback->mTotalTime);
+   EXPECT_GE(playback->mCurrentTime, keyframes.last().time);
+
+   for(S32 i = keyframes.size() - 1; i >= 0; i--)
+   {
+      playback->seek(keyframes[i].time);
+
+      EXPECT_EQ(keyframes[i].time, playback->mCurrentTime) << "Keyframe " << i;
+      EXPECT_EQ(S32(keyframes[i].eventSeq), playback->getNextRecvEventSeq()) << "Keyframe " << i;
+   }
+
+   // Going forward within an interval just keeps playing, and going past the next keyframe jumps straight to it
+   playback->seek(keyframes[1].time - 1);
+   EXPECT_GE(playback->mCurrentTime, keyframes[1].time - 1);
+   EXPECT_LE(playback->getNextRecvEventSeq(), S32(keyframes[1].eventSeq));
+
+   playback->seek(keyframes[2].time + 1);
+   EXPECT_GE(playback->mCurrentTime, keyframes[2].time + 1);
+   EXPECT_GE(playback->getNextRecvEventSeq(), S32(keyframes[2].eventSeq));
+
+   delete playbackGame;
+
+   remove(filename.c_str());
+}
+
+
+};
@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "gtest/gtest.h"
+
+#include "ServerGame.h"
+#include "ClientGame.h"
+#include "Level.h"
+#include "ship.h"
+#include "gameNetInterface.h"
+
+#include "LevelFilesForTesting.h"
+#include "TestUtils.h"
+
+
+namespace Zap
+{
+using namespace std;
+
+
+// With far more ghosts than fit in one packet, every ghost should still make it over eventually
+TEST(GhostConnectionTest, allGhostsEventuallySent)
+{
+   const S32 itemCount = 500;
+
+   GamePair gamePair(getLevelCodeWithItems(itemCount), 1);
+   ServerGame *serverGame = gamePair.server;
+   ClientGame *clientGame = gamePair.getClient(0);
+
+   Vector<DatabaseObject *> fillVector;
+   serverGame->getLevel()->findObjects(ResourceItemTypeNumber, fillVector);
+   ASSERT_EQ(itemCount, fillVector.size());
+
+   for(S32 i = 0; i < 500; i++)
+   {
+      dirtyAllItems(serverGame);    // Keep everyone competing for space in the packet
+      gamePair.idle(33);
+
+      fillVector.clear();
+      clientGame->getLevel()->findObjects(ResourceItemTypeNumber, fillVector);
+      if(fillVector.size() == itemCount)
+         break;
+   }
+
+   EXPECT_EQ(itemCount, fillVector.size());
+}
+
+
+// Every dirtied item should be pushed out to the one connection it's ghosted to
+TEST(GhostConnectionTest, dirtyListCounters)
+{
+   const S32 itemCount = 50;
+
+   GamePair gamePair(getLevelCodeWithItems(itemCount), 1);
+   ServerGame *serverGame = gamePair.server;
+
+   gamePair.idle(33, 100);    // Get everything ghosted
+
+   dirtyAllItems(serverGame);
+   serverGame->getNetInterface()->resetPacketPhaseStats();
+   serverGame->getNetInterface()->processConnections();
+
+   const NetInterface::PacketPhaseStats &stats = serverGame->getNetInterface()->getPacketPhaseStats();
+
+   // Other objects (the ship, say) may have been dirty too
+   EXPECT_LE(U32(itemCount), stats.dirtyObjects);
+   EXPECT_LE(U32(itemCount), stats.dirtyRefs);
+}
+
+
+static void dirtyAllShipHealth(ServerGame *serverGame)
+{
+   for(S32 i = 0; i < serverGame->getClientCount(); i++)
+   {
+      Ship *ship = serverGame->getClientInfo(i)->getShip();
+      if(ship)
+         ship->setMaskBits(Ship::HealthMask);
+   }
+}
+
+
+// Ships' health updates don't depend on who's watching, so each should be packed once per pass and copied to the
+// other connections
+TEST(GhostConnectionTest, sharedUpdatesAreReused)
+{
+   const S32 clientCount = 4;
+
+   GamePair gamePair(getLevelCodeWithItems(0), clientCount);
+   ServerGame *serverGame = gamePair.server;
+
+   gamePair.idle(33, 20);     // Get everyone ghosted
+
+   U32 hits, misses;
+   NetObject::getSharedUpdateStats(hits, misses);     // Clear out the counts from getting everyone in
+
+   for(S32 i = 0; i < 10; i++)
+   {
+      dirtyAllShipHealth(serverGame);
+      gamePair.idle(33);
+   }
+
+   NetObject::getSharedUpdateStats(hits, misses);
+
+   EXPECT_GT(hits, 0u);
+   EXPECT_GT(hits, misses);
+
+   // And everyone still agrees on everyone's health
+   for(S32 i = 0; i < clientCount; i++)
+   {
+      ClientGame *clientGame = gamePair.getClient(i);
+
+      Vector<DatabaseObject *> ships;
+      clientGame->getLevel()->findObjects(PlayerShipTypeNumber, ships);
+      EXPECT_EQ(clientCount, ships.size());
+
+      for(S32 j = 0; j < ships.size(); j++)
+         EXPECT_EQ(1.0f, static_cast<Ship *>(ships[j])->getHealth());
+   }
+}
+
+
+};
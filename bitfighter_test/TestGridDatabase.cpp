@@ -0,0 +1,310 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "gtest/gtest.h"
+
+#include "gridDB.h"
+#include "BfObject.h"
+#include "moveObject.h"    // For ActualState
+
+#include "GridWorldForTesting.h"
+
+#include "tnlThread.h"
+
+#include <algorithm>
+
+namespace Zap
+{
+
+using namespace std;
+using namespace TNL;
+
+
+static Vector<S32> getSortedIndices(const Vector<DatabaseObject *> &found)
+{
+   Vector<S32> indices;
+   for(S32 i = 0; i < found.size(); i++)
+      indices.push_back(static_cast<GridTestObject *>(found[i])->mIndex);
+
+   std::sort(indices.getStlVector().begin(), indices.getStlVector().end());
+   return indices;
+}
+
+
+static void runQueries(GridDatabase *database, const Rect &rect, Vector<Vector<S32> > &results)
+{
+   Vector<DatabaseObject *> found;
+
+   found.clear();
+   database->findObjects(PlayerShipTypeNumber, found, rect);
+   results.push_back(getSortedIndices(found));
+
+   found.clear();
+   database->findObjects((TestFunc)isShipType, found, rect);
+   results.push_back(getSortedIndices(found));
+
+   found.clear();
+   database->findObjects((TestFunc)isProjectileType, found, rect);
+   results.push_back(getSortedIndices(found));
+
+   found.clear();
+   database->findObjects((TestFunc)isWallType, found, rect);
+   results.push_back(getSortedIndices(found));
+
+   Vector<U8> types;
+   types.push_back(MineTypeNumber);
+   types.push_back(GoalZoneTypeNumber);
+
+   found.clear();
+   database->findObjects(types, found, rect);
+   results.push_back(getSortedIndices(found));
+}
+
+
+TEST(GridDatabaseTest, backendsReturnSameResults)
+{
+   GridTestWorld linkedWorld(GridDatabase::LinkedListBuckets);
+   GridTestWorld arrayWorld(GridDatabase::ArrayBuckets);
+
+   ASSERT_EQ(GridDatabase::LinkedListBuckets, linkedWorld.mDatabase->getBucketBackend());
+   ASSERT_EQ(GridDatabase::ArrayBuckets,      arrayWorld.mDatabase->getBucketBackend());
+
+   GridTestRandom linkedRandom(99), arrayRandom(99), queryRandom(7);
+
+   for(S32 tick = 0; tick < 20; tick++)
+   {
+      linkedWorld.tick(linkedRandom);
+      arrayWorld.tick(arrayRandom);
+
+      // Remove a few objects each tick to exercise swap-remove
+      S32 victim = GridTestWorld::WallCount + GridTestWorld::ZoneCount + tick * 7;
+      linkedWorld.mDatabase->removeFromDatabase(linkedWorld.mObjects[victim], false);
+      arrayWorld.mDatabase->removeFromDatabase(arrayWorld.mObjects[victim], false);
+
+      for(S32 i = 0; i < 20; i++)
+      {
+         Point center(queryRandom.readF(0, ArenaSize), queryRandom.readF(0, ArenaSize));
+         Rect rect(center, queryRandom.readF(50, 600));
+
+         Vector<Vector<S32> > linkedResults, arrayResults;
+         runQueries(linkedWorld.mDatabase, rect, linkedResults);
+         runQueries(arrayWorld.mDatabase,  rect, arrayResults);
+
+         ASSERT_EQ(linkedResults.size(), arrayResults.size());
+         for(S32 j = 0; j < linkedResults.size(); j++)
+            ASSERT_TRUE(linkedResults[j].getStlVector() == arrayResults[j].getStlVector()) << "Query " << j << " differs";
+      }
+   }
+
+   // Removed objects are no longer owned by their databases
+   for(S32 tick = 0; tick < 20; tick++)
+   {
+      S32 victim = GridTestWorld::WallCount + GridTestWorld::ZoneCount + tick * 7;
+      delete linkedWorld.mObjects[victim];
+      delete arrayWorld.mObjects[victim];
+   }
+}
+
+
+TEST(GridDatabaseTest, objectsSpanningBucketsFoundOnce)
+{
+   for(S32 backend = GridDatabase::LinkedListBuckets; backend <= GridDatabase::ArrayBuckets; backend++)
+   {
+      GridDatabase::BucketBackend oldBackend = GridDatabase::getDefaultBucketBackend();
+      GridDatabase::setDefaultBucketBackend((GridDatabase::BucketBackend)backend);
+      GridDatabase database;
+      GridDatabase::setDefaultBucketBackend(oldBackend);
+
+      // A wall covering 3x3 buckets, and one so big it wraps around the grid and lands in every bucket twice
+      (new GridTestObject(BarrierTypeNumber, 0, Point(400, 400), 300))->addToDatabase(&database);
+      (new GridTestObject(BarrierTypeNumber, 1, Point(0, 0), 5000))->addToDatabase(&database);
+
+      Vector<DatabaseObject *> found;
+      database.findObjects((TestFunc)isWallType, found, Rect(Point(0, 0), 8000));
+      EXPECT_EQ(2, found.size());
+
+      found.clear();
+      database.findObjects((TestFunc)isWallType, found, Rect(Point(300, 300), Point(500, 700)));
+      EXPECT_EQ(2, found.size());
+
+      found.clear();
+      database.findObjects(BarrierTypeNumber, found, Rect(Point(-3000, 2000), Point(-2900, 2100)));
+      ASSERT_EQ(1, found.size());
+      EXPECT_EQ(1, static_cast<GridTestObject *>(found[0])->mIndex);
+   }
+}
+
+
+TEST(GridDatabaseTest, nestedAndCombinedQueries)
+{
+   GridTestWorld world(GridDatabase::LinkedListBuckets);
+   Rect outerRect(Point(1000, 1000), 600);
+
+   Vector<DatabaseObject *> expected;
+   world.mDatabase->findObjects((TestFunc)isShipType, expected, outerRect);
+   ASSERT_TRUE(expected.size() > 0);
+
+   // Searching from inside another search's result loop must not disturb the outer results
+   ScopedDatabaseQuery outer;
+   world.mDatabase->findObjects((TestFunc)isShipType, outer->results, outerRect);
+
+   for(S32 i = 0; i < outer->results.size(); i++)
+   {
+      ScopedDatabaseQuery inner;
+      world.mDatabase->findObjects((TestFunc)isAnyObjectType, inner->results,
+                                   Rect(static_cast<GridTestObject *>(outer->results[i])->mPos, 100));
+      EXPECT_TRUE(inner->results.size() > 0);     // Finds at least the ship itself
+   }
+
+   EXPECT_TRUE(getSortedIndices(expected).getStlVector() == getSortedIndices(outer->results).getStlVector());
+
+   // Overlapping searches combined in one query report each object once
+   ScopedDatabaseQuery combined;
+   world.mDatabase->findObjects(*combined, (TestFunc)isShipType, outerRect);
+   world.mDatabase->findObjects(*combined, (TestFunc)isShipType, Rect(Point(1200, 1200), 600));
+   world.mDatabase->findObjects(*combined, PlayerShipTypeNumber, outerRect);
+
+   Vector<DatabaseObject *> separate;
+   world.mDatabase->findObjects((TestFunc)isShipType, separate, outerRect);
+   world.mDatabase->findObjects((TestFunc)isShipType, separate, Rect(Point(1200, 1200), 600));
+
+   Vector<S32> unique = getSortedIndices(separate);
+   unique.getStlVector().erase(std::unique(unique.getStlVector().begin(), unique.getStlVector().end()), unique.getStlVector().end());
+
+   EXPECT_TRUE(unique.getStlVector() == getSortedIndices(combined->results).getStlVector());
+}
+
+
+// Returns how far along the ray the first hit was, or 2 if nothing was hit.  Rays often start inside several
+// overlapping walls at once, so which of them gets reported can depend on search order; how far is what counts.
+static F32 findTimeLOS(GridDatabase *database, TestFunc testFunc, const Point &rayStart, const Point &rayEnd)
+{
+   F32 collisionTime;
+   Point surfaceNormal;
+
+   if(!database->findObjectLOS(testFunc, ActualState, rayStart, rayEnd, collisionTime, surfaceNormal))
+      return 2;
+
+   return collisionTime;
+}
+
+
+TEST(GridDatabaseTest, staticIndexReturnsSameResults)
+{
+   GridTestWorld plainWorld(GridDatabase::LinkedListBuckets);
+   GridTestWorld indexedWorld(GridDatabase::LinkedListBuckets);
+
+   indexedWorld.mDatabase->buildStaticIndex((TestFunc)isStaticGeometryType);
+   EXPECT_EQ(GridTestWorld::WallCount + GridTestWorld::ZoneCount, indexedWorld.mDatabase->getStaticObjectCount());
+
+   GridTestRandom plainRandom(99), indexedRandom(99), queryRandom(7);
+
+   for(S32 tick = 0; tick < 20; tick++)
+   {
+      plainWorld.tick(plainRandom);
+      indexedWorld.tick(indexedRandom);
+
+      // Now and then, take a wall out, or move one, which puts it back in the buckets
+      if(tick % 5 == 1)
+      {
+         plainWorld.mDatabase->removeFromDatabase(plainWorld.mObjects[tick], true);
+         indexedWorld.mDatabase->removeFromDatabase(indexedWorld.mObjects[tick], true);
+      }
+      else if(tick % 5 == 3)
+      {
+         plainWorld.mObjects[tick]->moveTo(plainWorld.mObjects[tick]->mPos + Point(300, 0));
+         indexedWorld.mObjects[tick]->moveTo(indexedWorld.mObjects[tick]->mPos + Point(300, 0));
+      }
+
+      for(S32 i = 0; i < 20; i++)
+      {
+         Point center(queryRandom.readF(0, ArenaSize), queryRandom.readF(0, ArenaSize));
+         Rect rect(center, queryRandom.readF(50, 600));
+
+         Vector<Vector<S32> > plainResults, indexedResults;
+         runQueries(plainWorld.mDatabase, rect, plainResults);
+         runQueries(indexedWorld.mDatabase, rect, indexedResults);
+
+         ASSERT_EQ(plainResults.size(), indexedResults.size());
+         for(S32 j = 0; j < plainResults.size(); j++)
+            ASSERT_TRUE(plainResults[j].getStlVector() == indexedResults[j].getStlVector()) << "Query " << j << " differs";
+
+         Point rayEnd(queryRandom.readF(0, ArenaSize), queryRandom.readF(0, ArenaSize));
+
+         EXPECT_EQ(findTimeLOS(plainWorld.mDatabase, (TestFunc)isWallType, center, rayEnd),
+                   findTimeLOS(indexedWorld.mDatabase, (TestFunc)isWallType, center, rayEnd));
+         EXPECT_EQ(findTimeLOS(plainWorld.mDatabase, (TestFunc)isAnyObjectType, center, rayEnd),
+                   findTimeLOS(indexedWorld.mDatabase, (TestFunc)isAnyObjectType, center, rayEnd));
+      }
+   }
+
+   EXPECT_EQ(GridTestWorld::WallCount + GridTestWorld::ZoneCount - 8, indexedWorld.mDatabase->getStaticObjectCount());
+}
+
+
+// Runs the same queries as the main thread, to check that searches don't interfere with one another
+class GridTestQueryThread : public Thread
+{
+public:
+   GridDatabase *mDatabase;
+   Semaphore *mDone;
+   Vector<Vector<S32> > mResults;
+
+   U32 run()
+   {
+      GridTestRandom queryRandom(7);
+
+      for(S32 i = 0; i < 200; i++)
+      {
+         Point center(queryRandom.readF(0, ArenaSize), queryRandom.readF(0, ArenaSize));
+         ScopedDatabaseQuery query;
+         mDatabase->findObjects((TestFunc)isAnyObjectType, query->results, Rect(center, queryRandom.readF(50, 600)));
+         mResults.push_back(getSortedIndices(query->results));
+      }
+
+      Thread::runExitFunctions();      // Frees our spare queries, as worker threads do
+      mDone->increment();
+      return 0;
+   }
+};
+
+
+TEST(GridDatabaseTest, concurrentQueries)
+{
+   const S32 threadCount = 4;
+
+   for(S32 backend = GridDatabase::LinkedListBuckets; backend <= GridDatabase::ArrayBuckets; backend++)
+   {
+      GridTestWorld world((GridDatabase::BucketBackend)backend);
+      Semaphore done(0, threadCount);
+
+      Vector<RefPtr<GridTestQueryThread> > threads;
+      for(S32 i = 0; i < threadCount; i++)
+      {
+         threads.push_back(new GridTestQueryThread);
+         threads[i]->mDatabase = world.mDatabase;
+         threads[i]->mDone = &done;
+         threads[i]->start();
+      }
+
+      for(S32 i = 0; i < threadCount; i++)
+         done.wait();
+
+      GridTestRandom queryRandom(7);
+      for(S32 i = 0; i < 200; i++)
+      {
+         Point center(queryRandom.readF(0, ArenaSize), queryRandom.readF(0, ArenaSize));
+         Vector<DatabaseObject *> found;
+         world.mDatabase->findObjects((TestFunc)isAnyObjectType, found, Rect(center, queryRandom.readF(50, 600)));
+
+         Vector<S32> expected = getSortedIndices(found);
+         for(S32 j = 0; j < threadCount; j++)
+            ASSERT_TRUE(expected.getStlVector() == threads[j]->mResults[i].getStlVector()) << "Thread " << j << ", query " << i;
+      }
+   }
+}
+
+
+};
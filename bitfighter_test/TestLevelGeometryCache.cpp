@@ -0,0 +1,247 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "LevelGeometryCache.h"
+#include "Level.h"
+#include "LevelFilesForTesting.h"
+#include "ServerGame.h"
+#include "gameType.h"
+#include "TestUtils.h"
+
+#include "stringUtils.h"
+
+#include "tnlNetInterface.h"
+#include "gtest/gtest.h"
+
+namespace Zap
+{
+
+
+static LevelGeometryCache::Geometry getTestGeometry()
+{
+   LevelGeometryCache::Geometry geometry;
+
+   geometry.hasWallEdges = true;
+   geometry.wallEdges.push_back(Point(0, 0));
+   geometry.wallEdges.push_back(Point(100, 0));
+   geometry.wallEdges.push_back(Point(100, 0));
+   geometry.wallEdges.push_back(Point(100, -50.5f));
+
+   geometry.hasNavMesh = true;
+   geometry.zones.resize(2);
+
+   for(S32 i = 0; i < 2; i++)
+   {
+      LevelGeometryCache::CachedZone &zone = geometry.zones[i];
+      zone.zoneId = U16(i);
+      zone.outline.push_back(Point(i * 10, 0));
+      zone.outline.push_back(Point(i * 10 + 10, 0));
+      zone.outline.push_back(Point(i * 10 + 10, 10));
+
+      NeighboringZone neighbor;
+      neighbor.zoneID = U16(1 - i);
+      neighbor.borderStart.set(10, 0);
+      neighbor.borderEnd.set(10, 10);
+      neighbor.borderCenter.set(10, 5);
+      neighbor.center.set(i == 0 ? 15 : 5, 5);
+      neighbor.distTo = 10.25f;
+      zone.neighbors.push_back(neighbor);
+   }
+
+   return geometry;
+}
+
+
+// What goes in comes out, and anything that isn't exactly what we wrote for this hash is rejected
+TEST(LevelGeometryCacheTest, roundTrip)
+{
+   const string hash = "0123456789abcdef0123456789abcdef";
+   LevelGeometryCache::Geometry geometry = getTestGeometry();
+
+   Vector<U8> data;
+   LevelGeometryCache::writeGeometry(hash, geometry, data);
+
+   LevelGeometryCache::Geometry reread;
+   ASSERT_TRUE(LevelGeometryCache::readGeometry(hash, data.address(), data.size(), reread));
+
+   EXPECT_TRUE(reread.hasWallEdges);
+   EXPECT_TRUE(reread.hasNavMesh);
+   EXPECT_FALSE(reread.navMeshFailed);
+
+   ASSERT_EQ(geometry.wallEdges.size(), reread.wallEdges.size());
+   for(S32 i = 0; i < geometry.wallEdges.size(); i++)
+      EXPECT_EQ(geometry.wallEdges[i], reread.wallEdges[i]);
+
+   ASSERT_EQ(2, reread.zones.size());
+   for(S32 i = 0; i < 2; i++)
+   {
+      EXPECT_EQ(geometry.zones[i].zoneId, reread.zones[i].zoneId);
+      ASSERT_EQ(3, reread.zones[i].outline.size());
+      EXPECT_EQ(geometry.zones[i].outline[2], reread.zones[i].outline[2]);
+
+      ASSERT_EQ(1, reread.zones[i].neighbors.size());
+      const NeighboringZone &neighbor = reread.zones[i].neighbors[0];
+      EXPECT_EQ(1 - i, neighbor.zoneID);
+      EXPECT_EQ(Point(10, 0), neighbor.borderStart);
+      EXPECT_EQ(Point(10, 10), neighbor.borderEnd);
+      EXPECT_EQ(Point(10, 5), neighbor.borderCenter);
+      EXPECT_EQ(geometry.zones[i].neighbors[0].center, neighbor.center);
+      EXPECT_EQ(10.25f, neighbor.distTo);
+   }
+
+   // Some other level's geometry
+   EXPECT_FALSE(LevelGeometryCache::readGeometry("fedcba9876543210fedcba9876543210", data.address(), data.size(), reread));
+
+   // Cut short anywhere
+   for(S32 i = 0; i < data.size(); i++)
+      EXPECT_FALSE(LevelGeometryCache::readGeometry(hash, data.address(), i, reread)) << "Truncated to " << i;
+
+   // Written by some other version
+   data[4]++;
+   EXPECT_FALSE(LevelGeometryCache::readGeometry(hash, data.address(), data.size(), reread));
+}
+
+
+// Loading a level a second time should give the same wall edges, from the cache
+TEST(LevelGeometryCacheTest, wallEdgesReused)
+{
+   Address addr;
+   NetInterface net(addr);    // We never use this, but it will initialize TNL to get past an assert
+
+   string code = getGenericHeader() + "BarrierMaker 40 -1 -1 -1 1\n"
+                                      "BarrierMaker 40 0 -1 0 1\n"
+                                      "Spawn 0 -0.5 0.5\n";
+
+   // Clear out anything left from an earlier run
+   const string folder = "levelcache_test";
+   string hash = Level(code).getHash();
+   remove(joindir(folder, hash + ".geom").c_str());
+
+   LevelGeometryCache::setFolder(folder);
+   ASSERT_TRUE(LevelGeometryCache::isEnabled());
+
+   U32 hits, misses;
+   LevelGeometryCache::getStats(hits, misses);     // Reset
+
+   Level first;
+   first.loadLevelFromString(code);
+   LevelGeometryCache::getStats(hits, misses);
+   EXPECT_EQ(0, hits);
+   EXPECT_EQ(1, misses);
+
+   Level second;
+   second.loadLevelFromString(code);
+   LevelGeometryCache::getStats(hits, misses);
+   EXPECT_EQ(1, hits);
+   EXPECT_EQ(0, misses);
+
+   const Vector<DatabaseObject *> *firstEdges = first.getWallEdgeDatabase()->findObjects_fast();
+   const Vector<DatabaseObject *> *secondEdges = second.getWallEdgeDatabase()->findObjects_fast();
+
+   ASSERT_GT(firstEdges->size(), 0);
+   ASSERT_EQ(firstEdges->size(), secondEdges->size());
+
+   for(S32 i = 0; i < firstEdges->size(); i++)
+   {
+      EXPECT_EQ(firstEdges->get(i)->getExtent().min, secondEdges->get(i)->getExtent().min);
+      EXPECT_EQ(firstEdges->get(i)->getExtent().max, secondEdges->get(i)->getExtent().max);
+   }
+
+   LevelGeometryCache::setFolder("");
+}
+
+
+static void copyZones(const Vector<BotNavMeshZone *> &zones, Vector<LevelGeometryCache::CachedZone> &copies)
+{
+   copies.resize(zones.size());
+
+   for(S32 i = 0; i < zones.size(); i++)
+   {
+      copies[i].zoneId = zones[i]->getZoneId();
+      copies[i].outline = *zones[i]->getOutline();
+      copies[i].neighbors = zones[i]->mNeighbors;
+   }
+}
+
+
+// A nav mesh built for a level should come back from the cache the next time the level is loaded: the same zones,
+// each at the position matching its id, with the same neighbors
+TEST(LevelGeometryCacheTest, navMeshReused)
+{
+   string code = getGenericHeader() + "BarrierMaker 40 -2 -2 2 -2\n"
+                                      "BarrierMaker 40 2 -2 2 2\n"
+                                      "BarrierMaker 40 2 2 -2 2\n"
+                                      "BarrierMaker 40 -2 2 -2 -2\n"
+                                      "BarrierMaker 40 0 -2 0 1\n"
+                                      "Spawn 0 -1 0\n";
+
+   // Clear out anything left from an earlier run; GamePair uses the cache folder next to the INI
+   GameSettingsPtr settings = GameSettingsPtr(new GameSettings());
+   string filename = joindir(joindir(settings->getFolderManager()->getIniDir(), "levelcache"), Level(code).getHash() + ".geom");
+   remove(filename.c_str());
+
+   Vector<LevelGeometryCache::CachedZone> built;
+
+   {
+      GamePair gamePair(settings, code);
+      EXPECT_FALSE(gamePair.server->getLevelLoadStats().navMeshCached);
+      copyZones(gamePair.server->getBotZoneList(), built);
+   }
+
+   ASSERT_GT(built.size(), 1);
+
+   {
+      GamePair gamePair(GameSettingsPtr(new GameSettings()), code);
+      EXPECT_TRUE(gamePair.server->getLevelLoadStats().navMeshCached);
+      EXPECT_FALSE(gamePair.server->getGameType()->mBotZoneCreationFailed);
+
+      const Vector<BotNavMeshZone *> &zones = gamePair.server->getBotZoneList();
+      ASSERT_EQ(built.size(), zones.size());
+      EXPECT_EQ(zones.size(), gamePair.server->getBotZoneDatabase().getObjectCount());
+
+      for(S32 i = 0; i < zones.size(); i++)
+      {
+         EXPECT_EQ(i, zones[i]->getZoneId());      // Zone ids index allZones
+         EXPECT_EQ(built[i].zoneId, zones[i]->getZoneId());
+
+         const Vector<Point> &outline = *zones[i]->getOutline();
+         ASSERT_EQ(built[i].outline.size(), outline.size()) << "Zone " << i;
+         for(S32 j = 0; j < outline.size(); j++)
+            EXPECT_EQ(built[i].outline[j], outline[j]) << "Zone " << i;
+
+         const Vector<NeighboringZone> &neighbors = zones[i]->mNeighbors;
+         ASSERT_EQ(built[i].neighbors.size(), neighbors.size()) << "Zone " << i;
+         for(S32 j = 0; j < neighbors.size(); j++)
+         {
+            EXPECT_EQ(built[i].neighbors[j].zoneID,       neighbors[j].zoneID)       << "Zone " << i;
+            EXPECT_EQ(built[i].neighbors[j].borderStart,  neighbors[j].borderStart)  << "Zone " << i;
+            EXPECT_EQ(built[i].neighbors[j].borderEnd,    neighbors[j].borderEnd)    << "Zone " << i;
+            EXPECT_EQ(built[i].neighbors[j].borderCenter, neighbors[j].borderCenter) << "Zone " << i;
+            EXPECT_EQ(built[i].neighbors[j].center,       neighbors[j].center)       << "Zone " << i;
+            EXPECT_EQ(built[i].neighbors[j].distTo,       neighbors[j].distTo)       << "Zone " << i;
+         }
+      }
+   }
+
+   // A level zone generation gave up on is remembered as such
+   string hash = "00112233445566778899aabbccddeeff";
+   LevelGeometryCache::setFolder("levelcache_test");
+   remove(joindir("levelcache_test", hash + ".geom").c_str());
+
+   Vector<BotNavMeshZone *> zones;
+   LevelGeometryCache::putNavMesh(hash, zones, true);
+
+   GridDatabase botZoneDatabase;
+   bool failed = false;
+   ASSERT_TRUE(LevelGeometryCache::getNavMesh(hash, botZoneDatabase, zones, false, failed));
+   EXPECT_TRUE(failed);
+   EXPECT_EQ(0, zones.size());
+
+   LevelGeometryCache::setFolder("");
+   remove(filename.c_str());
+}
+
+
+};
@@ -4,6 +4,8 @@
 //------------------------------------------------------------------------------
    
 #include "LevelSource.h"
+#include "LevelPipeline.h"
+#include "Level.h"
 #include "LevelFilesForTesting.h"
 
 #include "stringUtils.h"
@@ -11,6 +13,9 @@
 #include "tnlNetInterface.h"
 #include "gtest/gtest.h"
 
+#include <fstream>
+#include <sstream>
+
 namespace Zap
 {
 
@@ -41,5 +46,146 @@ TEST(TestLevelSource, tests)
 }
 
 
-};
+// A level loaded in the background should be the same as one loaded directly, and should only be handed out if it's
+// the one being asked for
+TEST(TestLevelSource, pipeline)
+{
+   Address addr;
+   NetInterface net(addr);
+
+   Vector<string> levelCodes;
+   levelCodes.push_back(getGenericHeader());
+   levelCodes.push_back(getGenericHeader() + "BarrierMaker 40 -1 -1 -1 1\nSpawn 0 -0.5 0.5\n");
+
+   StringLevelSource levelSource(levelCodes);
+   LevelPipeline pipeline;
+   F64 prepareMs;
+
+   ASSERT_TRUE(pipeline.prepare(&levelSource, 1));
+   EXPECT_EQ(1, pipeline.getPreparedIndex());
+
+   // Wrong level: nothing for us, and the prepared level is thrown away
+   EXPECT_EQ(NULL, pipeline.take(&levelSource, 0, prepareMs));
+   EXPECT_EQ(-1, pipeline.getPreparedIndex());
+
+   ASSERT_TRUE(pipeline.prepare(&levelSource, 1));
+   Level *prepared = pipeline.take(&levelSource, 1, prepareMs);
+   ASSERT_TRUE(prepared != NULL);
+   EXPECT_EQ(-1, pipeline.getPreparedIndex());
+
+   Level *loaded = levelSource.getLevel(1);
+   ASSERT_TRUE(loaded != NULL);
+
+   EXPECT_EQ(loaded->getHash(), prepared->getHash());
+   EXPECT_EQ(loaded->findObjects_fast()->size(), prepared->findObjects_fast()->size());
+
+   delete loaded;
+   delete prepared;
+}
+
+
+
+static void writeLevelFile(const string &path, const string &levelName, S32 minPlayers)
+{
+   ofstream file(path.c_str());
+   file << "GameType 8 15\n"
+        << "LevelName \"" << levelName << "\"\n"
+        << "MinPlayers " << minPlayers << "\n"
+        << "MaxPlayers 12\n"
+        << "Script testscript.levelgen\n";
+}
+
+
+// Enough levels to get the header scanner threads going; a second source sharing the index shouldn't need to read
+// anything but the one level we change
+TEST(TestLevelSource, headerIndex)
+{
+   Address addr;
+   NetInterface net(addr);
+
+   const string folder = "levelindex_test";
+   const string indexFile = joindir(folder, "levelindex.txt");
+   const S32 LevelCount = 3 * MultiLevelSource::MinLevelsPerScanThread;
+
+   ASSERT_TRUE(makeSureFolderExists(folder));
+   remove(indexFile.c_str());
 
+   Vector<string> levelList;
+   for(S32 i = 0; i < LevelCount; i++)
+   {
+      levelList.push_back("indexed_" + itos(i) + ".level");
+      writeLevelFile(joindir(folder, levelList[i]), "Indexed " + itos(i), i % 8);
+   }
+
+   U32 hits, misses;
+
+   {
+      FolderLevelSource levelSource(levelList, folder);
+      levelSource.setHeaderIndexFile(indexFile);
+      EXPECT_EQ(0, levelSource.getHeaderIndex()->getEntryCount());
+
+      ASSERT_TRUE(levelSource.loadLevels(NULL));
+      ASSERT_EQ(LevelCount, levelSource.getLevelCount());
+      EXPECT_FALSE(levelSource.getHeaderIndex()->isDirty());      // Saved after the scan
+
+      // Prefetching read everything, so populating each level came straight from the index
+      levelSource.getHeaderIndex()->getStats(hits, misses);
+      EXPECT_EQ(LevelCount, (S32)hits);
+      EXPECT_EQ(0, (S32)misses);
+
+      for(S32 i = 0; i < LevelCount; i++)
+      {
+         LevelInfo levelInfo = levelSource.getLevelInfo(i);
+         EXPECT_EQ("Indexed " + itos(i), levelInfo.mLevelName.getString());
+         EXPECT_EQ(BitmatchGame, levelInfo.mLevelType);
+         EXPECT_EQ(i % 8, levelInfo.minRecPlayers);
+         EXPECT_EQ(12, levelInfo.maxRecPlayers);
+         EXPECT_EQ("testscript.levelgen", levelInfo.mScriptFileName);
+      }
+   }
+
+   // Change one level's size; that one has to be read again, the rest come from the index saved above
+   writeLevelFile(joindir(folder, levelList[5]), "Renamed level", 3);
+
+   {
+      FolderLevelSource levelSource(levelList, folder);
+      levelSource.setHeaderIndexFile(indexFile);
+      EXPECT_EQ(LevelCount, levelSource.getHeaderIndex()->getEntryCount());
+
+      ASSERT_TRUE(levelSource.loadLevels(NULL));
+      ASSERT_EQ(LevelCount, levelSource.getLevelCount());
+
+      EXPECT_EQ(string("Renamed level"), levelSource.getLevelInfo(5).mLevelName.getString());
+      EXPECT_EQ(3, levelSource.getLevelInfo(5).minRecPlayers);
+      EXPECT_EQ(string("Indexed 6"), levelSource.getLevelInfo(6).mLevelName.getString());
+   }
+
+   // Round trip through a stream; junk lines are skipped
+   LevelHeaderIndex index;
+   LevelInfo levelInfo("a.level", folder);
+   levelInfo.mLevelName = "Tab\tName";
+   levelInfo.mLevelType = CTFGame;
+   levelInfo.minRecPlayers = 2;
+   levelInfo.maxRecPlayers = 6;
+   index.store("levels/a.level", 100, 2000, levelInfo);
+
+   stringstream stream;
+   index.writeToStream(stream);
+   stream << "not\tenough\tcolumns\n";
+
+   LevelHeaderIndex reread;
+   reread.readFromStream(stream);
+   EXPECT_EQ(1, reread.getEntryCount());
+
+   LevelInfo found("a.level", folder);
+   EXPECT_FALSE(reread.lookup("levels/a.level", 101, 2000, found));
+   ASSERT_TRUE(reread.lookup("levels/a.level", 100, 2000, found));
+   EXPECT_EQ(string("Tab Name"), found.mLevelName.getString());
+   EXPECT_EQ(CTFGame, found.mLevelType);
+   EXPECT_EQ(2, found.minRecPlayers);
+   EXPECT_EQ(6, found.maxRecPlayers);
+   EXPECT_EQ("a.level", found.filename);
+}
+
+
+};
@@ -5,10 +5,12 @@
 
 #include "gtest/gtest.h"
 
+#include "ServerListsForTesting.h"
 #include "TestUtils.h"
 
 #include "../master/master.h"
 #include "../master/MasterServerConnection.h"
+#include "../master/ServerRegistry.h"
 #include "masterConnection.h"
 #include "ClientGame.h"
 #include "UIManager.h"
@@ -41,5 +43,81 @@ TEST(MasterTest, Sanity)
 
    delete clientGame;
 }
+
+
+TEST(MasterTest, serverRegistry)
+{
+   ServerRegistry registry;
+   U32 start = registry.getVersion();
+
+   registry.updateServer(1, makeAddress(1), 39, false, true);
+   registry.updateServer(2, makeAddress(2), 39, false, true);
+   registry.updateServer(3, makeAddress(3), 39, true,  true);     // Host mode
+   registry.updateServer(4, makeAddress(4), 38, false, true);     // Old protocol
+   registry.updateServer(5, makeAddress(5), 39, false, false);    // Hidden
+
+   map<S32, IPAddress> list;
+   getFullList(registry, 39, false, list);
+   ASSERT_EQ(2, list.size());
+   EXPECT_TRUE(list.count(1) && list.count(2));
+
+   U32 version = registry.getVersion();
+
+   Vector<IPAddress> added;
+   Vector<S32> addedIds, removedIds;
+
+   // Nothing new
+   ASSERT_TRUE(registry.getChanges(39, false, version, added, addedIds, removedIds));
+   EXPECT_EQ(0, addedIds.size() + removedIds.size());
+
+   registry.removeServer(1);
+   registry.updateServer(5, makeAddress(5), 39, false, true);     // Restored
+   registry.updateServer(2, makeAddress(2), 39, true,  true);     // Switched to host mode
+
+   ASSERT_TRUE(registry.getChanges(39, false, version, added, addedIds, removedIds));
+   applyChanges(list, added, addedIds, removedIds);
+   ASSERT_EQ(1, list.size());
+   EXPECT_TRUE(list.count(5));
+
+   // From the very beginning is the same as the whole list
+   list.clear();
+   ASSERT_TRUE(registry.getChanges(39, true, start, added, addedIds, removedIds));
+   applyChanges(list, added, addedIds, removedIds);
+   EXPECT_EQ(2, list.size());
+
+   // Versions we never handed out get the whole list
+   EXPECT_FALSE(registry.getChanges(39, false, start - 1, added, addedIds, removedIds));
+   EXPECT_FALSE(registry.getChanges(39, false, registry.getVersion() + 1, added, addedIds, removedIds));
+}
+
+
+// Clients re-querying a master while servers come and go should all end up with the same list as a full query
+// would give them.  bitfighter_bench -serverlist times the same thing with many more clients.
+TEST(MasterTest, serverRegistryChurn)
+{
+   ServerListChurn churn(300, 100);
+
+   for(S32 round = 0; round < 10; round++)
+      churn.runRound(round, 20);
+
+   // Fewer entries than sending everyone the whole list every time
+   EXPECT_LT(churn.mSentEntries, churn.mFullEntries);
+
+   map<S32, IPAddress> expected;
+   getFullList(churn.mRegistry, 39, false, expected);
+
+   Vector<IPAddress> added;
+   Vector<S32> addedIds, removedIds;
+
+   for(S32 i = 0; i < churn.mClientLists.size(); i++)
+   {
+      // Bring everyone up to date, then make sure they agree with the master
+      ASSERT_TRUE(churn.mRegistry.getChanges(39, false, churn.mClientVersions[i], added, addedIds, removedIds));
+      applyChanges(churn.mClientLists[i], added, addedIds, removedIds);
+
+      ASSERT_EQ(expected.size(), churn.mClientLists[i].size()) << "client " << i;
+      EXPECT_TRUE(sameServers(expected, churn.mClientLists[i])) << "client " << i;
+   }
+}
 	
 };
@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "tnlNetInterface.h"
+
+#include "gtest/gtest.h"
+
+namespace Zap
+{
+
+using namespace TNL;
+
+
+// Lets us charge handshake packets directly, at whatever time we like
+class HandshakeTestInterface : public NetInterface
+{
+public:
+   HandshakeTestInterface() : NetInterface(Address()) { /* Do nothing */ }
+
+   bool allow(const Address &address, U32 time)
+   {
+      mCurrentTime = time;
+      return allowHandshakePacket(address);
+   }
+};
+
+
+static Address makeAddress(U32 netNum)
+{
+   Address address;
+   address.netNum[0] = netNum;
+   return address;
+}
+
+
+// A new address gets its burst all at once, then one packet each time it has waited long enough
+TEST(NetInterfaceTest, handshakeBurstAndRate)
+{
+   HandshakeTestInterface net;
+   net.setHandshakeRateLimit(10, 5);      // One packet per 100ms, bursts of 5
+
+   Address address = makeAddress(0x0A000001);
+   U32 time = 1000000;
+
+   for(S32 i = 0; i < 5; i++)
+      EXPECT_TRUE(net.allow(address, time)) << "Packet " << i;
+
+   EXPECT_FALSE(net.allow(address, time));
+   EXPECT_FALSE(net.allow(address, time + 99));
+   EXPECT_EQ(2, net.getHandshakeStats().packetsThrottled);
+
+   // Refused packets don't use anything up
+   EXPECT_TRUE(net.allow(address, time + 100));
+   EXPECT_FALSE(net.allow(address, time + 100));
+
+   EXPECT_FALSE(net.allow(address, time + 150));
+   EXPECT_TRUE(net.allow(address, time + 200));
+
+   // Credit from a long quiet spell stops at the burst size
+   time += 3600 * 1000;
+
+   for(S32 i = 0; i < 5; i++)
+      EXPECT_TRUE(net.allow(address, time)) << "Packet " << i;
+
+   EXPECT_FALSE(net.allow(address, time));
+}
+
+
+// One address using up its bucket leaves the others alone, short of the odd one that hashes to the same bucket
+TEST(NetInterfaceTest, handshakeBucketsPerAddress)
+{
+   HandshakeTestInterface net;
+   net.setHandshakeRateLimit(10, 1);
+
+   const U32 time = 1000000;
+   const S32 addressCount = 100;
+
+   EXPECT_TRUE(net.allow(makeAddress(0x0A000000), time));
+   EXPECT_FALSE(net.allow(makeAddress(0x0A000000), time));
+
+   S32 allowed = 0;
+   for(S32 i = 1; i <= addressCount; i++)
+      allowed += net.allow(makeAddress(0x0A000000 + i), time) ? 1 : 0;
+
+   EXPECT_GE(allowed, addressCount - 5);
+}
+
+
+// A rate of 0 turns the limit off
+TEST(NetInterfaceTest, handshakeLimitOff)
+{
+   HandshakeTestInterface net;
+   net.setHandshakeRateLimit(0, 1);
+
+   Address address = makeAddress(0x0A000001);
+
+   for(S32 i = 0; i < 1000; i++)
+      ASSERT_TRUE(net.allow(address, 1000000)) << "Packet " << i;
+
+   EXPECT_EQ(0, net.getHandshakeStats().packetsThrottled);
+}
+
+
+};
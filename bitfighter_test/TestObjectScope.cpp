@@ -208,4 +208,35 @@ TEST(ObjectScopeTest, TestItemPropagation)
 }
 
 
+// A team's spy bug shows what's around it to everyone on that team, no matter where their ships are, and to nobody else
+TEST(ObjectScopeTest, SpyBugVisibilityIsSharedByTeam)
+{
+   // Spy bug and item are far away from anywhere a ship might spawn
+   string levelCode = getLevelCodeForItemPropagationTests("SpyBug 0 40 40\nTestItem 40 40.5");
+
+   GamePair gamePair(levelCode, 0);
+   ServerGame *serverGame = gamePair.server;
+
+   ClientGame *blue1 = gamePair.addClientAndSetTeam("Blue1", 0);
+   ClientGame *blue2 = gamePair.addClientAndSetTeam("Blue2", 0);
+   ClientGame *red   = gamePair.addClientAndSetTeam("Red",   1);
+
+   gamePair.idle(10, 5);     // Let things settle
+
+   testObjectTransmission(TestItemTypeNumber, serverGame, 1, blue1, 1, red, 0);
+   testObjectTransmission(TestItemTypeNumber, serverGame, 1, blue2, 1, red, 0);
+
+   // Hand the spy bug to the other team
+   Vector<DatabaseObject *> fillVector;
+   serverGame->getLevel()->findObjects(SpyBugTypeNumber, fillVector);
+   ASSERT_EQ(1, fillVector.size());
+   static_cast<BfObject *>(fillVector[0])->setTeam(1);
+
+   gamePair.idle(10, 5);
+
+   testObjectTransmission(TestItemTypeNumber, serverGame, 1, blue1, 0, red, 1);
+   testObjectTransmission(TestItemTypeNumber, serverGame, 1, blue2, 0, red, 1);
+}
+
+
 }; // namespace Zap
@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "../zap/PolygonEdges.h"
+#include "../zap/GeomUtils.h"
+
+#include "PolygonsForTesting.h"
+
+#include "gtest/gtest.h"
+
+namespace Zap
+{
+
+using namespace TNL;
+
+
+class PolygonEdgesTest : public testing::Test
+{
+protected:
+   PolygonEdges::KernelSet mDefaultKernelSet;
+
+   virtual void SetUp()
+   {
+      mDefaultKernelSet = PolygonEdges::getKernelSet();
+   }
+
+   virtual void TearDown()
+   {
+      PolygonEdges::setKernelSet(mDefaultKernelSet);
+   }
+};
+
+
+// Every kernel set this build has should get what the Point based functions get, give or take some rounding
+TEST_F(PolygonEdgesTest, matchesGeomUtils)
+{
+   for(S32 kernelSet = PolygonEdges::ScalarKernels; kernelSet <= PolygonEdges::getBestKernelSet(); kernelSet++)
+   {
+      PolygonEdges::setKernelSet((PolygonEdges::KernelSet)kernelSet);
+      const char *name = PolygonEdges::getKernelSetName(PolygonEdges::getKernelSet());
+
+      EdgeTestRandom random(99);
+      Vector<Point> points;
+      PolygonEdges edges;
+
+      S32 sweptHits = 0, segmentHits = 0, containsHits = 0;
+
+      for(S32 i = 0; i < 500; i++)
+      {
+         makePolygon(random, points);
+         edges.set(points);
+
+         ASSERT_EQ(points.size(), edges.getEdgeCount());
+
+         for(S32 j = 0; j < 20; j++)
+         {
+            Point start(random.readF(-400, 400), random.readF(-400, 400));
+            Point delta(random.readF(-300, 300), random.readF(-300, 300));
+            F32 radius = random.readF(1, 30);
+
+            // Contains
+            bool expectedContains = polygonContainsPoint(points.address(), points.size(), start);
+            ASSERT_EQ(expectedContains, polygonContainsPoint(edges, start)) << name << ", polygon " << i << ", test " << j;
+            containsHits += expectedContains ? 1 : 0;
+
+            // Swept circle
+            Point expectedPoint, point;
+            F32 expectedFraction = -1, fraction = -1;
+
+            bool expectedHit = PolygonSweptCircleIntersect(points.address(), points.size(), start, delta, radius,
+                                                           expectedPoint, expectedFraction);
+            bool hit = PolygonSweptCircleIntersect(edges, start, delta, radius, point, fraction);
+
+            ASSERT_EQ(expectedHit, hit) << name << ", polygon " << i << ", test " << j;
+            if(hit)
+            {
+               EXPECT_NEAR(expectedFraction, fraction, 1e-5f) << name << ", polygon " << i << ", test " << j;
+               EXPECT_NEAR(expectedPoint.x, point.x, 0.01f) << name << ", polygon " << i << ", test " << j;
+               EXPECT_NEAR(expectedPoint.y, point.y, 0.01f) << name << ", polygon " << i << ", test " << j;
+               sweptHits++;
+            }
+
+            // Segment
+            Point expectedNormal, normal;
+            F32 expectedTime = -1, time = -1;
+
+            expectedHit = polygonIntersectsSegmentDetailed(points.address(), points.size(), true, start, start + delta,
+                                                           expectedTime, expectedNormal);
+            hit = polygonIntersectsSegmentDetailed(edges, start, start + delta, time, normal);
+
+            ASSERT_EQ(expectedHit, hit) << name << ", polygon " << i << ", test " << j;
+            if(hit)
+            {
+               EXPECT_FLOAT_EQ(expectedTime, time) << name << ", polygon " << i << ", test " << j;
+               EXPECT_FLOAT_EQ(expectedNormal.x, normal.x) << name << ", polygon " << i << ", test " << j;
+               EXPECT_FLOAT_EQ(expectedNormal.y, normal.y) << name << ", polygon " << i << ", test " << j;
+               segmentHits++;
+            }
+         }
+      }
+
+      // Make sure the random cases actually exercise the interesting paths
+      EXPECT_GT(containsHits, 100) << name;
+      EXPECT_GT(sweptHits, 500) << name;
+      EXPECT_GT(segmentHits, 500) << name;
+   }
+}
+
+
+// A circle already touching a wall at t = 0 should be reported there, but only if it's moving toward it
+TEST_F(PolygonEdgesTest, touchingAtStart)
+{
+   Vector<Point> square;
+   square.push_back(Point(0, 0));
+   square.push_back(Point(100, 0));
+   square.push_back(Point(100, 100));
+   square.push_back(Point(0, 100));
+
+   PolygonEdges edges(square);
+
+   Point point;
+   F32 fraction;
+
+   EXPECT_TRUE(PolygonSweptCircleIntersect(edges, Point(50, -5), Point(0, 10), 10, point, fraction));
+   EXPECT_EQ(0, fraction);
+   EXPECT_EQ(Point(50, 0), point);
+
+   EXPECT_FALSE(PolygonSweptCircleIntersect(edges, Point(50, -5), Point(0, -10), 10, point, fraction));
+}
+
+
+};
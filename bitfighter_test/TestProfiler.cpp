@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "gtest/gtest.h"
+
+#include "tnlProfiler.h"
+#include "tnlPlatform.h"
+
+#include <stdio.h>
+#include <string>
+
+
+namespace Zap
+{
+using namespace TNL;
+
+
+static void spin(U32 ms)
+{
+   U32 start = Platform::getRealMilliseconds();
+   while(Platform::getRealMilliseconds() - start < ms)
+      ;
+}
+
+
+static const Profiler::PhaseStats *findPhase(const Vector<Profiler::PhaseStats> &stats, const char *name)
+{
+   for(S32 i = 0; i < stats.size(); i++)
+      if(std::string(stats[i].name) == name)
+         return &stats[i];
+
+   return NULL;
+}
+
+
+class ProfilerTest : public testing::Test
+{
+protected:
+   virtual void SetUp()
+   {
+      Profiler::clear();
+      Profiler::setEnabled(true);
+   }
+
+   virtual void TearDown()
+   {
+      Profiler::setEnabled(false);
+      Profiler::clear();
+   }
+};
+
+
+TEST_F(ProfilerTest, nestedScopes)
+{
+   for(S32 i = 0; i < 3; i++)
+   {
+      TNL_PROFILE_SCOPE("outer");
+      spin(2);
+      {
+         TNL_PROFILE_SCOPE("inner");
+         spin(1);
+      }
+   }
+
+   Vector<Profiler::PhaseStats> stats;
+   Profiler::getPhaseStats(60000, stats);
+
+   ASSERT_EQ(2, stats.size());
+
+   const Profiler::PhaseStats *outer = findPhase(stats, "outer");
+   const Profiler::PhaseStats *inner = findPhase(stats, "inner");
+   ASSERT_TRUE(outer != NULL);
+   ASSERT_TRUE(inner != NULL);
+
+   EXPECT_EQ(3, outer->count);
+   EXPECT_EQ(3, inner->count);
+   EXPECT_GE(outer->p50Ms, inner->p50Ms);
+   EXPECT_GE(outer->totalMs, inner->totalMs);
+   EXPECT_LE(outer->p50Ms, outer->p99Ms);
+   EXPECT_LE(outer->p99Ms, outer->maxMs);
+}
+
+
+TEST_F(ProfilerTest, disabledRecordsNothing)
+{
+   Profiler::setEnabled(false);
+
+   {
+      TNL_PROFILE_SCOPE("ignored");
+   }
+
+   Vector<Profiler::PhaseStats> stats;
+   Profiler::getPhaseStats(60000, stats);
+
+   EXPECT_EQ(0, stats.size());
+}
+
+
+// The ring buffer keeps the most recent scopes once it's full
+TEST_F(ProfilerTest, ringBufferWraps)
+{
+   Profiler::setEventsPerThread(1000);
+
+   for(S32 i = 0; i < 1100; i++)
+   {
+      TNL_PROFILE_SCOPE("many");
+   }
+
+   Vector<Profiler::PhaseStats> stats;
+   Profiler::getPhaseStats(60000, stats);
+
+   Profiler::setEventsPerThread(Profiler::DefaultEventsPerThread);
+
+   ASSERT_EQ(1, stats.size());
+   EXPECT_EQ(1000, stats[0].count);
+}
+
+
+TEST_F(ProfilerTest, chromeTrace)
+{
+   {
+      TNL_PROFILE_SCOPE("traced");
+   }
+
+   const char *filename = "profiler_test_trace.json";
+   ASSERT_TRUE(Profiler::writeChromeTrace(filename, 60000));
+
+   FILE *f = fopen(filename, "r");
+   ASSERT_TRUE(f != NULL);
+
+   std::string contents;
+   char buf[256];
+   size_t len;
+   while((len = fread(buf, 1, sizeof(buf), f)) > 0)
+      contents.append(buf, len);
+   fclose(f);
+   remove(filename);
+
+   EXPECT_EQ(0, contents.find("{\"traceEvents\":["));
+   EXPECT_NE(std::string::npos, contents.find("\"name\":\"traced\",\"ph\":\"X\""));
+}
+
+
+};
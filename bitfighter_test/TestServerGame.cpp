@@ -5,6 +5,7 @@
 
 #include "gameType.h"
 #include "ServerGame.h"
+#include "GameManager.h"
 #include "EngineeredItem.h"
 
 #include "Level.h"
@@ -157,4 +158,29 @@ TEST(ServerGameTest, LoadoutManagementTests)
 }
 
 
+// Additional arenas take turns with the first, and each is the ServerGame while it runs
+TEST(ServerGameTest, Arenas)
+{
+   GamePair gamePair;
+   ServerGame *first = gamePair.server;
+
+   ServerGame *second = newServerGame();
+   second->setArenaIndex(1);
+   GameManager::addArena(second);
+
+   ASSERT_EQ(2, GameManager::getServerGames()->size());
+   EXPECT_EQ(first, GameManager::getServerGame());
+
+   GameManager::idle(10);
+   EXPECT_EQ(first, GameManager::getServerGame());    // Back to the first one when they're done
+
+   EXPECT_EQ(first->getSettings()->getHostName(), first->getServerName());
+   EXPECT_EQ(second->getSettings()->getHostName() + " #2", second->getServerName());
+
+   GameManager::deleteArena(second);
+   EXPECT_EQ(1, GameManager::getServerGames()->size());
+   EXPECT_EQ(first, GameManager::getServerGame());
+}
+
+
 };
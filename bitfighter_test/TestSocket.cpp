@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "SocketsForTesting.h"
+
+#include "tnlUDP.h"
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+namespace Zap
+{
+
+using namespace TNL;
+
+
+// Packets sent one at a time and a batch at a time should all arrive, in order and intact
+TEST(SocketTest, loopback)
+{
+   F64 ms;
+
+   EXPECT_TRUE(sendOverLoopback(false, 4, ms));
+   EXPECT_TRUE(sendOverLoopback(true, 4, ms));
+}
+
+
+TEST(SocketTest, batchedLoopback)
+{
+   // Asking for more than will fit in one system call
+   Socket sender(Address("IP:127.0.0.1:0"));
+   Socket receiver(Address("IP:127.0.0.1:0"));
+
+   const S32 count = Socket::MaxBatchSize + 5;
+   U8 buffers[count][MaxPacketDataSize];
+   Socket::Datagram datagrams[count];
+
+   for(S32 i = 0; i < count; i++)
+   {
+      writeU32ToBuffer(i, buffers[i]);
+
+      datagrams[i].address = receiver.getBoundAddress();
+      datagrams[i].buffer = buffers[i];
+      datagrams[i].capacity = MaxPacketDataSize;
+      datagrams[i].size = sizeof(U32);
+   }
+
+   ASSERT_EQ(count, sender.sendtoBatch(datagrams, count));
+
+   memset(buffers, 0, sizeof(buffers));
+
+   S32 received = 0;
+   while(received < count && receiver.waitForData(1000 * 1000))
+      received += receiver.recvfromBatch(datagrams + received, count - received);
+
+   ASSERT_EQ(count, received);
+
+   for(S32 i = 0; i < count; i++)
+   {
+      EXPECT_EQ(sizeof(U32), datagrams[i].size);
+      EXPECT_EQ(U32(i), readU32FromBuffer(buffers[i]));
+   }
+
+   // Nothing left to read
+   EXPECT_EQ(0, receiver.recvfromBatch(datagrams, count));
+}
+
+
+// Waiting on several sockets wakes up for a packet on any of them
+TEST(SocketTest, waitForDataOnSeveral)
+{
+   Socket sender(Address("IP:127.0.0.1:0"));
+   Socket first(Address("IP:127.0.0.1:0"));
+   Socket second(Address("IP:127.0.0.1:0"));
+
+   Vector<Socket *> sockets;
+   sockets.push_back(&first);
+   sockets.push_back(&second);
+
+   EXPECT_FALSE(Socket::waitForData(sockets, 0));
+
+   U8 buffer[4];
+   writeU32ToBuffer(1234, buffer);
+   ASSERT_EQ(NoError, sender.sendto(second.getBoundAddress(), buffer, sizeof(buffer)));
+
+   EXPECT_TRUE(Socket::waitForData(sockets, 1000 * 1000));
+   EXPECT_FALSE(first.waitForData(0));
+   EXPECT_TRUE(second.waitForData(0));
+}
+
+
+};
@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "TickSchedule.h"
+
+#include "gtest/gtest.h"
+
+namespace Zap
+{
+
+TEST(TickScheduleTest, FixedSchedule)
+{
+   TickSchedule schedule;
+   schedule.setInterval(10);
+
+   EXPECT_TRUE(schedule.isTickDue(1000));          // Always due before we've started
+   EXPECT_EQ(10, schedule.tick(1000));
+   EXPECT_DOUBLE_EQ(1010, schedule.getNextTickTime());
+
+   EXPECT_FALSE(schedule.isTickDue(1009.5));
+   EXPECT_TRUE(schedule.isTickDue(1010));
+
+   // Running late doesn't push the schedule back
+   EXPECT_EQ(13, schedule.tick(1013));
+   EXPECT_DOUBLE_EQ(1020, schedule.getNextTickTime());
+   EXPECT_EQ(7, schedule.tick(1020));
+
+   TickSchedule::JitterStats stats;
+   schedule.getJitterStats(stats);
+
+   EXPECT_EQ(2, stats.tickCount);
+   EXPECT_EQ(1, stats.lateTicks);
+   EXPECT_DOUBLE_EQ(1.5, stats.meanMs);
+   EXPECT_DOUBLE_EQ(1.5, stats.stdDevMs);
+   EXPECT_DOUBLE_EQ(3, stats.maxMs);
+
+   schedule.resetJitterStats();
+   schedule.getJitterStats(stats);
+   EXPECT_EQ(0, stats.tickCount);
+}
+
+
+TEST(TickScheduleTest, FractionalIntervals)
+{
+   TickSchedule schedule;
+   schedule.setInterval(1000.0 / 60);
+
+   // Fractions of a millisecond get handed out eventually, so a second of ticks adds up to a second
+   F64 now = 0;
+   U32 total = schedule.tick(now);
+
+   for(S32 i = 1; i < 60; i++)
+   {
+      now = schedule.getNextTickTime();
+      total += schedule.tick(now);
+   }
+
+   EXPECT_EQ(1000, total);
+}
+
+
+TEST(TickScheduleTest, Resync)
+{
+   TickSchedule schedule;
+   schedule.setInterval(10);
+   schedule.tick(0);
+
+   // A little behind: catch up with back-to-back ticks
+   schedule.tick(30);
+   EXPECT_TRUE(schedule.isTickDue(30));
+
+   // Hopelessly behind: start over
+   schedule.tick(1000);
+   EXPECT_DOUBLE_EQ(1010, schedule.getNextTickTime());
+
+   TickSchedule::JitterStats stats;
+   schedule.getJitterStats(stats);
+   EXPECT_EQ(1, stats.resyncCount);
+}
+
+};
@@ -16,11 +16,13 @@
 #include "UIManager.h"
 #include "SystemFunctions.h"
 #include "Level.h"
+#include "moveObject.h"
 #include "tnlAssert.h"
 
 #include "../zap/stringUtils.h"
 #include "gtest/gtest.h"
 
+#include <stdlib.h>
 #include <string>
 
 using namespace std;
@@ -69,6 +71,25 @@ ServerGame *newServerGame()
 }
 
 
+void dirtyAllItems(ServerGame *serverGame)
+{
+   Vector<DatabaseObject *> items;
+   serverGame->getLevel()->findObjects(ResourceItemTypeNumber, items);
+
+   for(S32 i = 0; i < items.size(); i++)
+      static_cast<MoveItem *>(items[i])->setPositionMask();
+}
+
+
+void getRandomPairs(S32 range, S32 count, Vector<pair<S32, S32> > &pairs)
+{
+   srand(1234);
+
+   for(S32 i = 0; i < count; i++)
+      pairs.push_back(pair<S32, S32>(rand() % range, rand() % range));
+}
+
+
 GamePair::GamePair(GameSettingsPtr settings)
 {
    initialize(settings, "", 0);
@@ -31,6 +31,12 @@ ClientGame *newClientGame(const GameSettingsPtr &settings);
 
 ServerGame *newServerGame();
 
+// Gives every ResourceItem on the server a position update waiting to go out
+void dirtyAllItems(ServerGame *serverGame);
+
+// Pairs of indices below range, such as zones to route between; the same for every run, so timings can be compared
+void getRandomPairs(S32 range, S32 count, Vector<pair<S32, S32> > &pairs);
+
 // Generic pack/unpack function -- feed it any class that supports pack/unpack
 template <class T>
 void packUnpack(T input, T &output, U32 mask = 0xFFFFFFFF)
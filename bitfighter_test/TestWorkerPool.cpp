@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "gtest/gtest.h"
+
+#include "tnlThread.h"
+
+
+namespace Zap
+{
+using namespace TNL;
+
+
+// Records which shares ran, and on how many threads
+class CountingPool : public WorkerPool
+{
+public:
+   Mutex mLock;
+   Vector<U32> mSharesRun;       // Times each share ran, by index
+   U32 mShareCount;
+
+   void doWork(U32 index, U32 shareCount)
+   {
+      mLock.lock();
+      mSharesRun[index]++;
+      mShareCount = shareCount;
+      mLock.unlock();
+   }
+};
+
+
+static Mutex gExitLock;
+static U32 gExitCount;
+
+static void countExit()
+{
+   gExitLock.lock();
+   gExitCount++;
+   gExitLock.unlock();
+}
+
+static Thread::ExitFunctionRegistration gCountExits(&countExit);
+
+
+TEST(WorkerPoolTest, everyShareRunsOnce)
+{
+   CountingPool pool;
+   pool.mSharesRun.resize(4);
+
+   ASSERT_EQ(3, pool.start(3));
+   EXPECT_EQ(3, pool.getWorkerCount());
+
+   for(S32 round = 1; round <= 5; round++)
+   {
+      pool.run();
+
+      // Every share, including the caller's, is done by the time run() returns
+      EXPECT_EQ(4, pool.mShareCount);
+      for(S32 i = 0; i < pool.mSharesRun.size(); i++)
+         EXPECT_EQ(U32(round), pool.mSharesRun[i]);
+   }
+}
+
+
+TEST(WorkerPoolTest, workersRunExitFunctions)
+{
+   gExitCount = 0;
+
+   CountingPool pool;
+   pool.mSharesRun.resize(3);
+
+   ASSERT_EQ(2, pool.start(2));
+   pool.run();
+
+   // Restarting stops the old workers first
+   ASSERT_EQ(2, pool.start(2));
+   EXPECT_EQ(2, gExitCount);
+
+   pool.stop();
+   EXPECT_EQ(4, gExitCount);
+   EXPECT_EQ(0, pool.getWorkerCount());
+
+   // With no workers, the caller does the whole job
+   pool.run();
+   EXPECT_EQ(1, pool.mShareCount);
+   EXPECT_EQ(2, pool.mSharesRun[0]);
+}
+
+
+};
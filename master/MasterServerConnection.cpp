@@ -340,49 +340,88 @@ void MasterServerConnection::c2mQueryServersOption(U32 queryId, bool hostonly)
 {
    Vector<IPAddress> addresses(IP_MESSAGE_ADDRESS_COUNT);
    Vector<S32> serverIdList(IP_MESSAGE_ADDRESS_COUNT);
-   
 
-   const Vector<MasterServerConnection *> *serverList = mMaster->getServerList();
+   // The registry only holds visible servers, already sorted by protocol version and host mode
+   const Vector<IPAddress> *allAddresses;
+   const Vector<S32> *allServerIds;
+   mMaster->getServerRegistry()->getServers(mCSProtocolVersion, hostonly, allAddresses, allServerIds);
 
-   for(S32 i = 0; i < serverList->size(); i++)
+   S32 count = allAddresses ? allAddresses->size() : 0;
+
+   // Send a packet's worth at a time...
+   for(S32 i = 0; i < count; i += IP_MESSAGE_ADDRESS_COUNT)
    {
-      // Hide hidden servers
-      if(serverList->get(i)->mIsIgnoredFromList)  
-         continue;
+      addresses.clear();
+      serverIdList.clear();
 
-      // Skip servers with incompatible versions
-      if(serverList->get(i)->mCSProtocolVersion != mCSProtocolVersion)  
-         continue;
+      for(S32 j = i; j < count && j < i + IP_MESSAGE_ADDRESS_COUNT; j++)
+      {
+         addresses.push_back(allAddresses->get(j));
+         serverIdList.push_back(allServerIds->get(j));
+      }
 
-      // Skip servers with host mode
-      if(((serverList->get(i)->mInfoFlags & HostModeFlag) != 0) != hostonly)
-         continue;
+      sendM2cQueryServersResponse(queryId, addresses, serverIdList);
+   }
 
-      // Add us to the results list
-      addresses.push_back(serverList->get(i)->getNetAddress().toIPAddress());
-      serverIdList.push_back(serverList->get(i)->getClientId());
+   // ...then a list with no servers, to let the client know we're done
+   addresses.clear();
+   serverIdList.clear();
+
+   sendM2cQueryServersResponse(queryId, addresses, serverIdList);
+}
+
+
+TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, c2mQueryServersSince, (U32 queryId, bool hostOnly, U32 listVersion))
+{
+   const ServerRegistry *registry = mMaster->getServerRegistry();
 
-      // If we get a packet's worth, send it to the client and empty our buffer...
-      if(addresses.size() == IP_MESSAGE_ADDRESS_COUNT)
+   Vector<IPAddress> allAddresses;
+   Vector<S32> allServerIds;
+   Vector<S32> allRemovedIds;
+
+   bool fullList = !registry->getChanges(mCSProtocolVersion, hostOnly, listVersion, allAddresses, allServerIds, allRemovedIds);
+
+   if(fullList)
+   {
+      const Vector<IPAddress> *addresses;
+      const Vector<S32> *serverIds;
+      registry->getServers(mCSProtocolVersion, hostOnly, addresses, serverIds);
+
+      if(addresses)
       {
-         sendM2cQueryServersResponse(queryId, addresses, serverIdList);
-         
-         addresses.clear();
-         serverIdList.clear();
+         allAddresses = *addresses;
+         allServerIds = *serverIds;
       }
    }
 
-   // Send the final packet
-   sendM2cQueryServersResponse(queryId, addresses, serverIdList);
+   Vector<IPAddress> addresses(IP_MESSAGE_ADDRESS_COUNT);
+   Vector<S32> serverIdList(IP_MESSAGE_ADDRESS_COUNT);
+   Vector<S32> removedIdList(IP_MESSAGE_ADDRESS_COUNT);
 
-   // If we sent any with the previous message, send another list with no servers
-   if(addresses.size())
+   S32 added = 0;
+   S32 removed = 0;
+
+   // Always send at least one message, even if nothing has changed, so the client knows it's up to date
+   do
    {
       addresses.clear();
       serverIdList.clear();
+      removedIdList.clear();
 
-      sendM2cQueryServersResponse(queryId, addresses, serverIdList);
-   }
+      for(; added < allAddresses.size() && addresses.size() < IP_MESSAGE_ADDRESS_COUNT; added++)
+      {
+         addresses.push_back(allAddresses[added]);
+         serverIdList.push_back(allServerIds[added]);
+      }
+
+      for(; removed < allRemovedIds.size() && removedIdList.size() < IP_MESSAGE_ADDRESS_COUNT; removed++)
+         removedIdList.push_back(allRemovedIds[removed]);
+
+      bool done = (added == allAddresses.size() && removed == allRemovedIds.size());
+
+      m2cQueryServersDelta(queryId, registry->getVersion(), fullList, addresses, serverIdList, removedIdList, done);
+
+   } while(added < allAddresses.size() || removed < allRemovedIds.size());
 }
 
 
@@ -510,78 +549,90 @@ static bool listClient(MasterServerConnection *client)
 // This gets updated whenever we gain or lose a server, at most every 5 seconds (currently)
 void MasterServerConnection::writeClientServerList_JSON()
 {
-   string jsonfile = mMaster->getSetting<string>(IniKey::JsonOutfile);
-
-   // Don't write if we don't have a file
-   if(jsonfile == "")
+   // Don't bother if we don't have a file
+   if(mMaster->getSetting<string>(IniKey::JsonOutfile) == "")
       return;
 
    bool first = true;
    S32 playerCount = 0;
    S32 serverCount = 0;
 
-   FILE *f = fopen(jsonfile.c_str(), "w");
-   if(f)
+   // First the servers
+   string json = "{\n\t\"servers\": [";
+
+   const Vector<MasterServerConnection *> *serverList = mMaster->getServerList();
+
+   for(S32 i = 0; i < serverList->size(); i++)
    {
-      // First the servers
-      fprintf(f, "{\n\t\"servers\": [");
+      MasterServerConnection *server = serverList->get(i);
 
-      const Vector<MasterServerConnection *> *serverList = mMaster->getServerList();
+      if(server->mIsIgnoredFromList)
+         continue;
 
-      for(S32 i = 0; i < serverList->size(); i++)
-      {
-         MasterServerConnection *server = serverList->get(i);
+      if(!first)
+         json += ", ";
 
-         if(server->mIsIgnoredFromList)
-            continue;
+      json += server->getJsonEntry();
 
-         fprintf(f, "%s\n\t\t{\n\t\t\t\"serverName\": \"%s\",\n\t\t\t\"protocolVersion\": %d,\n\t\t\t\"currentLevelName\": \"%s\",\n\t\t\t\"currentLevelType\": \"%s\",\n\t\t\t\"playerCount\": %d\n\t\t}",
-                     first ? "" : ", ", sanitizeForJson(server->mPlayerOrServerName.getString()).c_str(),
-                     server->mCSProtocolVersion, server->mLevelName.getString(), server->mLevelType.getString(), server->mPlayerCount);
-         playerCount += server->mPlayerCount;
-         serverCount++;
-         first = false;
-      }
+      playerCount += server->mPlayerCount;
+      serverCount++;
+      first = false;
+   }
 
-      // Next the player names      // "players": [ "chris", "colin", "fred", "george", "Peter99" ],
-      fprintf(f, "\n\t],\n\t\"players\": [");
-      first = true;
+   // Next the player names      // "players": [ "chris", "colin", "fred", "george", "Peter99" ],
+   json += "\n\t],\n\t\"players\": [";
+   first = true;
 
-      const Vector<MasterServerConnection *> *clientList = mMaster->getClientList();
+   const Vector<MasterServerConnection *> *clientList = mMaster->getClientList();
 
-      for(S32 i = 0; i < clientList->size(); i++)
+   for(S32 i = 0; i < clientList->size(); i++)
+   {
+      if(listClient(clientList->get(i)))
       {
-         if(listClient(clientList->get(i)))
-         {
-            fprintf(f, "%s\"%s\"", first ? "" : ", ", sanitizeForJson(clientList->get(i)->mPlayerOrServerName.getString()).c_str());
-            first = false;
-         }
+         json += first ? "\"" : ", \"";
+         json += sanitizeForJson(clientList->get(i)->mPlayerOrServerName.getString());
+         json += "\"";
+         first = false;
       }
+   }
 
-      // Authentication status      // "authenticated": [ true, false, false, true, true ],
-      fprintf(f, "],\n\t\"authenticated\": [");
-      first = true;
+   // Authentication status      // "authenticated": [ true, false, false, true, true ],
+   json += "],\n\t\"authenticated\": [";
+   first = true;
 
-      for(S32 i = 0; i < clientList->size(); i++)
+   for(S32 i = 0; i < clientList->size(); i++)
+   {
+      if(listClient(clientList->get(i)))
       {
-         if(listClient(clientList->get(i)))
-         {
-            fprintf(f, "%s%s", first ? "" : ", ", clientList->get(i)->mAuthenticated ? "true" : "false");
-            first = false;
-         }
+         if(!first)
+            json += ", ";
+
+         json += clientList->get(i)->mAuthenticated ? "true" : "false";
+         first = false;
       }
+   }
 
-      // Finally, the player and server counts
-      fprintf(f, "],\n\t\"serverCount\": %d,\n\t\"playerCount\": %d,\n", serverCount, playerCount);
+   // Finally, the player and server counts
+   json += "],\n\t\"serverCount\": " + itos(serverCount) + ",\n\t\"playerCount\": " + itos(playerCount) + ",\n";
 
-      // And the message-of-the-day
-      fprintf(f, "\t\"motd\": \"%s\"\n}\n", sanitizeForJson(mMaster->getSettings()->getMotd().c_str()).c_str());
+   // And the message-of-the-day
+   json += "\t\"motd\": \"" + sanitizeForJson(mMaster->getSettings()->getMotd().c_str()) + "\"\n}\n";
 
-      fflush(f);
-      fclose(f);
-   }
-   else
-      logprintf(LogConsumer::LogError, "Could not write to JSON file \"%s\"", jsonfile.c_str());
+   mMaster->writeJsonFile(json);
+}
+
+
+// Servers don't change much between writes, so we hang on to their JSON
+const string &MasterServerConnection::getJsonEntry()
+{
+   if(mJsonEntry == "")
+      mJsonEntry = "\n\t\t{\n\t\t\t\"serverName\": \"" + sanitizeForJson(mPlayerOrServerName.getString()) +
+                   "\",\n\t\t\t\"protocolVersion\": " + itos(mCSProtocolVersion) +
+                   ",\n\t\t\t\"currentLevelName\": \"" + string(mLevelName.getString()) +
+                   "\",\n\t\t\t\"currentLevelType\": \"" + string(mLevelType.getString()) +
+                   "\",\n\t\t\t\"playerCount\": " + itos(mPlayerCount) + "\n\t\t}";
+
+   return mJsonEntry;
 }
 
 /*  Resulting JSON data should look like this:
@@ -751,7 +802,14 @@ TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, s2mUpdateServerStatus, (Strin
       mNumBots     = botCount;
       mPlayerCount = playerCount;
       mMaxPlayers  = maxPlayers;
-      mInfoFlags   = infoFlags;
+
+      mJsonEntry = "";
+
+      if(mInfoFlags != infoFlags)
+      {
+         mInfoFlags = infoFlags;
+         mMaster->updateServerListing(this);    // Host mode may have changed
+      }
 
       // Check to ensure we're not getting flooded with these requests
       checkActivityTime(FOUR_SECONDS);
@@ -1698,6 +1756,9 @@ void MasterServerConnection::writeConnectAccept(BitStream *stream)
 
    if(mCMProtocolVersion >= 8)
       stream->write(mClientId);
+
+   if(mCMProtocolVersion >= 9)
+      stream->write(U32(MASTER_PROTOCOL_VERSION));    // So the client knows which queries we can answer
 }
 
 
@@ -1798,6 +1859,7 @@ TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, c2mSendChat, (StringPtr messa
                if(server->getNetAddress().isEqualAddress(addr) && (addr.port == 0 || addr.port == server->getNetAddress().port))
                {
                   server->mIsIgnoredFromList = true;
+                  mMaster->updateServerListing(server);
                   m2cSendChat(server->mPlayerOrServerName, true, "dropped");
                   droppedServer = true;
                }
@@ -1817,6 +1879,7 @@ TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, c2mSendChat, (StringPtr messa
                {
                   broughtBackServer = true;
                   serverList->get(i)->mIsIgnoredFromList = false;
+                  mMaster->updateServerListing(serverList->get(i));
                   m2cSendChat(serverList->get(i)->mPlayerOrServerName, true, "servers restored");
                }
             if(!broughtBackServer)
@@ -1952,6 +2015,7 @@ TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, s2mChangeName, (StringTableEn
    if(mConnectionType == MasterConnectionTypeServer)  // server only, don't want clients to rename yet (client names need to authenticate)
    {
       mPlayerOrServerName = name;
+      mJsonEntry = "";
       mMaster->writeJsonNow();  // update server name in ".json"
    }
 }
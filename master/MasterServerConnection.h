@@ -165,6 +165,8 @@ public:
 
    StringTableEntry mAutoDetectStr;             // Player's joystick autodetect string, for research purposes
 
+   string mJsonEntry;                           // Server's entry in the JSON file; cleared whenever anything in it changes
+
 public:
    static Vector<SafePtr<MasterServerConnection> > gLeaveChatTimerList;
    U32 mLeaveLobbyChatTimer;
@@ -206,6 +208,9 @@ public:
    TNL_DECLARE_RPC_OVERRIDE(c2mQueryHostServers, (U32 queryId));
    void c2mQueryServersOption(U32 queryId, bool hostonly);
 
+   // Newer clients can ask for just the servers that have changed since their last query
+   TNL_DECLARE_RPC_OVERRIDE(c2mQueryServersSince, (U32 queryId, bool hostOnly, U32 listVersion));
+
    /// checkActivityTime validates that this particular connection is
    /// not issuing too many requests at once in an attempt to DOS
    /// by flooding either the master server or any other server
@@ -232,6 +237,7 @@ public:
    // Write a current count of clients/servers for display on a website, using JSON format
    // This gets updated whenver we gain or lose a server, at most every 5 seconds (currently)
    static void writeClientServerList_JSON();
+   const string &getJsonEntry();
 
    bool isAuthenticated();
 
@@ -0,0 +1,197 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "ServerRegistry.h"
+
+#include "tnlRandom.h"
+#include "tnlAssert.h"
+
+namespace Master
+{
+
+// Constructor
+ServerRegistry::ServerRegistry()
+{
+   // Start somewhere random, so a client still holding a version from before we restarted won't be mistaken
+   // for one that's up to date
+   mFirstVersion = Random::readI(1, 0x3FFFFFFF);
+   mVersion = mFirstVersion;
+}
+
+
+// Destructor
+ServerRegistry::~ServerRegistry()
+{
+   // Do nothing
+}
+
+
+void ServerRegistry::logChange(Group &group, S32 serverId, const IPAddress &address, bool added)
+{
+   mVersion++;
+
+   Change change;
+   change.version = mVersion;
+   change.serverId = serverId;
+   change.address = address;
+   change.added = added;
+
+   group.changes.push_back(change);
+
+   // Forget the older half once we've got too many; anyone that far behind is better off with the whole list
+   if(group.changes.size() > MaxChangeLogSize)
+   {
+      S32 dropCount = group.changes.size() / 2;
+      group.oldestVersion = group.changes[dropCount - 1].version;
+      group.changes.getStlVector().erase(group.changes.getStlVector().begin(),
+                                         group.changes.getStlVector().begin() + dropCount);
+   }
+}
+
+
+void ServerRegistry::unlist(map<S32, Listing>::iterator listing)
+{
+   Group &group = mGroups[listing->second.key];
+   S32 index = listing->second.index;
+   S32 last = group.serverIds.size() - 1;
+
+   logChange(group, listing->first, group.addresses[index], false);
+
+   // Fill the hole with the last server in the group
+   if(index != last)
+   {
+      group.addresses[index] = group.addresses[last];
+      group.serverIds[index] = group.serverIds[last];
+      mListings[group.serverIds[index]].index = index;
+   }
+
+   group.addresses.erase(last);
+   group.serverIds.erase(last);
+
+   mListings.erase(listing);
+}
+
+
+void ServerRegistry::updateServer(S32 serverId, const IPAddress &address, U32 csProtocolVersion, bool hostMode, bool listed)
+{
+   GroupKey key(csProtocolVersion, hostMode);
+   map<S32, Listing>::iterator listing = mListings.find(serverId);
+
+   if(listing != mListings.end())
+   {
+      // Nothing we care about has changed
+      if(listed && listing->second.key == key)
+         return;
+
+      unlist(listing);
+   }
+
+   if(!listed)
+      return;
+
+   map<GroupKey, Group>::iterator it = mGroups.find(key);
+   if(it == mGroups.end())
+   {
+      it = mGroups.insert(pair<GroupKey, Group>(key, Group())).first;
+      it->second.oldestVersion = mFirstVersion;     // It's always been empty until now
+   }
+
+   Group &group = it->second;
+
+   Listing newListing;
+   newListing.key = key;
+   newListing.index = group.serverIds.size();
+   mListings[serverId] = newListing;
+
+   group.addresses.push_back(address);
+   group.serverIds.push_back(serverId);
+
+   logChange(group, serverId, address, true);
+}
+
+
+void ServerRegistry::removeServer(S32 serverId)
+{
+   map<S32, Listing>::iterator listing = mListings.find(serverId);
+
+   if(listing != mListings.end())
+      unlist(listing);
+}
+
+
+U32 ServerRegistry::getVersion() const
+{
+   return mVersion;
+}
+
+
+S32 ServerRegistry::getServerCount() const
+{
+   return (S32)mListings.size();
+}
+
+
+void ServerRegistry::getServers(U32 csProtocolVersion, bool hostMode, const Vector<IPAddress> *&addresses,
+                                const Vector<S32> *&serverIds) const
+{
+   map<GroupKey, Group>::const_iterator it = mGroups.find(GroupKey(csProtocolVersion, hostMode));
+
+   if(it == mGroups.end() || it->second.serverIds.size() == 0)
+   {
+      addresses = NULL;
+      serverIds = NULL;
+   }
+   else
+   {
+      addresses = &it->second.addresses;
+      serverIds = &it->second.serverIds;
+   }
+}
+
+
+bool ServerRegistry::getChanges(U32 csProtocolVersion, bool hostMode, U32 sinceVersion, Vector<IPAddress> &addedAddresses,
+                                Vector<S32> &addedServerIds, Vector<S32> &removedServerIds) const
+{
+   addedAddresses.clear();
+   addedServerIds.clear();
+   removedServerIds.clear();
+
+   if(sinceVersion < mFirstVersion || sinceVersion > mVersion)
+      return false;
+
+   map<GroupKey, Group>::const_iterator it = mGroups.find(GroupKey(csProtocolVersion, hostMode));
+
+   if(it == mGroups.end())       // Never had anything in it, so nothing has changed
+      return true;
+
+   const Group &group = it->second;
+
+   if(sinceVersion < group.oldestVersion)
+      return false;
+
+   // Newest first, so the last thing that happened to each server is the one that counts
+   map<S32, bool> seen;
+
+   for(S32 i = group.changes.size() - 1; i >= 0 && group.changes[i].version > sinceVersion; i--)
+   {
+      const Change &change = group.changes[i];
+
+      if(!seen.insert(pair<S32, bool>(change.serverId, true)).second)
+         continue;
+
+      if(change.added)
+      {
+         addedAddresses.push_back(change.address);
+         addedServerIds.push_back(change.serverId);
+      }
+      else
+         removedServerIds.push_back(change.serverId);
+   }
+
+   return true;
+}
+
+
+}
@@ -0,0 +1,91 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _SERVER_REGISTRY_H_
+#define _SERVER_REGISTRY_H_
+
+#include "tnlUDP.h"
+#include "tnlVector.h"
+
+#include <map>
+
+using namespace TNL;
+using namespace std;
+
+namespace Master
+{
+
+// The servers clients can see, grouped by the cs protocol they speak and whether or not they are in host mode --
+// the two things every server query filters on.  Each group keeps a ready-to-send list, so answering a query doesn't
+// involve looking at servers the client can't use.
+//
+// Every change gets a version number.  Clients that tell us the version of the list they already have can be sent
+// just what has changed since then.
+class ServerRegistry
+{
+public:
+   enum {
+      MaxChangeLogSize = 512,    // Changes remembered per group; clients further behind than this get the whole list
+   };
+
+private:
+   struct Change
+   {
+      U32 version;
+      S32 serverId;
+      IPAddress address;
+      bool added;                // Otherwise removed
+   };
+
+   struct Group
+   {
+      Vector<IPAddress> addresses;
+      Vector<S32> serverIds;     // Parallel to addresses
+      Vector<Change> changes;    // Oldest first
+      U32 oldestVersion;         // Deltas can only be worked out from this version on
+   };
+
+   typedef pair<U32, bool> GroupKey;      // cs protocol, host mode
+
+   // Where each listed server can be found
+   struct Listing
+   {
+      GroupKey key;
+      S32 index;                 // In the group's lists
+   };
+
+   map<GroupKey, Group> mGroups;
+   map<S32, Listing> mListings;  // By server id
+
+   U32 mFirstVersion;
+   U32 mVersion;
+
+   void logChange(Group &group, S32 serverId, const IPAddress &address, bool added);
+   void unlist(map<S32, Listing>::iterator listing);
+
+public:
+   ServerRegistry();             // Constructor
+   virtual ~ServerRegistry();    // Destructor
+
+   // Call whenever a server arrives, or anything about it we filter on changes.  Unlisted servers are hidden.
+   void updateServer(S32 serverId, const IPAddress &address, U32 csProtocolVersion, bool hostMode, bool listed);
+   void removeServer(S32 serverId);
+
+   U32 getVersion() const;
+   S32 getServerCount() const;
+
+   // Everything in a group, NULL if there's nothing in it
+   void getServers(U32 csProtocolVersion, bool hostMode, const Vector<IPAddress> *&addresses,
+                   const Vector<S32> *&serverIds) const;
+
+   // What changed in a group since sinceVersion; returns false if we can't tell, in which case the caller should
+   // send the whole list
+   bool getChanges(U32 csProtocolVersion, bool hostMode, U32 sinceVersion, Vector<IPAddress> &addedAddresses,
+                   Vector<S32> &addedServerIds, Vector<S32> &removedServerIds) const;
+};
+
+}
+
+#endif
@@ -232,6 +232,42 @@ void MasterServer::writeJsonNow()
 }
 
 
+// Write json to our JSON file, unless that's what's already there.  The file is written under a temporary name and
+// then moved into place, so anyone reading it never sees half a file.  Returns false if it couldn't be written.
+bool MasterServer::writeJsonFile(const string &json)
+{
+   if(json == mLastJson)
+      return true;
+
+   string jsonfile = getSetting<string>(IniKey::JsonOutfile);
+   string tempfile = jsonfile + ".tmp";
+
+   FILE *f = fopen(tempfile.c_str(), "wb");
+   if(!f)
+   {
+      logprintf(LogConsumer::LogError, "Could not write to JSON file \"%s\"", tempfile.c_str());
+      return false;
+   }
+
+   bool ok = (fwrite(json.c_str(), 1, json.length(), f) == json.length());
+   ok = (fclose(f) == 0) && ok;
+
+#ifdef TNL_OS_WIN32
+   remove(jsonfile.c_str());     // Windows won't rename over an existing file
+#endif
+
+   if(!ok || rename(tempfile.c_str(), jsonfile.c_str()) != 0)
+   {
+      logprintf(LogConsumer::LogError, "Could not write to JSON file \"%s\"", jsonfile.c_str());
+      remove(tempfile.c_str());
+      return false;
+   }
+
+   mLastJson = json;
+   return true;
+}
+
+
 const Vector<MasterServerConnection *> *MasterServer::getServerList() const
 {
    return &mServerList;
@@ -244,9 +280,16 @@ const Vector<MasterServerConnection *> *MasterServer::getClientList() const
 }
 
 
+const ServerRegistry *MasterServer::getServerRegistry() const
+{
+   return &mServerRegistry;
+}
+
+
 void MasterServer::addServer(MasterServerConnection *server)
 {
    mServerList.push_back(server);
+   updateServerListing(server);
 }
 
 
@@ -259,6 +302,7 @@ void MasterServer::addClient(MasterServerConnection *client)
 void MasterServer::removeServer(S32 index)
 {
    TNLAssert(index >= 0 && index < mServerList.size(), "Index out of range!");
+   mServerRegistry.removeServer(mServerList[index]->getClientId());
    mServerList.erase_fast(index);
 }
 
@@ -270,6 +314,14 @@ void MasterServer::removeClient(S32 index)
 }
 
 
+// Call whenever a server is hidden or restored, or changes its host mode flag
+void MasterServer::updateServerListing(MasterServerConnection *server)
+{
+   mServerRegistry.updateServer(server->getClientId(), server->getNetAddress().toIPAddress(), server->mCSProtocolVersion,
+                                (server->mInfoFlags & HostModeFlag) != 0, !server->mIsIgnoredFromList);
+}
+
+
 NetInterface *MasterServer::getNetInterface() const
 {
    return mNetInterface;
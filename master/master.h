@@ -6,6 +6,7 @@
 #include "masterInterface.h"
 
 #include "MasterServerConnection.h"
+#include "ServerRegistry.h"
 
 #include "../zap/IniFile.h"
 
@@ -125,6 +126,7 @@ private:
 
    Timer mJsonWriteTimer;
    bool mJsonWritingSuspended;
+   string mLastJson;                   // What we last wrote to the JSON file
 
    Timer mPingGameJoltTimer;
 
@@ -133,6 +135,8 @@ private:
    Vector<MasterServerConnection *> mServerList;
    Vector<MasterServerConnection *> mClientList;
 
+   ServerRegistry mServerRegistry;     // Servers clients can see, indexed for queries
+
    NetInterface *createNetInterface() const;
 
    bool motdHasChanged() const;
@@ -157,9 +161,11 @@ public:
    DatabaseAccessThread *getDatabaseAccessThread();
    void writeJsonDelayed();
    void writeJsonNow();
+   bool writeJsonFile(const string &json);
 
    const Vector<MasterServerConnection *> *getServerList() const;
    const Vector<MasterServerConnection *> *getClientList() const;
+   const ServerRegistry *getServerRegistry() const;
 
    void addServer(MasterServerConnection *server);
    void addClient(MasterServerConnection *client);
@@ -167,6 +173,8 @@ public:
    void removeServer(S32 index);
    void removeClient(S32 index);
 
+   void updateServerListing(MasterServerConnection *server);
+
    EasterEggBasket *getEasterEggBasket();
 
    void idle(const U32 timeDelta);
@@ -31,6 +31,7 @@ static const S32 M_RPC_019  = 3;
 static const S32 M_RPC_019a = 4;
 static const S32 M_RPC_019d = 5;
 static const S32 M_RPC_020  = 6;
+static const S32 M_RPC_021  = 7;
 
 TNL_IMPLEMENT_RPC(MasterServerInterface, c2mQueryServers,
    (U32 queryId), (queryId),
@@ -52,6 +53,16 @@ TNL_IMPLEMENT_RPC(MasterServerInterface, m2cQueryServersResponse_019a,
    (U32 queryId, Vector<IPAddress> ipList, Vector<S32> serverIdList), (queryId, ipList, serverIdList),
    NetClassGroupMasterMask, RPCGuaranteedOrdered, RPCDirServerToClient, M_RPC_019a) {}
 
+TNL_IMPLEMENT_RPC(MasterServerInterface, c2mQueryServersSince,
+   (U32 queryId, bool hostOnly, U32 listVersion), (queryId, hostOnly, listVersion),
+   NetClassGroupMasterMask, RPCGuaranteedOrdered, RPCDirClientToServer, M_RPC_021) {}
+
+TNL_IMPLEMENT_RPC(MasterServerInterface, m2cQueryServersDelta,
+   (U32 queryId, U32 listVersion, bool fullList, Vector<IPAddress> ipList, Vector<S32> serverIdList,
+    Vector<S32> removedIdList, bool done),
+   (queryId, listVersion, fullList, ipList, serverIdList, removedIdList, done),
+   NetClassGroupMasterMask, RPCGuaranteedOrdered, RPCDirServerToClient, M_RPC_021) {}
+
 TNL_IMPLEMENT_RPC(MasterServerInterface, c2mRequestArrangedConnection, 
    (U32 requestId, IPAddress remoteAddress, IPAddress internalAddress, ByteBufferPtr connectionParameters),
    (requestId, remoteAddress, internalAddress, connectionParameters),
@@ -77,6 +77,15 @@ public:
    TNL_DECLARE_RPC(m2cQueryServersResponse,      (U32 queryId, Vector<IPAddress> ipList));
    TNL_DECLARE_RPC(m2cQueryServersResponse_019a, (U32 queryId, Vector<IPAddress> ipList, Vector<S32> serverIdList));
 
+   /// c2mQueryServersSince asks for the servers that have come or gone since the list the client received with
+   /// listVersion; send 0 if there is no such list.  The master answers with one or more m2cQueryServersDelta RPCs,
+   /// the last with done set.  If fullList is set, the master couldn't work out what changed, and is sending the whole
+   /// list instead.  removedIdList only holds ids of servers that have gone away; any of them may be unknown to the
+   /// client.  Version 9 and later.
+   TNL_DECLARE_RPC(c2mQueryServersSince, (U32 queryId, bool hostOnly, U32 listVersion));
+   TNL_DECLARE_RPC(m2cQueryServersDelta, (U32 queryId, U32 listVersion, bool fullList, Vector<IPAddress> ipList,
+                                          Vector<S32> serverIdList, Vector<S32> removedIdList, bool done));
+
    /// c2mRequestArrangedConnection is an RPC sent from the client to the master to request an arranged
    /// connection with the specified server address.  The internalAddress should be the client's own self-reported
    /// IP address.  The connectionParameters buffer will be sent without modification to the specified
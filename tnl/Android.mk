@@ -31,6 +31,7 @@ LOCAL_SRC_FILES := assert.cpp \
 	netObject.cpp \
 	netStringTable.cpp \
 	platform.cpp \
+	profiler.cpp \
 	random.cpp \
 	rpc.cpp \
 	symmetricCipher.cpp \
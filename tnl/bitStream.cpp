@@ -224,19 +224,6 @@ bool BitStream::testBit(U32 bitCount)
    return (*(getBuffer() + (bitCount >> 3)) & (1 << (bitCount & 0x7))) != 0;
 }
 
-bool BitStream::writeFlag(bool val)
-{
-   if(bitNum + 1 > maxWriteBitNum)
-      if(!resizeBits(1))
-         return false;
-   if(val)
-      *(getBuffer() + (bitNum >> 3)) |= (1 << (bitNum & 0x7));
-   else
-      *(getBuffer() + (bitNum >> 3)) &= ~(1 << (bitNum & 0x7));
-   bitNum++;
-   return (val);
-}
-
 bool BitStream::write(const ByteBuffer *theBuffer)
 {
    U32 size = theBuffer->getBufferSize();
@@ -255,22 +242,6 @@ bool BitStream::read(ByteBuffer *theBuffer)
    return read(size, theBuffer->getBuffer());
 }
 
-U32 BitStream::readInt(U8 bitCount)
-{
-   TNLAssert(bitCount <= 32, "bitCount must be less then 32, for 64 bit, use readInt64");
-   U32 ret = 0;
-   readBits(bitCount, &ret);
-   ret = convertLEndianToHost(ret);
-
-   // Clear bits that we didn't read.
-   if(bitCount == 32)
-      return ret;
-   else
-      ret &= (1 << bitCount) - 1;
-
-   return ret;
-}
-
 U64 BitStream::readInt64(U8 bitCount)
 {
    U64 ret = 0;
@@ -287,13 +258,6 @@ U64 BitStream::readInt64(U8 bitCount)
 }
 
 
-void BitStream::writeInt(U32 val, U8 bitCount)
-{
-   TNLAssert(bitCount <= 32, "bitCount must be less then 32, for 64 bit, use writeInt64");
-   val = convertHostToLEndian(val);
-   writeBits(bitCount, &val);
-}
-
 void BitStream::writeInt64(U64 val, U8 bitCount)
 {
    val = convertHostToLEndian(val);
@@ -311,30 +275,10 @@ F32 BitStream::readFloat(U8 bitCount)
    return readInt(bitCount) / F32((1 << bitCount) - 1);
 }
 
-void BitStream::writeSignedFloat(F32 f, U8 bitCount)
-{
-   writeSignedInt(S32(f * ((1 << (bitCount - 1)) - 1)), bitCount);
-}
-
-F32 BitStream::readSignedFloat(U8 bitCount)
-{
-   return readSignedInt(bitCount) / F32((1 << (bitCount - 1)) - 1);
-}
-
-void BitStream::writeSignedInt(S32 value, U8 bitCount)
-{
-   writeInt(value, bitCount);
-}
-
 #if ((-1) >> 1 != -1)
 #error "Signed right shift error, your compiler doesn't support signed right shift?"
 #endif
 
-S32 BitStream::readSignedInt(U8 bitCount)
-{
-   return S32(readInt(bitCount)) << (32 - bitCount) >> (32 - bitCount);
-}
-
 void BitStream::writeNormalVector(const Point3F& vec, U8 bitCount)
 {
    F32 phi   = F32(atan2(vec.x, vec.y) * FloatInversePi );
@@ -125,6 +125,12 @@ StringTableEntry ConnectionStringTable::readStringTableEntry(BitStream *stream)
    return mRemoteStringTable[index];
 }
 
+void ConnectionStringTable::forgetConfirmedEntries()
+{
+   for(U32 i = 0; i < EntryCount; i++)
+      mEntryTable[i].receiveConfirmed = false;
+}
+
 void ConnectionStringTable::packetReceived(PacketList *note)
 {
    PacketEntry *walk = note->stringHead;
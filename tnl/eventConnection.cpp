@@ -104,6 +104,17 @@ void EventConnection::clearRecvEvents()
       delete mTNLDataBuffer;
 }
 
+S32 EventConnection::getNextUnsentEventSeq()
+{
+   return mSendEventQueueHead ? mSendEventQueueHead->mSeqCount : mNextSendEventSeq;
+}
+
+void EventConnection::setNextRecvEventSeq(S32 seq)
+{
+   TNLAssert(mWaitSeqEvents == NULL, "Events already waiting for an earlier sequence number");
+   mNextRecvEventSeq = seq;
+}
+
 void EventConnection::writeConnectRequest(BitStream *stream)
 {
    Parent::writeConnectRequest(stream);
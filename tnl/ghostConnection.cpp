@@ -30,9 +30,16 @@
 #include "tnlNetBase.h"
 #include "tnlNetObject.h"
 #include "tnlNetInterface.h"
+#include "tnlProfiler.h"
+
+#include <algorithm>
 
 namespace TNL {
 
+// Each NetObject keeps a list of the GhostInfos that refer to it, one per connection.  NetInterface can scope and
+// write packets for several connections at once, so changes to these shared lists are serialized.
+static Mutex gObjectRefLock;
+
 GhostConnection::GhostConnection()
 {
    // ghost management data:
@@ -183,14 +190,14 @@ void GhostConnection::packetReceived(PacketNotify *pnotify)
    }
 }
 
-static S32 QSORT_CALLBACK prioritySort(const void *a, const void *b)
+// Orders the update queue so the highest priority ghost sits at the top of the heap
+struct GhostPriorityLess
 {
-   GhostInfo *ga = *((GhostInfo **) a);
-   GhostInfo *gb = *((GhostInfo **) b);
-
-   F32 ret = ga->priority - gb->priority;
-   return (ret < 0) ? -1 : ((ret > 0) ? 1 : 0);
-} 
+   bool operator()(const GhostInfo *a, const GhostInfo *b) const
+   {
+      return a->priority < b->priority;
+   }
+};
 
 void GhostConnection::prepareWritePacket()
 {
@@ -315,6 +322,8 @@ bool GhostConnection::isDataToTransmit()
 
 void GhostConnection::writePacket(BitStream *bstream, PacketNotify *pnotify)
 {
+   TNL_PROFILE_SCOPE("GhostConnection::writePacket");
+
    Parent::writePacket(bstream, pnotify);
    GhostPacketNotify *notify = static_cast<GhostPacketNotify *>(pnotify);
 
@@ -333,7 +342,7 @@ void GhostConnection::writePacket(BitStream *bstream, PacketNotify *pnotify)
 
    // 2. call scoped objects' priority functions if the flag set is nonzero
    //    A removed ghost is assumed to have a high priority
-   // 3. call updates based on sorted priority until the packet is
+   // 3. call updates in priority order until the packet is
    //    full.  set flags to zero for all updated objects
 
    GhostInfo *walk;
@@ -344,6 +353,8 @@ void GhostConnection::writePacket(BitStream *bstream, PacketNotify *pnotify)
          detachObject(mGhostArray[i]);    // Sets KillGhost flags, sets obj to NULL, among other things
    }
 
+   mUpdateQueue.clear();
+
    U32 maxIndex = 0;
    for(S32 i = mGhostZeroUpdateIndex - 1; i >= 0; i--)
    {
@@ -358,25 +369,25 @@ void GhostConnection::writePacket(BitStream *bstream, PacketNotify *pnotify)
          continue;
       }
       // Don't do any ghost processing on objects that are being killed
-      // or in the process of ghosting
+      // or in the process of ghosting -- they can't be sent this packet, so they stay out of the queue
       else if(!(walk->flags & (GhostInfo::KillingGhost | GhostInfo::Ghosting)))
       {
          if(walk->flags & GhostInfo::KillGhost)
             walk->priority = F32_MAX;
          else
             walk->priority = walk->obj->getUpdatePriority(this, walk->updateMask, walk->updateSkipCount);
+
+         mUpdateQueue.push_back(walk);
       }
       else
          walk->priority = 0;
    }
    GhostRef *updateList = NULL;
 
-   if(mGhostZeroUpdateIndex != 0)
-      qsort(&mGhostArray[0], mGhostZeroUpdateIndex, sizeof(GhostInfo *), prioritySort);
-
-   // Reset the array indices...
-   for(S32 i = mGhostZeroUpdateIndex - 1; i >= 0; i--)
-      mGhostArray[i]->arrayIndex = i;
+   // Heapify is linear; we then only pay log(n) for each ghost that actually makes it into the packet
+   GhostInfo **queue = mUpdateQueue.address();
+   S32 queueSize = mUpdateQueue.size();
+   std::make_heap(queue, queue + queueSize, GhostPriorityLess());
 
    U8 bitsNeededToSendMaxIndex = 0;
 
@@ -394,11 +405,12 @@ void GhostConnection::writePacket(BitStream *bstream, PacketNotify *pnotify)
    U32 count = 0;
    bool have_something_to_send = bstream->getBitPosition() >= 256;
 
-   for(S32 i = mGhostZeroUpdateIndex - 1; i >= 0 && !bstream->isFull(); i--)
+   while(queueSize > 0 && !bstream->isFull())
    {
-      GhostInfo *walk = mGhostArray[i];
-      if(walk->flags & (GhostInfo::KillingGhost | GhostInfo::Ghosting))
-         continue;
+      std::pop_heap(queue, queue + queueSize, GhostPriorityLess());
+      queueSize--;
+
+      GhostInfo *walk = queue[queueSize];
 
       U32 updateStart = bstream->getBitPosition();
       U32 updateMask = walk->updateMask;
@@ -427,14 +439,14 @@ void GhostConnection::writePacket(BitStream *bstream, PacketNotify *pnotify)
             S32 classId = walk->obj->getClassId(getNetClassGroup());
             TNLAssert(U32(classId) < mGhostClassCount, "classID out of range");
             bstream->writeInt(classId, mGhostClassBitSize);
-            NetObject::mIsInitialUpdate = true;
+            NetObject::setInitialUpdate(true);
          }
          // update the object
-         retMask = walk->obj->packUpdate(this, updateMask, bstream);
+         retMask = walk->obj->packSharedUpdate(this, updateMask, bstream);
 
-         if(NetObject::mIsInitialUpdate)
+         if(walk->flags & GhostInfo::NotYetGhosted)
          {
-            NetObject::mIsInitialUpdate = false;
+            NetObject::setInitialUpdate(false);
             walk->obj->getClassRep()->addInitialUpdate(bstream->getBitPosition() - startPos);
          }
          else
@@ -582,9 +594,9 @@ void GhostConnection::readPacket(BitStream *bstream)
 
             obj->onGhostAddBeforeUpdate(this);
 
-            NetObject::mIsInitialUpdate = true;
+            NetObject::setInitialUpdate(true);
             mLocalGhosts[index]->unpackUpdate(this, bstream);
-            NetObject::mIsInitialUpdate = false;
+            NetObject::setInitialUpdate(false);
             
             if(!obj->onGhostAdd(this))    // Runs addToGame() on some objects
             {
@@ -641,12 +653,14 @@ void GhostConnection::detachObject(GhostInfo *info)
    }
    if(info->obj)
    {
+      gObjectRefLock.lock();
       if(info->prevObjectRef)
          info->prevObjectRef->nextObjectRef = info->nextObjectRef;
       else
          info->obj->mFirstObjectRef = info->nextObjectRef;
       if(info->nextObjectRef)
          info->nextObjectRef->prevObjectRef = info->prevObjectRef;
+      gObjectRefLock.unlock();
 
       // Remove it from the lookup table
       U32 id = info->obj->getHashId();
@@ -785,11 +799,13 @@ void GhostConnection::objectInScope(NetObject *obj)
 
    giptr->connection = this;
 
+   gObjectRefLock.lock();
    giptr->nextObjectRef = obj->mFirstObjectRef;
    if(obj->mFirstObjectRef)
       obj->mFirstObjectRef->prevObjectRef = giptr;
    giptr->prevObjectRef = NULL;
    obj->mFirstObjectRef = giptr;
+   gObjectRefLock.unlock();
    
    giptr->nextLookupInfo = mGhostLookupTable[index];
    mGhostLookupTable[index] = giptr;
@@ -79,6 +79,12 @@ namespace HuffmanStringProcessor {
 //Vector<HuffmanStringProcessor::HuffLeaf> HuffmanStringProcessor::mHuffLeaves;
 
 
+void HuffmanStringProcessor::initialize()
+{
+   if(mTablesBuilt == false)
+      buildTables();
+}
+
 void HuffmanStringProcessor::buildTables()
 {
    TNLAssert(mTablesBuilt == false, "Cannot build tables twice!");
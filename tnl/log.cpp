@@ -26,6 +26,7 @@
 
 #include "tnlLog.h"
 #include "tnlDataChunker.h"
+#include "tnlThread.h"
 
 #include <time.h>
 #include <string.h>
@@ -100,13 +101,35 @@ void LogConsumer::logString(LogConsumer::MsgType msgType, std::string message)
 }
 
 
+bool LogConsumer::isMsgTypeWanted(LogConsumer::MsgType msgType)
+{
+   for(LogConsumer *walk = LogConsumer::getLinkedList(); walk; walk = walk->getNext())
+      if(walk->mMsgTypes & msgType)
+         return true;
+
+   return false;
+}
+
+
 // Create reusable buffer for our logging functions.  Make it big because when we use datadumper 
 // in a script, some messages can get very long
 static char msg[1024 * 8];
 
 
+// Connection packets are built on worker threads, and robot scripts may run on them too, so several threads can log
+// at once; this guards msg and keeps their lines from interleaving.  Built on first use so logging during static
+// initialization still works.
+static Mutex &getLogLock()
+{
+   static Mutex logLock;
+   return logLock;
+}
+
+
 void LogConsumer::logprintf(const char *format, ...)
 {
+   getLogLock().lock();
+
    va_list args; 
    va_start(args, format); 
 
@@ -117,6 +140,8 @@ void LogConsumer::logprintf(const char *format, ...)
    std::string message(msg);
 
    prepareAndLogString(message);
+
+   getLogLock().unlock();
 }
 
 
@@ -224,6 +249,13 @@ LogType *LogType::find(const char *name)
 // Logs to logfiles that have subscribed to specified message type
 void logprintf(LogConsumer::MsgType msgType, const char *format, ...)
 {
+   // Many of these are per-packet diagnostics that are normally turned off; don't bother formatting them.
+   // This also keeps the network code, which may run on several threads, away from the shared buffer.
+   if(!LogConsumer::isMsgTypeWanted(msgType))
+      return;
+
+   getLogLock().lock();
+
    va_list args; 
    va_start(args, format); 
 
@@ -234,12 +266,16 @@ void logprintf(LogConsumer::MsgType msgType, const char *format, ...)
    std::string message(msg);
 
    LogConsumer::logString(msgType, message);
+
+   getLogLock().unlock();
 }
 
 
 // Logs to general log
 void logprintf(const char *format, ...)
 {
+   getLogLock().lock();
+
    va_list args; 
    va_start(args, format); 
 
@@ -250,6 +286,8 @@ void logprintf(const char *format, ...)
    std::string message(msg);
 
    LogConsumer::logString(LogConsumer::All, message);
+
+   getLogLock().unlock();
 }
 
 
@@ -40,6 +40,7 @@ Vector<NetClassRep *> NetClassRep::mClassTable[NetClassGroupCount][NetClassTypeC
 U32 NetClassRep::mClassCRC[NetClassGroupCount] = {INITIAL_CRC_VALUE, };
 
 bool NetClassRep::mInitialized = false;
+bool NetClassRep::mRecordUpdateStats = true;
 
 NetClassRep::NetClassRep()
 {
@@ -80,6 +80,8 @@ NetConnection::NetConnection()
    mLastUpdateTime = 0;
    mRoundTripTime = 0;
    mSendDelayCredit = 0;
+   mLastScopeTime = 0;
+   mLastWriteTime = 0;
    mConnectionState = NotConnected;
    
    mNotifyQueueHead = NULL;
@@ -677,6 +679,17 @@ void NetConnection::handleNotify(U32 sequence, bool recvd)
 
 void NetConnection::checkPacketSend(bool force, U32 curTime)
 {
+   PacketStream stream;
+
+   if(buildPacket(force, curTime, &stream))
+      sendPacket(&stream);
+}
+
+bool NetConnection::buildPacket(bool force, U32 curTime, PacketStream *stream)
+{
+   mLastScopeTime = 0;
+   mLastWriteTime = 0;
+
    U32 delay = mCurrentPacketSendPeriod;
 
    if(!force)
@@ -689,14 +702,19 @@ void NetConnection::checkPacketSend(bool force, U32 curTime)
             delay *= (mLastSendSeq - mHighestAckedSeq - 5) * 2;
 
          if(curTime - mLastUpdateTime + mSendDelayCredit < delay)
-            return;
+            return false;
       
          mSendDelayCredit = curTime - (mLastUpdateTime + delay - mSendDelayCredit);
          if(mSendDelayCredit > 1000)
             mSendDelayCredit = 1000;
       }
    }
+
+   S64 startTime = Platform::getHighPrecisionTimerValue();
    prepareWritePacket();
+   S64 scopeEndTime = Platform::getHighPrecisionTimerValue();
+   mLastScopeTime = scopeEndTime - startTime;
+
    if(windowFull() || !isDataToTransmit())
    {
       // there is nothing to transmit, or the window is full
@@ -717,17 +735,22 @@ void NetConnection::checkPacketSend(bool force, U32 curTime)
          {         
             mLastSeqRecvdAck = mLastSeqRecvd;
             mLastAckTime = curTime;
-            sendAckPacket();
+
+            stream->resetForWrite(MaxPacketDataSize);
+            writeRawPacket(stream, AckPacket);
+            logprintf(LogConsumer::LogConnectionProtocol, "send ack %d", mLastSendSeq);
+            return true;
          }
       }
-      return;
+      return false;
    }
-   PacketStream stream(mCurrentPacketSendSize);
+   stream->resetForWrite(mCurrentPacketSendSize);
    mLastUpdateTime = curTime;
 
-   writeRawPacket(&stream, DataPacket);   
+   writeRawPacket(stream, DataPacket);   
+   mLastWriteTime = Platform::getHighPrecisionTimerValue() - scopeEndTime;
 
-   sendPacket(&stream);
+   return true;
 }
 
 bool NetConnection::windowFull()
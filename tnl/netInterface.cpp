@@ -33,6 +33,7 @@
 #include "tnlNetObject.h"
 #include "tnlClientPuzzle.h"
 #include "tnlCertificate.h"
+#include "tnlHuffmanStringProcessor.h"
 #include <tomcrypt.h>
 
 namespace TNL {
@@ -56,6 +57,31 @@ NetInterface::NetInterface(const Address &bindAddress) : mSocket(bindAddress)
       mConnectionHashTable[i] = NULL;
    mSendPacketList = NULL;
    mCurrentTime = Platform::getRealMilliseconds();
+
+   mPacketWorkers.mInterface = this;
+   resetPacketPhaseStats();
+
+   mRecvBuffers = (U8 *) malloc(PacketBatchSize * MaxPacketDataSize);
+   mSendBuffers = (U8 *) malloc(PacketBatchSize * MaxPacketDataSize);
+
+   for(S32 i = 0; i < PacketBatchSize; i++)
+   {
+      mRecvDatagrams[i].buffer = mRecvBuffers + i * MaxPacketDataSize;
+      mRecvDatagrams[i].capacity = MaxPacketDataSize;
+      mRecvDatagrams[i].size = 0;
+
+      mSendDatagrams[i].buffer = mSendBuffers + i * MaxPacketDataSize;
+      mSendDatagrams[i].capacity = MaxPacketDataSize;
+      mSendDatagrams[i].size = 0;
+   }
+
+   mQueuedSendCount = 0;
+   mQueueSends = false;
+
+   mHandshakeBuckets = (HandshakeBucket *) calloc(HandshakeBucketCount, sizeof(HandshakeBucket));
+   mHandshakeRate = DefaultHandshakeRate;
+   mHandshakeBurst = DefaultHandshakeBurst;
+   resetHandshakeStats();
 }
 
 NetInterface::~NetInterface()
@@ -73,6 +99,14 @@ NetInterface::~NetInterface()
       free(mSendPacketList);
       mSendPacketList = next;
    }
+
+   mPacketWorkers.stop();
+   for(S32 i = 0; i < mPendingPackets.size(); i++)
+      delete mPendingPackets[i];
+
+   free(mRecvBuffers);
+   free(mSendBuffers);
+   free(mHandshakeBuckets);
 }
 
 Address NetInterface::getFirstBoundInterfaceAddress()
@@ -104,9 +138,38 @@ void NetInterface::setPrivateKey(AsymmetricKey *theKey)
 
 NetError NetInterface::sendto(const Address &address, BitStream *stream)
 {
+   if(mQueueSends)
+   {
+      queueSend(address, stream->getBuffer(), stream->getBytePosition());
+      return NoError;
+   }
+
    return mSocket.sendto(address, stream->getBuffer(), stream->getBytePosition());
 }
 
+void NetInterface::queueSend(const Address &address, const U8 *buffer, S32 bufferSize)
+{
+   TNLAssert(U32(bufferSize) <= MaxPacketDataSize, "Packet too big!");
+
+   if(mQueuedSendCount == PacketBatchSize)
+      flushSends();
+
+   Socket::Datagram &datagram = mSendDatagrams[mQueuedSendCount++];
+
+   datagram.address = address;
+   datagram.size = bufferSize;
+   memcpy(datagram.buffer, buffer, bufferSize);
+}
+
+void NetInterface::flushSends()
+{
+   if(mQueuedSendCount == 0)
+      return;
+
+   mSocket.sendtoBatch(mSendDatagrams, mQueuedSendCount);
+   mQueuedSendCount = 0;
+}
+
 void NetInterface::sendtoDelayed(const Address *address, NetConnection *receiveTo, BitStream *stream, U32 millisecondDelay)
 {
    U32 dataSize = stream->getBytePosition();
@@ -352,9 +415,53 @@ void NetInterface::processConnections()
       mSendPacketList = next;
    }
 
-   NetObject::collapseDirtyList(); // collapse all the mask bits...
-   for(S32 i = 0; i < mConnectionList.size(); i++)
-      mConnectionList[i]->checkPacketSend(false, getCurrentTime());
+   U32 dirtyObjects, dirtyRefs;
+   NetObject::collapseDirtyList(&dirtyObjects, &dirtyRefs); // collapse all the mask bits...
+   mPacketPhaseStats.dirtyObjects += dirtyObjects;
+   mPacketPhaseStats.dirtyRefs += dirtyRefs;
+
+   // Nothing changes while we write packets, so objects can pack an update once and share it between connections
+   NetObject::beginSharedUpdates();
+
+   // Game packets go out together at the end of the pass
+   mQueueSends = true;
+
+   if(mPacketWorkers.getWorkerCount() && mConnectionList.size() > 1)
+      buildPacketsInParallel();
+   else
+   {
+      S64 buildStart = Platform::getHighPrecisionTimerValue();
+      S64 sendTime = 0;
+      PacketStream stream;
+
+      for(S32 i = 0; i < mConnectionList.size(); i++)
+      {
+         NetConnection *conn = mConnectionList[i];
+
+         if(conn->buildPacket(false, getCurrentTime(), &stream))
+         {
+            S64 sendStart = Platform::getHighPrecisionTimerValue();
+            conn->sendPacket(&stream);
+            sendTime += Platform::getHighPrecisionTimerValue() - sendStart;
+            mPacketPhaseStats.packetsSent++;
+         }
+
+         mPacketPhaseStats.scopeMs += Platform::getHighPrecisionMilliseconds(conn->mLastScopeTime);
+         mPacketPhaseStats.writeMs += Platform::getHighPrecisionMilliseconds(conn->mLastWriteTime);
+      }
+
+      S64 flushStart = Platform::getHighPrecisionTimerValue();
+      flushSends();
+      S64 flushEnd = Platform::getHighPrecisionTimerValue();
+
+      mPacketPhaseStats.buildMs += Platform::getHighPrecisionMilliseconds(flushStart - buildStart - sendTime);
+      mPacketPhaseStats.sendMs += Platform::getHighPrecisionMilliseconds(sendTime + flushEnd - flushStart);
+   }
+
+   mQueueSends = false;
+   mPacketPhaseStats.processCount++;
+
+   NetObject::endSharedUpdates();
 
    if(U32(getCurrentTime() - mLastTimeoutCheckTime) > TimeoutCheckInterval)
    {
@@ -447,15 +554,25 @@ void NetInterface::processConnections()
 
 void NetInterface::checkIncomingPackets()
 {
-   PacketStream stream;
-   NetError error;
-   Address sourceAddress;
-
    mCurrentTime = Platform::getRealMilliseconds();
 
-   // read out all the available packets:
-   while((error = stream.recvfrom(mSocket, &sourceAddress)) == NoError)
-      processPacket(sourceAddress, &stream);
+   // read out all the available packets, a batch at a time:
+   for(;;)
+   {
+      S32 count = mSocket.recvfromBatch(mRecvDatagrams, PacketBatchSize);
+
+      for(S32 i = 0; i < count; i++)
+      {
+         BitStream stream(mRecvDatagrams[i].buffer, mRecvDatagrams[i].size);
+         stream.setMaxSizes(mRecvDatagrams[i].size, 0);
+         stream.reset();
+
+         processPacket(mRecvDatagrams[i].address, &stream);
+      }
+
+      if(count < PacketBatchSize)      // Nothing more waiting
+         break;
+   }
 }
 
 void NetInterface::processPacket(const Address &sourceAddress, BitStream *pStream)
@@ -565,11 +682,16 @@ void NetInterface::handleConnectChallengeRequest(const Address &addr, BitStream
    if(!mAllowConnections)
       return;
 
+   // These come from addresses we haven't verified, so don't let them turn us into a packet reflector
+   if(!allowHandshakePacket(addr))
+      return;
+
    Nonce clientNonce;
    clientNonce.read(stream);
    bool wantsKeyExchange = stream->readFlag();
    bool wantsCertificate = stream->readFlag();
 
+   mHandshakeStats.challengesAnswered++;
    sendConnectChallengeResponse(addr, clientNonce, wantsKeyExchange, wantsCertificate);
 }
 
@@ -746,8 +868,12 @@ void NetInterface::handleConnectRequest(const Address &address, BitStream *strea
    theParams.mServerNonce.read(stream);
    stream->read(&theParams.mClientIdentity);
 
+   // The identity token is our stateless cookie: if it doesn't match, this isn't a reply to our challenge
    if(theParams.mClientIdentity != computeClientIdentityToken(address, theParams.mNonce))
+   {
+      mHandshakeStats.badIdentityTokens++;
       return;
+   }
 
    stream->read(&theParams.mPuzzleDifficulty);
    stream->read(&theParams.mPuzzleSolution);
@@ -768,6 +894,10 @@ void NetInterface::handleConnectRequest(const Address &address, BitStream *strea
       }
    }
 
+   // Everything from here on costs us something
+   if(!allowHandshakePacket(address))
+      return;
+
    // Check the puzzle solution
    ClientPuzzleManager::ErrorCode result = mPuzzleManager.checkSolution(
       theParams.mPuzzleSolution, theParams.mNonce, theParams.mServerNonce,
@@ -839,6 +969,8 @@ void NetInterface::handleConnectRequest(const Address &address, BitStream *strea
    conn->setConnectionState(NetConnection::Connected);
    conn->onConnectionEstablished();
    sendConnectAccept(conn);
+
+   mHandshakeStats.connectionsAccepted++;
 }
 
 //-----------------------------------------------------------------------------
@@ -1390,4 +1522,153 @@ void NetInterface::handleConnectionError(NetConnection *theConnection, const cha
    disconnect(theConnection, NetConnection::ReasonError, errorString);
 }
 
+//-----------------------------------------------------------------------------
+// Handshake flood protection
+//-----------------------------------------------------------------------------
+
+bool NetInterface::allowHandshakePacket(const Address &address)
+{
+   if(mHandshakeRate == 0)
+      return true;
+
+   // Salted, so nobody can pick an address that shares a bucket with someone they want to lock out
+   U32 salt;
+   memcpy(&salt, mRandomHashData, sizeof(salt));
+
+   U32 index = address.netNum[0] ^ salt;
+   index ^= index >> 16;
+   index *= 0x45d9f3b;
+   index ^= index >> 16;
+
+   HandshakeBucket &bucket = mHandshakeBuckets[index & (HandshakeBucketCount - 1)];
+
+   U32 cost = 1000 / mHandshakeRate;
+   U32 maxCredit = cost * mHandshakeBurst;
+
+   // Buckets start out empty with a lastTime of 0, so an address we've never heard from gets a full bucket
+   U32 elapsed = mCurrentTime - bucket.lastTime;
+   bucket.credit = (elapsed >= maxCredit || bucket.credit + elapsed >= maxCredit) ? maxCredit : bucket.credit + elapsed;
+   bucket.lastTime = mCurrentTime;
+
+   if(bucket.credit < cost)
+   {
+      mHandshakeStats.packetsThrottled++;
+      return false;
+   }
+
+   bucket.credit -= cost;
+   return true;
+}
+
+void NetInterface::setHandshakeRateLimit(U32 packetsPerSecond, U32 burst)
+{
+   mHandshakeRate = min(packetsPerSecond, U32(1000));    // Cost is in whole milliseconds
+   mHandshakeBurst = max(burst, U32(1));
+
+   memset(mHandshakeBuckets, 0, HandshakeBucketCount * sizeof(HandshakeBucket));
+}
+
+void NetInterface::resetHandshakeStats()
+{
+   mHandshakeStats.challengesAnswered = 0;
+   mHandshakeStats.packetsThrottled = 0;
+   mHandshakeStats.badIdentityTokens = 0;
+   mHandshakeStats.connectionsAccepted = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Parallel packet building
+//-----------------------------------------------------------------------------
+
+void NetInterface::PacketWorkerPool::doWork(U32 index, U32 shareCount)
+{
+   mInterface->buildPackets(index, shareCount);
+}
+
+void NetInterface::setPacketWorkerCount(U32 count)
+{
+   mPacketWorkers.stop();
+
+   if(count == 0)
+      return;
+
+   // Build the Huffman tables now, rather than on a worker's first string write
+   HuffmanStringProcessor::initialize();
+
+   // Worker n handles connections n, n + step, n + 2 * step... where step is the worker count plus one;
+   // the main thread takes the share starting at connection 0
+   U32 started = mPacketWorkers.start(count);
+
+   if(started < count)
+      logprintf(LogConsumer::LogError, "Could only start %d of %d packet worker threads", started, count);
+}
+
+void NetInterface::buildPackets(S32 firstConnection, S32 step)
+{
+   for(S32 i = firstConnection; i < mPacketConnections.size(); i += step)
+      mPendingPacketReady[i] = mPacketConnections[i]->buildPacket(false, mCurrentTime, mPendingPackets[i]);
+}
+
+void NetInterface::buildPacketsInParallel()
+{
+   // Work from a copy of the connection list, so connections dropped while sending can't shift it under us
+   mPacketConnections.clear();
+   for(S32 i = 0; i < mConnectionList.size(); i++)
+      mPacketConnections.push_back(mConnectionList[i]);
+
+   while(mPendingPackets.size() < mPacketConnections.size())
+   {
+      mPendingPackets.push_back(new PacketStream);
+      mPendingPacketReady.push_back(0);
+   }
+
+   // Anything shared between connections that packet writing can touch needs protecting while workers run
+   StringTable::setThreadSafe(true);
+   NetClassRep::setRecordUpdateStats(false);
+
+   S64 buildStart = Platform::getHighPrecisionTimerValue();
+
+   mPacketWorkers.run();
+
+   S64 sendStart = Platform::getHighPrecisionTimerValue();
+
+   NetClassRep::setRecordUpdateStats(true);
+   StringTable::setThreadSafe(false);
+
+   // Sends happen in connection order, on this thread, exactly as they would have without workers
+   for(S32 i = 0; i < mPacketConnections.size(); i++)
+   {
+      NetConnection *conn = mPacketConnections[i];
+
+      if(mPendingPacketReady[i])
+      {
+         conn->sendPacket(mPendingPackets[i]);
+         mPacketPhaseStats.packetsSent++;
+      }
+
+      mPacketPhaseStats.scopeMs += Platform::getHighPrecisionMilliseconds(conn->mLastScopeTime);
+      mPacketPhaseStats.writeMs += Platform::getHighPrecisionMilliseconds(conn->mLastWriteTime);
+   }
+
+   mPacketConnections.clear();
+   flushSends();
+
+   S64 sendEnd = Platform::getHighPrecisionTimerValue();
+
+   mPacketPhaseStats.buildMs += Platform::getHighPrecisionMilliseconds(sendStart - buildStart);
+   mPacketPhaseStats.sendMs += Platform::getHighPrecisionMilliseconds(sendEnd - sendStart);
+}
+
+void NetInterface::resetPacketPhaseStats()
+{
+   mPacketPhaseStats.processCount = 0;
+   mPacketPhaseStats.packetsSent = 0;
+   mPacketPhaseStats.scopeMs = 0;
+   mPacketPhaseStats.writeMs = 0;
+   mPacketPhaseStats.buildMs = 0;
+   mPacketPhaseStats.sendMs = 0;
+   mPacketPhaseStats.dirtyObjects = 0;
+   mPacketPhaseStats.dirtyRefs = 0;
+}
+
 };
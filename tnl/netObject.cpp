@@ -33,7 +33,14 @@ namespace TNL {
 
 GhostConnection *NetObject::mRPCSourceConnection = NULL;
 GhostConnection *NetObject::mRPCDestConnection = NULL;
-bool NetObject::mIsInitialUpdate = false;
+ThreadStorage NetObject::mIsInitialUpdate;
+
+U32 NetObject::mCurrentSharedUpdatePass = 0;
+Mutex NetObject::mSharedUpdateLock;
+U32 NetObject::mSharedUpdateHits = 0;
+U32 NetObject::mSharedUpdateMisses = 0;
+
+static U32 gLastSharedUpdatePass = 0;
 
 NetObject::NetObject()
 {
@@ -43,6 +50,10 @@ NetObject::NetObject()
    mPrevDirtyList = NULL;
    mNextDirtyList = NULL;
    mDirtyMaskBits = 0;
+   mSharedUpdatePass = 0;
+   mSharedUpdateMask = 0;
+   mSharedUpdateRetMask = 0;
+   mSharedUpdateBitCount = 0;
 }
 
 // Copy constructor
@@ -53,6 +64,10 @@ NetObject::NetObject(const NetObject &t)
    mPrevDirtyList = NULL;
    mNextDirtyList = NULL;
    mDirtyMaskBits = 0;
+   mSharedUpdatePass = 0;
+   mSharedUpdateMask = 0;
+   mSharedUpdateRetMask = 0;
+   mSharedUpdateBitCount = 0;
 }
 
 
@@ -90,6 +105,9 @@ void NetObject::setMaskBits(U32 orMask)
    }
    mDirtyMaskBits |= orMask;
    TNLAssert(mDirtyMaskBits == 0 || (mPrevDirtyList != NULL || mNextDirtyList != NULL || mDirtyList == this), "Invalid dirty list state.");
+
+   // Whatever we cached no longer describes this object
+   mSharedUpdatePass = 0;
 }
 
 void NetObject::clearMaskBits(U32 orMask)
@@ -121,11 +139,10 @@ void NetObject::clearMaskBits(U32 orMask)
    }
 }
 
-void NetObject::collapseDirtyList()
+void NetObject::collapseDirtyList(U32 *dirtyObjects, U32 *propagatedRefs)
 {
-   Vector<NetObject *> tempV;
-   for(NetObject *t = mDirtyList; t; t = t->mNextDirtyList)
-      tempV.push_back(t);
+   U32 objectCount = 0;
+   U32 refCount = 0;
 
    for(NetObject *obj = mDirtyList; obj; )
    {
@@ -138,6 +155,8 @@ void NetObject::collapseDirtyList()
 
       if(orMask)
       {
+         objectCount++;
+
          for(GhostInfo *walk = obj->mFirstObjectRef; walk; walk = walk->nextObjectRef)
          {
             if(!walk->updateMask)
@@ -147,15 +166,18 @@ void NetObject::collapseDirtyList()
             }
             else
                walk->updateMask |= orMask;
+
+            refCount++;
          }
       }
       obj = next;
    }
    mDirtyList = NULL;
-   for(S32 i = 0; i < tempV.size(); i++)
-   {
-      TNLAssert(tempV[i]->mNextDirtyList == NULL && tempV[i]->mPrevDirtyList == NULL && tempV[i]->mDirtyMaskBits == 0, "Error in collapse");
-   }
+
+   if(dirtyObjects)
+      *dirtyObjects = objectCount;
+   if(propagatedRefs)
+      *propagatedRefs = refCount;
 }
 
 bool NetObject::onGhostAdd(GhostConnection *theConnection)
@@ -194,6 +216,91 @@ void NetObject::unpackUpdate(GhostConnection*, BitStream*)
    // Do nothing
 }
 
+U32 NetObject::getConnectionDependentMask(GhostConnection *)
+{
+   return 0xFFFFFFFF;
+}
+
+U32 NetObject::packSharedUpdate(GhostConnection *connection, U32 updateMask, BitStream *stream)
+{
+   if(!mCurrentSharedUpdatePass || isInitialUpdate() || (updateMask & getConnectionDependentMask(connection)))
+      return packUpdate(connection, updateMask, stream);
+
+   mSharedUpdateLock.lock();
+
+   if(mSharedUpdatePass == mCurrentSharedUpdatePass && mSharedUpdateMask == updateMask)
+   {
+      stream->writeBits(mSharedUpdateBitCount, mSharedUpdateBits.address());
+      U32 retMask = mSharedUpdateRetMask;
+      mSharedUpdateHits++;
+
+      mSharedUpdateLock.unlock();
+      return retMask;
+   }
+
+   mSharedUpdateLock.unlock();
+
+   U32 startPos = stream->getBitPosition();
+   U32 retMask = packUpdate(connection, updateMask, stream);
+
+   // Overran the packet -- it will be rewound, and what's in there now may not be all of it
+   if(!stream->isValid())
+      return retMask;
+
+   U32 bitCount = stream->getBitPosition() - startPos;
+
+   BitStream packed(stream->getBuffer(), (stream->getBitPosition() + 7) >> 3);
+   packed.setBitPosition(startPos);
+
+   mSharedUpdateLock.lock();
+
+   mSharedUpdateBits.resize((bitCount + 7) >> 3);
+   packed.readBits(bitCount, mSharedUpdateBits.address());
+
+   mSharedUpdatePass = mCurrentSharedUpdatePass;
+   mSharedUpdateMask = updateMask;
+   mSharedUpdateRetMask = retMask;
+   mSharedUpdateBitCount = bitCount;
+   mSharedUpdateMisses++;
+
+   mSharedUpdateLock.unlock();
+
+   return retMask;
+}
+
+void NetObject::beginSharedUpdates()
+{
+   TNLAssert(mCurrentSharedUpdatePass == 0, "Shared update passes don't nest");
+
+   // Skip 0, which means nothing is cached
+   gLastSharedUpdatePass++;
+   if(gLastSharedUpdatePass == 0)
+      gLastSharedUpdatePass++;
+
+   mCurrentSharedUpdatePass = gLastSharedUpdatePass;
+}
+
+void NetObject::endSharedUpdates()
+{
+   mCurrentSharedUpdatePass = 0;
+}
+
+void NetObject::getSharedUpdateStats(U32 &hits, U32 &misses, bool reset)
+{
+   mSharedUpdateLock.lock();
+
+   hits = mSharedUpdateHits;
+   misses = mSharedUpdateMisses;
+
+   if(reset)
+   {
+      mSharedUpdateHits = 0;
+      mSharedUpdateMisses = 0;
+   }
+
+   mSharedUpdateLock.unlock();
+}
+
 void NetObject::performScopeQuery(GhostConnection *connection)
 {
    // default behavior - since we have no idea here about
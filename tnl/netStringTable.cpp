@@ -30,6 +30,7 @@
 #include "tnlNetStringTable.h"
 #include "tnlDataChunker.h"
 #include "tnlNetInterface.h"
+#include "tnlThread.h"
 
 namespace TNL {
 
@@ -68,6 +69,18 @@ U32 mItemCount = 0; ///< number of strings in the table
 DataChunker *mMemPool = NULL; ///< memory pool from which string table data is allocated
 U32 mFreeStringDataSize = 0; ///< number of bytes freed by deallocated strings.  When this number exceeds CompactThreshold, the table is compacted.
 
+bool mThreadSafe = false; ///< when set, table operations are serialized with mLock
+S32 mThreadSafeCount = 0; ///< outstanding setThreadSafe(true) calls
+Mutex mLock;
+
+/// Holds mLock for its lifetime, if the table is in thread safe mode.
+struct TableLock
+{
+   bool mLocked;
+   TableLock() { mLocked = mThreadSafe; if(mLocked) mLock.lock(); }
+   ~TableLock() { if(mLocked) mLock.unlock(); }
+};
+
 // a little note about the free list...
 // the free list is essentially an index linked list encoded in the node
 // list.  The first entry in the list is mNodeListFreeEntry.
@@ -178,6 +191,20 @@ void destroy()
 
 //--------------------------------------
 
+//--------------------------------------
+void setThreadSafe(bool threadSafe)
+{
+   if(threadSafe)
+      mThreadSafeCount++;
+   else
+   {
+      TNLAssert(mThreadSafeCount > 0, "Unbalanced StringTable::setThreadSafe(false)!");
+      mThreadSafeCount--;
+   }
+
+   mThreadSafe = (mThreadSafeCount > 0);
+}
+
 //--------------------------------------
 
 StringTableEntryId insert(const char* val, const bool caseSens)
@@ -230,6 +257,7 @@ StringTableEntryId insertn(const char* val, S32 len, const bool caseSens)
 {
    if(!val || !*val || len == 0)
       return 0;
+   TableLock lock;
    if(!mBuckets)
       init();
    StringTableEntryId *walk;
@@ -293,6 +321,7 @@ StringTableEntryId insertn(const char* val, S32 len, const bool caseSens)
 //--------------------------------------
 StringTableEntryId lookup(const char* val, const bool  caseSens)
 {
+   TableLock lock;
    StringTableEntryId *walk;
    Node *stringNode;
    U32 key = hashString(val);
@@ -311,6 +340,7 @@ StringTableEntryId lookup(const char* val, const bool  caseSens)
 //--------------------------------------
 StringTableEntryId lookupn(const char* val, S32 len, const bool  caseSens)
 {
+   TableLock lock;
    StringTableEntryId *walk;
    Node *stringNode;
    U32 key = hashStringn(val, len);
@@ -396,11 +426,13 @@ void compact()
 
 void incRef(StringTableEntryId index)
 {
-    mNodeList[index]->refCount++;
+   TableLock lock;
+   mNodeList[index]->refCount++;
 }
 
 void decRef(StringTableEntryId index)
 {
+   TableLock lock;
    Node *theNode = mNodeList[index];
    if(--theNode->refCount)
       return;
@@ -434,6 +466,7 @@ const char *getString(StringTableEntryId index)
 {
    if(!index)
       return "";
+   TableLock lock;
 
    return mNodeList[index]->stringData;
 }
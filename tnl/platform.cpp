@@ -42,6 +42,7 @@
 #include <unistd.h>
 #include <signal.h>
 #include <sys/time.h>
+#include <time.h>
 
 #endif
 
@@ -414,6 +415,7 @@ U32 x86UNIXGetTickCountMicro()
    return uSecs;
 }
 
+// Monotonic, in microseconds, where the system supports it; otherwise milliseconds from the wall clock
 class UnixTimer
 {
    public:
@@ -422,11 +424,16 @@ class UnixTimer
       }
       S64 getCurrentTime()
       {
-         return x86UNIXGetTickCount();
+#ifdef CLOCK_MONOTONIC
+         timespec t;
+         if(clock_gettime(CLOCK_MONOTONIC, &t) == 0)
+            return S64(t.tv_sec) * 1000000 + t.tv_nsec / 1000;
+#endif
+         return S64(x86UNIXGetTickCount()) * 1000;
       }
       F64 convertToMS(S64 delta)
       {
-         return F64(delta);
+         return F64(delta) / 1000;
       }
 };
 
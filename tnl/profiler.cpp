@@ -0,0 +1,382 @@
+//-----------------------------------------------------------------------------------
+//
+//   Torque Network Library
+//   Copyright (C) 2004 GarageGames.com, Inc.
+//   For more information see http://www.opentnl.org
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   For use in products that are not compatible with the terms of the GNU
+//   General Public License, alternative licensing options are available
+//   from GarageGames.com.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//------------------------------------------------------------------------------------
+
+#include "tnlProfiler.h"
+#include "tnlThread.h"
+#include "tnlPlatform.h"
+#include "tnlAssert.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace TNL
+{
+
+/// The finished scopes of a single thread.  Only the owning thread writes events, so the mutex is only ever contended
+/// while somebody is reading them out.
+struct ThreadEvents
+{
+   struct Event
+   {
+      const char *name;
+      S64 start;
+      S64 end;
+      U32 depth;
+   };
+
+   Mutex mutex;
+   Vector<Event> events;   // Ring buffer
+   U32 next;               // Where the next event goes
+   U32 count;              // Events held so far, up to events.size()
+   U32 depth;              // Scopes open on the owning thread right now; only touched by that thread
+   U32 index;              // Tells threads apart in traces
+   bool released;          // Owning thread is done with us, another can take over
+};
+
+
+bool Profiler::mEnabled = false;
+
+static ThreadStorage gThreadEventsStorage;
+static Mutex gThreadListMutex;
+static Vector<ThreadEvents *> gThreadList;
+static U32 gEventsPerThread = Profiler::DefaultEventsPerThread;
+
+
+static ThreadEvents *getThreadEvents()
+{
+   ThreadEvents *events = (ThreadEvents *) gThreadEventsStorage.get();
+   if(events)
+      return events;
+
+   gThreadListMutex.lock();
+
+   for(S32 i = 0; i < gThreadList.size(); i++)
+      if(gThreadList[i]->released)
+      {
+         events = gThreadList[i];
+         events->released = false;
+         events->depth = 0;
+         break;
+      }
+
+   if(!events)
+   {
+      events = new ThreadEvents;
+      events->events.resize(gEventsPerThread);
+      events->next = 0;
+      events->count = 0;
+      events->depth = 0;
+      events->index = gThreadList.size();
+      events->released = false;
+
+      gThreadList.push_back(events);
+   }
+
+   gThreadListMutex.unlock();
+
+   gThreadEventsStorage.set(events);
+   return events;
+}
+
+
+void Profiler::setEnabled(bool enabled)
+{
+   mEnabled = enabled;
+}
+
+
+void Profiler::clear()
+{
+   gThreadListMutex.lock();
+
+   for(S32 i = 0; i < gThreadList.size(); i++)
+   {
+      gThreadList[i]->mutex.lock();
+      gThreadList[i]->next = 0;
+      gThreadList[i]->count = 0;
+      gThreadList[i]->mutex.unlock();
+   }
+
+   gThreadListMutex.unlock();
+}
+
+
+void Profiler::setEventsPerThread(U32 count)
+{
+   TNLAssert(count > 0, "Need room for at least one event!");
+
+   gThreadListMutex.lock();
+
+   gEventsPerThread = count;
+
+   for(S32 i = 0; i < gThreadList.size(); i++)
+   {
+      gThreadList[i]->mutex.lock();
+      gThreadList[i]->events.resize(count);
+      gThreadList[i]->next = 0;
+      gThreadList[i]->count = 0;
+      gThreadList[i]->mutex.unlock();
+   }
+
+   gThreadListMutex.unlock();
+}
+
+
+U32 Profiler::getEventsPerThread()
+{
+   gThreadListMutex.lock();
+   U32 count = gEventsPerThread;
+   gThreadListMutex.unlock();
+
+   return count;
+}
+
+
+void Profiler::releaseThread()
+{
+   ThreadEvents *events = (ThreadEvents *) gThreadEventsStorage.get();
+   if(!events)
+      return;
+
+   gThreadListMutex.lock();
+   events->released = true;
+   gThreadListMutex.unlock();
+
+   gThreadEventsStorage.set(NULL);
+}
+
+// Worker threads record scopes too, and each would otherwise keep its buffer after it ends
+static Thread::ExitFunctionRegistration gReleaseProfilerEvents(&Profiler::releaseThread);
+
+
+ThreadEvents *Profiler::begin(S64 &start, U32 &depth)
+{
+   ThreadEvents *events = getThreadEvents();
+
+   depth = events->depth++;
+   start = Platform::getHighPrecisionTimerValue();
+
+   return events;
+}
+
+
+void Profiler::end(ThreadEvents *events, const char *name, S64 start, U32 depth)
+{
+   S64 endTime = Platform::getHighPrecisionTimerValue();
+
+   events->depth = depth;
+
+   events->mutex.lock();
+
+   ThreadEvents::Event &event = events->events[events->next];
+   event.name = name;
+   event.start = start;
+   event.end = endTime;
+   event.depth = depth;
+
+   U32 size = events->events.size();
+
+   events->next = (events->next + 1) % size;
+   if(events->count < size)
+      events->count++;
+
+   events->mutex.unlock();
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+struct CollectedEvent
+{
+   const char *name;
+   S64 start;
+   S64 end;
+   U32 depth;
+   U32 thread;
+   F64 ms;
+};
+
+
+// Timer ticks convert to milliseconds linearly, so work out the rate once rather than asking for every event
+static F64 getMsPerTick()
+{
+   const S64 Ticks = 1 << 24;
+   return Platform::getHighPrecisionMilliseconds(Ticks) / F64(Ticks);
+}
+
+
+// Copies out every event, on any thread, that finished within the last lastMs milliseconds
+static void collectEvents(U32 lastMs, Vector<CollectedEvent> &collected)
+{
+   F64 msPerTick = getMsPerTick();
+   S64 now = Platform::getHighPrecisionTimerValue();
+   S64 cutoff = now - S64(lastMs / msPerTick);
+
+   collected.clear();
+
+   gThreadListMutex.lock();
+
+   for(S32 i = 0; i < gThreadList.size(); i++)
+   {
+      ThreadEvents *events = gThreadList[i];
+      events->mutex.lock();
+
+      // Oldest first, so traces come out in order for each thread
+      U32 size = events->events.size();
+      U32 first = (events->next + size - events->count) % size;
+
+      for(U32 j = 0; j < events->count; j++)
+      {
+         const ThreadEvents::Event &event = events->events[(first + j) % size];
+         if(event.end < cutoff)
+            continue;
+
+         CollectedEvent e;
+         e.name = event.name;
+         e.start = event.start;
+         e.end = event.end;
+         e.depth = event.depth;
+         e.thread = events->index;
+         e.ms = F64(event.end - event.start) * msPerTick;
+
+         collected.push_back(e);
+      }
+
+      events->mutex.unlock();
+   }
+
+   gThreadListMutex.unlock();
+}
+
+
+// Sorts by name, then duration, for the benefit of getPhaseStats()
+static S32 QSORT_CALLBACK compareByNameAndDuration(CollectedEvent *a, CollectedEvent *b)
+{
+   S32 cmp = strcmp(a->name, b->name);
+   if(cmp != 0)
+      return cmp;
+
+   return a->ms < b->ms ? -1 : a->ms > b->ms ? 1 : 0;
+}
+
+
+// Nearest rank; durations must be sorted
+static F64 getPercentile(const CollectedEvent *sorted, S32 count, U32 percent)
+{
+   S32 rank = (count * percent + 99) / 100;
+   return sorted[rank > 0 ? rank - 1 : 0].ms;
+}
+
+
+void Profiler::getPhaseStats(U32 lastMs, Vector<PhaseStats> &stats)
+{
+   Vector<CollectedEvent> collected;
+   collectEvents(lastMs, collected);
+
+   collected.sort(compareByNameAndDuration);
+
+   stats.clear();
+
+   S32 runStart = 0;
+   for(S32 i = 1; i <= collected.size(); i++)
+   {
+      if(i < collected.size() && strcmp(collected[i].name, collected[runStart].name) == 0)
+         continue;
+
+      const CollectedEvent *run = collected.address() + runStart;
+      S32 count = i - runStart;
+
+      PhaseStats phase;
+      phase.name = run[0].name;
+      phase.count = count;
+      phase.totalMs = 0;
+      for(S32 j = 0; j < count; j++)
+         phase.totalMs += run[j].ms;
+      phase.p50Ms = getPercentile(run, count, 50);
+      phase.p99Ms = getPercentile(run, count, 99);
+      phase.maxMs = run[count - 1].ms;
+
+      stats.push_back(phase);
+      runStart = i;
+   }
+}
+
+
+// Scope names are ours, but may as well not let a stray quote break the whole file
+static void writeJsonString(FILE *f, const char *str)
+{
+   fputc('"', f);
+
+   for(; *str; str++)
+   {
+      if(*str == '"' || *str == '\\')
+         fputc('\\', f);
+
+      if(U8(*str) >= ' ')
+         fputc(*str, f);
+   }
+
+   fputc('"', f);
+}
+
+
+bool Profiler::writeChromeTrace(const char *filename, U32 lastMs)
+{
+   Vector<CollectedEvent> collected;
+   collectEvents(lastMs, collected);
+
+   FILE *f = fopen(filename, "w");
+   if(!f)
+      return false;
+
+   // Timestamps are microseconds from the start of the earliest scope we're writing
+   S64 origin = 0;
+   for(S32 i = 0; i < collected.size(); i++)
+      if(i == 0 || collected[i].start < origin)
+         origin = collected[i].start;
+
+   F64 msPerTick = getMsPerTick();
+
+   fprintf(f, "{\"traceEvents\":[");
+
+   for(S32 i = 0; i < collected.size(); i++)
+   {
+      const CollectedEvent &e = collected[i];
+
+      fprintf(f, "%s\n{\"name\":", i == 0 ? "" : ",");
+      writeJsonString(f, e.name);
+      fprintf(f, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"depth\":%u}}",
+              F64(e.start - origin) * msPerTick * 1000, e.ms * 1000, e.thread, e.depth);
+   }
+
+   fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+   bool ok = !ferror(f);
+   return fclose(f) == 0 && ok;
+}
+
+};
@@ -28,6 +28,7 @@
 #include "tnl.h"
 #include "tnlRandom.h"
 #include "tnlJournal.h"
+#include "tnlThread.h"
 
 namespace TNL {
 
@@ -37,6 +38,18 @@ static bool initialized = false;
 static prng_state prng;
 static U32 entropyAdded = 0;
 
+static bool threadSafe = false;     ///< when set, reads and entropy updates are serialized with lock
+static S32 threadSafeCount = 0;     ///< outstanding setThreadSafe(true) calls
+static Mutex lock;
+
+/// Holds lock for its lifetime, if we're in thread safe mode.
+struct RandomLock
+{
+   bool mLocked;
+   RandomLock() { mLocked = threadSafe; if(mLocked) lock.lock(); }
+   ~RandomLock() { if(mLocked) lock.unlock(); }
+};
+
 static void initialize()
 {
    initialized = true;
@@ -44,6 +57,25 @@ static void initialize()
    yarrow_ready(&prng);
 }
 
+void setThreadSafe(bool safe)
+{
+   if(safe)
+   {
+      // Set up now, so threads don't race to do it on their first read
+      if(!initialized)
+         initialize();
+
+      threadSafeCount++;
+   }
+   else
+   {
+      TNLAssert(threadSafeCount > 0, "Unbalanced Random::setThreadSafe(false)!");
+      threadSafeCount--;
+   }
+
+   threadSafe = (threadSafeCount > 0);
+}
+
 void *getState()                                      // Doesn't seem to be called
 {
    if(!initialized)
@@ -56,6 +88,8 @@ void *getState()                                      // Doesn't seem to be call
 // Needs at least 16 bytes of entropy to be effective.  Can call repeated times to accumulate entropy.
 void addEntropy(const U8 *randomData, U32 dataLen)    
 {
+   RandomLock randomLock;
+
    if(!initialized)
       initialize();
    yarrow_add_entropy(randomData, dataLen, &prng);
@@ -70,6 +104,8 @@ void addEntropy(const U8 *randomData, U32 dataLen)
 
 void read(U8 *outBuffer, U32 randomLen)
 {
+   RandomLock randomLock;
+
    if(!initialized)
       initialize();
 
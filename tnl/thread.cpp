@@ -229,6 +229,108 @@ Thread::~Thread()
 
 #endif
 
+// Filled in during static initialization, so nothing here can need constructing
+static const U32 MaxExitFunctions = 16;
+static Thread::ExitFunction gExitFunctions[MaxExitFunctions];
+static U32 gExitFunctionCount;
+
+void Thread::addExitFunction(ExitFunction function)
+{
+   TNLAssert(gExitFunctionCount < MaxExitFunctions, "Too many thread exit functions!");
+
+   if(gExitFunctionCount < MaxExitFunctions)
+      gExitFunctions[gExitFunctionCount++] = function;
+}
+
+void Thread::runExitFunctions()
+{
+   for(U32 i = 0; i < gExitFunctionCount; i++)
+      gExitFunctions[i]();
+}
+
+WorkerPool::WorkerPool()
+{
+   mStopping = false;
+}
+
+WorkerPool::~WorkerPool()
+{
+   stop();     // Idle workers never call doWork(), so it doesn't matter that our subclass is already gone
+}
+
+U32 WorkerPool::Worker::run()
+{
+   for(;;)
+   {
+      mStart.wait();
+
+      if(mPool->mStopping)
+         break;
+
+      mPool->doWork(mIndex, mPool->mWorkers.size() + 1);
+      mPool->mDone.increment();
+   }
+
+   Thread::runExitFunctions();
+
+   mPool->mDone.increment();
+   return 0;
+}
+
+U32 WorkerPool::start(U32 count)
+{
+   stop();
+
+   for(U32 i = 0; i < count; i++)
+   {
+      Worker *worker = new Worker;
+      worker->mPool = this;
+      worker->mIndex = i + 1;
+
+      if(!worker->start())
+      {
+         delete worker;
+         break;
+      }
+
+      mWorkers.push_back(worker);      // Worker won't look at this until we wake it
+   }
+
+   return mWorkers.size();
+}
+
+void WorkerPool::stop()
+{
+   if(mWorkers.size() == 0)
+      return;
+
+   mStopping = true;
+
+   for(S32 i = 0; i < mWorkers.size(); i++)
+      mWorkers[i]->mStart.increment();
+
+   for(S32 i = 0; i < mWorkers.size(); i++)
+      mDone.wait();
+
+   // Workers don't touch themselves after their final increment, so they can go now
+   for(S32 i = 0; i < mWorkers.size(); i++)
+      delete mWorkers[i];
+
+   mWorkers.clear();
+   mStopping = false;
+}
+
+void WorkerPool::run()
+{
+   for(S32 i = 0; i < mWorkers.size(); i++)
+      mWorkers[i]->mStart.increment();
+
+   doWork(0, mWorkers.size() + 1);
+
+   for(S32 i = 0; i < mWorkers.size(); i++)
+      mDone.wait();
+}
+
 ThreadQueue::ThreadQueueThread::ThreadQueueThread(ThreadQueue *q)
 {
    mThreadQueue = q;
@@ -39,6 +39,8 @@
 
 #include "tnl.h"
 
+#include <string.h>     // For memcpy
+
 namespace TNL {
 
 class SymmetricCipher;
@@ -81,6 +83,23 @@ protected:
    char mStringBuffer[256];
 
    bool resizeBits(U32 numBitsNeeded);
+
+   /// @name Word-at-a-time access
+   ///
+   /// Reads and writes of up to 32 bits touch at most 5 bytes, which all fit in one 64-bit word.  When there are
+   /// 8 bytes of buffer from the current byte on, the small integer and flag functions load that word, update or
+   /// extract their bits, and store it back, rather than going through readBits() and writeBits().  The bytes
+   /// written are the same either way.
+   ///
+   /// @{
+
+   /// Returns true if the 8 bytes from the current byte can be loaded and stored
+   bool canUseWord() const { return (bitNum >> 3) + 8 <= getBufferSize(); }
+
+   U64 loadWord() const;
+   void storeWord(U64 word);
+
+   /// @}
 public:
 
    /// @name Constructors
@@ -354,6 +373,97 @@ inline bool BitStream::readFlag()
    bitNum++;
    return ret;
 }
+
+inline bool BitStream::writeFlag(bool val)
+{
+   if(bitNum + 1 > maxWriteBitNum)
+      if(!resizeBits(1))
+         return false;
+
+   U8 *destPtr = getBuffer() + (bitNum >> 3);
+   U8 mask = U8(1 << (bitNum & 0x7));
+
+   *destPtr = (*destPtr & ~mask) | (val ? mask : 0);
+   bitNum++;
+   return (val);
+}
+
+inline U64 BitStream::loadWord() const
+{
+   U64 word;
+   memcpy(&word, getBuffer() + (bitNum >> 3), sizeof(word));
+   return convertLEndianToHost(word);
+}
+
+inline void BitStream::storeWord(U64 word)
+{
+   word = convertHostToLEndian(word);
+   memcpy(getBuffer() + (bitNum >> 3), &word, sizeof(word));
+}
+
+inline void BitStream::writeInt(U32 val, U8 bitCount)
+{
+   TNLAssert(bitCount <= 32, "bitCount must be less then 32, for 64 bit, use writeInt64");
+
+   if(bitNum + bitCount <= maxWriteBitNum && canUseWord())
+   {
+      U32 shift = bitNum & 0x7;
+      U64 mask = ((U64(1) << bitCount) - 1) << shift;
+
+      storeWord((loadWord() & ~mask) | ((U64(val) << shift) & mask));
+      bitNum += bitCount;
+      return;
+   }
+
+   // Near the end of the buffer, or it needs to grow
+   val = convertHostToLEndian(val);
+   writeBits(bitCount, &val);
+}
+
+inline U32 BitStream::readInt(U8 bitCount)
+{
+   TNLAssert(bitCount <= 32, "bitCount must be less then 32, for 64 bit, use readInt64");
+
+   if(bitNum + bitCount <= maxReadBitNum && canUseWord())
+   {
+      U32 ret = U32((loadWord() >> (bitNum & 0x7)) & ((U64(1) << bitCount) - 1));
+      bitNum += bitCount;
+      return ret;
+   }
+
+   // Near the end of the buffer, or reading past the end
+   U32 ret = 0;
+   readBits(bitCount, &ret);
+   ret = convertLEndianToHost(ret);
+
+   // Clear bits that we didn't read.
+   if(bitCount == 32)
+      return ret;
+   else
+      ret &= (1 << bitCount) - 1;
+
+   return ret;
+}
+
+inline void BitStream::writeSignedInt(S32 value, U8 bitCount)
+{
+   writeInt(value, bitCount);
+}
+
+inline S32 BitStream::readSignedInt(U8 bitCount)
+{
+   return S32(readInt(bitCount)) << (32 - bitCount) >> (32 - bitCount);
+}
+
+inline void BitStream::writeSignedFloat(F32 f, U8 bitCount)
+{
+   writeSignedInt(S32(f * ((1 << (bitCount - 1)) - 1)), bitCount);
+}
+
+inline F32 BitStream::readSignedFloat(U8 bitCount)
+{
+   return readSignedInt(bitCount) / F32((1 << (bitCount - 1)) - 1);
+}
 //extern void logprintf(const char *format, ...);
 
 inline void BitStream::writeIntAt(U32 value, U8 bitCount, U32 bitPosition)
@@ -405,6 +515,14 @@ class PacketStream : public BitStream
 public:
    /// Constructor assigns the internal buffer to the BitStream.
    PacketStream(U32 targetPacketSize = MaxPacketDataSize) : BitStream(buffer, targetPacketSize, MaxPacketDataSize) { buffer[0] = 0; }
+   /// Empties the stream so it can be reused for another packet of the given target size.
+   void resetForWrite(U32 targetPacketSize = MaxPacketDataSize)
+   {
+      setBuffer(buffer, targetPacketSize);
+      setMaxSizes(targetPacketSize, MaxPacketDataSize);
+      reset();
+      buffer[0] = 0;
+   }
    /// Sends this packet to the specified address through the specified socket.
    NetError sendto(Socket &outgoingSocket, const Address &theAddress);
    /// Reads a packet into the stream from the specified socket.
@@ -101,6 +101,9 @@ public:
    void packetReceived(PacketList *note);
    void packetDropped(PacketList *note);
    void packetRewind(PacketList *note, PacketEntry *p_entry);
+
+   /// Sends each string in full the next time it's written, as if the remote host had never seen it
+   void forgetConfirmedEntries();
 };
 
 };
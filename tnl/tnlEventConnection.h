@@ -82,6 +82,13 @@ protected:
    void clearSendEvents();
    void clearRecvEvents();
 
+   /// Returns the sequence number of the next ordered event that will be written into a packet
+   S32 getNextUnsentEventSeq();
+
+   /// Sets the sequence number of the next ordered event to process, for picking up a stream of packets partway
+   /// through.  Should follow clearRecvEvents().
+   void setNextRecvEventSeq(S32 seq);
+
    enum DebugConstants
    {
       DebugChecksum = 0xF00DBAAD,
@@ -158,6 +165,9 @@ public:
    /// returns the highest event version number supported on this connection --> unused
    U32 getEventClassVersion() { return mEventClassVersion; }
 
+   /// Returns the sequence number of the next ordered event we're waiting to process
+   S32 getNextRecvEventSeq() const { return mNextRecvEventSeq; }
+
    /// Posts a NetEvent for processing on the remote host
    bool postNetEvent(NetEvent *event);
 
@@ -152,6 +152,11 @@ protected:
    S32 mGhostZeroUpdateIndex; ///< Index in mGhostArray of first ghost with 0 update mask (ie, with no updates).
    S32 mGhostFreeIndex;       ///< index in mGhostArray of first free ghost.
 
+   Vector<GhostInfo *> mUpdateQueue;   ///< Max-heap (by priority) of the ghosts eligible for an update in the packet being written.
+                                       ///
+                                       ///  Only as many ghosts as fit in the packet are popped off, so we never pay to fully
+                                       ///  sort the pending ghosts, and mGhostArray itself is left alone.
+
    bool mGhosting;         ///< Am I currently ghosting objects over?
    bool mScoping;          ///< Am I currently allowing objects to be scoped?
    U32  mGhostingSequence; ///< Sequence number describing this ghosting session.
@@ -49,6 +49,10 @@ namespace HuffmanStringProcessor
    ///       WriteString can only write strings of up to 255 characters length.
    ///       Therefore, it is wise not to exceed that limit.
    bool writeHuffBuffer(BitStream* pStream, const char* out_pBuffer, U32 maxLen);
+
+   /// Builds the coding tables if that hasn't been done yet.  This happens automatically on first use,
+   /// but must be done up front if strings may first be written from several threads at once.
+   void initialize();
 };
 
 };
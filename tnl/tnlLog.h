@@ -120,6 +120,9 @@ public:
 
    static void logString(LogConsumer::MsgType msgType, std::string message);
 
+   /// Returns true if any consumer will log messages of msgType
+   static bool isMsgTypeWanted(LogConsumer::MsgType msgType);
+
 private:
    S32 mMsgTypes;    // A bitmap of MsgType values
    void prepareAndLogString(std::string message);
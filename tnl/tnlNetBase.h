@@ -219,6 +219,7 @@ protected:
    static Vector<NetClassRep *> mClassTable[NetClassGroupCount][NetClassTypeCount]; ///< Table of NetClassReps for construction by class ID.
    static U32 mClassCRC[NetClassGroupCount];                                ///< Internally computed class group CRC.
    static bool mInitialized;                                                ///< Set once the class tables are built, from initialize.
+   static bool mRecordUpdateStats;                                          ///< Cleared while packets are being written on several threads.
 
    /// mNetClassBitSize is the number of bits needed to transmit the class ID for a group and type.
    static U32 mNetClassBitSize[NetClassGroupCount][NetClassTypeCount];
@@ -244,6 +245,8 @@ public:
    /// Records bits used in the initial update of objects of this class.
    void addInitialUpdate(U32 bitCount)
    {
+      if(!mRecordUpdateStats)
+         return;
       mInitialUpdateCount++;
       mInitialUpdateBitsUsed += bitCount;
    }
@@ -251,10 +254,16 @@ public:
    /// Records bits used in a partial update of an object of this class.
    void addPartialUpdate(U32 bitCount)
    {
+      if(!mRecordUpdateStats)
+         return;
       mPartialUpdateCount++;
       mPartialUpdateBitsUsed += bitCount;
    }
 
+   /// Turns the update statistics above on or off.  They are unsynchronized, so NetInterface turns
+   /// them off while packets are being written on several threads.
+   static void setRecordUpdateStats(bool record) { mRecordUpdateStats = record; }
+
    virtual Object *create() const = 0;             ///< Creates an instance of the class this represents.
 
    /// Returns the number of classes registered under classGroup and classType.
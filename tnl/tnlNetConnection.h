@@ -52,6 +52,7 @@ namespace TNL {
 class NetConnection;
 class NetObject;
 class BitStream;
+class PacketStream;
 class NetInterface;
 class AsymmetricKey;
 class Certificate;
@@ -559,6 +560,24 @@ public:
    /// If force is true and there is space in the window, it will always send a packet.
    void checkPacketSend(bool force, U32 currentTime);
 
+   /// Does the work of checkPacketSend() except for the actual send: runs the scope query and writes
+   /// the next data (or ack) packet into stream.  Returns false if there is nothing to send.
+   ///
+   /// NetInterface can build packets for several connections at once, then hand them to sendPacket()
+   /// on the main thread.  That is only safe because of the following contract:
+   ///
+   /// - Nothing may create, delete or change a NetObject while packets are being built.  Scope queries
+   ///   and packUpdate() read objects shared by every connection.
+   /// - The ghost lists each NetObject keeps of the connections ghosting it are shared as well.
+   ///   objectInScope() and ghost deletion change them only under a lock.
+   /// - Everything else written is this connection's own.  Shared tables used while writing, such as
+   ///   the string table and the log, are locked or built before the workers start.
+   bool buildPacket(bool force, U32 currentTime, PacketStream *stream);
+
+   /// Time spent in the last buildPacket() call, in high precision timer units
+   S64 mLastScopeTime;     ///< ...preparing to write (this is where the scope query runs)
+   S64 mLastWriteTime;     ///< ...writing the packet
+
    /// Connection state flags for a NetConnection instance.  If this list is modifed, please check if netInterface.cpp needs updates as well
    enum NetConnectionState {
       NotConnected=0,            ///< Initial state of a NetConnection instance - not connected
@@ -45,6 +45,10 @@
 #include "tnlNetConnection.h"
 #endif
 
+#ifndef _TNLTHREAD_H_
+#include "tnlThread.h"
+#endif
+
 namespace TNL {
 
 class AsymmetricKey;
@@ -211,6 +215,85 @@ protected:
    };
    DelaySendPacket *mSendPacketList; /// List of delayed packets pending to send.
 
+   /// @name Parallel packet building
+   ///
+   /// When packet workers are running, processConnections() splits the connection list between the
+   /// workers and the main thread; each builds the packets for its share (including the scope query),
+   /// then the main thread sends them all, in connection order.
+   ///
+   /// @{
+
+   /// Each share of the job builds the packets for every shareCount'th connection
+   class PacketWorkerPool : public WorkerPool
+   {
+   public:
+      NetInterface *mInterface;
+      void doWork(U32 index, U32 shareCount);
+   };
+   friend class PacketWorkerPool;
+
+   PacketWorkerPool mPacketWorkers;          ///< No workers if packets are built on the main thread
+   Vector<RefPtr<NetConnection> > mPacketConnections;   ///< Connections being processed this tick
+   Vector<PacketStream *> mPendingPackets;   ///< One reusable packet per connection slot
+   Vector<U8> mPendingPacketReady;           ///< Nonzero if mPendingPackets[i] holds a packet to send this tick (not bool: workers write neighbouring entries)
+
+   void buildPackets(S32 firstConnection, S32 step);    ///< Builds packets for every step'th connection
+   void buildPacketsInParallel();
+
+   /// @}
+
+   /// @name Batched packet I/O
+   ///
+   /// checkIncomingPackets() reads packets a batch at a time into a preallocated ring, and the game
+   /// packets built by processConnections() are queued up and handed to the socket together.
+   ///
+   /// @{
+
+   enum {
+      PacketBatchSize = Socket::MaxBatchSize,
+   };
+
+   U8 *mRecvBuffers;                                     ///< PacketBatchSize packets' worth of space for checkIncomingPackets()
+   Socket::Datagram mRecvDatagrams[PacketBatchSize];     ///< Each one pointing at its share of mRecvBuffers
+   U8 *mSendBuffers;                                     ///< Space for packets queued by sendto()
+   Socket::Datagram mSendDatagrams[PacketBatchSize];
+   S32 mQueuedSendCount;                                 ///< Number of mSendDatagrams waiting to go
+   bool mQueueSends;                                     ///< True while sendto() should queue packets rather than send them
+
+   void queueSend(const Address &address, const U8 *buffer, S32 bufferSize);
+   void flushSends();                                    ///< Sends any queued packets
+
+   /// @}
+
+   /// @name Handshake flood protection
+   ///
+   /// Handshake packets from each source address are metered by a token bucket, and those over the limit are
+   /// dropped before we do any work on them.  A ConnectRequest has its identity token checked first; that costs
+   /// one hash and needs no per-client state, so spoofed requests are thrown out cheaply.
+   ///
+   /// @{
+
+   enum {
+      HandshakeBucketCount = 4096,     ///< Source addresses are hashed into this many buckets; must be a power of 2
+      DefaultHandshakeRate = 10,       ///< Handshake packets per second allowed from each address
+      DefaultHandshakeBurst = 20,      ///< Handshake packets an address that has been quiet can send at once
+   };
+
+   struct HandshakeBucket
+   {
+      U32 credit;                      ///< Milliseconds of sending banked; each packet costs 1000 / mHandshakeRate
+      U32 lastTime;                    ///< When credit was last topped up
+   };
+
+   HandshakeBucket *mHandshakeBuckets;
+   U32 mHandshakeRate;                 ///< Packets per second per address; 0 if there's no limit
+   U32 mHandshakeBurst;
+
+   /// Charges a handshake packet to address's bucket; returns false if it should be dropped
+   bool allowHandshakePacket(const Address &address);
+
+   /// @}
+
    enum NetInterfaceConstants {
       ChallengeRetryCount = 4,     /// Number of times to send connect challenge requests before giving up.
       ChallengeRetryTime = 2500,   /// Timeout interval in milliseconds before retrying connect challenge.
@@ -373,6 +456,53 @@ public:
    /// and pending connections.
    void processConnections();
 
+   /// Sets the number of worker threads used to build packets in processConnections(); 0 builds
+   /// everything on the calling thread, as before.  The game must not create, move or delete
+   /// objects from another thread while processConnections() is running.
+   void setPacketWorkerCount(U32 count);
+
+   /// Returns the number of packet worker threads
+   U32 getPacketWorkerCount() const { return mPacketWorkers.getWorkerCount(); }
+
+   /// Time spent in each phase of processConnections(), accumulated until reset.  Scope and write times
+   /// are summed over all connections, so with packet workers they can add up to more than buildMs.
+   struct PacketPhaseStats
+   {
+      U32 processCount;    ///< Number of processConnections() calls
+      U32 packetsSent;     ///< Number of packets built and sent
+      F64 scopeMs;         ///< Preparing packets to write, including scope queries
+      F64 writeMs;         ///< Writing ghost updates and events into packets
+      F64 buildMs;         ///< Wall time of the whole build phase, scoping and writing together
+      F64 sendMs;          ///< Handing packets to the socket (always on the main thread)
+      U32 dirtyObjects;    ///< Objects whose dirty mask bits were pushed out to their ghosts
+      U32 dirtyRefs;       ///< GhostInfos those mask bits were pushed into
+   };
+
+   /// Returns the timing counters for processConnections()
+   const PacketPhaseStats &getPacketPhaseStats() const { return mPacketPhaseStats; }
+
+   /// Zeroes the timing counters
+   void resetPacketPhaseStats();
+
+   /// Limits each source address to packetsPerSecond handshake packets (ConnectChallengeRequests and
+   /// ConnectRequests), with bursts of up to burst packets.  A packetsPerSecond of 0 turns the limit off.
+   void setHandshakeRateLimit(U32 packetsPerSecond, U32 burst);
+
+   /// Counts of what happened to incoming handshake packets, accumulated until reset.
+   struct HandshakeStats
+   {
+      U32 challengesAnswered;    ///< ConnectChallengeRequests we sent a response to
+      U32 packetsThrottled;      ///< Handshake packets dropped because their source was over its rate
+      U32 badIdentityTokens;     ///< ConnectRequests dropped because they weren't answering our challenge
+      U32 connectionsAccepted;   ///< ConnectRequests that ended with a new connection
+   };
+
+   /// Returns the handshake counters
+   const HandshakeStats &getHandshakeStats() const { return mHandshakeStats; }
+
+   /// Zeroes the handshake counters
+   void resetHandshakeStats();
+
    /// Returns the list of connections on this NetInterface.
    Vector<NetConnection *> &getConnectionList() { return mConnectionList; }
 
@@ -381,6 +511,10 @@ public:
 
    /// returns the current process time for this NetInterface
    U32 getCurrentTime() { return mCurrentTime; }
+
+private:
+   PacketPhaseStats mPacketPhaseStats;
+   HandshakeStats mHandshakeStats;
 };
 
 };
@@ -39,6 +39,10 @@
 #include "tnlRPC.h"
 #endif
 
+#ifndef _TNLTHREAD_H_
+#include "tnlThread.h"
+#endif
+
 namespace TNL {
 //----------------------------------------------------------------------------
 class GhostConnection;
@@ -214,9 +218,31 @@ class NetObject : public Object
    U32 mNetIndex;              ///< The index of this ghost on the other side of the connection.
    GhostInfo *mFirstObjectRef; ///< Head of the linked list of GhostInfos for this object.
 
-   static bool mIsInitialUpdate; ///< Managed by GhostConnection - set to true when this is an initial update
+   static ThreadStorage mIsInitialUpdate; ///< Managed by GhostConnection - non-NULL on this thread during an initial update
+                                          ///  (per-thread, as NetInterface may write packets on several threads at once)
+
+   static void setInitialUpdate(bool initialUpdate) { mIsInitialUpdate.set(initialUpdate ? (void *) 1 : NULL); }
    SafePtr<NetObject> mServerObject; ///< Direct pointer to the parent object on the server if it is a local connection
    GhostConnection *mOwningConnection; ///< The connection that owns this ghost, if it's a ghost
+
+   /// @name Shared update cache
+   ///
+   /// The last update packed during a shared update pass, so other connections wanting the same mask can copy it.
+   ///
+   /// @{
+
+   U32 mSharedUpdatePass;     ///< Pass mSharedUpdateBits was packed in, or 0 if there's nothing cached
+   U32 mSharedUpdateMask;
+   U32 mSharedUpdateRetMask;
+   U32 mSharedUpdateBitCount;
+   Vector<U8> mSharedUpdateBits;
+
+   static U32 mCurrentSharedUpdatePass;   ///< 0 when no pass is running
+   static Mutex mSharedUpdateLock;        ///< Packets may be written on several threads at once
+   static U32 mSharedUpdateHits;
+   static U32 mSharedUpdateMisses;
+
+   /// @}
 protected:
    enum NetFlag
    {
@@ -235,7 +261,7 @@ protected:
    static GhostConnection *mRPCDestConnection;
 
    /// Returns true if this pack/unpackUpdate is the initial one for the object
-   bool isInitialUpdate() { return mIsInitialUpdate; }
+   bool isInitialUpdate() { return mIsInitialUpdate.get() != NULL; }
 public:
    NetObject();
    ~NetObject();
@@ -244,8 +270,9 @@ public:
 
    /// collapseDirtyList pushes all the mDirtyMaskBits down into
    /// the GhostInfo's for each object, and clears out the dirty
-   /// list.
-   static void collapseDirtyList();
+   /// list.  If given, dirtyObjects and propagatedRefs are set to the
+   /// number of objects collapsed and GhostInfos they were pushed into.
+   static void collapseDirtyList(U32 *dirtyObjects = NULL, U32 *propagatedRefs = NULL);
 
    /// Returns the connection from which the current RPC method originated,
    /// or NULL if not currently within the processing of an RPC method call.
@@ -307,6 +334,27 @@ public:
    /// one-time initialization information for that object.
    virtual U32  packUpdate(GhostConnection *connection, U32 updateMask, BitStream *stream);
 
+   /// Returns the bits of updateMask for which packUpdate() would write something different to this connection
+   /// than to some other one -- positions relative to the connection's control object, ghost indices, string table
+   /// entries and the like.  Updates that don't involve any of them can be packed once per shared update pass and
+   /// copied to every connection that wants the same mask.
+   ///
+   /// The default is all bits, which keeps the object out of the cache; objects opt in by overriding it.  The
+   /// initial update is never shared.
+   virtual U32 getConnectionDependentMask(GhostConnection *connection);
+
+   /// Writes the update for updateMask, copying it from the cache if another connection already packed it during
+   /// this shared update pass, or calling packUpdate() and caching the result if it can be shared.
+   U32 packSharedUpdate(GhostConnection *connection, U32 updateMask, BitStream *stream);
+
+   /// Starts a shared update pass.  No object's state may change until the matching endSharedUpdates(), other
+   /// than through setMaskBits(), which drops that object's cached update.
+   static void beginSharedUpdates();
+   static void endSharedUpdates();
+
+   /// Counts of updates copied from the cache and packed into it since the last call
+   static void getSharedUpdateStats(U32 &hits, U32 &misses, bool reset = true);
+
    /// Unpack data written by packUpdate().
    ///
    /// unpackUpdate is called on the client to read an update out of a
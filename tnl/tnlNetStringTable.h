@@ -75,6 +75,13 @@ namespace StringTable
    /// Hash a string of given length into a U32.
    U32 hashStringn(const char* in_pString, S32 len);
 
+   /// While enabled, table operations are serialized with a mutex, so StringTableEntry instances
+   /// can be created, copied and destroyed on several threads at once.  Off by default, since
+   /// the locking isn't free; only change it while no other thread is using the table.  Calls
+   /// nest: the table stays thread safe until each setThreadSafe(true) has been matched by a
+   /// setThreadSafe(false), so one long running background job can share it with others.
+   void setThreadSafe(bool threadSafe);
+
    void incRef(StringTableEntryId index);   
    void decRef(StringTableEntryId index);
    const char *getString(StringTableEntryId index);
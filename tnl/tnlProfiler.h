@@ -0,0 +1,131 @@
+//-----------------------------------------------------------------------------------
+//
+//   Torque Network Library
+//   Copyright (C) 2004 GarageGames.com, Inc.
+//   For more information see http://www.opentnl.org
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   For use in products that are not compatible with the terms of the GNU
+//   General Public License, alternative licensing options are available
+//   from GarageGames.com.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//------------------------------------------------------------------------------------
+
+#ifndef _TNL_PROFILER_H_
+#define _TNL_PROFILER_H_
+
+#ifndef _TNL_TYPES_H_
+#include "tnlTypes.h"
+#endif
+
+#ifndef _TNL_VECTOR_H_
+#include "tnlVector.h"
+#endif
+
+namespace TNL
+{
+
+struct ThreadEvents;
+
+/// Scoped timers for finding out where the time goes.
+///
+/// Code to be measured is wrapped in a TNL_PROFILE_SCOPE("name"); each scope that finishes while the profiler is
+/// enabled is stored, with its start, end and nesting depth, in a fixed size ring buffer belonging to the thread
+/// it ran on.  Old scopes are overwritten, so the buffers always hold the last few seconds or so of activity.
+/// When the profiler is disabled, a scope costs a single test of a flag.
+///
+/// Scope names must be string literals, or otherwise outlive the profiler; only the pointer is kept.
+class Profiler
+{
+public:
+   enum {
+      DefaultEventsPerThread = 65536,
+   };
+
+   /// Timing of one named scope over some period.
+   struct PhaseStats
+   {
+      const char *name;
+      U32 count;        ///< Times the scope finished
+      F64 totalMs;
+      F64 p50Ms;        ///< Median duration
+      F64 p99Ms;
+      F64 maxMs;
+   };
+
+   /// Starts or stops recording.  Stopping keeps what's already been recorded.
+   static void setEnabled(bool enabled);
+   static bool isEnabled() { return mEnabled; }
+
+   /// Throws away everything recorded so far, on every thread.
+   static void clear();
+
+   /// Sets how many finished scopes each thread remembers before overwriting the oldest.  Throws away everything
+   /// recorded so far.
+   static void setEventsPerThread(U32 count);
+   static U32 getEventsPerThread();
+
+   /// Lets the next thread to record anything take over the calling thread's buffer.  Threads that come and go
+   /// should call this before they end, so they don't each leave a buffer behind; it runs as a Thread exit function,
+   /// so Thread::runExitFunctions() takes care of it.  What the thread recorded stays until it gets overwritten.
+   static void releaseThread();
+
+   /// Gathers stats for every scope that finished in the last lastMs milliseconds, on any thread, sorted by name.
+   static void getPhaseStats(U32 lastMs, Vector<PhaseStats> &stats);
+
+   /// Writes every scope that finished in the last lastMs milliseconds to filename, in the Chrome trace event
+   /// format (load it at chrome://tracing, or in Perfetto).  Returns false if the file couldn't be written.
+   static bool writeChromeTrace(const char *filename, U32 lastMs);
+
+   /// Times everything from its construction to its destruction.  Use TNL_PROFILE_SCOPE rather than making
+   /// these directly.
+   class Scope
+   {
+      ThreadEvents *mEvents;     // NULL if the profiler was off when we started
+      const char *mName;
+      S64 mStart;
+      U32 mDepth;
+
+   public:
+      explicit Scope(const char *name)
+      {
+         mEvents = mEnabled ? begin(mStart, mDepth) : NULL;
+         mName = name;
+      }
+
+      ~Scope()
+      {
+         if(mEvents)
+            end(mEvents, mName, mStart, mDepth);
+      }
+   };
+
+private:
+   static bool mEnabled;
+
+   static ThreadEvents *begin(S64 &start, U32 &depth);
+   static void end(ThreadEvents *events, const char *name, S64 start, U32 depth);
+};
+
+#define TNL_PROFILE_CONCAT_INNER(a, b) a##b
+#define TNL_PROFILE_CONCAT(a, b) TNL_PROFILE_CONCAT_INNER(a, b)
+
+/// Times the rest of the enclosing block under the given name
+#define TNL_PROFILE_SCOPE(name) TNL::Profiler::Scope TNL_PROFILE_CONCAT(profileScope, __LINE__)(name)
+
+};
+
+#endif
@@ -57,6 +57,11 @@ F32 readF();
 /// Returns a single random bit.
 bool readB();
 
+/// While enabled, reads and added entropy are serialized with a mutex, so several threads can
+/// use the generator at once.  Off by default, since the locking isn't free; only change it while
+/// no other thread is using the generator.  Calls nest, like StringTable::setThreadSafe().
+void setThreadSafe(bool threadSafe);
+
 /// Returns an opaque pointer to the random number generator's internal state
 /// for use in certain encryption functions.
 void *getState();
@@ -118,6 +118,25 @@ public:
 
    /// starts the thread's main run function.
    bool start();
+
+   /// Frees whatever a module keeps for the calling thread, such as scratch space held in a ThreadStorage.
+   typedef void (*ExitFunction)();
+
+   /// Registers a function for runExitFunctions() to call.  Modules register during static initialization,
+   /// with an ExitFunctionRegistration.
+   static void addExitFunction(ExitFunction function);
+
+   /// Calls every registered exit function on the calling thread.  Threads that come and go should call this
+   /// just before they end, so they don't each leave something behind.
+   static void runExitFunctions();
+
+   /// Registers an exit function when constructed:
+   ///
+   ///    static Thread::ExitFunctionRegistration gReleaseScratch(&releaseScratch);
+   struct ExitFunctionRegistration
+   {
+      ExitFunctionRegistration(ExitFunction function) { addExitFunction(function); }
+   };
 };
 
 /// Platform independent per-thread storage class.
@@ -192,6 +211,51 @@ public:
    void dispatchResponseCalls();
 };
 
+/// A set of worker threads that all share one job with the thread that owns the pool.  Each call to run() wakes
+/// every worker, does the caller's own share of the job, and returns once every worker has finished its share.
+/// Subclasses say what the job is by overriding doWork().
+///
+/// Workers call Thread::runExitFunctions() on their way out, so whatever the job left in per-thread storage goes
+/// with them.
+class WorkerPool
+{
+   class Worker : public Thread
+   {
+   public:
+      WorkerPool *mPool;
+      U32 mIndex;
+      Semaphore mStart;
+
+      U32 run();
+   };
+   friend class Worker;
+
+   Vector<Worker *> mWorkers;
+   Semaphore mDone;        ///< Incremented by each worker as it finishes its share
+   bool mStopping;         ///< Tells workers to exit when next woken
+
+protected:
+   /// Does one share of the job.  index is 0 on the thread that called run(), and 1 up to getWorkerCount() on the
+   /// workers; shareCount is getWorkerCount() + 1.  Every share runs at the same time, each on its own thread.
+   virtual void doWork(U32 index, U32 shareCount) = 0;
+
+public:
+   WorkerPool();
+   virtual ~WorkerPool();
+
+   /// Stops any workers we already have, then starts count new ones.  Returns how many actually started, which
+   /// is fewer than count if we ran out of threads; the job is then split fewer ways.
+   U32 start(U32 count);
+
+   /// Waits for every worker to exit.  Must not be called while run() is running.
+   void stop();
+
+   U32 getWorkerCount() const { return U32(mWorkers.size()); }
+
+   /// Runs the job, with one share on the calling thread and one on each worker, and returns when all are done
+   void run();
+};
+
 /// Declares a ThreadQueue method on a subclass of ThreadQueue.
 #define TNL_DECLARE_THREADQ_METHOD(func, args) \
    void func args; \
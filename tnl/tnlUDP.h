@@ -152,6 +152,16 @@ class Socket
 public:
    enum {
       DefaultBufferSize = 32768, ///< The default send and receive buffer sizes
+      MaxBatchSize = 32,         ///< Most packets handled by one system call in recvfromBatch() and sendtoBatch()
+   };
+
+   /// One packet for recvfromBatch() or sendtoBatch()
+   struct Datagram
+   {
+      Address address;  ///< Where the packet came from, or is going to
+      U8 *buffer;       ///< The packet data
+      S32 capacity;     ///< Size of buffer; for recvfromBatch()
+      S32 size;         ///< Number of bytes of packet data in buffer
    };
 
    /// Opens a socket on the specified address/port
@@ -177,6 +187,16 @@ public:
    /// @param   bytesRead       Specifies the number of bytes which were actually in the packet.
    NetError recvfrom(Address *address, U8 *buffer, S32 bufferSize, S32 *bytesRead);
 
+   /// Reads up to count waiting packets into datagrams, returning the number read.  On Linux the
+   /// packets are read MaxBatchSize at a time by recvmmsg(); elsewhere, and while journaling,
+   /// this is just repeated calls to recvfrom().
+   S32 recvfromBatch(Datagram *datagrams, S32 count);
+
+   /// Sends count packets, returning the number sent without error.  On Linux the packets are sent
+   /// MaxBatchSize at a time by sendmmsg(); elsewhere, and while journaling, this is just repeated
+   /// calls to sendto().
+   S32 sendtoBatch(const Datagram *datagrams, S32 count);
+
    /// Returns the Address corresponding to this socket, as bound on the local machine.
    Address getBoundAddress();
 
@@ -189,6 +209,13 @@ public:
    virtual NetError send(const U8 *buffer, S32 bufferSize);
 
    bool isWritable(U32 timeout = 0);
+
+   /// Waits up to timeoutMicros microseconds for a packet to arrive, returning true if there's one waiting to be
+   /// read.  Unlike isWritable(), a timeout of 0 doesn't block at all.
+   bool waitForData(U32 timeoutMicros);
+
+   /// Like waitForData(), but waits on all of sockets at once, returning true if any of them has a packet waiting.
+   static bool waitForData(const Vector<Socket *> &sockets, U32 timeoutMicros);
 };
 
 //inline void read(BitStream &s, IPAddress *val)
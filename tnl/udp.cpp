@@ -94,6 +94,9 @@ typedef in_addr IN_ADDR;
 
 #define closesocket close
 
+// Batched datagram I/O, recvmmsg() and sendmmsg()
+#define TNL_BATCHED_SOCKET_IO
+
 #else
 
 #endif
@@ -411,6 +414,146 @@ NetError Socket::recvfrom(Address *address, U8 *buffer, S32 bufferSize, S32 *out
    return NoError;
 }
 
+// The batched calls don't go through the journal, so stick to the single packet versions while it's in use
+static bool canBatchSocketIO()
+{
+#ifdef TNL_BATCHED_SOCKET_IO
+   return Journal::getCurrentMode() == Journal::Inactive;
+#else
+   return false;
+#endif
+}
+
+S32 Socket::recvfromBatch(Datagram *datagrams, S32 count)
+{
+   if(!canBatchSocketIO())
+   {
+      S32 received = 0;
+
+      while(received < count && recvfrom(&datagrams[received].address, datagrams[received].buffer,
+                                          datagrams[received].capacity, &datagrams[received].size) == NoError)
+         received++;
+
+      return received;
+   }
+
+#ifdef TNL_BATCHED_SOCKET_IO
+   SOCKADDR addresses[MaxBatchSize];
+   iovec iovecs[MaxBatchSize];
+   mmsghdr messages[MaxBatchSize];
+
+   S32 received = 0;
+
+   while(received < count)
+   {
+      S32 batchSize = min(count - received, S32(MaxBatchSize));
+
+      for(S32 i = 0; i < batchSize; i++)
+      {
+         iovecs[i].iov_base = datagrams[received + i].buffer;
+         iovecs[i].iov_len = datagrams[received + i].capacity;
+
+         memset(&messages[i].msg_hdr, 0, sizeof(messages[i].msg_hdr));
+         messages[i].msg_hdr.msg_name = &addresses[i];
+         messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+         messages[i].msg_hdr.msg_iov = &iovecs[i];
+         messages[i].msg_hdr.msg_iovlen = 1;
+      }
+
+      // Only the first packet is waited for, and only if this is a blocking socket
+      S32 batchReceived = ::recvmmsg(mPlatformSocket, messages, batchSize, MSG_WAITFORONE, NULL);
+
+      if(batchReceived <= 0)
+         break;
+
+      for(S32 i = 0; i < batchReceived; i++)
+      {
+         SocketToTNLAddress(&addresses[i], &datagrams[received + i].address);
+         datagrams[received + i].size = messages[i].msg_len;
+      }
+
+      received += batchReceived;
+
+      if(batchReceived < batchSize)    // That's everything that was waiting
+         break;
+   }
+
+   return received;
+#else
+   return 0;
+#endif
+}
+
+S32 Socket::sendtoBatch(const Datagram *datagrams, S32 count)
+{
+   if(!canBatchSocketIO())
+   {
+      S32 sent = 0;
+
+      for(S32 i = 0; i < count; i++)
+         if(sendto(datagrams[i].address, datagrams[i].buffer, datagrams[i].size) == NoError)
+            sent++;
+
+      return sent;
+   }
+
+#ifdef TNL_BATCHED_SOCKET_IO
+   SOCKADDR addresses[MaxBatchSize];
+   iovec iovecs[MaxBatchSize];
+   mmsghdr messages[MaxBatchSize];
+
+   S32 sent = 0;
+   S32 next = 0;
+
+   while(next < count)
+   {
+      S32 batchSize = 0;
+
+      while(batchSize < MaxBatchSize && next < count)
+      {
+         const Datagram &datagram = datagrams[next++];
+
+         if(datagram.address.transport != mTransportProtocol)
+            continue;
+
+         socklen_t addressSize;
+         TNLToSocketAddress(datagram.address, &addresses[batchSize], &addressSize);
+
+         iovecs[batchSize].iov_base = datagram.buffer;
+         iovecs[batchSize].iov_len = datagram.size;
+
+         memset(&messages[batchSize].msg_hdr, 0, sizeof(messages[batchSize].msg_hdr));
+         messages[batchSize].msg_hdr.msg_name = &addresses[batchSize];
+         messages[batchSize].msg_hdr.msg_namelen = addressSize;
+         messages[batchSize].msg_hdr.msg_iov = &iovecs[batchSize];
+         messages[batchSize].msg_hdr.msg_iovlen = 1;
+
+         batchSize++;
+      }
+
+      // sendmmsg() stops at the first packet it can't send; skip that one, as sendto() would, and carry on
+      S32 first = 0;
+
+      while(first < batchSize)
+      {
+         S32 batchSent = ::sendmmsg(mPlatformSocket, messages + first, batchSize - first, 0);
+
+         if(batchSent <= 0)
+            first++;
+         else
+         {
+            sent += batchSent;
+            first += batchSent;
+         }
+      }
+   }
+
+   return sent;
+#else
+   return 0;
+#endif
+}
+
 NetError Socket::connect(const Address &theAddress)
 {
    SOCKADDR destAddress;
@@ -482,6 +625,46 @@ bool Socket::isWritable(U32 timeoutMillis)
    return FD_ISSET(mPlatformSocket, &fds);
 }
 
+bool Socket::waitForData(U32 timeoutMicros)
+{
+   fd_set fds;
+   FD_ZERO(&fds);
+   FD_SET(mPlatformSocket, &fds);
+
+   timeval timeoutval;
+   timeoutval.tv_sec = timeoutMicros / 1000000;
+   timeoutval.tv_usec = timeoutMicros % 1000000;
+
+   if(::select(mPlatformSocket + 1, &fds, 0, 0, &timeoutval) == SOCKET_ERROR)
+      return false;
+
+   return FD_ISSET(mPlatformSocket, &fds);
+}
+
+bool Socket::waitForData(const Vector<Socket *> &sockets, U32 timeoutMicros)
+{
+   fd_set fds;
+   FD_ZERO(&fds);
+
+   S32 maxSocket = 0;
+
+   for(S32 i = 0; i < sockets.size(); i++)
+   {
+      FD_SET(sockets[i]->mPlatformSocket, &fds);
+
+      if(sockets[i]->mPlatformSocket > maxSocket)
+         maxSocket = sockets[i]->mPlatformSocket;
+   }
+
+   timeval timeoutval;
+   timeoutval.tv_sec = timeoutMicros / 1000000;
+   timeoutval.tv_usec = timeoutMicros % 1000000;
+
+   S32 ready = ::select(maxSocket + 1, &fds, 0, 0, &timeoutval);
+
+   return ready != SOCKET_ERROR && ready > 0;
+}
+
 #if defined ( TNL_OS_WIN32 )
 void Socket::getInterfaceAddresses(Vector<Address> *addressVector)
 {
@@ -0,0 +1,275 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+// Load generator for NetInterface's connection handshake.  Starts a server NetInterface on loopback, floods it
+// with ConnectChallengeRequests and forged ConnectRequests from many local addresses, and has a few real clients
+// try to connect in the middle of it all.  Reports how long the server spent handling packets, and what happened
+// to the handshakes.
+//
+// On Linux, all of 127.0.0.0/8 is loopback, so each flood source gets an address of its own and the per-address
+// rate limit can be seen doing its job.  Elsewhere, sources that can't be bound fall back to 127.0.0.1.
+
+#include "tnl.h"
+#include "tnlNetConnection.h"
+#include "tnlNetInterface.h"
+#include "tnlLog.h"
+#include "tnlNonce.h"
+#include "tnlRandom.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace TNL;
+
+class FloodConnection : public NetConnection
+{
+public:
+   TNL_DECLARE_NETCONNECTION(FloodConnection);
+};
+
+TNL_IMPLEMENT_NETCONNECTION(FloodConnection, NetClassGroupGame, true);
+
+
+struct FloodOptions
+{
+   S32 packets;         // Flood packets to send
+   S32 sources;         // Addresses to send them from
+   S32 burst;           // Packets sent between each server update
+   S32 clients;         // Real clients trying to connect
+   S32 rate;            // Server handshake rate limit per address; -1 leaves the default
+};
+
+
+static Address makeLoopbackAddress(U32 lowBits)
+{
+   IPAddress ip;
+   ip.netNum = (127 << 24) | lowBits;
+   ip.port = 0;
+
+   return Address(ip);
+}
+
+
+static void usage()
+{
+   printf("Usage: tnlflood [options]\n\n"
+          "  -packets <n>   Flood packets to send (default 20000)\n"
+          "  -sources <n>   Loopback addresses to send them from (default 64)\n"
+          "  -burst <n>     Packets sent between server updates (default 200)\n"
+          "  -clients <n>   Real clients connecting during the flood (default 8)\n"
+          "  -rate <n>      Server handshake packets per second per address; 0 for no limit\n\n");
+}
+
+
+static bool parseOptions(int argc, const char **argv, FloodOptions &options)
+{
+   options.packets = 20000;
+   options.sources = 64;
+   options.burst = 200;
+   options.clients = 8;
+   options.rate = -1;
+
+   for(S32 i = 1; i < argc; i++)
+   {
+      const char *arg = argv[i];
+      bool hasValue = i + 1 < argc;
+
+      if(!strcmp(arg, "-packets") && hasValue)
+         options.packets = atoi(argv[++i]);
+      else if(!strcmp(arg, "-sources") && hasValue)
+         options.sources = atoi(argv[++i]);
+      else if(!strcmp(arg, "-burst") && hasValue)
+         options.burst = atoi(argv[++i]);
+      else if(!strcmp(arg, "-clients") && hasValue)
+         options.clients = atoi(argv[++i]);
+      else if(!strcmp(arg, "-rate") && hasValue)
+         options.rate = atoi(argv[++i]);
+      else
+         return false;
+   }
+
+   return options.sources > 0 && options.burst > 0 && options.packets >= 0 && options.clients >= 0;
+}
+
+
+// Alternates between challenge requests, which the server will answer, and connect requests with made up
+// identity tokens, which it should throw out without doing any real work
+static void writeFloodPacket(PacketStream &out, S32 index)
+{
+   Nonce nonce;
+   nonce.getRandom();
+
+   if(index % 2 == 0)
+   {
+      out.write(U8(NetInterface::ConnectChallengeRequest));
+      nonce.write(&out);
+      out.writeFlag(false);
+      out.writeFlag(false);
+   }
+   else
+   {
+      Nonce serverNonce;
+      serverNonce.getRandom();
+
+      out.write(U8(NetInterface::ConnectRequest));
+      nonce.write(&out);
+      serverNonce.write(&out);
+      out.write(Random::readI());      // Identity token
+      out.write(U32(0));               // Puzzle difficulty
+      out.write(U32(0));               // Puzzle solution
+      out.writeFlag(false);
+   }
+}
+
+
+int main(int argc, const char **argv)
+{
+   FloodOptions options;
+   if(!parseOptions(argc, argv, options))
+   {
+      usage();
+      return 1;
+   }
+
+   U8 randData[sizeof(U32) + sizeof(S64)];
+   *((U32 *) randData) = Platform::getRealMilliseconds();
+   *((S64 *) (randData + sizeof(U32))) = Platform::getHighPrecisionTimerValue();
+   TNL::Random::addEntropy(randData, sizeof(randData));
+
+   // Server
+   NetInterface server(makeLoopbackAddress(1));
+   Address serverAddress = server.getSocket().getBoundAddress();
+
+   if(options.rate >= 0)
+      server.setHandshakeRateLimit(options.rate, options.rate * 2);
+
+   // Flood sources: 127.0.1.x, 127.0.2.x...
+   Vector<Socket *> sources;
+   S32 fallbacks = 0;
+
+   for(S32 i = 0; i < options.sources; i++)
+   {
+      Socket *socket = new Socket(makeLoopbackAddress(((i / 250 + 1) << 8) | (i % 250 + 1)));
+
+      if(!socket->isValid())
+      {
+         delete socket;
+         socket = new Socket(makeLoopbackAddress(1));
+         fallbacks++;
+      }
+
+      sources.push_back(socket);
+   }
+
+   if(fallbacks)
+      printf("Could only bind %d of %d sources to addresses of their own\n", options.sources - fallbacks, options.sources);
+
+   // Real clients, each with a port of its own on an address the flood doesn't use
+   Vector<NetInterface *> clientInterfaces;
+   Vector<RefPtr<FloodConnection> > clients;
+
+   for(S32 i = 0; i < options.clients; i++)
+   {
+      NetInterface *clientInterface = new NetInterface(makeLoopbackAddress(2));
+      if(!clientInterface->getSocket().isValid())
+      {
+         delete clientInterface;
+         clientInterface = new NetInterface(makeLoopbackAddress(1));
+      }
+
+      clientInterfaces.push_back(clientInterface);
+
+      FloodConnection *conn = new FloodConnection;
+      clients.push_back(conn);
+      conn->connect(clientInterface, serverAddress);
+   }
+
+   // Flood until every packet is sent and every client has connected or given up
+   S32 sent = 0;
+   S32 responses = 0;
+   S32 updates = 0;
+   F64 serverMs = 0;
+   F64 maxUpdateMs = 0;
+
+   U32 startTime = Platform::getRealMilliseconds();
+   const U32 TimeLimit = 30000;
+
+   for(;;)
+   {
+      for(S32 i = 0; i < options.burst && sent < options.packets; i++, sent++)
+      {
+         PacketStream out;
+         writeFloodPacket(out, sent);
+         out.sendto(*sources[sent % sources.size()], serverAddress);
+      }
+
+      S64 updateStart = Platform::getHighPrecisionTimerValue();
+      server.checkIncomingPackets();
+      server.processConnections();
+      F64 updateMs = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - updateStart);
+
+      serverMs += updateMs;
+      maxUpdateMs = max(maxUpdateMs, updateMs);
+      updates++;
+
+      for(S32 i = 0; i < clientInterfaces.size(); i++)
+      {
+         clientInterfaces[i]->checkIncomingPackets();
+         clientInterfaces[i]->processConnections();
+      }
+
+      // Count, and throw away, what the server sent back to the flood
+      for(S32 i = 0; i < sources.size(); i++)
+      {
+         PacketStream incoming;
+         Address from;
+         while(incoming.recvfrom(*sources[i], &from) == NoError)
+            responses++;
+      }
+
+      S32 pending = 0;
+      for(S32 i = 0; i < clients.size(); i++)
+      {
+         if(clients[i]->getConnectionState() < NetConnection::ConnectTimedOut)    // Still getting connected
+            pending++;
+      }
+
+      if(sent >= options.packets && pending == 0)
+         break;
+
+      if(Platform::getRealMilliseconds() - startTime > TimeLimit)
+      {
+         printf("Gave up after %d seconds\n", TimeLimit / 1000);
+         break;
+      }
+
+      Platform::sleep(1);
+   }
+
+   U32 elapsed = Platform::getRealMilliseconds() - startTime;
+
+   S32 connected = 0;
+   for(S32 i = 0; i < clients.size(); i++)
+      if(clients[i]->getConnectionState() == NetConnection::Connected)
+         connected++;
+
+   const NetInterface::HandshakeStats &stats = server.getHandshakeStats();
+
+   printf("Sent %d flood packets from %d sources in %d ms; %d responses came back\n", sent, sources.size(), elapsed, responses);
+   printf("Clients connected: %d of %d\n", connected, clients.size());
+   printf("Server updates: %d, %.2f ms on average, %.2f ms at most\n", updates, updates ? serverMs / updates : 0.0, maxUpdateMs);
+   printf("Handshakes: %d challenges answered, %d packets throttled, %d bad identity tokens, %d connections accepted\n",
+          stats.challengesAnswered, stats.packetsThrottled, stats.badIdentityTokens, stats.connectionsAccepted);
+
+   clients.clear();
+   for(S32 i = 0; i < clientInterfaces.size(); i++)
+      delete clientInterfaces[i];
+
+   for(S32 i = 0; i < sources.size(); i++)
+      delete sources[i];
+
+   return 0;
+}
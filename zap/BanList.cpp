@@ -27,6 +27,11 @@ BanList::BanList(const string &iniDir)
 
    defaultBanDurationMinutes = 60;
    kickDurationMilliseconds = 30 * 1000;     // 30 seconds is a good breather
+
+   mNextBanId = 0;
+
+   for(S32 i = 0; i <= AddressBits; i++)
+      mPrefixLengthCounts[i] = 0;
 }
 
 
@@ -37,6 +42,13 @@ BanList::~BanList()
 }
 
 
+// Min-heap ordering for mExpiryQueue
+bool BanList::BanExpiry::operator>(const BanExpiry &other) const
+{
+   return time > other.time;
+}
+
+
 string addressToString(const Address &address)
 {
    // Build proper IP Address string
@@ -60,26 +72,217 @@ string ptimeToIsoString(const ptime &ptime)
 }
 
 
+static S64 ptimeToSeconds(const ptime &time)
+{
+   static const ptime epoch(boost::gregorian::date(1970, 1, 1));
+   return (time - epoch).total_seconds();
+}
+
+
+// Same clock the ban start times are written with
+S64 BanList::getCurrentTime()
+{
+   return ptimeToSeconds(second_clock::local_time());
+}
+
+
+static U32 prefixMask(S32 prefixLength)
+{
+   return prefixLength == 0 ? 0 : U32(0xFFFFFFFF) << (32 - prefixLength);
+}
+
+
+// Understands "*", "1.2.3.4", "1.2.*" (or "1.2.*.*") and "1.2.0.0/16".  Anything else, including host names, returns
+// false; we don't want to be doing DNS lookups while checking bans.
+bool BanList::parseAddressRange(const string &address, U32 &net, S32 &prefixLength)
+{
+   if(address == "*")
+   {
+      net = 0;
+      prefixLength = 0;
+      return true;
+   }
+
+   string quad = address;
+   S32 cidr = -1;
+
+   size_t slash = address.find('/');
+   if(slash != string::npos)
+   {
+      string bits = address.substr(slash + 1);
+      if(bits.length() < 1 || bits.length() > 2 || bits.find_first_not_of("0123456789") != string::npos)
+         return false;
+
+      cidr = atoi(bits.c_str());
+      if(cidr > AddressBits)
+         return false;
+
+      quad = address.substr(0, slash);
+   }
+
+   Vector<string> octets;
+   parseString(quad.c_str(), octets, '.');
+
+   if(octets.size() < 1 || octets.size() > 4)
+      return false;
+
+   U32 value = 0;
+   S32 knownOctets = 0;
+   bool wildcard = false;
+
+   for(S32 i = 0; i < octets.size(); i++)
+   {
+      if(octets[i] == "*")
+      {
+         wildcard = true;
+         continue;
+      }
+
+      // Nothing but wildcards after the first one
+      if(wildcard || octets[i].length() < 1 || octets[i].length() > 3 ||
+         octets[i].find_first_not_of("0123456789") != string::npos)
+         return false;
+
+      S32 octet = atoi(octets[i].c_str());
+      if(octet > 255)
+         return false;
+
+      value |= U32(octet) << (24 - 8 * i);
+      knownOctets++;
+   }
+
+   // Wildcards and CIDR don't mix, and without a wildcard we need a full address
+   if(wildcard ? cidr != -1 : octets.size() != 4)
+      return false;
+
+   prefixLength = wildcard ? 8 * knownOctets : (cidr == -1 ? AddressBits : cidr);
+   net = value & prefixMask(prefixLength);
+
+   return true;
+}
+
+
+// Fills in the compiled fields of banItem, adds it to the list and the index, and queues it up to expire
+void BanList::addBan(BanItem &banItem, S64 startTime, S32 durationMinutes)
+{
+   banItem.id = mNextBanId++;
+   banItem.expiresAt = startTime + S64(durationMinutes) * 60;
+
+   if(!parseAddressRange(banItem.address, banItem.net, banItem.prefixLength))
+      banItem.prefixLength = -1;
+
+   serverBanList[banItem.id] = banItem;
+   indexBan(banItem);
+
+   BanExpiry expiry;
+   expiry.time = banItem.expiresAt;
+   expiry.id = banItem.id;
+   mExpiryQueue.push(expiry);
+}
+
+
+void BanList::indexBan(const BanItem &banItem)
+{
+   // A name banned from anywhere is found by name; other wildcard bans match every address, so go in with /0
+   if(banItem.address == banListWildcardCharater && banItem.nickname != "*" && banItem.nickname != "*NonAuthenticated")
+      mNicknameIndex[banItem.nickname].push_back(banItem.id);
+
+   else if(banItem.prefixLength >= 0)
+   {
+      mAddressIndex[banItem.prefixLength][banItem.net].push_back(banItem.id);
+      mPrefixLengthCounts[banItem.prefixLength]++;
+   }
+}
+
+
+static void removeId(Vector<U32> &ids, U32 id)
+{
+   for(S32 i = 0; i < ids.size(); i++)
+      if(ids[i] == id)
+      {
+         ids.erase(i);
+         return;
+      }
+}
+
+
+void BanList::unindexBan(const BanItem &banItem)
+{
+   if(banItem.address == banListWildcardCharater && banItem.nickname != "*" && banItem.nickname != "*NonAuthenticated")
+   {
+      NicknameIndex::iterator it = mNicknameIndex.find(banItem.nickname);
+      if(it == mNicknameIndex.end())
+         return;
+
+      removeId(it->second, banItem.id);
+      if(it->second.size() == 0)
+         mNicknameIndex.erase(it);
+   }
+
+   else if(banItem.prefixLength >= 0)
+   {
+      AddressIndex &index = mAddressIndex[banItem.prefixLength];
+      AddressIndex::iterator it = index.find(banItem.net);
+      if(it == index.end())
+         return;
+
+      removeId(it->second, banItem.id);
+      if(it->second.size() == 0)
+         index.erase(it);
+
+      mPrefixLengthCounts[banItem.prefixLength]--;
+   }
+}
+
+
+void BanList::removeBan(U32 id)
+{
+   BanMap::iterator it = serverBanList.find(id);
+   if(it == serverBanList.end())
+      return;
+
+   unindexBan(it->second);
+   serverBanList.erase(it);
+}
+
+
+// Drops bans whose time is up.  Bans removed by other means are still in the queue; we just skip them when they
+// come up.
+void BanList::expireBans(S64 now)
+{
+   while(!mExpiryQueue.empty() && mExpiryQueue.top().time < now)
+   {
+      removeBan(mExpiryQueue.top().id);
+      mExpiryQueue.pop();
+   }
+}
+
+
 void BanList::addToBanList(const Address &address, S32 durationMinutes, bool nonAuthenticatedOnly)
 {
    BanItem banItem;
    banItem.durationMinutes = itos(durationMinutes);
    banItem.address = addressToString(address);
    banItem.nickname = nonAuthenticatedOnly ? "*NonAuthenticated" : "*";
-   banItem.startDateTime = ptimeToIsoString(second_clock::local_time());
 
-   serverBanList.push_back(banItem);
+   ptime now = second_clock::local_time();
+   banItem.startDateTime = ptimeToIsoString(now);
+
+   addBan(banItem, ptimeToSeconds(now), durationMinutes);
 }
 
+
 void BanList::addPlayerNameToBanList(const char *playerName, S32 durationMinutes)
 {
    BanItem banItem;
    banItem.durationMinutes = itos(durationMinutes);
    banItem.address = "*";
    banItem.nickname = playerName;
-   banItem.startDateTime = ptimeToIsoString(second_clock::local_time());
 
-   serverBanList.push_back(banItem);
+   ptime now = second_clock::local_time();
+   banItem.startDateTime = ptimeToIsoString(now);
+
+   addBan(banItem, ptimeToSeconds(now), durationMinutes);
 }
 
 
@@ -111,8 +314,10 @@ bool BanList::processBanListLine(const string &line)
    string startDateTime = words[2];
    string durationMinutes = words[3];
 
-   // Validate IP address string
-   if (!(Address(address.c_str()).isValid()) && address.compare(banListWildcardCharater) != 0)
+   // Validate IP address string; ranges are fine, and anything else has to be something Address understands
+   U32 net;
+   S32 prefixLength;
+   if(!parseAddressRange(address, net, prefixLength) && !(Address(address.c_str()).isValid()))
       return false;
 
    // nickname could be anything...
@@ -133,7 +338,8 @@ bool BanList::processBanListLine(const string &line)
       return false;
 
    // Validate duration
-   if(atoi(durationMinutes.c_str()) <= 0)
+   S32 duration = atoi(durationMinutes.c_str());
+   if(duration <= 0)
       return false;
 
    // Now finally add to banList
@@ -143,14 +349,14 @@ bool BanList::processBanListLine(const string &line)
    banItem.startDateTime = startDateTime;
    banItem.durationMinutes = durationMinutes;
 
-   serverBanList.push_back(banItem);
+   addBan(banItem, ptimeToSeconds(tempDateTime), duration);
 
    // Phoew! we made it..
    return true;
 }
 
 
-string BanList::banItemToString(BanItem *banItem)
+string BanList::banItemToString(const BanItem *banItem)
 {
    // IP, nickname, startTime, duration     <- in this order
 
@@ -164,36 +370,66 @@ string BanList::banItemToString(BanItem *banItem)
 
 bool BanList::isBanned(const Address &address, const string &nickname, bool isAuthenticated)
 {
-   string addressString = addressToString(address);
-   ptime currentTime = second_clock::local_time();
+   return isBanned(address, nickname, isAuthenticated, getCurrentTime());
+}
+
+
+// now is in seconds, as returned by getCurrentTime()
+bool BanList::isBanned(const Address &address, const string &nickname, bool isAuthenticated, S64 now)
+{
+   expireBans(now);
 
-   for (S32 i = 0; i < serverBanList.size(); i++)
+   U32 ip = address.netNum[0];
+
+   // One lookup for each prefix length we have bans for, most specific first
+   for(S32 prefixLength = AddressBits; prefixLength >= 0; prefixLength--)
    {
-      // Check IP
-      if (addressString.compare(serverBanList[i].address) != 0 && serverBanList[i].address.compare("*") != 0)
+      if(mPrefixLengthCounts[prefixLength] == 0)
          continue;
 
-      // Check if authenticated
-      if (serverBanList[i].nickname.compare("*NonAuthenticated") == 0 && isAuthenticated)
-         continue;
+      const AddressIndex &index = mAddressIndex[prefixLength];
+      AddressIndex::const_iterator it = index.find(ip & prefixMask(prefixLength));
 
-      // Check nickname
-      else if (nickname.compare(serverBanList[i].nickname) != 0 && serverBanList[i].nickname.compare("*") != 0)
-         continue;
+      if(it != index.end() && anyBanMatches(it->second, nickname, isAuthenticated, now))
+         return true;
+   }
 
-      // Check time
-      if (from_iso_string(serverBanList[i].startDateTime) + minutes(atoi(serverBanList[i].durationMinutes.c_str())) < currentTime)
-         continue;
+   NicknameIndex::const_iterator it = mNicknameIndex.find(nickname);
 
-      // If we get here, that means nickname and IP address matched and we are still in the
-      // ban allotted time period
-      return true;
+   return it != mNicknameIndex.end() && anyBanMatches(it->second, nickname, isAuthenticated, now);
+}
+
+
+bool BanList::anyBanMatches(const Vector<U32> &ids, const string &nickname, bool isAuthenticated, S64 now) const
+{
+   for(S32 i = 0; i < ids.size(); i++)
+   {
+      BanMap::const_iterator it = serverBanList.find(ids[i]);
+
+      if(it != serverBanList.end() && banMatches(it->second, nickname, isAuthenticated, now))
+         return true;
    }
 
    return false;
 }
 
 
+// The address has already been matched by the index; this checks everything else
+bool BanList::banMatches(const BanItem &banItem, const string &nickname, bool isAuthenticated, S64 now) const
+{
+   // Check if authenticated
+   if(banItem.nickname == "*NonAuthenticated" && isAuthenticated)
+      return false;
+
+   // Check nickname
+   else if(banItem.nickname != nickname && banItem.nickname != "*")
+      return false;
+
+   // Check time
+   return banItem.expiresAt >= now;
+}
+
+
 string BanList::getDelimiter()
 {
    return banListTokenDelimiter;
@@ -218,11 +454,17 @@ S32 BanList::getDefaultBanDuration()
 }
 
 
+S32 BanList::getBanCount() const
+{
+   return (S32)serverBanList.size();
+}
+
+
 Vector<string> BanList::banListToString()
 {
    Vector<string> banList;
-   for(S32 i = 0; i < serverBanList.size(); i++)
-      banList.push_back(banItemToString(&serverBanList[i]));
+   for(BanMap::const_iterator it = serverBanList.begin(); it != serverBanList.end(); it++)
+      banList.push_back(banItemToString(&it->second));
 
    return banList;
 }
@@ -230,7 +472,17 @@ Vector<string> BanList::banListToString()
 
 void BanList::loadBanList(const Vector<string> &banItemList)
 {
-   serverBanList.clear();  // Clear old list for /loadini command.
+   // Clear old list for /loadini command.
+   serverBanList.clear();
+   mNicknameIndex.clear();
+   mExpiryQueue = priority_queue<BanExpiry, vector<BanExpiry>, greater<BanExpiry> >();
+
+   for(S32 i = 0; i <= AddressBits; i++)
+   {
+      mAddressIndex[i].clear();
+      mPrefixLengthCounts[i] = 0;
+   }
+
    for(S32 i = 0; i < banItemList.size(); i++)
       if(!processBanListLine(banItemList[i]))
          logprintf("Ban list item on line %d is malformed: %s", i+1, banItemList[i].c_str());
@@ -9,7 +9,11 @@
 #include "tnlTypes.h"
 #include "tnlUDP.h"
 
+#include <functional>
+#include <map>
+#include <queue>
 #include <string>
+#include <vector>
 
 using namespace TNL;
 using namespace std;
@@ -17,6 +21,11 @@ using namespace std;
 namespace Zap
 {
 
+// Bans are kept in their text form, just as they appear in the INI, and also compiled into an index so that checking
+// a connecting client doesn't mean walking the whole list.  Exact addresses and ranges (1.2.3.*, 1.2.3.0/24 and the
+// like) go into one map per prefix length, so a lookup is one map search per prefix length in use.  Bans on a name
+// from any address go into a map of their own.  Start times and durations are parsed once, when the ban is added, and
+// bans come out of the index, and the list, as they expire.
 class BanList
 {
 private:
@@ -26,6 +35,20 @@ private:
       string nickname;
       string startDateTime;
       string durationMinutes;
+
+      // Compiled from the above
+      U32 id;
+      S64 expiresAt;          // Seconds since the epoch, local time, like startDateTime
+      U32 net;                // Address, masked to prefixLength bits
+      S32 prefixLength;       // -1 if address isn't something we can match against, such as a host name
+   };
+
+   struct BanExpiry
+   {
+      S64 time;
+      U32 id;
+
+      bool operator>(const BanExpiry &other) const;
    };
 
    struct KickedHost {
@@ -33,9 +56,23 @@ private:
       U32 kickTimeRemaining;
    };
 
-   Vector<BanItem> serverBanList;
+   enum {
+      AddressBits = 32,
+   };
+
+   typedef map<U32, BanItem> BanMap;                 // Id -> ban; ids only go up, so this is in the order bans were added
+   typedef map<U32, Vector<U32> > AddressIndex;      // Masked address -> ids of bans on that range
+   typedef map<string, Vector<U32> > NicknameIndex;  // Nickname -> ids of bans on that name from any address
+
+   BanMap serverBanList;
    Vector<KickedHost> serverKickList;
 
+   U32 mNextBanId;
+   AddressIndex mAddressIndex[AddressBits + 1];     // Indexed by prefix length
+   S32 mPrefixLengthCounts[AddressBits + 1];        // Bans in each of the above, so we can skip empty ones
+   NicknameIndex mNicknameIndex;
+   priority_queue<BanExpiry, vector<BanExpiry>, greater<BanExpiry> > mExpiryQueue;
+
    string banListTokenDelimiter;
    string banListWildcardCharater;
 
@@ -43,7 +80,16 @@ private:
    S32 kickDurationMilliseconds;
 
    bool processBanListLine(const string &line);
-   string banItemToString(BanItem *banItem);
+   string banItemToString(const BanItem *banItem);
+
+   void addBan(BanItem &banItem, S64 startTime, S32 durationMinutes);
+   void indexBan(const BanItem &banItem);
+   void unindexBan(const BanItem &banItem);
+   void removeBan(U32 id);
+   void expireBans(S64 now);
+
+   bool banMatches(const BanItem &banItem, const string &nickname, bool isAuthenticated, S64 now) const;
+   bool anyBanMatches(const Vector<U32> &ids, const string &nickname, bool isAuthenticated, S64 now) const;
 
 public:
    explicit BanList(const string &iniDir);
@@ -54,12 +100,18 @@ public:
    void removeFromBanList(const Address &address);
 
    bool isBanned(const Address &address, const string &nickname, bool isAuthenticated);
+   bool isBanned(const Address &address, const string &nickname, bool isAuthenticated, S64 now);
+
+   static bool parseAddressRange(const string &address, U32 &net, S32 &prefixLength);
+   static S64 getCurrentTime();
 
    string getDelimiter();
    string getWildcard();
    S32 getKickDuration();
    S32 getDefaultBanDuration();
 
+   S32 getBanCount() const;
+
    Vector<string> banListToString();
    void loadBanList(const Vector<string> &banItemList);
 
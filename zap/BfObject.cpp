@@ -25,6 +25,8 @@
 #include "MathUtils.h"           // For sq()
 #include "stringUtils.h"         // For itos()
 
+#include "tnlThread.h"
+
 using namespace TNL;
 
 namespace Zap
@@ -233,6 +235,14 @@ bool isZoneType(U8 x)      // Zones a ship could be in
 }
 
 
+// Level geometry that stays put for the whole game; see GridDatabase::buildStaticIndex()
+bool isStaticGeometryType(U8 x)
+{
+   return
+         isWallType(x) || isZoneType(x) || x == ForceFieldTypeNumber;
+}
+
+
 bool isSeekerTarget(U8 x)
 {
    return isShipType(x);
@@ -412,11 +422,20 @@ bool EditorObject::isInEditor() const
 // BfObject - the declarations are in GameObject.h
 
 
+// Levels can be loaded on a LevelPipeline thread while the main thread creates objects of its own, so the counters
+// handing out ids and serial numbers are only touched while holding this
+static Mutex gObjectCounterLock;
+
+
 static S32 getNextDefaultId() 
 {
    static S32 nextId = 0;
-   nextId--;
-   return nextId;
+
+   gObjectCounterLock.lock();
+   S32 id = --nextId;
+   gObjectCounterLock.unlock();
+
+   return id;
 }
 
 
@@ -477,7 +496,9 @@ void BfObject::assignNewSerialNumber()
 {
    static S32 mNextSerialNumber = 0;
 
+   gObjectCounterLock.lock();
    mSerialNumber = mNextSerialNumber++;
+   gObjectCounterLock.unlock();
 }
 
 
@@ -1400,25 +1421,25 @@ void BfObject::writeThisTeam(BitStream *stream)
 // Lua interface
 //               Fn name         Param profiles     Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, getClassId,     ARRAYDEF({{            END }               }), 1 ) \
-   METHOD(CLASS, getObjType,     ARRAYDEF({{            END }               }), 1 ) \
-   METHOD(CLASS, getId,          ARRAYDEF({{            END }               }), 1 ) \
-   METHOD(CLASS, setId,          ARRAYDEF({{ INT,       END }               }), 1 ) \
-   METHOD(CLASS, getLoc,         ARRAYDEF({{            END }               }), 1 ) \
-   METHOD(CLASS, setLoc,         ARRAYDEF({{ PT,        END }               }), 1 ) \
-   METHOD(CLASS, getPos,         ARRAYDEF({{            END }               }), 1 ) \
-   METHOD(CLASS, setPos,         ARRAYDEF({{ PT,        END }               }), 1 ) \
-   METHOD(CLASS, getTeamIndx,    ARRAYDEF({{            END }               }), 1 ) \
-   METHOD(CLASS, getTeamIndex,   ARRAYDEF({{            END }               }), 1 ) \
-   METHOD(CLASS, setTeam,        ARRAYDEF({{ TEAM_INDX, END }               }), 1 ) \
-   METHOD(CLASS, removeFromGame, ARRAYDEF({{            END }               }), 1 ) \
-   METHOD(CLASS, setGeom,        ARRAYDEF({{ PT,        END }, { GEOM, END }}), 2 ) \
-   METHOD(CLASS, getGeom,        ARRAYDEF({{            END }               }), 1 ) \
-   METHOD(CLASS, clone,          ARRAYDEF({{            END }               }), 1 ) \
-   METHOD(CLASS, isSelected,     ARRAYDEF({{            END }               }), 1 ) \
-   METHOD(CLASS, setSelected,    ARRAYDEF({{ BOOL,      END }               }), 1 ) \
-   METHOD(CLASS, getOwner,       ARRAYDEF({{            END }               }), 1 ) \
-   METHOD(CLASS, setOwner,       ARRAYDEF({{ STR,       END }               }), 1 ) \
+   METHOD(CLASS, getClassId,     ARRAYDEF({{            END }               }), 1, READ_ONLY )  \
+   METHOD(CLASS, getObjType,     ARRAYDEF({{            END }               }), 1, READ_ONLY )  \
+   METHOD(CLASS, getId,          ARRAYDEF({{            END }               }), 1, READ_ONLY )  \
+   METHOD(CLASS, setId,          ARRAYDEF({{ INT,       END }               }), 1, READ_WRITE ) \
+   METHOD(CLASS, getLoc,         ARRAYDEF({{            END }               }), 1, READ_ONLY )  \
+   METHOD(CLASS, setLoc,         ARRAYDEF({{ PT,        END }               }), 1, READ_WRITE ) \
+   METHOD(CLASS, getPos,         ARRAYDEF({{            END }               }), 1, READ_ONLY )  \
+   METHOD(CLASS, setPos,         ARRAYDEF({{ PT,        END }               }), 1, READ_WRITE ) \
+   METHOD(CLASS, getTeamIndx,    ARRAYDEF({{            END }               }), 1, READ_ONLY )  \
+   METHOD(CLASS, getTeamIndex,   ARRAYDEF({{            END }               }), 1, READ_ONLY )  \
+   METHOD(CLASS, setTeam,        ARRAYDEF({{ TEAM_INDX, END }               }), 1, READ_WRITE ) \
+   METHOD(CLASS, removeFromGame, ARRAYDEF({{            END }               }), 1, READ_WRITE ) \
+   METHOD(CLASS, setGeom,        ARRAYDEF({{ PT,        END }, { GEOM, END }}), 2, READ_WRITE ) \
+   METHOD(CLASS, getGeom,        ARRAYDEF({{            END }               }), 1, READ_ONLY )  \
+   METHOD(CLASS, clone,          ARRAYDEF({{            END }               }), 1, READ_WRITE ) \
+   METHOD(CLASS, isSelected,     ARRAYDEF({{            END }               }), 1, READ_ONLY )  \
+   METHOD(CLASS, setSelected,    ARRAYDEF({{ BOOL,      END }               }), 1, READ_WRITE ) \
+   METHOD(CLASS, getOwner,       ARRAYDEF({{            END }               }), 1, READ_ONLY )  \
+   METHOD(CLASS, setOwner,       ARRAYDEF({{ STR,       END }               }), 1, READ_WRITE ) \
 
 GENERATE_LUA_METHODS_TABLE(BfObject, LUA_METHODS);
 GENERATE_LUA_FUNARGS_TABLE(BfObject, LUA_METHODS);
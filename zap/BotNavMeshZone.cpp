@@ -19,6 +19,8 @@
 #include <clipper.hpp>
 
 #include <vector>
+#include <queue>
+#include <functional>
 #include <math.h>
 
 
@@ -725,41 +727,107 @@ F32 AStar::heuristic(const Vector<BotNavMeshZone *> *zones, S32 fromZone, S32 to
 }
 
 
-// Returns a path, including the startZone and targetZone 
-Vector<Point> AStar::findPath(const Vector<BotNavMeshZone *> *zones, S32 startZone, S32 targetZone, const Point &target)
+// Scratch space for findZonePath().  Each thread gets its own, so robots ticking in parallel can all search at once.
+struct AStarScratch
+{
+   U32 onClosedList;
+   U32 onOpenList;
+
+   // Because of the two counters above, these arrays can be reused without further initialization
+   Vector<U32> whichList;        // Record whether a zone is on the open or closed list
+   Vector<S32> openList;
+   Vector<S32> openZone;
+   Vector<S32> parentZones;
+
+   Vector<F32> Fcost;
+   Vector<F32> Gcost;
+   Vector<F32> Hcost;
+
+   AStarScratch() { onClosedList = 0; onOpenList = 0; }
+};
+
+static ThreadStorage gAStarScratch;
+
+
+static AStarScratch *getAStarScratch(S32 zoneCount)
 {
-   // Because of these variables...
-   static U16 onClosedList = 0;
-   static U16 onOpenList;
+   AStarScratch *scratch = (AStarScratch *)gAStarScratch.get();
 
-   // ...these arrays can be reused without further initialization
-   static U16 whichList[MAX_ZONES];       // Record whether a zone is on the open or closed list
-   static S16 openList[MAX_ZONES + 1]; 
-   static S16 openZone[MAX_ZONES]; 
-   static S16 parentZones[MAX_ZONES]; 
+   if(!scratch)
+   {
+      scratch = new AStarScratch;      // Lives until the thread calls AStar::releaseThread()
+      gAStarScratch.set(scratch);
+   }
+
+   // Zones are added one at a time as levels get bigger, so new entries must start off on neither list
+   if(scratch->whichList.size() < zoneCount)
+   {
+      S32 oldSize = scratch->whichList.size();
+
+      scratch->whichList.resize(zoneCount);
+      for(S32 i = oldSize; i < zoneCount; i++)
+         scratch->whichList[i] = 0;
+
+      scratch->openList   .resize(zoneCount + 2);
+      scratch->openZone   .resize(zoneCount + 1);
+      scratch->parentZones.resize(zoneCount);
+      scratch->Fcost      .resize(zoneCount + 1);
+      scratch->Gcost      .resize(zoneCount);
+      scratch->Hcost      .resize(zoneCount + 1);
+   }
 
-   static F32 Fcost[MAX_ZONES];   
-   static F32 Gcost[MAX_ZONES];    
-   static F32 Hcost[MAX_ZONES];   
+   return scratch;
+}
+
+
+void AStar::releaseThread()
+{
+   delete (AStarScratch *)gAStarScratch.get();
+   gAStarScratch.set(NULL);
+}
 
-   S16 numberOfOpenListItems = 0;
+// Bots search for paths on the bot tick workers, which come and go with the server
+static Thread::ExitFunctionRegistration gReleaseAStarScratch(&AStar::releaseThread);
+
+
+// Finds the zones along the best route from startZone to targetZone, and puts them in zonePath, starting with
+// targetZone and working back to startZone.  If zoneClusters and allowedClusters are provided, only zones in a
+// cluster with a non-zero entry in allowedClusters are considered.  Returns false if there is no route.
+//
+// Safe to call from several threads at once.
+bool AStar::findZonePath(const Vector<BotNavMeshZone *> *zones, S32 startZone, S32 targetZone, Vector<U16> &zonePath,
+                         const Vector<U16> *zoneClusters, const Vector<U8> *allowedClusters)
+{
+   zonePath.clear();
+
+   AStarScratch *scratch = getAStarScratch(zones->size());
+
+   U32 *whichList    = scratch->whichList.address();
+   S32 *openList     = scratch->openList.address();
+   S32 *openZone     = scratch->openZone.address();
+   S32 *parentZones  = scratch->parentZones.address();
+   F32 *Fcost        = scratch->Fcost.address();
+   F32 *Gcost        = scratch->Gcost.address();
+   F32 *Hcost        = scratch->Hcost.address();
+
+   S32 numberOfOpenListItems = 0;
    bool foundPath;
 
    S32 newOpenListItemID = 0;         // Used for creating new IDs for zones to make heap work
 
-   Vector<Point> path;
-
    // This block here lets us repeatedly reuse the whichList array without resetting it or recreating it
-   // which, for larger numbers of zones should be a real time saver.  It's not clear if it is particularly
-   // more efficient for the zone counts we typically see in Bitfighter levels.
-   if(onClosedList > U16_MAX - 3 ) // Reset whichList when we've run out of headroom
+   // which, for larger numbers of zones should be a real time saver.
+   if(scratch->onClosedList > U32_MAX - 3) // Reset whichList when we've run out of headroom
    {
-      for(S32 i = 0; i < MAX_ZONES; i++) 
+      for(S32 i = 0; i < scratch->whichList.size(); i++) 
          whichList[i] = 0;
-      onClosedList = 0;   
+      scratch->onClosedList = 0;   
    }
-   onClosedList = onClosedList + 2; // Changing the values of onOpenList and onClosed list is faster than redimming whichList() array
-   onOpenList = onClosedList - 1;
+   scratch->onClosedList += 2;   // Changing the values of onOpenList and onClosed list is faster than redimming whichList() array
+   scratch->onOpenList = scratch->onClosedList - 1;
+
+   const U32 onClosedList = scratch->onClosedList;
+   const U32 onOpenList   = scratch->onOpenList;
 
    Gcost[startZone] = 0;         // That's the cost of going from the startZone to the startZone!
    Fcost[0] = Hcost[0] = heuristic(zones, startZone, targetZone);
@@ -798,12 +866,12 @@ Vector<Point> AStar::findPath(const Vector<BotNavMeshZone *> *zones, S32 startZo
             
          //   Delete the top item in binary heap and reorder the heap, with the lowest F cost item rising to the top.
          openList[1] = openList[numberOfOpenListItems + 1];   // Move the last item in the heap up to slot #1
-         S16 v = 1; 
+         S32 v = 1; 
 
          //   Loop until the new item in slot #1 sinks to its proper spot in the heap.
          while(true) // ***
          {
-            S16 u = v;      
+            S32 u = v;      
             if (2 * u + 1 < numberOfOpenListItems) // if both children exist
             {
                // Check if the F cost of the parent is greater than each child,
@@ -822,7 +890,7 @@ Vector<Point> AStar::findPath(const Vector<BotNavMeshZone *> *zones, S32 startZo
 
             if(u != v) // If parent's F is > one of its children, swap them...
             {
-               S16 temp = openList[u];
+               S32 temp = openList[u];
                openList[u] = openList[v];
                openList[v] = temp;         
             }
@@ -836,11 +904,11 @@ Vector<Point> AStar::findPath(const Vector<BotNavMeshZone *> *zones, S32 startZo
          // Add these adjacent child squares to the open list
          //   for later consideration if appropriate.
 
-         Vector<NeighboringZone> neighboringZones = zones->get(parentZone)->mNeighbors;
+         const Vector<NeighboringZone> &neighboringZones = zones->get(parentZone)->mNeighbors;
 
          for(S32 a = 0; a < neighboringZones.size(); a++)
          {
-            NeighboringZone zone = neighboringZones[a];
+            const NeighboringZone &zone = neighboringZones[a];
             S32 zoneID = zone.zoneID;
 
             //   Check if zone is already on the closed list (items on the closed list have
@@ -848,9 +916,12 @@ Vector<Point> AStar::findPath(const Vector<BotNavMeshZone *> *zones, S32 startZo
             if(whichList[zoneID] == onClosedList) 
                continue;
 
+            // Skip zones outside the corridor we've been asked to stay in
+            if(allowedClusters && !allowedClusters->get(zoneClusters->get(zoneID)))
+               continue;
+
             //   Add zone to the open list if it's not already on it
-            TNLAssert(newOpenListItemID < MAX_ZONES, "Too many nav zones... try increasing MAX_ZONES!");
-            if(whichList[zoneID] != onOpenList && newOpenListItemID < MAX_ZONES) 
+            if(whichList[zoneID] != onOpenList) 
             {   
                // Create a new open list item in the binary heap
                newOpenListItemID = newOpenListItemID + 1;   // Give each new item a unique id
@@ -869,7 +940,7 @@ Vector<Point> AStar::findPath(const Vector<BotNavMeshZone *> *zones, S32 startZo
                // or bubbles all the way to the top (if it has the lowest F cost).
                while(m > 1 && Fcost[openList[m]] <= Fcost[openList[m/2]]) 
                {
-                  S16 temp = openList[m/2];
+                  S32 temp = openList[m/2];
                   openList[m/2] = openList[m];
                   openList[m] = temp;
                   m = m/2;
@@ -911,7 +982,7 @@ Vector<Point> AStar::findPath(const Vector<BotNavMeshZone *> *zones, S32 startZo
                         S32 m = i;
                         while(m > 1 && Fcost[openList[m]] < Fcost[openList[m/2]]) 
                         {
-                           S16 temp = openList[m/2];
+                           S32 temp = openList[m/2];
                            openList[m/2] = openList[m];
                            openList[m] = temp;
                            m = m/2;
@@ -934,36 +1005,58 @@ Vector<Point> AStar::findPath(const Vector<BotNavMeshZone *> *zones, S32 startZo
       }
    }
 
-   // Save the path if it exists
    if(!foundPath)
-   {      
-      TNLAssert(path.size() == 0, "Expected empty path!");
-      return path;
-   }
-
-   // Working backwards from the target to the starting location by checking
-   // each cell's parent, figure out the length of the path.
-   //
-   // Fortunately, we want our list to have the closest zone last (see getWaypoint),
-   // so it all works out nicely.
-   //
-   // We'll store both the zone center and the gateway to the neighboring zone.  This
-   // will help keep the robot from getting hung up on blocked but technically visible
-   // paths, such as when we are trying to fly around a protruding wall stub.
+      return false;
 
-   path.push_back(target);                               // First point is the actual target itself
-   path.push_back(zones->get(targetZone)->getCenter());  // Second is the center of the target's zone
-      
+   // Working backwards from the target to the starting location by checking each cell's parent
    S32 zone = targetZone;
+   zonePath.push_back(zone);
 
    while(zone != startZone)
    {
-      path.push_back(findGateway(zones, parentZones[zone], zone));   // Don't switch findGateway arguments, some path is one way (teleporters).
-      zone = parentZones[zone];                                      // Find the parent of the current cell
-      path.push_back(zones->get(zone)->getCenter());
+      zone = parentZones[zone];
+      zonePath.push_back(zone);
    }
 
-   path.push_back(zones->get(startZone)->getCenter());
+   return true;
+}
+
+
+// Turn a list of zones from findZonePath() into points for a bot to follow.  The closest point comes last (see getWaypoint).
+//
+// We'll store both the zone center and the gateway to the neighboring zone.  This will help keep the robot from
+// getting hung up on blocked but technically visible paths, such as when we are trying to fly around a protruding
+// wall stub.
+void AStar::buildWaypoints(const Vector<BotNavMeshZone *> *zones, const Vector<U16> &zonePath, const Point &target,
+                           Vector<Point> &path)
+{
+   path.clear();
+
+   if(zonePath.size() == 0)
+      return;
+
+   path.push_back(target);                                     // First point is the actual target itself
+   path.push_back(zones->get(zonePath[0])->getCenter());       // Second is the center of the target's zone
+
+   for(S32 i = 1; i < zonePath.size(); i++)
+   {
+      path.push_back(findGateway(zones, zonePath[i], zonePath[i - 1]));   // Don't switch findGateway arguments, some path is one way (teleporters).
+      path.push_back(zones->get(zonePath[i])->getCenter());
+   }
+
+   path.push_back(zones->get(zonePath.last())->getCenter());
+}
+
+
+// Returns a path, including the startZone and targetZone 
+Vector<Point> AStar::findPath(const Vector<BotNavMeshZone *> *zones, S32 startZone, S32 targetZone, const Point &target)
+{
+   Vector<U16> zonePath;
+   Vector<Point> path;
+
+   if(findZonePath(zones, startZone, targetZone, zonePath))
+      buildWaypoints(zones, zonePath, target, path);
+
    return path;
 }
 
@@ -978,6 +1071,550 @@ Point AStar::findGateway(const Vector<BotNavMeshZone *> *zones, S32 zone1, S32 z
 }
 
 
+////////////////////////////////////////
+////////////////////////////////////////
+
+static const S32 ZonesPerCluster = 32;             // Roughly how many zones get grouped together in the hierarchical search
+static const S32 ClusterThreshold = 512;           // Levels with at least this many zones use the hierarchical search by default
+static const S32 MaxNextHopTableZones = 2000;      // Biggest level we'll build a next hop table for; it needs 2 bytes per pair of zones
+
+
+// Works out the next hop table for BotPathFinder on a thread of its own.  Takes a copy of the nav mesh's connections
+// up front, so the zones themselves can go away (with their level) while it's still running.
+class NextHopTableBuilder : public Thread
+{
+private:
+   S32 mZoneCount;
+
+   // Connections, stored backwards: the zones leading into zone i are mFrom[mFirstFrom[i]] to mFrom[mFirstFrom[i + 1] - 1]
+   Vector<S32> mFirstFrom;
+   Vector<U16> mFrom;
+   Vector<F32> mCost;
+
+   Mutex mLock;
+   bool mCancelled;
+   bool mFinished;
+   Semaphore mDone;
+   bool mJoined;              // Only touched by the thread that owns us
+
+   bool isCancelled()
+   {
+      mLock.lock();
+      bool cancelled = mCancelled;
+      mLock.unlock();
+
+      return cancelled;
+   }
+
+public:
+   Vector<U16> nextHops;      // Row per target zone; see BotPathFinder::mNextHops
+
+   explicit NextHopTableBuilder(const Vector<BotNavMeshZone *> &zones)
+   {
+      mZoneCount = zones.size();
+      mCancelled = false;
+      mFinished = false;
+      mJoined = false;
+
+      mFirstFrom.resize(mZoneCount + 1);
+      for(S32 i = 0; i <= mZoneCount; i++)
+         mFirstFrom[i] = 0;
+
+      for(S32 i = 0; i < mZoneCount; i++)
+         for(S32 j = 0; j < zones[i]->mNeighbors.size(); j++)
+            mFirstFrom[zones[i]->mNeighbors[j].zoneID + 1]++;
+
+      for(S32 i = 0; i < mZoneCount; i++)
+         mFirstFrom[i + 1] += mFirstFrom[i];
+
+      mFrom.resize(mFirstFrom[mZoneCount]);
+      mCost.resize(mFirstFrom[mZoneCount]);
+
+      Vector<S32> fill;
+      fill.resize(mZoneCount);
+      for(S32 i = 0; i < mZoneCount; i++)
+         fill[i] = mFirstFrom[i];
+
+      for(S32 i = 0; i < mZoneCount; i++)
+         for(S32 j = 0; j < zones[i]->mNeighbors.size(); j++)
+         {
+            const NeighboringZone &neighbor = zones[i]->mNeighbors[j];
+            S32 index = fill[neighbor.zoneID]++;
+
+            mFrom[index] = (U16)i;
+            mCost[index] = neighbor.distTo;
+         }
+   }
+
+   // Dijkstra backwards from each zone in turn; whichever way we reach a zone from is its next hop toward the target
+   U32 run()
+   {
+      typedef pair<F32, S32> OpenZone;    // Cost to target, zone
+
+      nextHops.resize(mZoneCount * mZoneCount);
+
+      Vector<F32> cost;
+      cost.resize(mZoneCount);
+
+      for(S32 target = 0; target < mZoneCount && !isCancelled(); target++)
+      {
+         U16 *row = nextHops.address() + target * mZoneCount;
+
+         for(S32 i = 0; i < mZoneCount; i++)
+         {
+            row[i] = U16_MAX;
+            cost[i] = F32_MAX;
+         }
+
+         priority_queue<OpenZone, vector<OpenZone>, greater<OpenZone> > open;
+
+         row[target] = (U16)target;
+         cost[target] = 0;
+         open.push(OpenZone(0, target));
+
+         while(!open.empty())
+         {
+            OpenZone best = open.top();
+            open.pop();
+
+            if(best.first > cost[best.second])     // Stale entry
+               continue;
+
+            for(S32 i = mFirstFrom[best.second]; i < mFirstFrom[best.second + 1]; i++)
+            {
+               F32 newCost = best.first + mCost[i];
+
+               if(newCost < cost[mFrom[i]])
+               {
+                  cost[mFrom[i]] = newCost;
+                  row[mFrom[i]] = (U16)best.second;
+                  open.push(OpenZone(newCost, mFrom[i]));
+               }
+            }
+         }
+      }
+
+      mLock.lock();
+      mFinished = !mCancelled;
+      mLock.unlock();
+
+      mDone.increment();
+      return 0;
+   }
+
+   bool isFinished()
+   {
+      mLock.lock();
+      bool finished = mFinished;
+      mLock.unlock();
+
+      return finished;
+   }
+
+   // Stop as soon as possible, and wait for the thread to end
+   void cancel()
+   {
+      mLock.lock();
+      mCancelled = true;
+      mLock.unlock();
+
+      finish();
+   }
+
+   // Wait for the thread to end, however long that takes
+   void finish()
+   {
+      if(!mJoined)
+         mDone.wait();
+
+      mJoined = true;
+   }
+};
+
+
+// Constructor
+BotPathFinder::BotPathFinder()
+{
+   mZones = NULL;
+   mUseClusters = false;
+   mUseNextHopTable = false;
+   mTableBuilder = NULL;
+   mNextHopZoneCount = 0;
+}
+
+
+// Destructor
+BotPathFinder::~BotPathFinder()
+{
+   stopTableBuilder();
+}
+
+
+// Call whenever the nav mesh is rebuilt; forgets any paths we've cached for the old one.  If useNextHopTable is set,
+// and the level is small enough, starts working out the next hop table in the background; until it's ready, paths
+// are searched for as usual.
+void BotPathFinder::reset(const Vector<BotNavMeshZone *> *zones, bool useNextHopTable)
+{
+   stopTableBuilder();
+
+   mCacheLock.lock();
+   mCache.clear();
+   mNextHops.clear();
+   mNextHopZoneCount = 0;
+   mCacheLock.unlock();
+
+   mZones = zones;
+   mUseNextHopTable = useNextHopTable;
+
+   setUseClusters(zones && zones->size() >= ClusterThreshold);
+
+   if(mUseNextHopTable && mZones && mZones->size() > 0 && mZones->size() <= MaxNextHopTableZones)
+   {
+      mTableBuilder = new NextHopTableBuilder(*mZones);
+
+      if(!mTableBuilder->start())
+      {
+         logprintf(LogConsumer::LogError, "Could not start thread to build bot next hop table; bots will search for paths instead");
+         delete mTableBuilder;
+         mTableBuilder = NULL;
+      }
+   }
+}
+
+
+void BotPathFinder::stopTableBuilder()
+{
+   if(!mTableBuilder)
+      return;
+
+   mTableBuilder->cancel();
+   delete mTableBuilder;
+   mTableBuilder = NULL;
+}
+
+
+// Take the next hop table if the builder is done with it.  Call with mCacheLock held.
+void BotPathFinder::collectNextHopTable()
+{
+   if(!mTableBuilder || !mTableBuilder->isFinished())
+      return;
+
+   mTableBuilder->finish();
+
+   mNextHops.getStlVector().swap(mTableBuilder->nextHops.getStlVector());
+   mNextHopZoneCount = mZones->size();
+
+   delete mTableBuilder;
+   mTableBuilder = NULL;
+}
+
+
+// Block until the next hop table is ready; returns false if none is being built.  Mostly for testing.
+bool BotPathFinder::waitForNextHopTable()
+{
+   mCacheLock.lock();
+
+   if(mTableBuilder)
+      mTableBuilder->finish();
+
+   collectNextHopTable();
+   bool ready = mNextHopZoneCount > 0;
+   mCacheLock.unlock();
+
+   return ready;
+}
+
+
+bool BotPathFinder::hasNextHopTable()
+{
+   mCacheLock.lock();
+   collectNextHopTable();
+   bool ready = mNextHopZoneCount > 0;
+   mCacheLock.unlock();
+
+   return ready;
+}
+
+
+// Switch the hierarchical search on or off.  Don't call while bots might be looking for paths.
+void BotPathFinder::setUseClusters(bool useClusters)
+{
+   mUseClusters = useClusters;
+
+   mZoneClusters.clear();
+   mClusterCenters.clear();
+   mClusterNeighbors.clear();
+
+   if(mUseClusters && mZones)
+      buildClusters();
+
+   // Cached paths may have come from the other search
+   mCacheLock.lock();
+   mCache.clear();
+   mCacheLock.unlock();
+}
+
+
+bool BotPathFinder::getUseClusters() const
+{
+   return mUseClusters;
+}
+
+
+S32 BotPathFinder::getClusterCount() const
+{
+   return mClusterCenters.size();
+}
+
+
+S32 BotPathFinder::getCachedPathCount()
+{
+   mCacheLock.lock();
+   S32 count = (S32)mCache.size();
+   mCacheLock.unlock();
+
+   return count;
+}
+
+
+// Group neighboring zones into clusters of about ZonesPerCluster zones each, by flooding out from each zone that
+// hasn't been claimed yet.  Two clusters are neighbors if any of their zones are.
+void BotPathFinder::buildClusters()
+{
+   static const U16 Unclaimed = U16_MAX;
+
+   const Vector<BotNavMeshZone *> &zones = *mZones;
+
+   mZoneClusters.resize(zones.size());
+   for(S32 i = 0; i < zones.size(); i++)
+      mZoneClusters[i] = Unclaimed;
+
+   Vector<S32> frontier;
+
+   for(S32 i = 0; i < zones.size(); i++)
+   {
+      if(mZoneClusters[i] != Unclaimed)
+         continue;
+
+      U16 cluster = (U16)mClusterCenters.size();
+      Point centerSum(0, 0);
+      S32 members = 0;
+
+      frontier.clear();
+      frontier.push_back(i);
+      mZoneClusters[i] = cluster;
+
+      for(S32 j = 0; j < frontier.size() && members < ZonesPerCluster; j++)
+      {
+         BotNavMeshZone *zone = zones[frontier[j]];
+
+         centerSum += zone->getCenter();
+         members++;
+
+         for(S32 k = 0; k < zone->mNeighbors.size() && frontier.size() < ZonesPerCluster; k++)
+         {
+            U16 neighbor = zone->mNeighbors[k].zoneID;
+
+            if(mZoneClusters[neighbor] == Unclaimed)
+            {
+               mZoneClusters[neighbor] = cluster;
+               frontier.push_back(neighbor);
+            }
+         }
+      }
+
+      mClusterCenters.push_back(centerSum / (F32)members);
+   }
+
+   mClusterNeighbors.resize(mClusterCenters.size());
+
+   for(S32 i = 0; i < zones.size(); i++)
+   {
+      U16 cluster = mZoneClusters[i];
+
+      for(S32 j = 0; j < zones[i]->mNeighbors.size(); j++)
+      {
+         U16 neighborCluster = mZoneClusters[zones[i]->mNeighbors[j].zoneID];
+
+         if(neighborCluster != cluster && !mClusterNeighbors[cluster].contains(neighborCluster))
+            mClusterNeighbors[cluster].push_back(neighborCluster);
+      }
+   }
+}
+
+
+// Dijkstra over the cluster graph.  Marks every cluster on the route in allowedClusters, plus their immediate
+// neighbors so the zone level search has a little room to cut corners.  Returns false if targetCluster can't be
+// reached at all.
+bool BotPathFinder::findClusterCorridor(U16 startCluster, U16 targetCluster, Vector<U8> &allowedClusters) const
+{
+   typedef pair<F32, S32> OpenCluster;    // Cost so far, cluster
+
+   S32 clusterCount = mClusterCenters.size();
+
+   Vector<F32> cost;
+   Vector<S32> parent;
+
+   cost.resize(clusterCount);
+   parent.resize(clusterCount);
+
+   for(S32 i = 0; i < clusterCount; i++)
+   {
+      cost[i] = F32_MAX;
+      parent[i] = -1;
+   }
+
+   priority_queue<OpenCluster, vector<OpenCluster>, greater<OpenCluster> > open;
+
+   cost[startCluster] = 0;
+   open.push(OpenCluster(0, startCluster));
+
+   bool found = false;
+
+   while(!open.empty())
+   {
+      OpenCluster best = open.top();
+      open.pop();
+
+      if(best.first > cost[best.second])     // Stale entry; we've found a better way here since it was added
+         continue;
+
+      if(best.second == targetCluster)
+      {
+         found = true;
+         break;
+      }
+
+      const Vector<U16> &neighbors = mClusterNeighbors[best.second];
+      for(S32 i = 0; i < neighbors.size(); i++)
+      {
+         F32 newCost = best.first + mClusterCenters[best.second].distanceTo(mClusterCenters[neighbors[i]]);
+
+         if(newCost < cost[neighbors[i]])
+         {
+            cost[neighbors[i]] = newCost;
+            parent[neighbors[i]] = best.second;
+            open.push(OpenCluster(newCost, neighbors[i]));
+         }
+      }
+   }
+
+   if(!found)
+      return false;
+
+   allowedClusters.resize(clusterCount);
+   for(S32 i = 0; i < clusterCount; i++)
+      allowedClusters[i] = 0;
+
+   for(S32 cluster = targetCluster; cluster != -1; cluster = parent[cluster])
+   {
+      allowedClusters[cluster] = 1;
+
+      for(S32 i = 0; i < mClusterNeighbors[cluster].size(); i++)
+         allowedClusters[mClusterNeighbors[cluster][i]] = 1;
+   }
+
+   return true;
+}
+
+
+// Zone level search, using the cluster corridor to narrow things down when the hierarchical search is on
+bool BotPathFinder::searchZonePath(S32 startZone, S32 targetZone, Vector<U16> &zonePath) const
+{
+   if(!mUseClusters || mZoneClusters[startZone] == mZoneClusters[targetZone])
+      return AStar::findZonePath(mZones, startZone, targetZone, zonePath);
+
+   Vector<U8> allowedClusters;
+
+   // If the clusters aren't connected, the zones can't be either
+   if(!findClusterCorridor(mZoneClusters[startZone], mZoneClusters[targetZone], allowedClusters))
+      return false;
+
+   if(AStar::findZonePath(mZones, startZone, targetZone, zonePath, &mZoneClusters, &allowedClusters))
+      return true;
+
+   // Corridor was too tight (one way teleporters can do this); fall back to searching everything
+   return AStar::findZonePath(mZones, startZone, targetZone, zonePath);
+}
+
+
+// Follow the next hop table from startZone to targetZone, and put the zones in zonePath, in the same order
+// AStar::findZonePath() uses.  Leaves zonePath empty if there is no route.
+void BotPathFinder::walkNextHopTable(S32 startZone, S32 targetZone, Vector<U16> &zonePath) const
+{
+   zonePath.clear();
+
+   const U16 *row = mNextHops.address() + targetZone * mNextHopZoneCount;
+
+   if(row[startZone] == U16_MAX)
+      return;
+
+   S32 zone = startZone;
+   zonePath.push_back(zone);
+
+   while(zone != targetZone)
+   {
+      zone = row[zone];
+      zonePath.push_back(zone);
+
+      TNLAssert(zonePath.size() <= mNextHopZoneCount, "Loop in next hop table!");
+   }
+
+   zonePath.reverse();
+}
+
+
+// Fills path with waypoints from startZone to target, which lies in targetZone; see AStar::buildWaypoints() for the
+// format.  Routes between zones are cached, so only the first bot to ask about a pair of zones pays for the search.
+// Returns false if there is no route.  Safe to call from several threads at once.
+bool BotPathFinder::findPath(S32 startZone, S32 targetZone, const Point &target, Vector<Point> &path)
+{
+   path.clear();
+
+   if(!mZones || startZone < 0 || targetZone < 0 || startZone >= mZones->size() || targetZone >= mZones->size())
+      return false;
+
+   pair<U16, U16> key((U16)startZone, (U16)targetZone);
+   Vector<U16> zonePath;
+   bool found;
+
+   mCacheLock.lock();
+   collectNextHopTable();
+   bool haveTable = mNextHopZoneCount > 0;
+   mCacheLock.unlock();
+
+   // Once it's ready, the table doesn't change until the next reset(), so we can read it without the lock
+   if(haveTable)
+   {
+      walkNextHopTable(startZone, targetZone, zonePath);
+      AStar::buildWaypoints(mZones, zonePath, target, path);
+
+      return path.size() > 0;
+   }
+
+   mCacheLock.lock();
+   PathCache::const_iterator it = mCache.find(key);
+   found = (it != mCache.end());
+   if(found)
+      zonePath = it->second;
+   mCacheLock.unlock();
+
+   if(!found)
+   {
+      // Search without holding the lock; if another thread beats us to it, we'll just find the same thing
+      searchZonePath(startZone, targetZone, zonePath);
+
+      mCacheLock.lock();
+      mCache[key] = zonePath;          // Empty when there's no route, which is worth remembering too
+      mCacheLock.unlock();
+   }
+
+   AStar::buildWaypoints(mZones, zonePath, target, path);
+
+   return path.size() > 0;
+}
+
+
 };
 
 
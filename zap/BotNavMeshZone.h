@@ -9,6 +9,10 @@
 #include "gridDB.h"            // Parent
 #include "../recast/Recast.h"  // for rcPolyMesh;
 
+#include "tnlThread.h"
+
+#include <map>
+
 namespace Zap
 {
 
@@ -103,11 +107,73 @@ private:
    static Point findGateway(const Vector<BotNavMeshZone *> *zones, S32 zone1, S32 zone2);
 
 public:
+   static bool findZonePath(const Vector<BotNavMeshZone *> *zones, S32 startZone, S32 targetZone, Vector<U16> &zonePath,
+                            const Vector<U16> *zoneClusters = NULL, const Vector<U8> *allowedClusters = NULL);
+   static void buildWaypoints(const Vector<BotNavMeshZone *> *zones, const Vector<U16> &zonePath, const Point &target,
+                              Vector<Point> &path);
+
    static Vector<Point> findPath (const Vector<BotNavMeshZone *> *zones, S32 startZone, S32 targetZone, const Point &target);
+
+   static void releaseThread();     // Frees the calling thread's scratch space; runs as a Thread exit function
    
 };
 
 
+////////////////////////////////////////
+////////////////////////////////////////
+
+class NextHopTableBuilder;
+
+// Finds routes for bots across the current level's nav mesh, caching the result for each pair of zones.  On large
+// levels, zones are also grouped into clusters, and a quick search over the clusters narrows down the zones the full
+// search needs to look at.  On smaller ones, a table of the next zone to head for, for every pair of zones, can be
+// built in the background, after which routes are just looked up.  Server only; findPath() may be called from
+// several threads at once.
+class BotPathFinder
+{
+private:
+   typedef map<pair<U16, U16>, Vector<U16> > PathCache;
+
+   const Vector<BotNavMeshZone *> *mZones;
+
+   PathCache mCache;                         // Zone-to-zone routes, shared by all bots
+   Mutex mCacheLock;
+
+   bool mUseClusters;
+   Vector<U16> mZoneClusters;                // Cluster each zone belongs to
+   Vector<Point> mClusterCenters;
+   Vector<Vector<U16> > mClusterNeighbors;
+
+   bool mUseNextHopTable;
+   NextHopTableBuilder *mTableBuilder;       // Non-NULL while the table is being built
+   Vector<U16> mNextHops;                    // Entry [target * mNextHopZoneCount + zone] is the zone to head for
+   S32 mNextHopZoneCount;                    // from zone to get to target, or U16_MAX if there's no way; 0 if no table
+
+   void buildClusters();
+   void stopTableBuilder();
+   void collectNextHopTable();
+   void walkNextHopTable(S32 startZone, S32 targetZone, Vector<U16> &zonePath) const;
+   bool findClusterCorridor(U16 startCluster, U16 targetCluster, Vector<U8> &allowedClusters) const;
+   bool searchZonePath(S32 startZone, S32 targetZone, Vector<U16> &zonePath) const;
+
+public:
+   BotPathFinder();              // Constructor
+   virtual ~BotPathFinder();     // Destructor
+
+   void reset(const Vector<BotNavMeshZone *> *zones, bool useNextHopTable = false);
+
+   void setUseClusters(bool useClusters);
+   bool getUseClusters() const;
+   S32 getClusterCount() const;
+   S32 getCachedPathCount();
+
+   bool hasNextHopTable();
+   bool waitForNextHopTable();
+
+   bool findPath(S32 startZone, S32 targetZone, const Point &target, Vector<Point> &path);
+};
+
+
 };
 
 
@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "BotTickScheduler.h"
+
+#include "EventManager.h"
+#include "LuaScriptRunner.h"
+#include "LuaWrapper.h"
+#include "ServerGame.h"
+
+#include "tnlLog.h"
+#include "tnlNetStringTable.h"
+#include "tnlRandom.h"
+
+
+namespace Zap
+{
+
+void BotTickScheduler::Workers::doWork(U32 index, U32 shareCount)
+{
+   mScheduler->tickScripts();
+}
+
+
+// Constructor
+BotTickScheduler::BotTickScheduler(ServerGame *game)
+{
+   mGame = game;
+   mWorkers.mScheduler = this;
+   mNextScript = 0;
+   mDeltaT = 0;
+}
+
+
+// Destructor
+BotTickScheduler::~BotTickScheduler()
+{
+   stopWorkers();
+}
+
+
+void BotTickScheduler::setWorkerCount(U32 count)
+{
+   U32 started = mWorkers.start(count);
+
+   if(started < count)
+      logprintf(LogConsumer::LogError, "Could only start %d of %d bot worker threads", started, count);
+}
+
+
+S32 BotTickScheduler::getWorkerCount() const
+{
+   return mWorkers.getWorkerCount();
+}
+
+
+void BotTickScheduler::stopWorkers()
+{
+   mWorkers.stop();
+}
+
+
+// Bots vary wildly in how long they take, so rather than carving up the list ahead of time, each thread just grabs
+// the next script nobody has started on yet
+void BotTickScheduler::tickScripts()
+{
+   luaW_setWorldLocked(true);
+
+   for(;;)
+   {
+      mNextScriptLock.lock();
+      S32 index = mNextScript++;
+      mNextScriptLock.unlock();
+
+      if(index >= mScripts.size())
+         break;
+
+      EventManager::get()->fireTickEvent(mScripts[index], mDeltaT);
+   }
+
+   luaW_setWorldLocked(false);
+}
+
+
+void BotTickScheduler::fireTickEvent(U32 deltaT)
+{
+   // Anything on the shared Lua state gets ticked here, the rest is returned to us
+   EventManager::get()->fireEvent(EventManager::TickEvent, deltaT, &mScripts);
+
+   if(mScripts.size() == 0)
+      return;
+
+   mGame->getGameInfo();         // Built on first use, so make sure that doesn't happen on a worker
+
+   mDeltaT = deltaT;
+   mNextScript = 0;
+
+   // Bots share the string table, and math.random reads from TNL::Random
+   StringTable::setThreadSafe(true);
+   Random::setThreadSafe(true);
+
+   mWorkers.run();
+
+   Random::setThreadSafe(false);
+   StringTable::setThreadSafe(false);
+
+   // Now apply whatever the bots asked for, in the order they'd have asked for it had they run one after another
+   for(S32 i = 0; i < mScripts.size(); i++)
+      mScripts[i]->runDeferredCalls();
+
+   mScripts.clear();
+}
+
+
+}
+
@@ -0,0 +1,62 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _BOT_TICK_SCHEDULER_H_
+#define _BOT_TICK_SCHEDULER_H_
+
+#include "tnlThread.h"
+#include "tnlVector.h"
+
+using namespace TNL;
+
+namespace Zap
+{
+
+class ServerGame;
+class LuaScriptRunner;
+
+// Fires the bots' onTick events, running scripts that have Lua states of their own on a pool of worker threads.
+// Scripts sharing the global Lua state are ticked on the main thread, as they always have been.
+//
+// While workers are running, the world is locked: methods marked READ_ONLY in their class's method table run
+// straight away, while anything that would change the game is queued up and replayed on the main thread, in order, once
+// every bot has finished.  Server only.
+class BotTickScheduler
+{
+private:
+   // Every share of the job is the same: keep ticking scripts until there are none left
+   class Workers : public WorkerPool
+   {
+   public:
+      BotTickScheduler *mScheduler;
+      void doWork(U32 index, U32 shareCount);
+   };
+
+   ServerGame *mGame;
+
+   Workers mWorkers;
+
+   Vector<LuaScriptRunner *> mScripts;    // Scripts to tick this time around
+   S32 mNextScript;                       // Next entry in mScripts waiting for a thread to pick it up
+   Mutex mNextScriptLock;
+   U32 mDeltaT;
+
+   void tickScripts();                    // Run on every thread, until mScripts is used up
+
+public:
+   explicit BotTickScheduler(ServerGame *game);    // Constructor
+   virtual ~BotTickScheduler();                    // Destructor
+
+   void setWorkerCount(U32 count);
+   S32 getWorkerCount() const;
+   void stopWorkers();
+
+   void fireTickEvent(U32 deltaT);
+};
+
+}
+
+#endif
+
@@ -940,6 +940,20 @@ void unlockTeams(ClientGame *game, const Vector<string> &words)
 }
 
 
+// Everything happens on the server; we just pass the arguments along
+void profileHandler(ClientGame *game, const Vector<string> &words)
+{
+   if(!game->hasAdmin("!!! Need admin permissions to use the profiler"))
+      return;
+
+   Vector<StringPtr> args;
+   for(S32 i = 1; i < words.size(); i++)
+      args.push_back(StringPtr(words[i]));
+
+   game->sendCommand("profile", args);
+}
+
+
 void banPlayerHandler(ClientGame *game, const Vector<string> &words)
 {
    if(!game->hasAdmin("!!! Need admin permissions to ban players"))
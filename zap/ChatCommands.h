@@ -129,6 +129,7 @@ void rateMapHandler            (ClientGame *game, const Vector<string> &args);
 void pauseHandler              (ClientGame *game, const Vector<string> &args);
 void lockTeams                 (ClientGame *game, const Vector<string> &args);
 void unlockTeams               (ClientGame *game, const Vector<string> &args);
+void profileHandler            (ClientGame *game, const Vector<string> &args);
 
 
 // The following are only available in debug builds!
@@ -88,6 +88,7 @@ namespace Zap
    { "shuffle",            &ChatCommands::shuffleTeams,              { },            0, ADMIN_COMMANDS,  0,  1,  { "" },                  "Randomly reshuffle teams" },
    { "lockteams",          &ChatCommands::lockTeams,                 { },            0, ADMIN_COMMANDS,  0,  1,  { "" },                  "Lock teams - teams same every game, players may not change" },
    { "unlockteams",        &ChatCommands::unlockTeams,               { },            0, ADMIN_COMMANDS,  0,  1,  { "" },                  "Unlock teams - Teams revert to normal behavior" },
+   { "profile",            &ChatCommands::profileHandler,            { STR },        1, ADMIN_COMMANDS,  0,  1,  {"[on|off|secs]"},       "Start or stop server tick profiler, or save last [secs] as a trace" },
 
    { "setownerpass", &ChatCommands::setOwnerPassHandler,       { STR },        1, OWNER_COMMANDS,  0,  1,  {"[passwd]"},            "Set owner password" },
    { "setadminpass", &ChatCommands::setAdminPassHandler,       { STR },        1, OWNER_COMMANDS,  0,  1,  {"[passwd]"},            "Set admin password" },
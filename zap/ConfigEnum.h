@@ -91,6 +91,13 @@
    SETTINGS_ITEM(YesNo,              GameRecordingDownload,    "Host",           "GameRecordingDownload",    No,                              NULL,     NULL,     "If Yes, other players can download")                                                                                           \
    SETTINGS_ITEM(U32,                MaxFpsServer,             "Host",           "MaxFPS",                   100,                             NULL,     NULL,     "Maximum FPS the dedicated server will run at.  Higher values use more CPU (and power), lower may increase lag.\n"              \
                                                                                                                                                                   "Specify 0 for no limit. Negative values will not make Bitfighter run backwards.  Sorry.  (default = 100)")                     \
+   SETTINGS_ITEM(YesNo,              ArrayBucketDatabase,      "Host",           "ArrayBucketDatabase",      No,                              NULL,     NULL,     "Store the spatial database in contiguous per-bucket arrays rather than linked lists.  Experimental (Yes/No)")                  \
+   SETTINGS_ITEM(U32,                NetWorkers,               "Host",           "NetWorkers",               0,                               NULL,     NULL,     "Number of extra threads used to build packets for connected players; 0 does all the work on the main thread (default = 0)")   \
+   SETTINGS_ITEM(U32,                BotWorkers,               "Host",           "BotWorkers",               0,                               NULL,     NULL,     "Number of extra threads used to run robot scripts; each bot then gets its own Lua state.  0 runs every bot on the main thread (default = 0)")   \
+   SETTINGS_ITEM(YesNo,              BotNextHopTable,          "Host",           "BotNextHopTable",          Yes,                             NULL,     NULL,     "On levels with up to 2000 bot zones, work out every route bots could need in the background, so they never have to search (Yes/No)")   \
+   SETTINGS_ITEM(U32,                Arenas,                   "Host",           "Arenas",                   1,                               NULL,     NULL,     "Number of games a dedicated server hosts at once, each on its own port, counting up from the host address's port (default = 1)")   \
+   SETTINGS_ITEM(YesNo,              EventDrivenLoop,          "Host",           "EventDrivenLoop",          No,                              NULL,     NULL,     "Dedicated server wakes up when packets arrive or a tick is due, rather than polling every millisecond.  Experimental (Yes/No)")   \
+   SETTINGS_ITEM(YesNo,              LevelGeometryCache,       "Host",           "LevelGeometryCache",       Yes,                             NULL,     NULL,     "Keep the wall edges and bot zones of levels that have been played in the levelcache folder, so they load faster next time (Yes/No)")   \
    MYSQL_SETTINGS_TABLE_ENTRY                                                                                                                                                                                                                                                                     \
                                                                                                                                                                                                                                                                                                   \
    SETTINGS_ITEM(YesNo,              VotingEnabled,            "Host-Voting",    "VoteEnable",               No,                              NULL,     NULL,     "Enable voting on this server")                                                                                                 \
@@ -1106,9 +1106,9 @@ bool CoreItem::canBeNeutral() { return true; }
  */
 //               Fn name    Param profiles         Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, getCurrentHealth, ARRAYDEF({{          END }}), 1 ) \
-   METHOD(CLASS, getFullHealth,    ARRAYDEF({{          END }}), 1 ) \
-   METHOD(CLASS, setFullHealth,    ARRAYDEF({{ NUM_GE0, END }}), 1 ) \
+   METHOD(CLASS, getCurrentHealth, ARRAYDEF({{          END }}), 1, READ_ONLY )  \
+   METHOD(CLASS, getFullHealth,    ARRAYDEF({{          END }}), 1, READ_ONLY )  \
+   METHOD(CLASS, setFullHealth,    ARRAYDEF({{ NUM_GE0, END }}), 1, READ_WRITE ) \
 
 GENERATE_LUA_METHODS_TABLE(CoreItem, LUA_METHODS);
 GENERATE_LUA_FUNARGS_TABLE(CoreItem, LUA_METHODS);
@@ -250,16 +250,16 @@ REGISTER_LUA_CLASS(EditorPlugin);
 
 //               Fn name    Param profiles         Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, getGridSize,        ARRAYDEF({{ END          }                    }), 1 ) \
-   METHOD(CLASS, getSelectedObjects, ARRAYDEF({{ END          }                    }), 1 ) \
-   METHOD(CLASS, getAllObjects,      ARRAYDEF({{ END          }                    }), 1 ) \
-   METHOD(CLASS, showMessage,        ARRAYDEF({{ STR,     END }, { STR, BOOL, END }}), 2 ) \
-   METHOD(CLASS, setDisplayCenter,   ARRAYDEF({{ PT,      END }                    }), 1 ) \
-   METHOD(CLASS, setDisplayExtents,  ARRAYDEF({{ PT, PT,  END }                    }), 1 ) \
-   METHOD(CLASS, setDisplayZoom,     ARRAYDEF({{ NUM_GE0, END }                    }), 1 ) \
-   METHOD(CLASS, getDisplayCenter,   ARRAYDEF({{ END          }                    }), 1 ) \
-   METHOD(CLASS, getDisplayExtents,  ARRAYDEF({{ END          }                    }), 1 ) \
-   METHOD(CLASS, getDisplayZoom,     ARRAYDEF({{ END          }                    }), 1 ) \
+   METHOD(CLASS, getGridSize,        ARRAYDEF({{ END          }                    }), 1, READ_ONLY )  \
+   METHOD(CLASS, getSelectedObjects, ARRAYDEF({{ END          }                    }), 1, READ_ONLY )  \
+   METHOD(CLASS, getAllObjects,      ARRAYDEF({{ END          }                    }), 1, READ_ONLY )  \
+   METHOD(CLASS, showMessage,        ARRAYDEF({{ STR,     END }, { STR, BOOL, END }}), 2, READ_WRITE ) \
+   METHOD(CLASS, setDisplayCenter,   ARRAYDEF({{ PT,      END }                    }), 1, READ_WRITE ) \
+   METHOD(CLASS, setDisplayExtents,  ARRAYDEF({{ PT, PT,  END }                    }), 1, READ_WRITE ) \
+   METHOD(CLASS, setDisplayZoom,     ARRAYDEF({{ NUM_GE0, END }                    }), 1, READ_WRITE ) \
+   METHOD(CLASS, getDisplayCenter,   ARRAYDEF({{ END          }                    }), 1, READ_ONLY )  \
+   METHOD(CLASS, getDisplayExtents,  ARRAYDEF({{ END          }                    }), 1, READ_ONLY )  \
+   METHOD(CLASS, getDisplayZoom,     ARRAYDEF({{ END          }                    }), 1, READ_ONLY )  \
 
 GENERATE_LUA_METHODS_TABLE(EditorPlugin, LUA_METHODS);
 GENERATE_LUA_FUNARGS_TABLE(EditorPlugin, LUA_METHODS);
@@ -1150,15 +1150,15 @@ void EngineeredItem::doneEditingAttrs(EditorAttributeMenuUI *attributeMenu)
  */
 //               Fn name              Param profiles  Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, isActive,             ARRAYDEF({{       END }}), 1 ) \
-   METHOD(CLASS, getMountAngle,        ARRAYDEF({{       END }}), 1 ) \
-   METHOD(CLASS, getHealth,            ARRAYDEF({{       END }}), 1 ) \
-   METHOD(CLASS, setHealth,            ARRAYDEF({{ NUM,  END }}), 1 ) \
-   METHOD(CLASS, getDisabledThreshold, ARRAYDEF({{       END }}), 1 ) \
-   METHOD(CLASS, getHealRate,          ARRAYDEF({{       END }}), 1 ) \
-   METHOD(CLASS, setHealRate,          ARRAYDEF({{ INT,  END }}), 1 ) \
-   METHOD(CLASS, getEngineered,        ARRAYDEF({{       END }}), 1 ) \
-   METHOD(CLASS, setEngineered,        ARRAYDEF({{ BOOL, END }}), 1 ) \
+   METHOD(CLASS, isActive,             ARRAYDEF({{       END }}), 1, READ_ONLY )  \
+   METHOD(CLASS, getMountAngle,        ARRAYDEF({{       END }}), 1, READ_ONLY )  \
+   METHOD(CLASS, getHealth,            ARRAYDEF({{       END }}), 1, READ_ONLY )  \
+   METHOD(CLASS, setHealth,            ARRAYDEF({{ NUM,  END }}), 1, READ_WRITE ) \
+   METHOD(CLASS, getDisabledThreshold, ARRAYDEF({{       END }}), 1, READ_ONLY )  \
+   METHOD(CLASS, getHealRate,          ARRAYDEF({{       END }}), 1, READ_ONLY )  \
+   METHOD(CLASS, setHealRate,          ARRAYDEF({{ INT,  END }}), 1, READ_WRITE ) \
+   METHOD(CLASS, getEngineered,        ARRAYDEF({{       END }}), 1, READ_ONLY )  \
+   METHOD(CLASS, setEngineered,        ARRAYDEF({{ BOOL, END }}), 1, READ_WRITE ) \
 
 GENERATE_LUA_METHODS_TABLE(EngineeredItem, LUA_METHODS);
 GENERATE_LUA_FUNARGS_TABLE(EngineeredItem, LUA_METHODS);
@@ -2338,9 +2338,9 @@ void Turret::onGeomChanged()
  */
 //               Fn name     Param profiles  Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, getAimAngle,  ARRAYDEF({{      END }}), 1 ) \
-   METHOD(CLASS, setAimAngle,  ARRAYDEF({{ NUM, END }}), 1 ) \
-   METHOD(CLASS, setWeapon,    ARRAYDEF({{ WEAP_ENUM, END }}), 1 ) \
+   METHOD(CLASS, getAimAngle,  ARRAYDEF({{      END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, setAimAngle,  ARRAYDEF({{ NUM, END }}), 1, READ_WRITE ) \
+   METHOD(CLASS, setWeapon,    ARRAYDEF({{ WEAP_ENUM, END }}), 1, READ_WRITE ) \
 
 
 GENERATE_LUA_METHODS_TABLE(Turret, LUA_METHODS);
@@ -2819,7 +2819,7 @@ void Mortar::onGeomChanged()
  */
 //               Fn name     Param profiles  Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, setWeapon,    ARRAYDEF({{ WEAP_ENUM, END }}), 1 ) \
+   METHOD(CLASS, setWeapon,    ARRAYDEF({{ WEAP_ENUM, END }}), 1, READ_WRITE ) \
 
 
 GENERATE_LUA_METHODS_TABLE(Mortar, LUA_METHODS);
@@ -5,10 +5,15 @@
 
 #include "EventManager.h"
 
+#include "GameManager.h"
+#include "ServerGame.h"
+
 #include "playerInfo.h"          // For RobotPlayerInfo constructor
 #include "robot.h"
 #include "Zone.h"
 
+#include "tnlProfiler.h"
+
 //#include "../lua/luaprofiler-2.0.2/src/luaprofiler.h"      // For... the profiler!
 
 #ifndef ZAP_DEDICATED
@@ -56,6 +61,28 @@ static const EventDef eventDefs[] = {
 static EventManager *eventManager = NULL;   // Singleton event manager, one copy is used by all listeners
 
 
+// Scripts may have Lua states of their own, so events need to be pushed onto the subscriber's state
+static lua_State *getSubscriberState(const Subscription &subscription)
+{
+   lua_State *L = subscription.subscriber->getLuaState();
+
+   TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
+
+   return L;
+}
+
+
+// There's one set of subscriptions for the whole process, but when we're hosting several arenas, a script should only hear
+// about what happens in its own.  Events are fired while an arena is running, so that's the one they're about.
+static bool isInCurrentArena(const Subscription &subscription)
+{
+   if(GameManager::getServerGames()->size() <= 1)
+      return true;
+
+   return subscription.subscriber->belongsTo(GameManager::getServerGame());
+}
+
+
 // C++ constructor
 EventManager::EventManager()
 {
@@ -107,7 +134,7 @@ void EventManager::subscribe(LuaScriptRunner *subscriber, EventType eventType, S
    if(isSubscribed(subscriber, eventType) || isPendingSubscribed(subscriber, eventType))
       return;
 
-   lua_State *L = LuaScriptRunner::getL();
+   lua_State *L = subscriber->getLuaState();
 
    // Make sure the script has the proper event listener
    bool ok = LuaScriptRunner::loadFunction(L, subscriber->getScriptId(), eventDefs[eventType].function);     // -- function
@@ -250,48 +277,78 @@ void EventManager::fireEvent(EventType eventType)
    if(suppressEvents(eventType))   
       return;
 
-   lua_State *L = LuaScriptRunner::getL();
-
-   TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
-
    for(S32 i = 0; i < subscriptions[eventType].size(); i++)
+   {
+      if(!isInCurrentArena(subscriptions[eventType][i]))
+         continue;
+
+      lua_State *L = getSubscriberState(subscriptions[eventType][i]);
       fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
+   }
 }
 
 
-// onTick
-void EventManager::fireEvent(EventType eventType, U32 deltaT)
+// onTick.  If parallelSubscribers is provided, scripts with Lua states of their own are not ticked here, but are added to
+// the list so the caller can tick them itself, alongside one another, with fireTickEvent().
+void EventManager::fireEvent(EventType eventType, U32 deltaT, Vector<LuaScriptRunner *> *parallelSubscribers)
 {
+   if(parallelSubscribers)
+      parallelSubscribers->clear();
+
    if(suppressEvents(eventType))   
       return;
 
    if(eventType == TickEvent)
       mStepCount--;   
 
-   lua_State *L = LuaScriptRunner::getL();
-
-   TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
-
    for(S32 i = 0; i < subscriptions[eventType].size(); i++)
    {
+      if(!isInCurrentArena(subscriptions[eventType][i]))
+         continue;
+
+      if(parallelSubscribers && subscriptions[eventType][i].subscriber->ownsLuaState())
+      {
+         parallelSubscribers->push_back(subscriptions[eventType][i].subscriber);
+         continue;
+      }
+
+      lua_State *L = getSubscriberState(subscriptions[eventType][i]);
+
       lua_pushinteger(L, deltaT);   // -- deltaT
       fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
    }
 }
 
 
+// Tick a single subscriber handed back by the above.  Only touches the subscriber's own Lua state, so subscribers with
+// states of their own can be ticked on different threads at the same time.
+void EventManager::fireTickEvent(LuaScriptRunner *subscriber, U32 deltaT)
+{
+   for(S32 i = 0; i < subscriptions[TickEvent].size(); i++)
+      if(subscriptions[TickEvent][i].subscriber == subscriber)
+      {
+         lua_State *L = getSubscriberState(subscriptions[TickEvent][i]);
+
+         lua_pushinteger(L, deltaT);   // -- deltaT
+         fire(L, subscriber, eventDefs[TickEvent].function, subscriptions[TickEvent][i].context);
+         return;
+      }
+}
+
+
 // onShipSpawned
 void EventManager::fireEvent(EventType eventType, Ship *ship)
 {
    if(suppressEvents(eventType))   
       return;
 
-   lua_State *L = LuaScriptRunner::getL();
-
-   TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
-
    for(S32 i = 0; i < subscriptions[eventType].size(); i++)
    {
+      if(!isInCurrentArena(subscriptions[eventType][i]))
+         continue;
+
+      lua_State *L = getSubscriberState(subscriptions[eventType][i]);
+
       ship->push(L);                // -- ship
       fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
    }
@@ -304,12 +361,13 @@ void EventManager::fireEvent(EventType eventType, Ship *ship, BfObject *damaging
    if(suppressEvents(eventType))
       return;
 
-   lua_State *L = LuaScriptRunner::getL();
-
-   TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
-
    for(S32 i = 0; i < subscriptions[eventType].size(); i++)
    {
+      if(!isInCurrentArena(subscriptions[eventType][i]))
+         continue;
+
+      lua_State *L = getSubscriberState(subscriptions[eventType][i]);
+
       ship->push(L);                // -- ship
 
       if(damagingObject)
@@ -334,12 +392,13 @@ void EventManager::fireEvent(LuaScriptRunner *sender, EventType eventType, const
    if(suppressEvents(eventType))   
       return;
 
-   lua_State *L = LuaScriptRunner::getL();
-
-   TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
-
    for(S32 i = 0; i < subscriptions[eventType].size(); i++)
    {
+      if(!isInCurrentArena(subscriptions[eventType][i]))
+         continue;
+
+      lua_State *L = getSubscriberState(subscriptions[eventType][i]);
+
       if(sender == subscriptions[eventType][i].subscriber)    // Don't alert sender about own message!
          continue;
 
@@ -363,12 +422,13 @@ void EventManager::fireEvent(LuaScriptRunner *player, EventType eventType, LuaPl
    if(suppressEvents(eventType))   
       return;
 
-   lua_State *L = LuaScriptRunner::getL();
-
-   TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
-
    for(S32 i = 0; i < subscriptions[eventType].size(); i++)
    {
+      if(!isInCurrentArena(subscriptions[eventType][i]))
+         continue;
+
+      lua_State *L = getSubscriberState(subscriptions[eventType][i]);
+
       if(player == subscriptions[eventType][i].subscriber)    // Don't trouble player with own joinage or leavage!
          continue;
 
@@ -384,12 +444,13 @@ void EventManager::fireEvent(EventType eventType, Ship *ship, Zone *zone)
    if(suppressEvents(eventType))   
       return;
 
-   lua_State *L = LuaScriptRunner::getL();
-
-   TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
-
    for(S32 i = 0; i < subscriptions[eventType].size(); i++)
    {
+      if(!isInCurrentArena(subscriptions[eventType][i]))
+         continue;
+
+      lua_State *L = getSubscriberState(subscriptions[eventType][i]);
+
       try   
       {
          // Passing ship, zone, zoneType, zoneId
@@ -416,12 +477,13 @@ void EventManager::fireEvent(EventType eventType, S32 score, S32 team, LuaPlayer
    if(suppressEvents(eventType))
          return;
 
-   lua_State *L = LuaScriptRunner::getL();
-
-   TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
-
    for(S32 i = 0; i < subscriptions[eventType].size(); i++)
    {
+      if(!isInCurrentArena(subscriptions[eventType][i]))
+         continue;
+
+      lua_State *L = getSubscriberState(subscriptions[eventType][i]);
+
       lua_pushinteger(L, score);   // -- score
       lua_pushinteger(L, team);    // -- score, team
 
@@ -439,6 +501,8 @@ void EventManager::fireEvent(EventType eventType, S32 score, S32 team, LuaPlayer
 // Returns true if there was an error, false if everything ran ok
 bool EventManager::fire(lua_State *L, LuaScriptRunner *scriptRunner, const char *function, ScriptContext context)
 {
+   TNL_PROFILE_SCOPE(function);     // function comes from eventDefs, so will be around as long as we are
+
    setScriptContext(L, context);
 
    bool ok = false;
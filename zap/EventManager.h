@@ -106,7 +106,8 @@ public:
 
    // We'll have several different signatures for this one...
    void fireEvent(EventType eventType);
-   void fireEvent(EventType eventType, U32 deltaT);      // Tick
+   void fireEvent(EventType eventType, U32 deltaT, Vector<LuaScriptRunner *> *parallelSubscribers = NULL);  // Tick
+   void fireTickEvent(LuaScriptRunner *subscriber, U32 deltaT);   // Tick one of the parallelSubscribers from above
    void fireEvent(EventType eventType, Ship *ship);      // ShipSpawned
    void fireEvent(EventType eventType, Ship *ship, BfObject *damagingObject, BfObject *shooter);  // ShipKilled
    void fireEvent(LuaScriptRunner *sender, EventType eventType, const char *message, LuaPlayerInfo *playerInfo, bool global);  // MsgReceived
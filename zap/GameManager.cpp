@@ -5,8 +5,10 @@
 
 #include "GameManager.h"
 
+#include "BanList.h"
 #include "DisplayManager.h"
 #include "FontManager.h"
+#include "gameNetInterface.h"
 #include "ServerGame.h"
 #include "SoundSystem.h"
 #include "VideoSystem.h"
@@ -28,6 +30,7 @@ namespace Zap
 
 // Declare statics
 ServerGame *GameManager::mServerGame = NULL;
+Vector<ServerGame *> GameManager::mServerGames;
 
 #ifndef ZAP_DEDICATED
    Vector<ClientGame *> GameManager::mClientGames;
@@ -75,6 +78,10 @@ bool GameManager::hostGame()
       return false;
    }
 
+   // Any other arenas share the first one's level list, so they're ready to go too
+   for(S32 i = 1; i < mServerGames.size(); i++)
+      mServerGames[i]->startHosting();
+
 #ifndef ZAP_DEDICATED
    const Vector<ClientGame *> *clientGames = GameManager::getClientGames();
 
@@ -148,21 +155,132 @@ void GameManager::setServerGame(ServerGame *serverGame)
    TNLAssert(!mServerGame, "Already have a ServerGame!");
 
    mServerGame = serverGame;
+   mServerGames.push_back(serverGame);
 }
 
 
+// Deletes every arena, not just the first
 void GameManager::deleteServerGame()
 {
+   // Last one first, so the first arena, which the others were started from, goes last
+   while(mServerGames.size() > 1)
+   {
+      mServerGame = mServerGames.last();
+      mServerGames.pop_back();
+      delete mServerGame;
+   }
+
+   mServerGame = mServerGames.size() ? mServerGames[0] : NULL;
+   mServerGames.clear();
+
    // mServerGame might be NULL here; for example when quitting after losing a connection to the game server
    delete mServerGame;     // Kill the serverGame (leaving the clients running)
    mServerGame = NULL;
 }
 
 
+// Host another arena in this process.  Can only be done once there's a ServerGame to go along with.
+void GameManager::addArena(ServerGame *serverGame)
+{
+   TNLAssert(serverGame, "Expect a valid serverGame here!");
+   TNLAssert(mServerGames.size() > 0, "Need a ServerGame before adding more arenas!");
+
+   mServerGames.push_back(serverGame);
+}
+
+
+// Close down one of the additional arenas; the rest carry on
+void GameManager::deleteArena(ServerGame *serverGame)
+{
+   TNLAssert(mServerGames.size() > 0 && serverGame != mServerGames[0], "Use deleteServerGame() for the first arena!");
+
+   for(S32 i = 1; i < mServerGames.size(); i++)
+      if(mServerGames[i] == serverGame)
+      {
+         mServerGames.erase(i);
+         delete serverGame;
+         return;
+      }
+}
+
+
+const Vector<ServerGame *> *GameManager::getServerGames()
+{
+   return &mServerGames;
+}
+
+
+// Arenas share a LevelSource, so none of them may be loading from it while it changes
+void GameManager::cancelLevelPipelines()
+{
+   for(S32 i = 0; i < mServerGames.size(); i++)
+      mServerGames[i]->cancelLevelPipeline();
+}
+
+
+// True if nobody is playing in any arena, so a dedicated server can take it easy
+bool GameManager::areAllArenasSuspended()
+{
+   for(S32 i = 0; i < mServerGames.size(); i++)
+      if(!mServerGames[i]->isSuspended())
+         return false;
+
+   return true;
+}
+
+
+// Blocks until a packet arrives for any arena, or timeoutMicros microseconds pass.  Returns true if there are
+// packets for checkIncomingPackets() to process.
+bool GameManager::waitForIncomingPackets(U32 timeoutMicros)
+{
+   Vector<Socket *> sockets;
+
+   for(S32 i = 0; i < mServerGames.size(); i++)
+      sockets.push_back(&mServerGames[i]->getNetInterface()->getSocket());
+
+   return Socket::waitForData(sockets, timeoutMicros);
+}
+
+
+// Reads whatever has arrived for every arena; as in idleServerGame(), each arena is getServerGame() while it reads
+void GameManager::checkIncomingPackets()
+{
+   if(mServerGames.size() == 0)
+      return;
+
+   for(S32 i = 0; i < mServerGames.size(); i++)
+   {
+      mServerGame = mServerGames[i];
+      mServerGame->getNetInterface()->checkIncomingPackets();
+   }
+
+   mServerGame = mServerGames[0];
+}
+
+
+// Arenas take turns; while each one runs, getServerGame() returns it, so code that has no other way to find its
+// ServerGame gets the right one
 void GameManager::idleServerGame(U32 timeDelta)
 {
+   // Arenas share their settings, and so their ban list; expire kicks once per tick, not once per arena
    if(mServerGame)
+      mServerGame->getSettings()->getBanList()->updateKickList(timeDelta);    // Unban players who's bans have expired
+
+   if(mServerGames.size() <= 1)
+   {
+      if(mServerGame)
+         mServerGame->idle(timeDelta);
+
+      return;
+   }
+
+   for(S32 i = 0; i < mServerGames.size(); i++)
+   {
+      mServerGame = mServerGames[i];
       mServerGame->idle(timeDelta);
+   }
+
+   mServerGame = mServerGames[0];
 }
 
 
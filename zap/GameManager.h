@@ -33,7 +33,8 @@ public:
    };
 
 private:
-   static ServerGame *mServerGame;
+   static ServerGame *mServerGame;                 // The arena whose turn it is to run; the first one otherwise
+   static Vector<ServerGame *> mServerGames;       // Every arena we're hosting, first one first
 #ifndef ZAP_DEDICATED
    static Vector<ClientGame *> mClientGames;
 #endif
@@ -58,6 +59,15 @@ public:
    static void deleteServerGame();
    static void idleServerGame(U32 timeDelta);
 
+   // Additional arenas, hosted alongside the first ServerGame
+   static void addArena(ServerGame *serverGame);
+   static void deleteArena(ServerGame *serverGame);
+   static const Vector<ServerGame *> *getServerGames();
+   static void cancelLevelPipelines();
+   static bool areAllArenasSuspended();
+   static bool waitForIncomingPackets(U32 timeoutMicros);
+   static void checkIncomingPackets();
+
 
    // ClientGame related
 #ifndef ZAP_DEDICATED
@@ -30,86 +30,188 @@ namespace Zap
 // fwrite might have multiple 1-second freeze on VPS server or heavy disk access
 // Having fwrite in separate thread might fix the game from freezing/lagging
 // if run in VPS server or with heavy disk access
+//
+// The game thread copies records into a ring, and the writer thread drains it to the file.  The lock only guards
+// the positions, never the copying or the fwrite, and each side only waits when the ring is full (game thread) or
+// empty (writer thread), woken by the other side when that changes.
 
 class WriteBufferThread : public Thread
 {
 private:
+   enum {
+      RingSize = 1024 * 256,
+   };
+
    FILE *f;
-   U32 lastPos;
-   U32 currPos;
-   U8 buffer[1024*128];
-   TNL::Semaphore sem1;
-   U32 threadPos;
-   bool exitNow;
-public:
+   U8 ring[RingSize];
+
+   Mutex mLock;
+   U32 mReadPos;              // Only the writer thread moves this
+   U32 mWritePos;             // Only the game thread moves this
+   U32 mUsed;                 // Bytes written into the ring but not yet to the file
+   bool mReaderWaiting;
+   bool mWriterWaiting;
+   bool mExitNow;
+
+   Semaphore mDataReady;
+   Semaphore mSpaceFreed;
+   Semaphore mFinished;
+   bool mStarted;
+
+   // Backpressure stats, game thread only
+   U32 mBytesWritten;
+   U32 mPeakUsed;
+   U32 mStallCount;
+   F64 mStallMs;
+
+   // Copies len bytes into the ring at mWritePos, wrapping around the end if need be
+   void copyIn(const U8 *data, U32 len)
+   {
+      U32 firstPart = min(len, U32(RingSize) - mWritePos);
+
+      memcpy(&ring[mWritePos], data, firstPart);
+      memcpy(&ring[0], data + firstPart, len - firstPart);
+
+      mWritePos = (mWritePos + len) % RingSize;
+   }
 
+public:
    WriteBufferThread(FILE *file)
    {
       TNLAssert(file != 0, "Must have a file handle");
-      lastPos = 0;
-      currPos = 0;
-      threadPos = 0;
-      exitNow = false;
       f = file;
-      if(!start())
+
+      mReadPos = 0;
+      mWritePos = 0;
+      mUsed = 0;
+      mReaderWaiting = false;
+      mWriterWaiting = false;
+      mExitNow = false;
+
+      mBytesWritten = 0;
+      mPeakUsed = 0;
+      mStallCount = 0;
+      mStallMs = 0;
+
+      mStarted = start();
+      if(!mStarted)
       {
          logprintf(LogConsumer::LogWarning, "Failed to create thread for recorder, games may not record");
          fclose(f);
          f = NULL;
       }
    }
+
    ~WriteBufferThread()
    {
-      exitNow = true;
-      sem1.increment();
-      while(f != 0)         // Wait until the other thread is done
-         Platform::sleep(1);
+      if(!mStarted)
+         return;
+
+      mLock.lock();
+      mExitNow = true;
+      bool wake = mReaderWaiting;
+      mReaderWaiting = false;
+      mLock.unlock();
+
+      if(wake)
+         mDataReady.increment();
+
+      mFinished.wait();       // Wait until the other thread has written everything and closed the file
+
+      if(mStallCount > 0)
+         logprintf(LogConsumer::LogWarning, "Game recorder: disk couldn't keep up %d times, stalling the game for %.1fms in all",
+                   mStallCount, mStallMs);
+
+      logprintf(LogConsumer::ServerFilter, "Game recorder: wrote %d bytes, buffer peaked at %d of %d bytes",
+                mBytesWritten, mPeakUsed, U32(RingSize));
    }
 
+   U32 getBytesWritten() { return mBytesWritten; }
 
-   U8 *getBuffer(U32 size)
+   // Game thread.  Blocks if the ring is too full to take len more bytes.
+   void write(const U8 *data, U32 len)
    {
-      if(currPos + size > sizeof(buffer))
-      {
-         lastPos = currPos;
-         currPos = 0;
-      }
-      U32 t = threadPos;
-      while(t > currPos && t < currPos + size) // Buffer too full, waiting...
+      if(!mStarted || len == 0)
+         return;
+
+      TNLAssert(len <= RingSize, "Record bigger than the whole buffer");
+
+      mLock.lock();
+
+      if(RingSize - mUsed < len)
       {
-         Platform::sleep(1);
-         t = threadPos;
+         S64 stallStart = Platform::getHighPrecisionTimerValue();
+         mStallCount++;
+
+         while(RingSize - mUsed < len)
+         {
+            mWriterWaiting = true;
+            mLock.unlock();
+            mSpaceFreed.wait();
+            mLock.lock();
+         }
+
+         mStallMs += Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - stallStart);
       }
-      return &buffer[currPos];
-   }
-   void addBuffer(U32 size)
-   {
-      currPos += size;
-      sem1.increment();
+
+      mLock.unlock();
+
+      // The writer thread never touches the free part of the ring, so no need to hold the lock while copying
+      copyIn(data, len);
+
+      mLock.lock();
+      mUsed += len;
+      U32 used = mUsed;
+      bool wake = mReaderWaiting;
+      mReaderWaiting = false;
+      mLock.unlock();
+
+      if(wake)
+         mDataReady.increment();
+
+      mBytesWritten += len;
+      if(used > mPeakUsed)
+         mPeakUsed = used;
    }
 
    U32 run()
    {
-      U32 currPos1 = currPos; // currPos could change anytime by other thread
-      while(!exitNow || currPos1 != threadPos)
+      while(true)
       {
-         if(currPos1 < threadPos)
-         {
+         mLock.lock();
 
-            fwrite(&buffer[threadPos], 1, lastPos - threadPos, f);
-            threadPos = 0;
-         }
-         else if(currPos1 > threadPos)
+         while(mUsed == 0 && !mExitNow)
          {
-            fwrite(&buffer[threadPos], 1, currPos1 - threadPos, f);
-            threadPos = currPos1;
+            mReaderWaiting = true;
+            mLock.unlock();
+            mDataReady.wait();  // Waits until the game thread writes something, or we're told to quit
+            mLock.lock();
          }
-         else
-            sem1.wait();  // Waits until sem1.increment
-         currPos1 = currPos;
+
+         U32 used = mUsed;
+         mLock.unlock();
+
+         if(used == 0)        // Exiting, and everything's been written
+            break;
+
+         U32 len = min(used, U32(RingSize) - mReadPos);
+         fwrite(&ring[mReadPos], 1, len, f);
+
+         mLock.lock();
+         mReadPos = (mReadPos + len) % RingSize;
+         mUsed -= len;
+         bool wake = mWriterWaiting;
+         mWriterWaiting = false;
+         mLock.unlock();
+
+         if(wake)
+            mSpaceFreed.increment();
       }
+
       fclose(f);
-      f = 0;
+      f = NULL;
+      mFinished.increment();
+
       return 0;
    }
 };
@@ -168,6 +270,8 @@ GameRecorderServer::GameRecorderServer(ServerGame *game)
    mWriter = NULL;
    mGame = game;
    mMilliSeconds = 0;
+   mRecordedTime = 0;
+   mLastKeyframeTime = 0;
    mWriteMaxBitSize = U32_MAX;
    mPackUnpackShipEnergyMeter = true;
 
@@ -195,12 +299,20 @@ GameRecorderServer::GameRecorderServer(ServerGame *game)
       mConnectionParameters.mIsInitiator = false;
       mConnectionParameters.mDebugObjectSizes = false;
 
-      U8 *data = mWriter->getBuffer(4);
+      U8 data[4];
       data[0] = CS_PROTOCOL_VERSION;
       data[1] = U8(mGhostClassCount);
       data[2] = U8(mEventClassCount);
-      data[3] = U8(mEventClassCount >> 8) | 0x10;
-      mWriter->addBuffer(4);
+      data[3] = U8(mEventClassCount >> 8) | U8((EnergyMeterFlag | KeyframesFlag) >> 8);
+      mWriter->write(data, 4);
+
+      // Seeking to the very start works just like seeking to a keyframe
+      KeyframeIndexEntry start;
+      start.time = 0;
+      start.offset = 4;
+      start.eventSeq = getNextUnsentEventSeq();
+      mKeyframes.push_back(start);
+
       gameRecorderScoping(this, game);
 
       s2cSetServerName(game->getSettings()->getHostName());
@@ -211,7 +323,10 @@ GameRecorderServer::GameRecorderServer(ServerGame *game)
 GameRecorderServer::~GameRecorderServer()
 {
    if(mWriter)
+   {
+      writeIndex();
       delete mWriter;
+   }
 }
 
 
@@ -240,11 +355,23 @@ void GameRecorderServer::idle(U32 MilliSeconds)
       return;
    }
 
+   writePacketRecord(MilliSeconds + mMilliSeconds);
+   mMilliSeconds = 0;
+
+   if(mRecordedTime - mLastKeyframeTime >= KeyframeInterval)
+      writeKeyframe();
+}
+
+
+// Writes one packet's worth of updates, stamped with the time since the last one
+void GameRecorderServer::writePacketRecord(U32 ms)
+{
+   TNLAssert(ms < (1 << 10), "Only 10 bits for the time");
+
    GhostPacketNotify notify;
    mNotifyQueueTail = &notify;
 
-   U8 *data = mWriter->getBuffer(16383 + 3);
-   BitStream bstream(&data[3], 16383);
+   BitStream bstream(&mRecordBuffer[3], MaxPacketSize);
 
    prepareWritePacket();
    GhostConnection::writePacket(&bstream, &notify);
@@ -254,12 +381,94 @@ void GameRecorderServer::idle(U32 MilliSeconds)
 
    bstream.zeroToByteBoundary();
    U32 size = bstream.getBytePosition();
-   U32 ms = MilliSeconds + mMilliSeconds;
-   mMilliSeconds = 0;
-   data[0] = U8(size);
-   data[1] = U8((size >> 8) & 63) | U8((ms >> 8) << 6);
-   data[2] = U8(ms);
-   mWriter->addBuffer(bstream.getBytePosition() + 3);
+
+   mRecordBuffer[0] = U8(size);
+   mRecordBuffer[1] = U8((size >> 8) & 63) | U8((ms >> 8) << 6);
+   mRecordBuffer[2] = U8(ms);
+   mWriter->write(mRecordBuffer, size + 3);
+
+   mRecordedTime += ms;
+}
+
+
+// Forgets everything the playback was sent, and sends it all again, so playback can start from here.  The marker
+// in front tells playback to clear out what it had, and which ordered event comes next.
+void GameRecorderServer::writeKeyframe()
+{
+   KeyframeIndexEntry keyframe;
+   keyframe.time = mRecordedTime;
+   keyframe.offset = mWriter->getBytesWritten();
+   keyframe.eventSeq = getNextUnsentEventSeq();
+   mKeyframes.push_back(keyframe);
+   mLastKeyframeTime = mRecordedTime;
+
+   U8 marker[3 + KeyframeMarkerSize];
+   marker[0] = U8(KeyframeMarker);
+   marker[1] = U8(KeyframeMarker >> 8);
+   marker[2] = 0;
+   writeU32(&marker[3], keyframe.eventSeq);
+   mWriter->write(marker, sizeof(marker));
+
+   // Every object goes back to being a new ghost, and strings get sent in full again
+   clearGhostInfo();
+   mStringTable->forgetConfirmedEntries();
+   gameRecorderScoping(this, mGame);
+
+   // Push it all out now, so there's no waiting for the picture to fill in after a seek
+   for(S32 i = 0; i < MaxKeyframePackets && GhostConnection::isDataToTransmit(); i++)
+      writePacketRecord(0);
+
+   // The GameType resends the level, teams and players as it's ghosted, but not individual scores
+   GameType *gameType = mGame->getGameType();
+
+   if(gameType && !gameType->isTeamGame())
+   {
+      NetObject::setRPCDestConnection(this);
+      for(S32 i = 0; i < mGame->getClientCount(); i++)
+         gameType->s2cSetPlayerScore(i, mGame->getClientInfo(i)->getScore());
+      NetObject::setRPCDestConnection(NULL);
+
+      writePacketRecord(0);
+   }
+}
+
+
+// The index goes after an end of recording marker, so older versions of playback stop before they get to it
+void GameRecorderServer::writeIndex()
+{
+   U8 endMarker[3] = { 0, 0, 0 };
+   mWriter->write(endMarker, sizeof(endMarker));
+
+   U8 entry[12];
+   for(S32 i = 0; i < mKeyframes.size(); i++)
+   {
+      writeU32(&entry[0], mKeyframes[i].time);
+      writeU32(&entry[4], mKeyframes[i].offset);
+      writeU32(&entry[8], mKeyframes[i].eventSeq);
+      mWriter->write(entry, sizeof(entry));
+   }
+
+   U8 trailer[IndexTrailerSize];
+   writeU32(&trailer[0], mKeyframes.size());
+   writeU32(&trailer[4], mRecordedTime + mMilliSeconds);
+   writeU32(&trailer[8], IndexMagic);
+   mWriter->write(trailer, sizeof(trailer));
+}
+
+
+// Little endian, whatever the platform
+void GameRecorderServer::writeU32(U8 *dest, U32 value)
+{
+   dest[0] = U8(value);
+   dest[1] = U8(value >> 8);
+   dest[2] = U8(value >> 16);
+   dest[3] = U8(value >> 24);
+}
+
+
+U32 GameRecorderServer::readU32(const U8 *src)
+{
+   return U32(src[0]) | (U32(src[1]) << 8) | (U32(src[2]) << 16) | (U32(src[3]) << 24);
 }
 
 
@@ -17,21 +17,62 @@ namespace Zap {
 class ServerGame;
 class WriteBufferThread;
 
+// A recording is a 4 byte header, then a series of records, each a 3 byte header holding the size and the time since
+// the previous record, followed by that many bytes of packet data.  A record of size 0 ends the recording.
+//
+// Every KeyframeInterval a keyframe marker record is written, after which everything is sent to the playback again
+// from scratch, so playback can start there.  After the end of the recording comes an index of the keyframes, and a
+// trailer giving the number of keyframes, the length of the recording, and IndexMagic.
+struct KeyframeIndexEntry
+{
+   U32 time;            // Milliseconds from the start of the recording
+   U32 offset;          // Position of the keyframe marker in the file
+   U32 eventSeq;        // Sequence number of the next ordered event after the marker
+};
+
+
 class GameRecorderServer : public GameConnection
 {
    typedef GhostConnection Parent;
 
+public:
+   enum {
+      MaxPacketSize     = 0x3FFF - 1,     // Fits in the 14 bits of the record header, leaving room for...
+      KeyframeMarker    = 0x3FFF,         // ...this, which older playbacks take as the end of the recording
+      KeyframeMarkerSize = 4,             // Event sequence number following the marker's header
+      KeyframeInterval  = 10000,          // Milliseconds
+      MaxKeyframePackets = 64,            // Most packets to spend getting everything sent after a keyframe
+
+      EnergyMeterFlag   = 0x1000,         // Flags in the header's event class count
+      KeyframesFlag     = 0x2000,
+
+      IndexEntrySize    = 12,
+      IndexTrailerSize  = 12,
+      IndexMagic        = 0x49464B42,     // "BKFI"
+   };
+
 private:
    WriteBufferThread *mWriter;
    ServerGame *mGame;
    TNL::NetObject mNetObj;
    U32 mMilliSeconds;
+   U32 mRecordedTime;
+   U32 mLastKeyframeTime;
+   Vector<KeyframeIndexEntry> mKeyframes;
+   U8 mRecordBuffer[MaxPacketSize + 3];
+
+   void writePacketRecord(U32 ms);
+   void writeKeyframe();
+   void writeIndex();
 
 public:
    string mFileName;
 
    static string buildGameRecorderExtension();
 
+   static void writeU32(U8 *dest, U32 value);
+   static U32 readU32(const U8 *src);
+
    GameRecorderServer(ServerGame *game);
    ~GameRecorderServer();
 
@@ -95,6 +95,8 @@ GameRecorderPlayback::GameRecorderPlayback(ClientGame *game, const char *filenam
    mTotalTime = 0;
    mIsButtonHeldDown = false;
 
+   bool hasKeyframes = false;
+
    if(!mFile)
       mFile = fopen(filename, "rb");
 
@@ -105,11 +107,15 @@ GameRecorderPlayback::GameRecorderPlayback(ClientGame *game, const char *filenam
       fread(data, 1, 4, mFile);
       mGhostClassCount = data[1];
       mEventClassCount = U32(data[2]) | (U32(data[3]) << 8);
-      if(mEventClassCount & 0x1000)
+      if(mEventClassCount & GameRecorderServer::EnergyMeterFlag)
       {
          mPackUnpackShipEnergyMeter = true;
-         mEventClassCount &= ~0x1000;
+         mEventClassCount &= ~GameRecorderServer::EnergyMeterFlag;
       }
+
+      hasKeyframes = (mEventClassCount & GameRecorderServer::KeyframesFlag) != 0;
+      mEventClassCount &= ~GameRecorderServer::KeyframesFlag;
+
       if(data[0] != CS_PROTOCOL_VERSION || 
          mEventClassCount > NetClassRep::getNetClassCount(getNetClassGroup(), NetClassTypeEvent) || 
          mGhostClassCount > NetClassRep::getNetClassCount(getNetClassGroup(), NetClassTypeObject))
@@ -131,19 +137,99 @@ GameRecorderPlayback::GameRecorderPlayback(ClientGame *game, const char *filenam
    if(mFile)
    {
       S32 filepos = ftell(mFile);
-      while(true)
+
+      // Recordings that weren't finished properly won't have an index, but may still have keyframes
+      if(!hasKeyframes || !readIndex())
+         scanRecording();
+
+      fseek(mFile, filepos, SEEK_SET);
+   }
+}
+
+
+// Reads the keyframe index from the end of the file, returning false if there isn't one
+bool GameRecorderPlayback::readIndex()
+{
+   U8 trailer[GameRecorderServer::IndexTrailerSize];
+
+   if(fseek(mFile, -S32(sizeof(trailer)), SEEK_END) != 0 || fread(trailer, 1, sizeof(trailer), mFile) != sizeof(trailer))
+      return false;
+
+   U32 count = GameRecorderServer::readU32(&trailer[0]);
+   U32 totalTime = GameRecorderServer::readU32(&trailer[4]);
+
+   if(GameRecorderServer::readU32(&trailer[8]) != U32(GameRecorderServer::IndexMagic) || count == 0 || count > 0x100000)
+      return false;
+
+   S32 indexSize = S32(count * GameRecorderServer::IndexEntrySize + sizeof(trailer));
+   if(fseek(mFile, -indexSize, SEEK_END) != 0)
+      return false;
+
+   Vector<KeyframeIndexEntry> keyframes;
+
+   for(U32 i = 0; i < count; i++)
+   {
+      U8 entry[GameRecorderServer::IndexEntrySize];
+      if(fread(entry, 1, sizeof(entry), mFile) != sizeof(entry))
+         return false;
+
+      KeyframeIndexEntry keyframe;
+      keyframe.time = GameRecorderServer::readU32(&entry[0]);
+      keyframe.offset = GameRecorderServer::readU32(&entry[4]);
+      keyframe.eventSeq = GameRecorderServer::readU32(&entry[8]);
+      keyframes.push_back(keyframe);
+   }
+
+   mKeyframes = keyframes;
+   mTotalTime = totalTime;
+
+   return true;
+}
+
+
+// Walks the whole recording to add up its length and find any keyframes
+void GameRecorderPlayback::scanRecording()
+{
+   mKeyframes.clear();
+   mTotalTime = 0;
+
+   // Starting from the top is the same as starting from a keyframe, with a brand new connection's first event
+   KeyframeIndexEntry start;
+   start.time = 0;
+   start.offset = 4;
+   start.eventSeq = 0;
+   mKeyframes.push_back(start);
+
+   fseek(mFile, 4, SEEK_SET);
+
+   while(true)
+   {
+      S32 recordPos = ftell(mFile);
+
+      U8 data[3];
+      if(fread(data, 1, 3, mFile) != 3)
+         break;
+      U32 size = (U32(data[1] & 63) << 8) + data[0];
+      U32 milli = S32((U32(data[1] >> 6) << 8) + data[2]);
+      if(size == 0)
+         break;
+      mTotalTime += milli;
+
+      if(size == GameRecorderServer::KeyframeMarker)
       {
-         U8 data[3];
-         if(fread(data, 1, 3, mFile) != 3)
-            break;
-         U32 size = (U32(data[1] & 63) << 8) + data[0];
-         U32 milli = S32((U32(data[1] >> 6) << 8) + data[2]);
-         if(size == 0)
+         U8 seq[GameRecorderServer::KeyframeMarkerSize];
+         if(fread(seq, 1, sizeof(seq), mFile) != sizeof(seq))
             break;
-         mTotalTime += milli;
-         fseek(mFile, size, SEEK_CUR);
+
+         KeyframeIndexEntry keyframe;
+         keyframe.time = mTotalTime;
+         keyframe.offset = recordPos;
+         keyframe.eventSeq = GameRecorderServer::readU32(seq);
+         mKeyframes.push_back(keyframe);
+         continue;
       }
-      fseek(mFile, filepos, SEEK_SET);
+
+      fseek(mFile, size, SEEK_CUR);
    }
 }
 
@@ -159,6 +245,12 @@ bool GameRecorderPlayback::isValid()     { return mFile != NULL; }
 bool GameRecorderPlayback::lostContact() { return false; }
 
 
+const Vector<KeyframeIndexEntry> &GameRecorderPlayback::getKeyframes() const
+{
+   return mKeyframes;
+}
+
+
 void GameRecorderPlayback::addPendingMove(Move *theMove)
 {
    bool nextButton = theMove->fire;
@@ -259,6 +351,17 @@ void GameRecorderPlayback::processMoreData(U32 MilliSeconds)
       mCurrentTime += milli;
       mMilliSeconds += milli;
 
+      // Everything gets sent again from here; start over with it
+      if(size == GameRecorderServer::KeyframeMarker)
+      {
+         U8 seq[GameRecorderServer::KeyframeMarkerSize];
+         if(fread(seq, 1, sizeof(seq), mFile) != sizeof(seq))
+            break;
+
+         resetForKeyframe(GameRecorderServer::readU32(seq));
+         continue;
+      }
+
       if(size == 0 || size >= sizeof(data)) // End of file?
       {
          mMilliSeconds = S32_MAX;
@@ -275,17 +378,59 @@ void GameRecorderPlayback::processMoreData(U32 MilliSeconds)
 }
 
 
-void GameRecorderPlayback::restart()
+// Throws away everything we've been sent so far, ready for it all to be sent again
+void GameRecorderPlayback::resetForKeyframe(S32 eventSeq)
 {
    deleteLocalGhosts();
-   mMilliSeconds = 0;
-   mSizeToRead = 0;
-   mCurrentTime = 0;
    clearRecvEvents();
+   setNextRecvEventSeq(eventSeq);
    mGame->clearClientList();
+}
+
+
+void GameRecorderPlayback::jumpToKeyframe(const KeyframeIndexEntry &keyframe)
+{
+   resetForKeyframe(keyframe.eventSeq);
+   mMilliSeconds = 0;
+   mSizeToRead = 0;
+   mCurrentTime = keyframe.time;
 
    if(mFile)
-      fseek(mFile, 4, SEEK_SET);
+      fseek(mFile, keyframe.offset, SEEK_SET);
+}
+
+
+void GameRecorderPlayback::restart()
+{
+   if(mKeyframes.size() > 0)
+      jumpToKeyframe(mKeyframes[0]);
+}
+
+
+// Plays from the nearest keyframe at or before time, unless we're already between there and time
+void GameRecorderPlayback::seek(U32 time)
+{
+   if(mKeyframes.size() == 0)
+      return;
+
+   // Binary search for the last keyframe at or before time; the first is always at 0
+   S32 first = 0;
+   S32 last = mKeyframes.size() - 1;
+
+   while(first < last)
+   {
+      S32 mid = (first + last + 1) / 2;
+
+      if(mKeyframes[mid].time <= time)
+         first = mid;
+      else
+         last = mid - 1;
+   }
+
+   if(time < mCurrentTime || mKeyframes[first].time > mCurrentTime)
+      jumpToKeyframe(mKeyframes[first]);
+
+   processMoreData(time - mCurrentTime);
 }
 
 // --------
@@ -529,11 +674,7 @@ bool PlaybackGameUserInterface::onKeyDown(InputCode inputCode)
 
          U32 time = U32(x2 * mPlaybackConnection->mTotalTime);
 
-         // TODO: maybe we need to seek more efficiency by avoiding having to start all over from the beginning
-         if(time < mPlaybackConnection->mCurrentTime)
-            mPlaybackConnection->restart();
-
-         mPlaybackConnection->processMoreData(time - mPlaybackConnection->mCurrentTime);
+         mPlaybackConnection->seek(time);
          resetRenderState(getGame());
 
          return true;
@@ -10,6 +10,7 @@
 #include "tnlGhostConnection.h"
 #include "tnlNetObject.h"
 #include "gameConnection.h"
+#include "GameRecorder.h"
 
 #include "UIMenus.h"
 
@@ -26,6 +27,12 @@ class GameRecorderPlayback : public GameConnection
    S32 mMilliSeconds;
    U32 mSizeToRead;
    SafePtr<ClientInfo> mClientInfoSpectating;
+   Vector<KeyframeIndexEntry> mKeyframes;    // Always starts with the start of the recording
+
+   bool readIndex();
+   void scanRecording();
+   void resetForKeyframe(S32 eventSeq);
+   void jumpToKeyframe(const KeyframeIndexEntry &keyframe);
 
 public:
    GameRecorderPlayback(ClientGame *game, const char *filename);
@@ -38,6 +45,7 @@ public:
    U32 mCurrentTime;
 
    bool isValid();
+   const Vector<KeyframeIndexEntry> &getKeyframes() const;
 
    bool lostContact();
    void addPendingMove(Move *theMove);
@@ -46,6 +54,7 @@ public:
    void updateSpectate();
    void processMoreData(TNL::U32 MilliSeconds);
    void restart();
+   void seek(U32 time);
 };
 
 
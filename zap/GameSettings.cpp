@@ -85,6 +85,8 @@ ParamInfo paramDefs[] = {
 { "hostdescr",             ONE_REQUIRED,   HOST_DESCRIPTION,      1, "<string>",  "Set a brief description of the server, which will be visible when players browse for game servers. Use double quotes (\") for descriptions containing spaces.", "You must specify a description (use quotes) with the -hostdescr option" },
 { "maxplayers",            ONE_REQUIRED,   MAX_PLAYERS_PARAM,     1, "<int>",     "Max players allowed in a game (default is 128)", "You must specify the max number of players on your server with the -maxplayers option" }, 
 { "hostaddr",              ONE_REQUIRED,   HOST_ADDRESS,          1, "<address>", "Specify host address for the server to listen to when hosting",                        "You must specify a host address for the host to listen on (e.g. IP:Any:28000 or IP:192.169.1.100:5500)" },
+{ "net-workers",           ONE_REQUIRED,   NET_WORKERS,           1, "<int>",     "Number of extra threads used to build packets for connected players (default is 0, build everything on the main thread)", "You must specify the number of threads with the -net-workers option" },
+{ "bot-workers",           ONE_REQUIRED,   BOT_WORKERS,           1, "<int>",     "Number of extra threads used to run robot scripts (default is 0, run every bot on the main thread)", "You must specify the number of threads with the -bot-workers option" },
 
 // Specifying levels
 { "levels",                ALL_REMAINING,  LEVEL_LIST,            2, "<level 1> [level 2]...", "Specify the levels to play. Note that all remaining items on the command line will be interpreted as levels, so this must be the last parameter.", "You must specify one or more levels to load with the -levels option" },
@@ -107,6 +109,7 @@ ParamInfo paramDefs[] = {
 { "loss",                  ONE_REQUIRED,   SIMULATED_LOSS,        4, "<float>",   "Simulate the specified amount of packet loss, from 0 (no loss) to 1 (all packets lost) Note: Client only!", "You must specify a loss rate between 0 and 1 with the -loss option" },
 { "lag",                   ONE_REQUIRED,   SIMULATED_LAG,         4, "<int>",     "Simulate the specified amount of server lag (in milliseconds) Note: Client only!",                          "You must specify a lag (in ms) with the -lag option" },
 { "stutter",               ONE_REQUIRED,   SIMULATED_STUTTER,     4, "<int>",     "Simulate VPS CPU stutter (in milliseconds/second) Note: Server only!",                                      "You must specify a value (in ms) with the -stutter option.  Values clamped to 0-1000" },
+{ "profile",               NO_PARAMETERS,  PROFILE_TICKS,         4, "",          "Record where server ticks spend their time from the start; admins can save it with /profile Note: Server only!", "" },
 { "forceupdate",           NO_PARAMETERS,  FORCE_UPDATE,          4, "",          "Trick game into thinking it needs to update",                                            "" },
 
 // Also, see the directives section below!
@@ -407,6 +410,38 @@ U32 GameSettings::getMaxPlayers()
 }
 
 
+// Number of worker threads the server uses to scope objects and build packets for its connections
+U32 GameSettings::getNetWorkerCount()
+{
+   static const U32 MaxNetWorkers = 32;
+
+   U32 workers;
+
+   if(isCmdLineParamSpecified(NET_WORKERS))
+      workers = getCmdLineParamU32(NET_WORKERS);
+   else
+      workers = mIniSettings.mSettings.getVal<U32>(IniKey::NetWorkers);
+
+   return min(workers, MaxNetWorkers);
+}
+
+
+// Number of worker threads the server uses to run robot scripts
+U32 GameSettings::getBotWorkerCount()
+{
+   static const U32 MaxBotWorkers = 32;
+
+   U32 workers;
+
+   if(isCmdLineParamSpecified(BOT_WORKERS))
+      workers = getCmdLineParamU32(BOT_WORKERS);
+   else
+      workers = mIniSettings.mSettings.getVal<U32>(IniKey::BotWorkers);
+
+   return min(workers, MaxBotWorkers);
+}
+
+
 // Write all our settings to bitfighter.ini
 void GameSettings::save()
 {
@@ -438,6 +473,12 @@ bool GameSettings::getForceUpdate()
 }
 
 
+bool GameSettings::getProfileTicks()
+{
+   return isCmdLineParamSpecified(PROFILE_TICKS);
+}
+
+
 string GameSettings::getPlayerName()
 {
    return mPlayerName;
@@ -586,16 +627,26 @@ string GameSettings::getlevelLoc()
 }
 
 
+static const string LevelHeaderIndexFilename = "levelindex.txt";
+
 // Returns a pointer to the desired LevelSource, depending on if you are using a playlist file or not
 LevelSource *GameSettings::chooseLevelSource(Game *game)
 {
+	MultiLevelSource *levelSource;
+
 	if(isUsingPlaylist())
 	{
 		printf("isUsingPlaylist, and returned playlist object\n");
-		return new FileListLevelSource(getPlaylist(), getFolderManager()->getLevelDir(), this);
+		levelSource = new FileListLevelSource(getPlaylist(), getFolderManager()->getLevelDir(), this);
 	}
 	else
-		return new FolderLevelSource(getLevelList(), getFolderManager()->getLevelDir());
+		levelSource = new FolderLevelSource(getLevelList(), getFolderManager()->getLevelDir());
+
+	// Remember level headers between runs, so unchanged levels don't need to be read again
+	if(getFolderManager()->getIniDir() != "")
+		levelSource->setHeaderIndexFile(joindir(getFolderManager()->getIniDir(), LevelHeaderIndexFilename));
+
+	return levelSource;
 }
 
 
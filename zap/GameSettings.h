@@ -47,6 +47,8 @@ enum ParamId {
    HOST_DESCRIPTION,
    MAX_PLAYERS_PARAM,
    HOST_ADDRESS,
+   NET_WORKERS,
+   BOT_WORKERS,
 
    LEVEL_LIST,
    USE_FILE,
@@ -68,6 +70,7 @@ enum ParamId {
    SIMULATED_LOSS,
    SIMULATED_LAG,
    SIMULATED_STUTTER,
+   PROFILE_TICKS,
    FORCE_UPDATE,
 
    SEND_RESOURCE,
@@ -218,6 +221,8 @@ public:
 
    string getHostAddress();
    U32 getMaxPlayers();
+   U32 getNetWorkerCount();
+   U32 getBotWorkerCount();
 
    void save();
 
@@ -251,6 +256,7 @@ public:
    string getDefaultName();
 
    bool getForceUpdate();
+   bool getProfileTicks();
 
    string getPlayerName();
 
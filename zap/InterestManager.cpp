@@ -0,0 +1,197 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "InterestManager.h"
+
+#include "game.h"
+#include "Level.h"
+#include "ClientInfo.h"
+#include "gameConnection.h"
+#include "projectile.h"       // For SpyBug
+#include "ship.h"
+#include "TeamConstants.h"
+
+
+namespace Zap
+{
+
+// Constructor
+InterestManager::InterestManager()
+{
+   mSpyBugSetCount = 0;
+   mCmdrsMapSetCount = 0;
+}
+
+
+// Destructor
+InterestManager::~InterestManager()
+{
+   mSpyBugSets.deleteAndClear();
+   mCmdrsMapSets.deleteAndClear();
+}
+
+
+// Forget everything; sets are kept around for reuse
+void InterestManager::clear()
+{
+   mSpyBugSetCount = 0;
+   mCmdrsMapSetCount = 0;
+}
+
+
+// Find the set for the specified group, or claim a fresh one if this is the first time we've seen the group this tick
+InterestManager::VisibilitySet *InterestManager::getSet(Vector<VisibilitySet *> &sets, S32 &count, S32 team, ClientInfo *owner)
+{
+   for(S32 i = 0; i < count; i++)
+      if(sets[i]->team == team && sets[i]->owner == owner)
+         return sets[i];
+
+   if(count == sets.size())
+      sets.push_back(new VisibilitySet);
+
+   VisibilitySet *set = sets[count];
+   count++;
+
+   set->team = team;
+   set->owner = owner;
+   set->query.clear();
+
+   return set;
+}
+
+
+const InterestManager::VisibilitySet *InterestManager::findSet(const Vector<VisibilitySet *> &sets, S32 count,
+                                                               S32 team, ClientInfo *owner) const
+{
+   for(S32 i = 0; i < count; i++)
+      if(sets[i]->team == team && sets[i]->owner == owner)
+         return sets[i];
+
+   return NULL;
+}
+
+
+// Rebuild all visibility sets; call once per tick, after everything has moved, before scoping
+void InterestManager::update(Game *game, Level *level, bool isTeamGame)
+{
+   clear();
+
+   if(!level)
+      return;
+
+   updateSpyBugSets(level, isTeamGame);
+
+   if(isTeamGame)
+      updateCmdrsMapSets(game, level);
+}
+
+
+// Each spy bug is searched once, no matter how many players can see through it
+void InterestManager::updateSpyBugSets(Level *level, bool isTeamGame)
+{
+   const Vector<DatabaseObject *> *spyBugs = level->findObjects_fast(SpyBugTypeNumber);
+
+   Point scopeRange(SpyBug::SPY_BUG_RANGE, SpyBug::SPY_BUG_RANGE);
+
+   for(S32 i = 0; i < spyBugs->size(); i++)
+   {
+      SpyBug *sb = static_cast<SpyBug *>(spyBugs->get(i));
+
+      VisibilitySet *set;
+
+      // Mirrors SpyBug::isVisibleToPlayer()
+      if(sb->getTeam() == TEAM_NEUTRAL)
+         set = getSet(mSpyBugSets, mSpyBugSetCount, TEAM_NEUTRAL, NULL);
+      else if(isTeamGame)
+         set = getSet(mSpyBugSets, mSpyBugSetCount, sb->getTeam(), NULL);
+      else if(sb->getOwner())
+         set = getSet(mSpyBugSets, mSpyBugSetCount, TEAM_NEUTRAL, sb->getOwner());
+      else
+         continue;      // Owner has left; nobody can see through this one
+
+      Point pos = sb->getActualPos();
+      Rect queryRect(pos, pos);
+      queryRect.expand(scopeRange);
+
+      level->findObjects(set->query, (TestFunc)isAnyObjectType, queryRect);
+   }
+}
+
+
+// What each team's ships contribute to the commander's map.  Only built for teams where someone is looking.
+void InterestManager::updateCmdrsMapSets(Game *game, Level *level)
+{
+   for(S32 i = 0; i < game->getClientCount(); i++)
+   {
+      ClientInfo *clientInfo = game->getClientInfo(i);
+      GameConnection *conn = clientInfo->getConnection();
+
+      if(!conn || !conn->isInCommanderMap())
+         continue;
+
+      S32 team = clientInfo->getTeamIndex();
+
+      if(findSet(mCmdrsMapSets, mCmdrsMapSetCount, team, NULL))     // Already built
+         continue;
+
+      VisibilitySet *set = getSet(mCmdrsMapSets, mCmdrsMapSetCount, team, NULL);
+
+      for(S32 j = 0; j < game->getClientCount(); j++)
+      {
+         ClientInfo *teammate = game->getClientInfo(j);
+
+         if(teammate->getTeamIndex() != team)
+            continue;
+
+         Ship *ship = teammate->getShip();
+         if(!ship)            // Can happen!
+            continue;
+
+         bool hasSensor = ship->hasModule(ModuleSensor);
+
+         Rect queryRect(ship->getActualPos(), ship->getActualPos());
+         queryRect.expand(Game::getScopeRange(hasSensor));
+
+         TestFunc testFunc = hasSensor ? &isVisibleOnCmdrsMapWithSensorType : &isVisibleOnCmdrsMapType;
+
+         level->findObjects(set->query, testFunc, queryRect);
+      }
+   }
+}
+
+
+// Objects seen by neutral spy bugs, which are visible to everyone
+const Vector<DatabaseObject *> *InterestManager::getNeutralSpyBugObjects() const
+{
+   const VisibilitySet *set = findSet(mSpyBugSets, mSpyBugSetCount, TEAM_NEUTRAL, NULL);
+
+   return set ? &set->query.results : NULL;
+}
+
+
+// Objects seen by the spy bugs belonging to clientInfo's team (or, in non-team games, to clientInfo itself)
+const Vector<DatabaseObject *> *InterestManager::getSpyBugObjects(ClientInfo *clientInfo, bool isTeamGame) const
+{
+   const VisibilitySet *set;
+
+   if(isTeamGame)
+      set = clientInfo->getTeamIndex() == TEAM_NEUTRAL ? NULL : findSet(mSpyBugSets, mSpyBugSetCount, clientInfo->getTeamIndex(), NULL);
+   else
+      set = findSet(mSpyBugSets, mSpyBugSetCount, TEAM_NEUTRAL, clientInfo);
+
+   return set ? &set->query.results : NULL;
+}
+
+
+// Objects the ships of the specified team show on the commander's map
+const Vector<DatabaseObject *> *InterestManager::getCmdrsMapObjects(S32 team) const
+{
+   const VisibilitySet *set = findSet(mCmdrsMapSets, mCmdrsMapSetCount, team, NULL);
+
+   return set ? &set->query.results : NULL;
+}
+
+
+}
@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _INTEREST_MANAGER_H_
+#define _INTEREST_MANAGER_H_
+
+#include "gridDB.h"
+
+#include "tnlVector.h"
+
+using namespace TNL;
+
+namespace Zap
+{
+
+class Game;
+class Level;
+class ClientInfo;
+
+// Works out, once per tick, what each team can see through its spy bugs and its ships on the commander's map.
+// Scope queries for individual players then just walk the shared results instead of repeating the same searches
+// for every teammate.  Server only.
+//
+// Results are only valid until objects are next added, moved or removed, so update() needs to be called right
+// before the connections are processed.  Once updated, lookups are read-only and safe from any thread.
+class InterestManager
+{
+private:
+   // Objects visible to one group of players
+   struct VisibilitySet
+   {
+      S32 team;               // Team whose players share this set, or TEAM_NEUTRAL
+      ClientInfo *owner;      // In non-team games, spy bugs are only visible to their owner; NULL otherwise
+      DatabaseQuery query;    // What the group can see; each object appears only once
+   };
+
+   Vector<VisibilitySet *> mSpyBugSets;      // One per team (or owner) with spy bugs, plus one for neutral bugs
+   Vector<VisibilitySet *> mCmdrsMapSets;    // One per team with a player looking at the commander's map
+   S32 mSpyBugSetCount;
+   S32 mCmdrsMapSetCount;
+
+   VisibilitySet *getSet(Vector<VisibilitySet *> &sets, S32 &count, S32 team, ClientInfo *owner);
+   const VisibilitySet *findSet(const Vector<VisibilitySet *> &sets, S32 count, S32 team, ClientInfo *owner) const;
+
+   void updateSpyBugSets(Level *level, bool isTeamGame);
+   void updateCmdrsMapSets(Game *game, Level *level);
+
+public:
+   InterestManager();      // Constructor
+   ~InterestManager();     // Destructor
+
+   void update(Game *game, Level *level, bool isTeamGame);
+   void clear();
+
+   // Each returns NULL if there is nothing to see
+   const Vector<DatabaseObject *> *getNeutralSpyBugObjects() const;
+   const Vector<DatabaseObject *> *getSpyBugObjects(ClientInfo *clientInfo, bool isTeamGame) const;
+   const Vector<DatabaseObject *> *getCmdrsMapObjects(S32 team) const;
+};
+
+}
+
+#endif
+
@@ -10,6 +10,7 @@
 #include "game.h"
 #include "gameType.h"
 #include "LevelDatabase.h"
+#include "LevelGeometryCache.h"
 #include "LevelLoadException.h"
 #include "robot.h"
 #include "Spawn.h"
@@ -21,6 +22,7 @@
 #include "stringUtils.h"
 
 #include "tnlLog.h"
+#include "tnlProfiler.h"
 
 #include <fstream>
 #include <sstream>
@@ -160,6 +162,8 @@ namespace Zap
    // if contents is empty or somehow invalid.
    void Level::loadLevelFromString(const string &contents, const string &filename)
    {
+      TNL_PROFILE_SCOPE("Level::loadLevelFromString");
+
       istringstream iss(contents);
       string line;
 
@@ -173,9 +177,9 @@ namespace Zap
 
       mLevelHash = md5.getHash();
 
-      // Build wall edge geometry
+      // Build wall edge geometry, or fetch it if we've seen this level before
       Vector<Point> wallEdgePoints;  // <== not used
-      buildWallEdgeGeometry(wallEdgePoints);
+      buildCachedWallEdgeGeometry(wallEdgePoints);
 
       // Snap enigneered items to those edges
       snapAllEngineeredItems(false);
@@ -214,6 +218,22 @@ namespace Zap
    }
 
 
+   // Like buildWallEdgeGeometry(), but uses edges from the LevelGeometryCache if it has any for this level, and adds them
+   // to it if it doesn't.  The cache is keyed by the level's hash, so only use this when the walls are still exactly as
+   // they were in the level file.
+   void Level::buildCachedWallEdgeGeometry(Vector<Point> &wallEdgePoints)
+   {
+      if(LevelGeometryCache::getWallEdges(mLevelHash, wallEdgePoints))
+      {
+         mWallEdgeManager.setEdges(wallEdgePoints);
+         return;
+      }
+
+      buildWallEdgeGeometry(wallEdgePoints);
+      LevelGeometryCache::putWallEdges(mLevelHash, wallEdgePoints);
+   }
+
+
    // Snaps all engineered items in database
    void Level::snapAllEngineeredItems(bool onlyUnsnapped)
    {
@@ -87,6 +87,7 @@ public:
    LevelInfo &getLevelInfo();
 
    void buildWallEdgeGeometry(Vector<Point> &wallEdgePoints);
+   void buildCachedWallEdgeGeometry(Vector<Point> &wallEdgePoints);
    void snapAllEngineeredItems(bool onlyUnsnapped);
 
    string toLevelCode() const;
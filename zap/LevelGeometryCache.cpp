@@ -0,0 +1,486 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "LevelGeometryCache.h"
+
+#include "BotNavMeshZone.h"
+#include "stringUtils.h"
+
+#include "tnlEndian.h"
+#include "tnlLog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace Zap
+{
+
+// Statics
+string LevelGeometryCache::mFolder;
+Mutex LevelGeometryCache::mLock;
+U32 LevelGeometryCache::mHits = 0;
+U32 LevelGeometryCache::mMisses = 0;
+
+static const U32 CacheMagic = 0x47464242;    // "BBFG"
+static const char *CacheExtension = ".geom";
+
+enum GeometryFlags {
+   HasWallEdgesFlag  = BIT(0),
+   HasNavMeshFlag    = BIT(1),
+   NavMeshFailedFlag = BIT(2),
+};
+
+
+// Constructor
+LevelGeometryCache::Geometry::Geometry()
+{
+   hasWallEdges = false;
+   hasNavMesh = false;
+   navMeshFailed = false;
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+// Everything is stored little-endian, whatever the host
+static void writeU32(Vector<U8> &data, U32 value)
+{
+   value = convertHostToLEndian(value);
+
+   S32 pos = data.size();
+   data.resize(pos + sizeof(value));
+   memcpy(data.address() + pos, &value, sizeof(value));
+}
+
+
+static void writeF32(Vector<U8> &data, F32 value)
+{
+   U32 bits;
+   memcpy(&bits, &value, sizeof(bits));
+   writeU32(data, bits);
+}
+
+
+static void writePoint(Vector<U8> &data, const Point &point)
+{
+   writeF32(data, point.x);
+   writeF32(data, point.y);
+}
+
+
+static void writePoints(Vector<U8> &data, const Vector<Point> &points)
+{
+   writeU32(data, points.size());
+
+   for(S32 i = 0; i < points.size(); i++)
+      writePoint(data, points[i]);
+}
+
+
+// Reads values from a buffer; once we run off the end, everything reads as 0 and isValid() goes false
+class GeometryReader
+{
+private:
+   const U8 *mData;
+   U32 mSize;
+   U32 mPos;
+   bool mValid;
+
+public:
+   GeometryReader(const U8 *data, U32 size)
+   {
+      mData = data;
+      mSize = size;
+      mPos = 0;
+      mValid = true;
+   }
+
+   bool isValid() const
+   {
+      return mValid;
+   }
+
+   U32 readU32()
+   {
+      if(!mValid || mSize - mPos < sizeof(U32))
+      {
+         mValid = false;
+         return 0;
+      }
+
+      U32 value;
+      memcpy(&value, mData + mPos, sizeof(value));
+      mPos += sizeof(value);
+
+      return convertLEndianToHost(value);
+   }
+
+   F32 readF32()
+   {
+      U32 bits = readU32();
+
+      F32 value;
+      memcpy(&value, &bits, sizeof(value));
+      return value;
+   }
+
+   Point readPoint()
+   {
+      F32 x = readF32();
+      F32 y = readF32();
+      return Point(x, y);
+   }
+
+   // Count is checked against what's left, so a corrupt file can't have us allocating gigabytes
+   U32 readCount(U32 bytesPerItem)
+   {
+      U32 count = readU32();
+
+      if(!mValid || count > (mSize - mPos) / bytesPerItem)
+      {
+         mValid = false;
+         return 0;
+      }
+
+      return count;
+   }
+
+   void readPoints(Vector<Point> &points)
+   {
+      U32 count = readCount(2 * sizeof(F32));
+
+      points.resize(count);
+      for(U32 i = 0; i < count; i++)
+         points[i] = readPoint();
+   }
+};
+
+
+// Layout: magic, version, hash, flags, wall edges, then zones with their outlines and neighbors
+void LevelGeometryCache::writeGeometry(const string &hash, const Geometry &geometry, Vector<U8> &data)
+{
+   data.clear();
+
+   writeU32(data, CacheMagic);
+   writeU32(data, FormatVersion);
+
+   writeU32(data, (U32)hash.length());
+   for(size_t i = 0; i < hash.length(); i++)
+      data.push_back(U8(hash[i]));
+
+   U32 flags = 0;
+   if(geometry.hasWallEdges)
+      flags |= HasWallEdgesFlag;
+   if(geometry.hasNavMesh)
+      flags |= HasNavMeshFlag;
+   if(geometry.navMeshFailed)
+      flags |= NavMeshFailedFlag;
+
+   writeU32(data, flags);
+
+   writePoints(data, geometry.wallEdges);
+
+   writeU32(data, geometry.zones.size());
+
+   for(S32 i = 0; i < geometry.zones.size(); i++)
+   {
+      const CachedZone &zone = geometry.zones[i];
+
+      writeU32(data, zone.zoneId);
+      writePoints(data, zone.outline);
+
+      writeU32(data, zone.neighbors.size());
+
+      for(S32 j = 0; j < zone.neighbors.size(); j++)
+      {
+         const NeighboringZone &neighbor = zone.neighbors[j];
+
+         writeU32(data, neighbor.zoneID);
+         writePoint(data, neighbor.borderStart);
+         writePoint(data, neighbor.borderEnd);
+         writePoint(data, neighbor.borderCenter);
+         writePoint(data, neighbor.center);
+         writeF32(data, neighbor.distTo);
+      }
+   }
+}
+
+
+// Returns false if data isn't a complete geometry record for this hash, in this version of the format
+bool LevelGeometryCache::readGeometry(const string &hash, const U8 *data, U32 size, Geometry &geometry)
+{
+   GeometryReader reader(data, size);
+
+   if(reader.readU32() != CacheMagic || reader.readU32() != FormatVersion)
+      return false;
+
+   U32 hashLength = reader.readCount(1);
+   if(!reader.isValid() || hashLength != hash.length() || memcmp(data + 3 * sizeof(U32), hash.c_str(), hashLength) != 0)
+      return false;
+
+   GeometryReader body(data + 3 * sizeof(U32) + hashLength, size - 3 * sizeof(U32) - hashLength);
+
+   U32 flags = body.readU32();
+   geometry.hasWallEdges  = (flags & HasWallEdgesFlag) != 0;
+   geometry.hasNavMesh    = (flags & HasNavMeshFlag) != 0;
+   geometry.navMeshFailed = (flags & NavMeshFailedFlag) != 0;
+
+   body.readPoints(geometry.wallEdges);
+
+   const U32 MinZoneSize = 3 * sizeof(U32);
+   const U32 NeighborSize = sizeof(U32) + 9 * sizeof(F32);
+
+   U32 zoneCount = body.readCount(MinZoneSize);
+   geometry.zones.resize(zoneCount);
+
+   for(U32 i = 0; i < zoneCount && body.isValid(); i++)
+   {
+      CachedZone &zone = geometry.zones[i];
+
+      zone.zoneId = U16(body.readU32());
+      body.readPoints(zone.outline);
+
+      U32 neighborCount = body.readCount(NeighborSize);
+      zone.neighbors.resize(neighborCount);
+
+      for(U32 j = 0; j < neighborCount; j++)
+      {
+         NeighboringZone &neighbor = zone.neighbors[j];
+
+         neighbor.zoneID       = U16(body.readU32());
+         neighbor.borderStart  = body.readPoint();
+         neighbor.borderEnd    = body.readPoint();
+         neighbor.borderCenter = body.readPoint();
+         neighbor.center       = body.readPoint();
+         neighbor.distTo       = body.readF32();
+      }
+   }
+
+   return body.isValid();
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+void LevelGeometryCache::setFolder(const string &folder)
+{
+   mLock.lock();
+
+   mFolder = folder;
+
+   if(mFolder != "" && !makeSureFolderExists(mFolder))
+      mFolder = "";
+
+   mLock.unlock();
+}
+
+
+bool LevelGeometryCache::isEnabled()
+{
+   mLock.lock();
+   bool enabled = mFolder != "";
+   mLock.unlock();
+
+   return enabled;
+}
+
+
+string LevelGeometryCache::getFilename(const string &hash)
+{
+   return joindir(mFolder, hash + CacheExtension);
+}
+
+
+// Private; call with mLock held
+bool LevelGeometryCache::load(const string &hash, Geometry &geometry)
+{
+   if(mFolder == "" || hash == "")
+      return false;
+
+   // Geometry files are small enough, even for big levels, that reading the whole thing in one go is the quick way
+   string contents;
+   if(!readFile(getFilename(hash), contents))
+      return false;
+
+   if(readGeometry(hash, (const U8 *)contents.data(), (U32)contents.size(), geometry))
+      return true;
+
+   geometry = Geometry();     // Stale or damaged; start over
+   return false;
+}
+
+
+// Private; call with mLock held.  Writes to a temp file first, so a crash can't leave a half-written file behind.
+bool LevelGeometryCache::save(const string &hash, const Geometry &geometry)
+{
+   if(mFolder == "" || hash == "")
+      return false;
+
+   Vector<U8> data;
+   writeGeometry(hash, geometry, data);
+
+   string filename = getFilename(hash);
+   string tempFilename = filename + ".tmp";
+
+   FILE *f = fopen(tempFilename.c_str(), "wb");
+   if(!f)
+   {
+      logprintf(LogConsumer::LogWarning, "Could not write level geometry cache file %s", tempFilename.c_str());
+      return false;
+   }
+
+   bool ok = fwrite(data.address(), 1, data.size(), f) == (size_t)data.size();
+   ok = (fclose(f) == 0) && ok;
+
+   remove(filename.c_str());     // Windows won't rename over an existing file
+
+   if(!ok || rename(tempFilename.c_str(), filename.c_str()) != 0)
+   {
+      remove(tempFilename.c_str());
+      return false;
+   }
+
+   return true;
+}
+
+
+bool LevelGeometryCache::getWallEdges(const string &hash, Vector<Point> &wallEdgePoints)
+{
+   Geometry geometry;
+
+   mLock.lock();
+   bool found = load(hash, geometry) && geometry.hasWallEdges;
+
+   if(mFolder != "")
+   {
+      if(found)
+         mHits++;
+      else
+         mMisses++;
+   }
+   mLock.unlock();
+
+   if(found)
+      wallEdgePoints = geometry.wallEdges;
+
+   return found;
+}
+
+
+void LevelGeometryCache::putWallEdges(const string &hash, const Vector<Point> &wallEdgePoints)
+{
+   mLock.lock();
+
+   if(mFolder != "")
+   {
+      Geometry geometry;
+      load(hash, geometry);      // Keep any nav mesh we already have
+
+      geometry.hasWallEdges = true;
+      geometry.wallEdges = wallEdgePoints;
+
+      save(hash, geometry);
+   }
+
+   mLock.unlock();
+}
+
+
+bool LevelGeometryCache::getNavMesh(const string &hash, GridDatabase &botZoneDatabase, Vector<BotNavMeshZone *> &allZones,
+                                    bool triangulateZones, bool &failed)
+{
+   Geometry geometry;
+
+   mLock.lock();
+   bool found = load(hash, geometry) && geometry.hasNavMesh;
+
+   if(mFolder != "")
+   {
+      if(found)
+         mHits++;
+      else
+         mMisses++;
+   }
+   mLock.unlock();
+
+   if(!found)
+      return false;
+
+   // Rebuild the zones the same way BotNavMeshZone::buildBotMeshZones() does, in zone id order so each zone's
+   // position in allZones matches its id
+   allZones.deleteAndClear();
+
+   for(S32 i = 0; i < geometry.zones.size(); i++)
+   {
+      const CachedZone &cachedZone = geometry.zones[i];
+
+      BotNavMeshZone *zone = new BotNavMeshZone(cachedZone.zoneId);
+
+      if(!triangulateZones)
+         zone->disableTriangulation();
+
+      for(S32 j = 0; j < cachedZone.outline.size(); j++)
+         zone->addVert(cachedZone.outline[j]);
+
+      zone->mNeighbors = cachedZone.neighbors;
+      zone->addToZoneDatabase(&botZoneDatabase);
+
+      allZones.push_back(zone);
+   }
+
+   failed = geometry.navMeshFailed;
+   return true;
+}
+
+
+void LevelGeometryCache::putNavMesh(const string &hash, const Vector<BotNavMeshZone *> &allZones, bool failed)
+{
+   mLock.lock();
+
+   if(mFolder != "")
+   {
+      Geometry geometry;
+      load(hash, geometry);      // Keep the wall edges
+
+      geometry.hasNavMesh = true;
+      geometry.navMeshFailed = failed;
+      geometry.zones.resize(allZones.size());
+
+      for(S32 i = 0; i < allZones.size(); i++)
+      {
+         BotNavMeshZone *zone = allZones[i];
+         CachedZone &cachedZone = geometry.zones[i];
+
+         cachedZone.zoneId = zone->getZoneId();
+         cachedZone.outline = *zone->getOutline();
+         cachedZone.neighbors = zone->mNeighbors;
+      }
+
+      save(hash, geometry);
+   }
+
+   mLock.unlock();
+}
+
+
+void LevelGeometryCache::getStats(U32 &hits, U32 &misses, bool reset)
+{
+   mLock.lock();
+
+   hits = mHits;
+   misses = mMisses;
+
+   if(reset)
+   {
+      mHits = 0;
+      mMisses = 0;
+   }
+
+   mLock.unlock();
+}
+
+}
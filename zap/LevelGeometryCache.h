@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _LEVEL_GEOMETRY_CACHE_H_
+#define _LEVEL_GEOMETRY_CACHE_H_
+
+#include "BotNavMeshZone.h"      // For NeighboringZone
+#include "Point.h"
+
+#include "tnlThread.h"
+#include "tnlTypes.h"
+#include "tnlVector.h"
+
+#include <string>
+
+using namespace TNL;
+using namespace std;
+
+namespace Zap
+{
+
+// Keeps the expensive-to-build geometry of levels we've already played -- the Clipper-merged wall edges and the bot
+// nav mesh -- in a binary file per level, named for the level's MD5 hash.  Loading a level we've seen before can then
+// skip straight to adding objects to the game.
+//
+// Everything here is derived from the level file alone, so a hash match means the geometry is good.  Nav meshes for
+// levels with levelgens are never cached, since the scripts can add walls.  Bump FormatVersion whenever wall edge or
+// zone generation changes, and old files will be ignored and rewritten.
+//
+// The cache is disabled until setFolder() is called.  All methods are static, and safe to call from the level
+// pipeline's thread.
+class LevelGeometryCache
+{
+public:
+   enum {
+      FormatVersion = 1,
+   };
+
+   struct CachedZone
+   {
+      U16 zoneId;
+      Vector<Point> outline;
+      Vector<NeighboringZone> neighbors;
+   };
+
+   // What we know about one level
+   struct Geometry
+   {
+      bool hasWallEdges;
+      Vector<Point> wallEdges;       // Pairs of points, as produced by WallEdgeManager::clipAllWallEdges()
+
+      bool hasNavMesh;
+      bool navMeshFailed;            // Zone generation gave up on this level; no point trying again
+      Vector<CachedZone> zones;
+
+      Geometry();
+   };
+
+private:
+   static string mFolder;
+   static Mutex mLock;
+
+   static U32 mHits;
+   static U32 mMisses;
+
+   static string getFilename(const string &hash);
+
+   static bool load(const string &hash, Geometry &geometry);      // Call with mLock held
+   static bool save(const string &hash, const Geometry &geometry);
+
+public:
+   static void setFolder(const string &folder);    // "" disables the cache
+   static bool isEnabled();
+
+   static bool getWallEdges(const string &hash, Vector<Point> &wallEdgePoints);
+   static void putWallEdges(const string &hash, const Vector<Point> &wallEdgePoints);
+
+   // Rebuilds botZoneDatabase and allZones from the cache; failed is set if zone generation failed for this level
+   static bool getNavMesh(const string &hash, GridDatabase &botZoneDatabase, Vector<BotNavMeshZone *> &allZones,
+                          bool triangulateZones, bool &failed);
+   static void putNavMesh(const string &hash, const Vector<BotNavMeshZone *> &allZones, bool failed);
+
+   static void writeGeometry(const string &hash, const Geometry &geometry, Vector<U8> &data);
+   static bool readGeometry(const string &hash, const U8 *data, U32 size, Geometry &geometry);
+
+   static void getStats(U32 &hits, U32 &misses, bool reset = true);
+};
+
+}
+
+#endif
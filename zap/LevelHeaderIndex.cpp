@@ -0,0 +1,267 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "LevelHeaderIndex.h"
+
+#include "LevelSource.h"
+#include "gameType.h"
+
+#include "tnlLog.h"
+#include "tnlVector.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+
+namespace Zap
+{
+
+// Bump the version if the columns change, and old indexes will be ignored
+const char *LevelHeaderIndex::Header = "# Bitfighter level header index v1";
+
+enum IndexColumns {
+   PathCol,
+   ModTimeCol,
+   SizeCol,
+   GameTypeCol,
+   MinPlayersCol,
+   MaxPlayersCol,
+   ScriptCol,
+   LevelNameCol,
+   ColumnCount
+};
+
+
+// Constructor
+LevelHeaderIndex::LevelHeaderIndex()
+{
+   mDirty = false;
+   mHits = 0;
+   mMisses = 0;
+}
+
+
+// Destructor
+LevelHeaderIndex::~LevelHeaderIndex()
+{
+   // Do nothing
+}
+
+
+void LevelHeaderIndex::setFilename(const string &filename)
+{
+   mFilename = filename;
+}
+
+
+const string &LevelHeaderIndex::getFilename() const
+{
+   return mFilename;
+}
+
+
+bool LevelHeaderIndex::load()
+{
+   if(mFilename == "")
+      return false;
+
+   ifstream file(mFilename.c_str());
+   if(!file)
+      return false;
+
+   readFromStream(file);
+   return true;
+}
+
+
+bool LevelHeaderIndex::save()
+{
+   if(mFilename == "" || !mDirty)
+      return true;
+
+   ofstream file(mFilename.c_str());
+   if(!file)
+   {
+      logprintf(LogConsumer::LogWarning, "Could not write level index %s", mFilename.c_str());
+      return false;
+   }
+
+   writeToStream(file);
+   mDirty = false;
+
+   return true;
+}
+
+
+// Tabs and line breaks would throw off the columns; nothing legitimate should contain them anyway
+static string sanitizeColumn(const string &str)
+{
+   string col = str;
+
+   for(size_t i = 0; i < col.length(); i++)
+      if(col[i] == '\t' || col[i] == '\n' || col[i] == '\r')
+         col[i] = ' ';
+
+   return col;
+}
+
+
+static S64 parseS64(const string &str)
+{
+   S64 val = 0;
+   istringstream(str) >> val;
+   return val;
+}
+
+
+static void splitColumns(const string &line, Vector<string> &cols)
+{
+   cols.clear();
+
+   size_t start = 0;
+   for(;;)
+   {
+      size_t end = line.find('\t', start);
+      if(end == string::npos)
+      {
+         cols.push_back(line.substr(start));
+         return;
+      }
+
+      cols.push_back(line.substr(start, end - start));
+      start = end + 1;
+   }
+}
+
+
+// Adds whatever it can read from stream to the index; anything that doesn't look right is skipped
+void LevelHeaderIndex::readFromStream(istream &stream)
+{
+   string line;
+
+   if(!getline(stream, line) || line != Header)
+      return;
+
+   Vector<string> cols;
+
+   while(getline(stream, line))
+   {
+      if(line.length() > 0 && line[line.length() - 1] == '\r')
+         line.erase(line.length() - 1);
+
+      splitColumns(line, cols);
+
+      if(cols.size() != ColumnCount || cols[PathCol] == "")
+         continue;
+
+      GameTypeId gameTypeId = GameType::getGameTypeIdFromName(cols[GameTypeCol]);
+      if(gameTypeId == NoGameType)
+         continue;
+
+      Entry &entry = mEntries[cols[PathCol]];
+
+      entry.modTime = parseS64(cols[ModTimeCol]);
+      entry.size = parseS64(cols[SizeCol]);
+      entry.levelType = gameTypeId;
+      entry.minRecPlayers = atoi(cols[MinPlayersCol].c_str());
+      entry.maxRecPlayers = atoi(cols[MaxPlayersCol].c_str());
+      entry.scriptFileName = cols[ScriptCol];
+      entry.levelName = cols[LevelNameCol];
+   }
+}
+
+
+void LevelHeaderIndex::writeToStream(ostream &stream) const
+{
+   stream << Header << '\n';
+
+   for(EntryMap::const_iterator it = mEntries.begin(); it != mEntries.end(); it++)
+   {
+      const Entry &entry = it->second;
+
+      stream << sanitizeColumn(it->first)                        << '\t'
+             << entry.modTime                                    << '\t'
+             << entry.size                                       << '\t'
+             << GameType::getGameTypeClassName(entry.levelType)  << '\t'
+             << entry.minRecPlayers                              << '\t'
+             << entry.maxRecPlayers                              << '\t'
+             << sanitizeColumn(entry.scriptFileName)             << '\t'
+             << sanitizeColumn(entry.levelName)                  << '\n';
+   }
+}
+
+
+bool LevelHeaderIndex::lookup(const string &path, S64 modTime, S64 size, LevelInfo &levelInfo)
+{
+   EntryMap::const_iterator it = mEntries.find(path);
+
+   if(it == mEntries.end() || it->second.modTime != modTime || it->second.size != size)
+   {
+      mMisses++;
+      return false;
+   }
+
+   const Entry &entry = it->second;
+
+   levelInfo.mLevelName = entry.levelName;
+   levelInfo.mLevelType = entry.levelType;
+   levelInfo.minRecPlayers = entry.minRecPlayers;
+   levelInfo.maxRecPlayers = entry.maxRecPlayers;
+   levelInfo.mScriptFileName = entry.scriptFileName;
+
+   mHits++;
+   return true;
+}
+
+
+void LevelHeaderIndex::store(const string &path, S64 modTime, S64 size, const LevelInfo &levelInfo)
+{
+   Entry &entry = mEntries[path];
+
+   entry.modTime = modTime;
+   entry.size = size;
+   entry.levelName = levelInfo.mLevelName.getString();
+   entry.levelType = levelInfo.mLevelType;
+   entry.minRecPlayers = levelInfo.minRecPlayers;
+   entry.maxRecPlayers = levelInfo.maxRecPlayers;
+   entry.scriptFileName = levelInfo.mScriptFileName;
+
+   mDirty = true;
+}
+
+
+// Like lookup(), but without filling anything in or counting towards the stats
+bool LevelHeaderIndex::isCurrent(const string &path, S64 modTime, S64 size) const
+{
+   EntryMap::const_iterator it = mEntries.find(path);
+   return it != mEntries.end() && it->second.modTime == modTime && it->second.size == size;
+}
+
+
+S32 LevelHeaderIndex::getEntryCount() const
+{
+   return (S32)mEntries.size();
+}
+
+
+bool LevelHeaderIndex::isDirty() const
+{
+   return mDirty;
+}
+
+
+void LevelHeaderIndex::getStats(U32 &hits, U32 &misses, bool reset)
+{
+   hits = mHits;
+   misses = mMisses;
+
+   if(reset)
+   {
+      mHits = 0;
+      mMisses = 0;
+   }
+}
+
+}
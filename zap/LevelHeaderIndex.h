@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _LEVEL_HEADER_INDEX_H_
+#define _LEVEL_HEADER_INDEX_H_
+
+#include "GameTypesEnum.h"       // For GameTypeId
+
+#include "tnlTypes.h"
+
+#include <map>
+#include <string>
+
+using namespace TNL;
+using namespace std;
+
+namespace Zap
+{
+
+struct LevelInfo;
+
+// Remembers what we found in the header of each level file we've looked at, so a server with thousands of levels
+// doesn't have to open and parse every one of them each time it starts up.  Entries are keyed by the level's full
+// path, and are only used while the file's modification time and size still match what they were when we read it.
+//
+// The index is kept in a tab separated text file, one level per line; a file from some other version, or one that
+// can't be read at all, just means we start with an empty index.
+class LevelHeaderIndex
+{
+private:
+   struct Entry
+   {
+      S64 modTime;
+      S64 size;
+      string levelName;
+      GameTypeId levelType;
+      S32 minRecPlayers;
+      S32 maxRecPlayers;
+      string scriptFileName;
+   };
+
+   typedef map<string, Entry> EntryMap;
+
+   EntryMap mEntries;
+   string mFilename;          // Where we load from and save to; "" if the index only lives in memory
+   bool mDirty;               // True if anything has changed since we were loaded or saved
+
+   U32 mHits;
+   U32 mMisses;
+
+public:
+   static const char *Header;
+
+   LevelHeaderIndex();           // Constructor
+   virtual ~LevelHeaderIndex();  // Destructor
+
+   void setFilename(const string &filename);
+   const string &getFilename() const;
+
+   bool load();               // Returns true if an index was read from mFilename
+   bool save();               // Only writes if something changed; returns false if the file couldn't be written
+
+   void readFromStream(istream &stream);
+   void writeToStream(ostream &stream) const;
+
+   // Fills in levelInfo's header fields if we have an up-to-date entry for path; filename and folder are left alone
+   bool lookup(const string &path, S64 modTime, S64 size, LevelInfo &levelInfo);
+   void store(const string &path, S64 modTime, S64 size, const LevelInfo &levelInfo);
+   bool isCurrent(const string &path, S64 modTime, S64 size) const;
+
+   S32 getEntryCount() const;
+   bool isDirty() const;
+
+   void getStats(U32 &hits, U32 &misses, bool reset = true);
+};
+
+}
+
+#endif
@@ -0,0 +1,235 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "LevelPipeline.h"
+
+#include "Level.h"
+#include "LevelSource.h"
+#include "gridDB.h"
+
+#include "tnlNetStringTable.h"
+#include "tnlPlatform.h"
+#include "tnlAssert.h"
+
+namespace Zap
+{
+
+// Constructor
+LevelLoadStats::LevelLoadStats()
+{
+   clear();
+}
+
+
+void LevelLoadStats::clear()
+{
+   prepared = false;
+   prepareMs = 0;
+   waitMs = 0;
+   addToGameMs = 0;
+   levelGenMs = 0;
+   navMeshMs = 0;
+   navMeshCached = false;
+   totalMs = 0;
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+// Constructor
+LevelPipeline::Loader::Loader(LevelSource *source, S32 index)
+{
+   this->source = source;
+   this->index = index;
+   level = NULL;
+   prepareMs = 0;
+
+   mFinished = false;
+   mJoined = false;
+}
+
+
+U32 LevelPipeline::Loader::run()
+{
+   S64 startTime = Platform::getHighPrecisionTimerValue();
+
+   level = source->getLevel(index);
+
+   prepareMs = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - startTime);
+
+   // We're the only thing this thread will ever do
+   Thread::runExitFunctions();
+
+   mLock.lock();
+   mFinished = true;
+   mLock.unlock();
+
+   mDone.increment();
+   return 0;
+}
+
+
+bool LevelPipeline::Loader::isFinished()
+{
+   mLock.lock();
+   bool finished = mFinished;
+   mLock.unlock();
+
+   return finished;
+}
+
+
+// Wait for the thread to end, however long that takes
+void LevelPipeline::Loader::finish()
+{
+   if(!mJoined)
+      mDone.wait();
+
+   mJoined = true;
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+// Constructor
+LevelPipeline::LevelPipeline()
+{
+   mLoader = NULL;
+   mLevel = NULL;
+   mPrepareMs = 0;
+   mIndex = -1;
+   mSource = NULL;
+}
+
+
+// Destructor
+LevelPipeline::~LevelPipeline()
+{
+   cancel();
+}
+
+
+// Start loading the specified level in the background.  If we're already working on a different level, that one
+// is thrown away.  Returns false if the thread could not be started, in which case the level will simply be loaded
+// the usual way when it's needed.
+bool LevelPipeline::prepare(LevelSource *source, S32 index)
+{
+   TNLAssert(source, "Need a LevelSource!");
+
+   if(index < 0 || index >= source->getLevelCount())
+      return false;
+
+   string descriptor = source->getLevelFileDescriptor(index);
+
+   // Already on it
+   if(mIndex == index && mSource == source && mDescriptor == descriptor)
+      return true;
+
+   cancel();
+
+   // Loading creates StringTableEntries and adds objects to the level's databases, which share some global state
+   // with the rest of the game
+   StringTable::setThreadSafe(true);
+   GridDatabase::setThreadSafe(true);
+
+   mLoader = new Loader(source, index);
+
+   if(!mLoader->start())
+   {
+      delete mLoader;
+      mLoader = NULL;
+
+      StringTable::setThreadSafe(false);
+      GridDatabase::setThreadSafe(false);
+
+      return false;
+   }
+
+   mSource = source;
+   mIndex = index;
+   mDescriptor = descriptor;
+
+   return true;
+}
+
+
+S32 LevelPipeline::getPreparedIndex() const
+{
+   return mIndex;
+}
+
+
+void LevelPipeline::collect()
+{
+   if(!mLoader)
+      return;
+
+   mLoader->finish();
+
+   mLevel = mLoader->level;
+   mPrepareMs = mLoader->prepareMs;
+
+   delete mLoader;
+   mLoader = NULL;
+
+   StringTable::setThreadSafe(false);
+   GridDatabase::setThreadSafe(false);
+}
+
+
+// Hand over the level we prepared, if it's the one being asked for, waiting for the loader to finish if need be.
+// Returns NULL if we don't have it, in which case the caller should load the level itself.  The caller owns the
+// returned Level.
+Level *LevelPipeline::take(LevelSource *source, S32 index, F64 &prepareMs)
+{
+   if(mIndex == -1)
+      return NULL;
+
+   // Levels can be added, removed or replaced after we've started, so make sure we're still talking about the same one
+   if(source != mSource || index != mIndex || index >= source->getLevelCount() ||
+         source->getLevelFileDescriptor(index) != mDescriptor)
+   {
+      cancel();
+      return NULL;
+   }
+
+   collect();
+
+   Level *level = mLevel;
+   prepareMs = mPrepareMs;
+
+   mLevel = NULL;
+   mIndex = -1;
+   mSource = NULL;
+
+   return level;
+}
+
+
+// Call regularly; lets go of the thread once it's done, without waiting for it
+void LevelPipeline::update()
+{
+   if(mLoader && mLoader->isFinished())
+      collect();
+}
+
+
+// Forget whatever we were preparing.  A level already being loaded can't be interrupted, so this waits for it.
+void LevelPipeline::cancel()
+{
+   collect();
+
+   delete mLevel;
+   mLevel = NULL;
+
+   mIndex = -1;
+   mSource = NULL;
+   mDescriptor = "";
+}
+
+
+}
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _LEVEL_PIPELINE_H_
+#define _LEVEL_PIPELINE_H_
+
+#include "tnlThread.h"
+#include "tnlTypes.h"
+
+#include <string>
+
+using namespace TNL;
+using namespace std;
+
+namespace Zap
+{
+
+class Level;
+class LevelSource;
+
+// How long each stage of the last level change took
+struct LevelLoadStats
+{
+   bool prepared;       // True if the level was loaded in the background, while the previous game was finishing
+   F64 prepareMs;       // Reading, parsing, hashing and building wall geometry; on the pipeline thread if prepared is set
+   F64 waitMs;          // Time the main thread spent getting the Level, either waiting on the pipeline or loading it itself
+   F64 addToGameMs;     // Adding walls and objects to the game
+   F64 levelGenMs;      // Running levelgen scripts
+   F64 navMeshMs;       // Building the bot nav mesh, or fetching it from the LevelGeometryCache
+   bool navMeshCached;  // True if it came from the cache
+   F64 totalMs;         // Everything, start to finish, on the main thread
+
+   LevelLoadStats();
+   void clear();
+};
+
+
+// Loads the next level on a thread of its own while the current game is winding down, so that when it's time to
+// switch, all ServerGame has left to do is add the prepared Level to the game.  Only the work done by
+// LevelSource::getLevel() happens in the background; anything that needs the game itself (adding objects, running
+// levelgens, building the nav mesh) stays on the main thread.
+//
+// Only one level is prepared at a time.  While a level is being prepared, the StringTable and GridDatabase are
+// switched to their thread safe modes; call update() regularly so they can be switched back once loading is done.
+class LevelPipeline
+{
+private:
+   class Loader : public Thread
+   {
+   private:
+      Mutex mLock;
+      bool mFinished;
+      Semaphore mDone;
+      bool mJoined;              // Only touched by the thread that owns us
+
+   public:
+      LevelSource *source;
+      S32 index;
+      Level *level;              // NULL if the level could not be loaded
+      F64 prepareMs;
+
+      Loader(LevelSource *source, S32 index);
+
+      U32 run();
+      bool isFinished();
+      void finish();
+   };
+
+   Loader *mLoader;
+   string mDescriptor;           // Descriptor of the level we're working on, so we can tell if it's been swapped out
+   Level *mLevel;                // Prepared level, once mLoader is done with it
+   F64 mPrepareMs;
+   S32 mIndex;
+   LevelSource *mSource;
+
+   void collect();               // Wait for the loader and take what it made
+
+public:
+   LevelPipeline();              // Constructor
+   virtual ~LevelPipeline();     // Destructor
+
+   bool prepare(LevelSource *source, S32 index);
+   S32 getPreparedIndex() const; // Returns -1 if nothing is being prepared
+
+   Level *take(LevelSource *source, S32 index, F64 &prepareMs);
+   void update();
+   void cancel();
+};
+
+}
+
+#endif
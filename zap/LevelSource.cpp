@@ -14,6 +14,7 @@
 #include "stringUtils.h"
 
 #include "tnlAssert.h"
+#include "tnlThread.h"
 
 #include <sstream>
 
@@ -154,10 +155,11 @@ namespace Zap
       bool foundGameType = false, foundLevelName = false, foundMinPlayers = false,
          foundMaxPlayers = false, foundScriptName = false;
 
-      static const S32 gameTypeLen = strlen("GameType");
-      static const S32 levelNameLen = strlen("LevelName");
-      static const S32 minMaxPlayersLen = strlen("MinPlayers");
-      static const S32 scriptLen = strlen("Script");
+      // Constants rather than strlen()s, so there's nothing to initialize when this runs on several threads at once
+      static const S32 gameTypeLen = sizeof("GameType") - 1;
+      static const S32 levelNameLen = sizeof("LevelName") - 1;
+      static const S32 minMaxPlayersLen = sizeof("MinPlayers") - 1;
+      static const S32 scriptLen = sizeof("Script") - 1;
 
       std::size_t pos;
 
@@ -343,6 +345,13 @@ namespace Zap
    }
 
 
+   // Lets a LevelSource get ready for a run of populateLevelInfoFromSourceByIndex() calls; most have nothing to do
+   void LevelSource::prefetchLevelInfos()
+   {
+      // Do nothing
+   }
+
+
    ////////////////////////////////////////
    ////////////////////////////////////////
 
@@ -355,13 +364,104 @@ namespace Zap
 
    MultiLevelSource::~MultiLevelSource()
    {
-      // Do nothing
+      mHeaderIndex.save();    // Keep anything we learned about levels populated one at a time
+   }
+
+
+   void MultiLevelSource::setHeaderIndexFile(const string &filename)
+   {
+      mHeaderIndex.setFilename(filename);
+      mHeaderIndex.load();
+   }
+
+
+   LevelHeaderIndex *MultiLevelSource::getHeaderIndex()
+   {
+      return &mHeaderIndex;
+   }
+
+
+   // A level whose header the index couldn't give us
+   struct HeaderScanJob
+   {
+      string path;
+      S64 modTime;
+      S64 size;
+      LevelInfo levelInfo;
+      bool ok;
+   };
+
+
+   // Reads jobs index, index + shareCount, index + 2 * shareCount...
+   class MultiLevelSource::HeaderScanner : public WorkerPool
+   {
+   public:
+      Vector<HeaderScanJob> *jobs;
+
+      void doWork(U32 index, U32 shareCount)
+      {
+         for(S32 i = index; i < jobs->size(); i += shareCount)
+            (*jobs)[i].ok = MultiLevelSource::readLevelHeader((*jobs)[i].path, (*jobs)[i].levelInfo);
+      }
+   };
+
+
+   // Makes sure the header index is current for every level we have, reading the headers of any new or changed
+   // levels on several threads at once.  After this, populateLevelInfoFromSourceByIndex() won't need to read
+   // anything but the file's stamp.
+   void MultiLevelSource::prefetchLevelInfos()
+   {
+      S64 startTime = Platform::getHighPrecisionTimerValue();
+
+      Vector<HeaderScanJob> jobs;
+
+      for(S32 i = 0; i < mLevelInfos.size(); i++)
+      {
+         HeaderScanJob job;
+         job.path = FolderManager::findLevelFile(mLevelInfos[i].folder, mLevelInfos[i].filename);
+
+         // Missing levels will be reported when we get around to populating them
+         if(job.path == "" || !getFileStamp(job.path, job.modTime, job.size))
+            continue;
+
+         if(mHeaderIndex.isCurrent(job.path, job.modTime, job.size))
+            continue;
+
+         job.levelInfo = mLevelInfos[i];
+         job.ok = false;
+         jobs.push_back(job);
+      }
+
+      HeaderScanner scanner;
+      scanner.jobs = &jobs;
+
+      StringTable::setThreadSafe(true);      // Level names go into the StringTable
+
+      // If we can't get all the threads we asked for, the jobs are just split fewer ways
+      S32 threads = scanner.start(min(S32(HeaderScanThreads), jobs.size() / MinLevelsPerScanThread));
+      scanner.run();
+      scanner.stop();
+
+      StringTable::setThreadSafe(false);
+
+      for(S32 i = 0; i < jobs.size(); i++)
+         if(jobs[i].ok)
+            mHeaderIndex.store(jobs[i].path, jobs[i].modTime, jobs[i].size, jobs[i].levelInfo);
+
+      mHeaderIndex.save();
+
+      if(jobs.size() > 0)
+         logprintf(LogConsumer::ServerFilter, "Read %d level headers (%d more were already indexed) in %.1fms using %d threads",
+               jobs.size(), mLevelInfos.size() - jobs.size(),
+               Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - startTime), threads + 1);
    }
 
 
    // Populate all our levelInfos from disk; return true if we managed to load any, false otherwise
    bool MultiLevelSource::loadLevels(FolderManager *folderManager)
    {
+      prefetchLevelInfos();
+
       bool anyLoaded = false;
 
       for(S32 i = 0; i < mLevelInfos.size(); i++)
@@ -415,23 +515,44 @@ namespace Zap
 
 
    // Populates levelInfo with data from fullFilename -- returns true if successful, false otherwise
-   // Reads 4kb of file and uses what it finds there to populate the levelInfo
+   // Uses the header index if the file hasn't changed since we last read it; otherwise reads 4kb of the file
+   // and uses what it finds there to populate the levelInfo
    bool MultiLevelSource::populateLevelInfoFromSource(const string &fullFilename, LevelInfo &levelInfo)
    {
       // Check if we got a dud... (FolderManager::findLevelFile() will, for example, return "" if it fails)
       if(fullFilename.empty())
          return false;
 
-      FILE *f = fopen(fullFilename.c_str(), "rb");
-      if(!f)
+      S64 modTime, size;
+      bool haveStamp = getFileStamp(fullFilename, modTime, size);
+
+      if(haveStamp && mHeaderIndex.lookup(fullFilename, modTime, size, levelInfo))
+      {
+         levelInfo.ensureLevelInfoHasValidName();
+         return true;
+      }
+
+      if(!readLevelHeader(fullFilename, levelInfo))
       {
          logprintf(LogConsumer::LogWarning, "Could not read level file %s [%s]... Skipping...",
             levelInfo.filename.c_str(), fullFilename.c_str());
          return false;
       }
 
-      Level level;
-      level.loadLevelFromFile(fullFilename);
+      if(haveStamp)
+         mHeaderIndex.store(fullFilename, modTime, size, levelInfo);
+
+      return true;
+   }
+
+
+   // Reads the first 4kb of fullFilename and fills levelInfo with what it finds there.  Doesn't log or touch
+   // anything but levelInfo (and the StringTable), so it can be run on several threads at once.  Static method.
+   bool MultiLevelSource::readLevelHeader(const string &fullFilename, LevelInfo &levelInfo)
+   {
+      FILE *f = fopen(fullFilename.c_str(), "rb");
+      if(!f)
+         return false;
 
       // some ideas for getting the area of a level:
       //   if(loadLevel())
@@ -517,17 +638,12 @@ namespace Zap
       //
       //
 
-
-
-
-
       char data[1024 * 4];  // Should be enough to fit all parameters at the beginning of level; we don't need to read everything
       S32 size = (S32)fread(data, 1, sizeof(data), f);
       fclose(f);
 
       getLevelInfoFromCodeChunk(string(data, size), levelInfo);     // Fills levelInfo with data from file
 
-
       levelInfo.ensureLevelInfoHasValidName();
       return true;
    }
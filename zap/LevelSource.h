@@ -7,6 +7,7 @@
 #define _LEVEL_SOURCE_H_
 
 #include "GameTypesEnum.h"       // For GameTypeId
+#include "LevelHeaderIndex.h"
 
 #include "tnlNetStringTable.h"
 #include "tnlTypes.h"
@@ -99,6 +100,7 @@ public:
 
    virtual Level *getLevel(S32 index) const = 0;
    virtual bool loadLevels(FolderManager *folderManager);
+   virtual void prefetchLevelInfos();
    virtual string getLevelFileDescriptor(S32 index) const = 0;
    virtual bool isEmptyLevelDirOk() const = 0;
 
@@ -119,16 +121,32 @@ class MultiLevelSource : public LevelSource
 {
    typedef LevelSource Parent;
 
+private:
+   class HeaderScanner;
+
+   LevelHeaderIndex mHeaderIndex;
+
 public:
+   enum {
+      HeaderScanThreads = 4,           // Threads reading level headers, besides the main thread
+      MinLevelsPerScanThread = 16,     // Not worth starting a thread for fewer levels than this
+   };
+
    MultiLevelSource();              // Constructor
    virtual ~MultiLevelSource();     // Destructor
 
+   void setHeaderIndexFile(const string &filename);
+   LevelHeaderIndex *getHeaderIndex();
+
    bool loadLevels(FolderManager *folderManager);
+   void prefetchLevelInfos();
    Level *getLevel(S32 index) const;
    string getLevelFileDescriptor(S32 index) const;
    bool isEmptyLevelDirOk() const;
 
    bool populateLevelInfoFromSource(const string &fullFilename, LevelInfo &levelInfo);
+
+   static bool readLevelHeader(const string &fullFilename, LevelInfo &levelInfo);
 };
 
 
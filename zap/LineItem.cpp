@@ -385,8 +385,8 @@ bool LineItem::canBeNeutral() { return true; }
  */
 //               Fn name       Param profiles  Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-      METHOD(CLASS, setGlobal, ARRAYDEF({{ BOOL,    END }}), 1 ) \
-      METHOD(CLASS, getGlobal, ARRAYDEF({{          END }}), 1 ) \
+      METHOD(CLASS, setGlobal, ARRAYDEF({{ BOOL,    END }}), 1, READ_WRITE ) \
+      METHOD(CLASS, getGlobal, ARRAYDEF({{          END }}), 1, READ_ONLY )  \
 
 GENERATE_LUA_METHODS_TABLE(LineItem, LUA_METHODS);
 GENERATE_LUA_FUNARGS_TABLE(LineItem, LUA_METHODS);
@@ -6,6 +6,7 @@
 #include "LuaObject.h"
 
 #include "tnlLog.h"
+#include "tnlThread.h"
 #include "LuaScriptRunner.h"
 
 #include <map>
@@ -19,6 +20,7 @@ namespace Zap
 
 // Statics
 static map<string, set<LuaObject *> > mPotentiallyUntrackedObjects;
+static Mutex mTrackerLock;       // Robots ticking on worker threads can create objects, too
 
 // LuaObject is a parent class for all objects that can be instantiated by Lua.  It currently serves as a repository
 // for memory leak control when objects are constructed by not used in Lua.  See Issue 308: Lua memory leak.
@@ -54,16 +56,19 @@ LuaObject::~LuaObject()
 }
 
 
-void LuaObject::trackThisItem()
+void LuaObject::trackThisItem(lua_State *L)
 {
-   lua_State *L = LuaScriptRunner::getL();
    string scriptId = LuaScriptRunner::getScriptId(L);
 
    mScriptId = scriptId;
 
+   mTrackerLock.lock();
+
    TNLAssert(mPotentiallyUntrackedObjects[scriptId].find(this) == mPotentiallyUntrackedObjects[scriptId].end(), "Duplicate object!");
 
    mPotentiallyUntrackedObjects[scriptId].insert(this);
+
+   mTrackerLock.unlock();
 }
 
 
@@ -74,8 +79,12 @@ void LuaObject::untrackThisItem()
    if(mScriptId.empty())
       return;
 
+   mTrackerLock.lock();
+
    if(mPotentiallyUntrackedObjects[mScriptId].find(this) != mPotentiallyUntrackedObjects[mScriptId].end())
       mPotentiallyUntrackedObjects[mScriptId].erase(this);
+
+   mTrackerLock.unlock();
 }
 
 
@@ -90,13 +99,17 @@ void LuaObject::eraseAllPotentiallyUntrackedObjects(const string &scriptId)
    // of mPotentiallyUntrackedObjects, which would cause crashes if we were iterating over it directly.
    // Hmmm... that doesn't really make sense, but if we iterate over mPotentiallyUntrackedObjects[scriptId] 
    // directly, we do get a crash, so I propose leaving it like this.
+   mTrackerLock.lock();
    set<LuaObject *> temp = mPotentiallyUntrackedObjects[scriptId];
+   mTrackerLock.unlock();
 
    for(set<LuaObject *>::iterator it = temp.begin(); it != temp.end(); it++)
       delete *it;
 
    // We don't need to track objects for this script anymore, and this id will never be reused
+   mTrackerLock.lock();
    mPotentiallyUntrackedObjects.erase(scriptId);
+   mTrackerLock.unlock();
 }
 
 
@@ -35,6 +35,65 @@
 #include <string>
 
 
+////////////////////////////////////////
+////////////////////////////////////////
+
+// Support for LuaWrapper, which lives outside our namespace
+
+Mutex gLuaProxyLock;
+
+static ThreadStorage gWorldLocked;     // Non-NULL on threads running scripts that may look at the world, but not touch it
+
+static const char *DEFERRED_CALLS_KEY = "deferred_calls";
+
+
+bool luaW_isWorldLocked()
+{
+   return gWorldLocked.get() != NULL;
+}
+
+
+void luaW_setWorldLocked(bool locked)
+{
+   gWorldLocked.set(locked ? &gWorldLocked : NULL);
+}
+
+
+// Save the method call sitting on the stack so it can be made later, by LuaScriptRunner::runDeferredCalls()
+void luaW_deferCall(lua_State *L, lua_CFunction function)
+{
+   S32 args = lua_gettop(L);                                      // -- <<args>>
+
+   lua_getfield(L, LUA_REGISTRYINDEX, DEFERRED_CALLS_KEY);        // -- <<args>>, calls
+
+   if(lua_isnil(L, -1))
+   {
+      lua_pop(L, 1);                                              // -- <<args>>
+      lua_newtable(L);                                            // -- <<args>>, calls
+      lua_pushvalue(L, -1);                                       // -- <<args>>, calls, calls
+      lua_setfield(L, LUA_REGISTRYINDEX, DEFERRED_CALLS_KEY);     // -- <<args>>, calls
+   }
+
+   // Each call is saved as { function, arg1, arg2, ..., n = argCount }; n is needed because args may be nil
+   lua_createtable(L, args + 1, 1);                               // -- <<args>>, calls, call
+
+   lua_pushcfunction(L, function);                                // -- <<args>>, calls, call, function
+   lua_rawseti(L, -2, 1);                                         // -- <<args>>, calls, call
+
+   for(S32 i = 1; i <= args; i++)
+   {
+      lua_pushvalue(L, i);                                        // -- <<args>>, calls, call, arg
+      lua_rawseti(L, -2, i + 1);                                  // -- <<args>>, calls, call
+   }
+
+   lua_pushinteger(L, args);                                      // -- <<args>>, calls, call, argCount
+   lua_setfield(L, -2, "n");                                      // -- <<args>>, calls, call
+
+   lua_rawseti(L, -2, (S32)lua_objlen(L, -2) + 1);                // -- <<args>>, calls
+   lua_pop(L, 1);                                                 // -- <<args>>
+}
+
+
 namespace Zap
 {
 
@@ -42,7 +101,7 @@ namespace Zap
 ////////////////////////////////////////
 
 // Declare and Initialize statics:
-lua_State *LuaScriptRunner::L = NULL;
+lua_State *LuaScriptRunner::mSharedL = NULL;
 string LuaScriptRunner::mScriptingDir;
 
 deque<string> LuaScriptRunner::mCachedScripts;
@@ -61,6 +120,10 @@ LuaScriptRunner::LuaScriptRunner()
    mLuaGame = NULL;
    mLevel = NULL;
 
+   L = mSharedL;
+   mOwnsLuaState = false;
+   mKillScriptPending = false;
+
    static U32 mNextScriptId = 0;
 
    // Initialize all subscriptions to unsubscribed -- bits will automatically subscribe to onTick later
@@ -91,9 +154,13 @@ LuaScriptRunner::~LuaScriptRunner()
    LuaObject::eraseAllPotentiallyUntrackedObjects(scriptId);
 
    // And delete the script's environment table from the Lua instance
-   deleteScript(scriptId);
+   deleteScript(L, scriptId);
 
    LUAW_DESTRUCTOR_CLEANUP;
+
+   // Closing the state collects the proxies it holds, so do this after our own have been marked defunct
+   if(mOwnsLuaState)
+      lua_close(L);
 }
 
 
@@ -102,11 +169,61 @@ const char *LuaScriptRunner::getErrorMessagePrefix() { return "SCRIPT"; }
 
 lua_State *LuaScriptRunner::getL()
 {
-   TNLAssert(L, "L not yet instantiated!");
+   TNLAssert(mSharedL, "L not yet instantiated!");
+   return mSharedL;
+}
+
+
+lua_State *LuaScriptRunner::getLuaState() const
+{
    return L;
 }
 
 
+bool LuaScriptRunner::ownsLuaState() const
+{
+   return mOwnsLuaState;
+}
+
+
+bool LuaScriptRunner::belongsTo(const Game *game) const
+{
+   return mLuaGame == game;
+}
+
+
+// Create a Lua state for this script alone, so it can run on a different thread than other scripts.  Scripts loaded into
+// their own state aren't cached, as the cache lives in the shared state.  Returns false if the state couldn't be set up.
+bool LuaScriptRunner::createLuaState()
+{
+   TNLAssert(!mOwnsLuaState, "Already have a state of our own!");
+
+   lua_State *privateL = lua_open();
+
+   if(!privateL)
+   {
+      logError("Could not instantiate a Lua interpreter for this script.");
+      return false;
+   }
+
+   try
+   {
+      configureNewLuaInstance(privateL);
+   }
+   catch(const LuaException &e)
+   {
+      logError("Could not configure a Lua interpreter for this script: %s", e.msg.c_str());
+      lua_close(privateL);
+      return false;
+   }
+
+   L = privateL;
+   mOwnsLuaState = true;
+
+   return true;
+}
+
+
 Game *LuaScriptRunner::getLuaGame() const
 {
    return mLuaGame;
@@ -115,10 +232,10 @@ Game *LuaScriptRunner::getLuaGame() const
 
 void LuaScriptRunner::shutdown()
 {
-   if(L)
+   if(mSharedL)
    {
-      lua_close(L);
-      L = NULL;
+      lua_close(mSharedL);
+      mSharedL = NULL;
    }
 }
 
@@ -214,7 +331,7 @@ void LuaScriptRunner::pushStackTracer()
 // environment.  This loaded script will be cleared when the parent script terminates
 bool LuaScriptRunner::loadCompileRunEnvironmentScript(const string &scriptName) {
    // The timer is loaded in each script
-   loadCompileScript(joindir(mScriptingDir, scriptName).c_str());
+   loadCompileScript(L, joindir(mScriptingDir, scriptName).c_str());
    setEnvironment();
 
    S32 err = lua_pcall(L, 0, 0, 0);
@@ -253,8 +370,8 @@ bool LuaScriptRunner::loadScript(bool cacheScript)
    {
       pushStackTracer();            // -- _stackTracer
 
-      if(!cacheScript)
-         loadCompileScript(mScriptName.c_str());
+      if(!cacheScript || mOwnsLuaState)
+         loadCompileScript(L, mScriptName.c_str());
       else  
       {
          bool found = false;
@@ -278,7 +395,7 @@ bool LuaScriptRunner::loadScript(bool cacheScript)
             }
 
             // Load new script into cache using full name as registry key
-            loadCompileSaveScript(mScriptName.c_str(), mScriptName.c_str());
+            loadCompileSaveScript(L, mScriptName.c_str(), mScriptName.c_str());
             mCachedScripts.push_back(mScriptName);
          }
 
@@ -386,7 +503,12 @@ bool LuaScriptRunner::runFunction(const char *function, S32 returnValues)
       dumpStack(L);
       logprintf(LogConsumer::LogError, "Terminating script");
 
-      killScript();
+      // Killing a script changes the world, which will have to wait if it's being held still for us
+      if(luaW_isWorldLocked())
+         mKillScriptPending = true;
+      else
+         killScript();
+
       clearStack(L);
       return true;
    }
@@ -395,23 +517,76 @@ bool LuaScriptRunner::runFunction(const char *function, S32 returnValues)
 }
 
 
+// Run calls saved by luaW_deferCall() while the world was locked, in the order the script made them.  The script has
+// long since moved on, so any return values are dropped.  Must be called with the world unlocked.
+void LuaScriptRunner::runDeferredCalls()
+{
+   TNLAssert(!luaW_isWorldLocked(), "World is still locked!");
+
+   if(mKillScriptPending)
+   {
+      mKillScriptPending = false;
+      killScript();
+      return;
+   }
+
+   TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
+
+   lua_getfield(L, LUA_REGISTRYINDEX, DEFERRED_CALLS_KEY);        // -- calls
+
+   if(lua_isnil(L, -1))
+   {
+      lua_pop(L, 1);                                              // -- <<empty stack>>
+      return;
+   }
+
+   // Start a fresh list, in case one of these calls ends up making more
+   lua_pushnil(L);                                                // -- calls, nil
+   lua_setfield(L, LUA_REGISTRYINDEX, DEFERRED_CALLS_KEY);        // -- calls
+
+   S32 callCount = (S32)lua_objlen(L, 1);
+
+   for(S32 i = 1; i <= callCount; i++)
+   {
+      lua_rawgeti(L, 1, i);                                       // -- calls, call
+      lua_getfield(L, 2, "n");                                    // -- calls, call, argCount
+      S32 args = (S32)lua_tointeger(L, -1);
+      lua_pop(L, 1);                                              // -- calls, call
+
+      for(S32 j = 1; j <= args + 1; j++)
+         lua_rawgeti(L, 2, j);                                    // -- calls, call, function, <<args>>
+
+      if(lua_pcall(L, args, 0, 0))                                // -- calls, call
+      {
+         logError("%s", lua_tostring(L, -1));                     // Also clears the stack
+         killScript();
+         return;
+      }
+
+      lua_pop(L, 1);                                              // -- calls
+   }
+
+   clearStack(L);
+}
+
+
 // Start Lua and get everything configured
 bool LuaScriptRunner::startLua(const string &scriptingDir)
 {
-   TNLAssert(!L, "L should not have been created yet!");
+   TNLAssert(!mSharedL, "L should not have been created yet!");
 
    mScriptingDir = scriptingDir;
 
    // Prepare the Lua global environment
    try 
    {
-      L = lua_open();               // Create a new Lua interpreter; will be shutdown in the destructor
+      mSharedL = lua_open();        // Create a new Lua interpreter; will be shutdown in the destructor
 
       // Failure here is likely to be something systemic, something bad.  Like smallpox.
-      if(!L)
+      if(!mSharedL)
          throw LuaException("Could not instantiate the Lua interpreter.");
 
-      configureNewLuaInstance(L);   // Throws any errors it encounters
+      configureNewLuaInstance(mSharedL);   // Throws any errors it encounters
 
       return true;
    }
@@ -420,8 +595,8 @@ bool LuaScriptRunner::startLua(const string &scriptingDir)
    {
       // Lua just isn't going to work out for this session.
       logprintf(LogConsumer::LogError, "=====FATAL LUA ERROR=====\n%s\n=========================", e.msg.c_str());
-      lua_close(L);
-      L = NULL;
+      lua_close(mSharedL);
+      mSharedL = NULL;
       return false;
    }
 
@@ -429,7 +604,7 @@ bool LuaScriptRunner::startLua(const string &scriptingDir)
 }
 
 
-// Prepare a new Lua environment ("L") for use -- called from startLua(), and testing.
+// Prepare a new Lua environment ("L") for use -- called from startLua(), createLuaState(), and testing.
 // This function will throw errors.  (Well, hopefully it won't, but it could!)
 void LuaScriptRunner::configureNewLuaInstance(lua_State *L)
 {
@@ -442,10 +617,10 @@ void LuaScriptRunner::configureNewLuaInstance(lua_State *L)
    luaL_openlibs(L);    // Load the standard libraries
 
    // This allows the safe use of 'require' in our scripts
-   setModulePath();
+   setModulePath(L);
 
    // Register all our classes in the global namespace... they will be copied below when we copy the environment
-   registerClasses();            // Perform class and global function registration once per lua_State
+   registerClasses(L);           // Perform class and global function registration once per lua_State
    registerLooseFunctions(L);    // Register some functions not associated with a particular class
 
    // Set scads of global vars in the Lua instance that mimic the use of the enums we use everywhere.
@@ -454,34 +629,34 @@ void LuaScriptRunner::configureNewLuaInstance(lua_State *L)
    setGlobalObjectArrays(L);
 
    // Immediately execute the lua helper functions (these are global and need to be loaded before sandboxing)
-   loadCompileRunHelper("lua_helper_functions.lua");
+   loadCompileRunHelper(L, "lua_helper_functions.lua");
 
    // Load our vector library
-   loadCompileRunHelper("luavec.lua");
+   loadCompileRunHelper(L, "luavec.lua");
 
    // Load our helper functions and store copies of the compiled code in the registry where we can use them for starting new scripts
-   loadCompileSaveHelper("robot_helper_functions.lua",    ROBOT_HELPER_FUNCTIONS_KEY);
-   loadCompileSaveHelper("levelgen_helper_functions.lua", LEVELGEN_HELPER_FUNCTIONS_KEY);
-   loadCompileSaveHelper("timer.lua", SCRIPT_TIMER_KEY);
+   loadCompileSaveHelper(L, "robot_helper_functions.lua",    ROBOT_HELPER_FUNCTIONS_KEY);
+   loadCompileSaveHelper(L, "levelgen_helper_functions.lua", LEVELGEN_HELPER_FUNCTIONS_KEY);
+   loadCompileSaveHelper(L, "timer.lua", SCRIPT_TIMER_KEY);
 
 
    // Perform sandboxing now
    // Only code executed before this point can access dangerous functions
-   loadCompileRunHelper("sandbox.lua");
+   loadCompileRunHelper(L, "sandbox.lua");
 }
 
 
-void LuaScriptRunner::loadCompileSaveHelper(const string &scriptName, const char *registryKey)
+void LuaScriptRunner::loadCompileSaveHelper(lua_State *L, const string &scriptName, const char *registryKey)
 {
-   loadCompileSaveScript(joindir(mScriptingDir, scriptName).c_str(), registryKey);
+   loadCompileSaveScript(L, joindir(mScriptingDir, scriptName).c_str(), registryKey);
 }
 
 
 // Load a script from the scripting directory by basename (e.g. "my_script.lua").
 // Throws LuaException when there's an error compiling or running the script.
-void LuaScriptRunner::loadCompileRunHelper(const string &scriptName)
+void LuaScriptRunner::loadCompileRunHelper(lua_State *L, const string &scriptName)
 {
-   loadCompileScript(joindir(mScriptingDir, scriptName).c_str());
+   loadCompileScript(L, joindir(mScriptingDir, scriptName).c_str());
    if(lua_pcall(L, 0, 0, 0))
       throw LuaException("Error running " + scriptName + ": " + string(lua_tostring(L, -1)));
 }
@@ -489,16 +664,16 @@ void LuaScriptRunner::loadCompileRunHelper(const string &scriptName)
 
 // Load script from specified file, compile it, and store it in the registry.
 // All callers of this script have catch blocks, so we can throw errors if something goes wrong.
-void LuaScriptRunner::loadCompileSaveScript(const char *filename, const char *registryKey)
+void LuaScriptRunner::loadCompileSaveScript(lua_State *L, const char *filename, const char *registryKey)
 {
-   loadCompileScript(filename);                       // Throws if there is an error
+   loadCompileScript(L, filename);                    // Throws if there is an error
    lua_setfield(L, LUA_REGISTRYINDEX, registryKey);   // Save compiled code in registry
 }
 
 
 // Load script and place on top of the stack.
 // All callers of this script have catch blocks, so we can throw errors if something goes wrong.
-void LuaScriptRunner::loadCompileScript(const char *filename)
+void LuaScriptRunner::loadCompileScript(lua_State *L, const char *filename)
 {
    // luaL_loadfile: Loads a file as a Lua chunk. This function uses lua_load to load the chunk in the file named filename. 
    // If filename is NULL, then it loads from the standard input. The first line in the file is ignored if it starts with a #.
@@ -513,7 +688,7 @@ void LuaScriptRunner::loadCompileScript(const char *filename)
 
 
 // Delete script's environment from the registry -- actually set the registry entry to nil so the table can be collected
-void LuaScriptRunner::deleteScript(const char *name)
+void LuaScriptRunner::deleteScript(lua_State *L, const char *name)
 {
    // If a script is not found, or there is some other problem with the bot (or levelgen), we might get here before our L has been
    // set up.  If L hasn't been defined, there's no point in mucking with the registry, right?
@@ -591,11 +766,11 @@ void LuaScriptRunner::logError(const char *format, ...)
    vsnprintf(buffer, sizeof(buffer), format, args);
    va_end(args);
 
-   logErrorHandler(buffer, getErrorMessagePrefix());
+   logErrorHandler(L, buffer, getErrorMessagePrefix());
 }
 
 
-void LuaScriptRunner::logErrorHandler(const char *msg, const char *prefix) 
+void LuaScriptRunner::logErrorHandler(lua_State *L, const char *msg, const char *prefix) 
 { 
    // Log the error to the logging system and also to the game console
    logprintf(LogConsumer::LogError, "%s %s", prefix, msg);
@@ -620,7 +795,7 @@ static string getStackTraceLine(lua_State *L, S32 level)
 */
 
 // Register classes needed by all script runners
-void LuaScriptRunner::registerClasses()
+void LuaScriptRunner::registerClasses(lua_State *L)
 {
    LuaW_Registrar::registerClasses(L);    // Register all objects that use our automatic registration scheme
 }
@@ -653,7 +828,7 @@ void LuaScriptRunner::setLuaArgs(const Vector<string> &args)
 
 
 // Set up paths so that we can use require to load code in our scripts 
-void LuaScriptRunner::setModulePath()   
+void LuaScriptRunner::setModulePath(lua_State *L)
 {
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
@@ -1004,15 +1179,15 @@ void LuaScriptRunner::setGlobalObjectArrays(lua_State *L)
  */
 //               Fn name    Param profiles         Profile count
 #define LUA_METHODS(CLASS, METHOD) \
-      METHOD(CLASS, pointCanSeePoint,      ARRAYDEF({{ PT, PT, END }}), 1 ) \
-      METHOD(CLASS, findObjectById,        ARRAYDEF({{ INT, END }}), 1 )    \
-      METHOD(CLASS, findAllObjects,        ARRAYDEF({{ INTx, END }, { END }}), 2 ) \
-      METHOD(CLASS, findAllObjectsInArea,  ARRAYDEF({{ PT, PT, INTS, END }}), 1 ) \
-      METHOD(CLASS, addItem,               ARRAYDEF({{ BFOBJ, END }}), 1 )  \
-      METHOD(CLASS, getGameInfo,           ARRAYDEF({{ END }}), 1 )         \
-      METHOD(CLASS, getPlayerCount,        ARRAYDEF({{ END }}), 1 )         \
-      METHOD(CLASS, subscribe,             ARRAYDEF({{ EVENT, END }}), 1 )  \
-      METHOD(CLASS, unsubscribe,           ARRAYDEF({{ EVENT, END }}), 1 )  \
+      METHOD(CLASS, pointCanSeePoint,      ARRAYDEF({{ PT, PT, END }}), 1, READ_ONLY ) \
+      METHOD(CLASS, findObjectById,        ARRAYDEF({{ INT, END }}), 1, READ_ONLY )    \
+      METHOD(CLASS, findAllObjects,        ARRAYDEF({{ INTx, END }, { END }}), 2, READ_ONLY ) \
+      METHOD(CLASS, findAllObjectsInArea,  ARRAYDEF({{ PT, PT, INTS, END }}), 1, READ_ONLY ) \
+      METHOD(CLASS, addItem,               ARRAYDEF({{ BFOBJ, END }}), 1, READ_WRITE )  \
+      METHOD(CLASS, getGameInfo,           ARRAYDEF({{ END }}), 1, READ_ONLY )         \
+      METHOD(CLASS, getPlayerCount,        ARRAYDEF({{ END }}), 1, READ_ONLY )         \
+      METHOD(CLASS, subscribe,             ARRAYDEF({{ EVENT, END }}), 1, READ_WRITE )  \
+      METHOD(CLASS, unsubscribe,           ARRAYDEF({{ EVENT, END }}), 1, READ_WRITE )  \
 
 
 GENERATE_LUA_FUNARGS_TABLE(LuaScriptRunner, LUA_METHODS);
@@ -1147,10 +1322,9 @@ S32 LuaScriptRunner::lua_findAllObjects(lua_State *L)
 
    TNLAssert(mLevel != NULL, "Grid Database must not be NULL!");
 
-   fillVector.clear();
-   static Vector<U8> types;
-
-   types.clear();
+   ScopedDatabaseQuery query;
+   Vector<DatabaseObject *> &foundObjects = query->results;
+   Vector<U8> types;
 
    // We expect only numbers on the stack:  -- objType1, objType2, ...
    while(lua_gettop(L) > 0)
@@ -1158,11 +1332,11 @@ S32 LuaScriptRunner::lua_findAllObjects(lua_State *L)
       U8 typenum = (U8)lua_tointeger(L, -1);
 
       // Requests for botzones have to be handled separately; not a problem, we'll just do the search here, and add them to
-      // fillVector, where they'll be merged with the rest of our search results.
+      // foundObjects, where they'll be merged with the rest of our search results.
       if(typenum != BotNavMeshZoneTypeNumber)
          types.push_back(typenum);
       else
-         getLuaGame()->getBotZoneDatabase().findObjects(BotNavMeshZoneTypeNumber, fillVector);
+         getLuaGame()->getBotZoneDatabase().findObjects(BotNavMeshZoneTypeNumber, foundObjects);
 
       lua_pop(L, 1);
    }
@@ -1173,14 +1347,14 @@ S32 LuaScriptRunner::lua_findAllObjects(lua_State *L)
       results = mLevel->findObjects_fast();
    else
    {
-      mLevel->findObjects(types, fillVector);
-      results = &fillVector;
+      mLevel->findObjects(types, foundObjects);
+      results = &foundObjects;
    }
    
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack not cleared!");
 
    // Create a table, with enough slots pre-allocated for our data
-   lua_createtable(L, fillVector.size(), 0);
+   lua_createtable(L, foundObjects.size(), 0);
 
    for(S32 i = 0; i < results->size(); i++)
    {
@@ -1216,10 +1390,9 @@ S32 LuaScriptRunner::lua_findAllObjectsInArea(lua_State *L)
 
    TNLAssert(mLevel != NULL, "Grid Database must not be NULL!");
 
-   static Vector<U8> types;
-
-   types.clear();
-   fillVector.clear();
+   Vector<U8> types;
+   ScopedDatabaseQuery query;
+   Vector<DatabaseObject *> &foundObjects = query->results;
 
    bool hasBotZoneType = false;
 
@@ -1246,18 +1419,18 @@ S32 LuaScriptRunner::lua_findAllObjectsInArea(lua_State *L)
    Rect searchArea = Rect(p1, p2);
 
    if(hasBotZoneType)
-      getLuaGame()->getBotZoneDatabase().findObjects(BotNavMeshZoneTypeNumber, fillVector, searchArea);
+      getLuaGame()->getBotZoneDatabase().findObjects(BotNavMeshZoneTypeNumber, foundObjects, searchArea);
 
-   mLevel->findObjects(types, fillVector, searchArea);
+   mLevel->findObjects(types, foundObjects, searchArea);
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack not cleared!");
 
    // Create a table, with enough slots pre-allocated for our data
-   lua_createtable(L, fillVector.size(), 0);
+   lua_createtable(L, foundObjects.size(), 0);
 
-   for(S32 i = 0; i < fillVector.size(); i++)
+   for(S32 i = 0; i < foundObjects.size(); i++)
    {
-      static_cast<BfObject *>(fillVector[i])->push(L);
+      static_cast<BfObject *>(foundObjects[i])->push(L);
       lua_rawseti(L, 1, i + 1);
    }
 
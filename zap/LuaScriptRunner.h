@@ -52,19 +52,21 @@ private:
 
    static string mScriptingDir;
 
+   static lua_State *mSharedL;   // The Lua state used by every script that doesn't have one of its own
+
    void setLuaArgs(const Vector<string> &args);
-   static void setModulePath();
+   static void setModulePath(lua_State *L);
 
-   static void loadCompileSaveHelper(const string &scriptName, const char *registryKey);
-   static void loadCompileRunHelper(const string &scriptName);
-   static void loadCompileSaveScript(const char *filename, const char *registryKey);
-   static void loadCompileScript(const char *filename);
+   static void loadCompileSaveHelper(lua_State *L, const string &scriptName, const char *registryKey);
+   static void loadCompileRunHelper(lua_State *L, const string &scriptName);
+   static void loadCompileSaveScript(lua_State *L, const char *filename, const char *registryKey);
+   static void loadCompileScript(lua_State *L, const char *filename);
 
    void pushStackTracer();      // Put error handler function onto the stack
 
    static void setEnums(lua_State *L);                       // Set a whole slew of enum values that we want the scripts to have access to
    static void setGlobalObjectArrays(lua_State *L);          // And some objects
-   static void logErrorHandler(const char *msg, const char *prefix);
+   static void logErrorHandler(lua_State *L, const char *msg, const char *prefix);
 
 protected:
    enum ScriptType {
@@ -82,7 +84,9 @@ protected:
 
    Level *mLevel;                // Pointer to our current level
 
-   static lua_State *L;          // Main Lua state variable
+   lua_State *L;                 // Lua state this script runs in; the shared state unless we've created our own
+   bool mOwnsLuaState;           // True if L belongs to this script alone, and will be closed along with it
+   bool mKillScriptPending;      // Script failed while the world was locked; it will be killed in runDeferredCalls()
    string mScriptName;           // Fully qualified script name, with path and everything
    Vector<string> mScriptArgs;   // List of arguments passed to the script
 
@@ -95,12 +99,12 @@ protected:
    virtual bool prepareEnvironment();
 
    static int luaPanicked(lua_State *L);  // Handle a total freakout by Lua
-   static void registerClasses();
+   static void registerClasses(lua_State *L);
    void setEnvironment();                 // Sets the environment for the function on the top of the stack to that associated with name
 
    bool loadCompileRunEnvironmentScript(const string &scriptName);
 
-   static void deleteScript(const char *name);  // Remove saved script from the Lua registry
+   static void deleteScript(lua_State *L, const char *name);  // Remove saved script from the Lua registry
 
    static void registerLooseFunctions(lua_State *L);     // Register some functions not associated with a particular class
 
@@ -138,7 +142,13 @@ public:
 
    virtual const char *getErrorMessagePrefix();
 
-   static lua_State *getL();
+   static lua_State *getL();                          // The shared state
+   lua_State *getLuaState() const;                    // The state this script is running in
+
+   bool createLuaState();                             // Give this script a state of its own; call before the script is loaded
+   bool ownsLuaState() const;
+   bool belongsTo(const Game *game) const;            // True if the script is running in game
+   void runDeferredCalls();                           // Run calls saved while the world was locked
    static const char *getScriptId(lua_State *L);
 
    static bool startLua(const string &scriptingDir);  // Create L
@@ -219,13 +229,17 @@ public:
 // Starting with a definition like the following:
 /*
  #define LUA_METHODS(CLASS, METHOD) \
-    METHOD(CLASS, addDest,    ARRAYDEF({{ PT,  END }}), 1 ) \
-    METHOD(CLASS, delDest,    ARRAYDEF({{ INT, END }}), 1 ) \
-    METHOD(CLASS, clearDests, ARRAYDEF({{      END }}), 1 ) \
+    METHOD(CLASS, addDest,    ARRAYDEF({{ PT,  END }}), 1, READ_WRITE ) \
+    METHOD(CLASS, delDest,    ARRAYDEF({{ INT, END }}), 1, READ_WRITE ) \
+    METHOD(CLASS, clearDests, ARRAYDEF({{      END }}), 1, READ_WRITE ) \
 */
+//
+// The last column is READ_ONLY for methods that only look at the world, and READ_WRITE for anything that might change
+// it.  Robots can tick on several threads at once, and only READ_ONLY methods run right away while they do; the rest
+// are saved and made on the main thread afterwards (see BotTickScheduler).  When in doubt, use READ_WRITE.
 
-#define LUA_METHOD_ITEM(class_, name, b, c) \
-{ #name, luaW_doMethod<class_, &class_::lua_## name > },
+#define LUA_METHOD_ITEM(class_, name, b, c, access) \
+{ #name, luaW_doMethod<class_, &class_::lua_## name, access > },
 
 
 #define GENERATE_LUA_METHODS_TABLE(class_, table_) \
@@ -238,16 +252,16 @@ const luaL_reg class_::luaMethods[] =              \
 // Generates something like the following:
 // const luaL_reg Teleporter::luaMethods[] =
 // {
-//       { "addDest",    luaW_doMethod<Teleporter, &Teleporter::lua_addDest >    }
-//       { "delDest",    luaW_doMethod<Teleporter, &Teleporter::lua_delDest >    }
-//       { "clearDests", luaW_doMethod<Teleporter, &Teleporter::lua_clearDests > }
+//       { "addDest",    luaW_doMethod<Teleporter, &Teleporter::lua_addDest,    READ_WRITE > }
+//       { "delDest",    luaW_doMethod<Teleporter, &Teleporter::lua_delDest,    READ_WRITE > }
+//       { "clearDests", luaW_doMethod<Teleporter, &Teleporter::lua_clearDests, READ_WRITE > }
 //       { NULL, NULL }
 // };
 
 
 ////////////////////////////////////////
 
- #define LUA_FUNARGS_ITEM(class_, name, profiles, profileCount) \
+ #define LUA_FUNARGS_ITEM(class_, name, profiles, profileCount, access) \
 { #name, {profiles, profileCount } },
  
 
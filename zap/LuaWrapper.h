@@ -53,6 +53,8 @@ extern "C"
 #include "LuaBase.h"   
 #include "LuaException.h"   
 
+#include "tnlThread.h"
+
 #include <string>
 #include <vector>
 #include <map>
@@ -94,6 +96,23 @@ inline bool luaW_shouldCreateProxy(lua_State* L)
 }
 
 
+// Robots can run their onTick handlers on several threads at once (see BotTickScheduler).  While they do, the world is
+// locked: methods that only look at it run as usual, but calls to anything else are saved with luaW_deferCall() and
+// made on the main thread once every robot has finished.  Defined in LuaScriptRunner.cpp.
+bool luaW_isWorldLocked();
+void luaW_setWorldLocked(bool locked);    // For the current thread
+void luaW_deferCall(lua_State *L, lua_CFunction function);
+
+
+// Every method table says whether each of its methods only looks at the world (see LUA_METHOD_ITEM); read-only ones
+// are safe to call while the world is locked
+enum LuaMethodAccess
+{
+   READ_WRITE,
+   READ_ONLY
+};
+
+
 // These are the default allocator and deallocator. If you would prefer an
 // alternative option, you may select a different function when registering
 // your class.
@@ -244,7 +263,7 @@ void luaW_setUsingProxy(lua_State* L, T* obj, bool usingProxy)
    // will contain the proxy for proxied object otherwise it contains the object itself
    if(usingProxy)
    {
-      LuaProxy<T> *proxy = obj->getLuaProxy();
+      LuaProxy<T> *proxy = obj->getLuaProxy(L);
       lua_pushlightuserdata(L, proxy);                // -- ... usingproxy_table, &proxy
    }
    else
@@ -386,8 +405,8 @@ void luaW_push(lua_State* L, T* obj)
    // Should we be using proxies for our objects?
    if(luaW_shouldCreateProxy(L))
    {
-      // Get the object's proxy, or create one if it doesn't yet exist
-      LuaProxy<T> *proxy = obj->getLuaProxy();
+      // Get the object's proxy for this state, or create one if it doesn't yet exist
+      LuaProxy<T> *proxy = obj->getLuaProxy(L);
 
       if(proxy)         // Retrieve the userdata for this proxy from our cache table
       {
@@ -410,7 +429,7 @@ void luaW_push(lua_State* L, T* obj)
       else
       {
          // Create a new proxy
-         proxy = new LuaProxy<T>(obj);
+         proxy = new LuaProxy<T>(obj, L);
 
          // Add a new entry to our cache table (a weak table; more about those here: http://lua-users.org/wiki/WeakTablesTutorial).
          // Note that from here on down, we'll fall back on the normal LuaW push code, except for the bit at the end where
@@ -1156,30 +1175,52 @@ public:
 
 
 
+// An object gets one proxy for each Lua state it has been pushed into (robots may have a state of their own), and
+// the object's proxies are chained together through mNext.  Robots ticking on different threads can push or collect
+// proxies for the same object at the same time, so the chains are only touched while holding gLuaProxyLock.
+extern TNL::Mutex gLuaProxyLock;
+
 template <class T>
 class LuaProxy
 {
 private:
     bool mDefunct;
     T *mProxiedObject;
+    lua_State *mL;          // State this proxy lives in
+    LuaProxy<T> *mNext;     // Next proxy for the same object, in some other state
 
 public:
     // Default constructor
     LuaProxy() { TNLAssert(false, "Not used"); }
 
     // Typical constructor
-    explicit LuaProxy(T *obj)
+    LuaProxy(T *obj, lua_State *L)
     {
       mProxiedObject = obj;
-      obj->setLuaProxy(this);
+      mL = L;
       mDefunct = false;
+
+      gLuaProxyLock.lock();
+      mNext = obj->mLuaProxy;
+      obj->setLuaProxy(this);
+      gLuaProxyLock.unlock();
     }
 
    // Destructor
    ~LuaProxy()
    {
+      gLuaProxyLock.lock();
+
+      // Once defunct, our object is gone, and so is the chain
       if(!mDefunct)
-         mProxiedObject->mLuaProxy = NULL;
+         for(LuaProxy<T> **link = &mProxiedObject->mLuaProxy; *link; link = &(*link)->mNext)
+            if(*link == this)
+            {
+               *link = mNext;
+               break;
+            }
+
+      gLuaProxyLock.unlock();
    }
 
 
@@ -1187,6 +1228,33 @@ public:
    bool isDefunct()        { return mDefunct;       }
 
    void setDefunct(bool isDefunct) { mDefunct = isDefunct; }
+
+
+   // Find the proxy for the specified state in the chain starting with proxy; returns NULL if there isn't one
+   static LuaProxy<T> *find(LuaProxy<T> *proxy, lua_State *L)
+   {
+      gLuaProxyLock.lock();
+
+      while(proxy && proxy->mL != L)
+         proxy = proxy->mNext;
+
+      gLuaProxyLock.unlock();
+
+      return proxy;
+   }
+
+
+   // Called on the head of the chain when the proxied object is destroyed; scripts holding on to any of its
+   // proxies will find them empty
+   void setChainDefunct()
+   {
+      gLuaProxyLock.lock();
+
+      for(LuaProxy<T> *proxy = this; proxy; proxy = proxy->mNext)
+         proxy->mDefunct = true;
+
+      gLuaProxyLock.unlock();
+   }
 };
 
 
@@ -1201,21 +1269,21 @@ public:
 // instantiated and accessed from Lua (pushed from c++)
 #define  LUAW_DECLARE_CLASS_CUSTOM_CONSTRUCTOR(className) \
    LuaProxy<className> *mLuaProxy; \
-   LuaProxy<className> *getLuaProxy() { return mLuaProxy; } \
+   LuaProxy<className> *getLuaProxy(lua_State *L) { return LuaProxy<className>::find(mLuaProxy, L); } \
    virtual void setLuaProxy(LuaProxy<className> *obj) { mLuaProxy = obj; } \
    virtual void push(lua_State *L) { luaW_push(L, this); } 
 
 // This one is for an abstract class and cannot be instantiated or returned as an object in Lua
 #define  LUAW_DECLARE_ABSTRACT_CLASS(className) \
    LuaProxy<className> *mLuaProxy; \
-   LuaProxy<className> *getLuaProxy() { return mLuaProxy; } \
+   LuaProxy<className> *getLuaProxy(lua_State *L) { return LuaProxy<className>::find(mLuaProxy, L); } \
    virtual void setLuaProxy(LuaProxy<className> *obj) { mLuaProxy = obj; } \
    className(lua_State *L) { THROW_LUA_EXCEPTION(L, "Illegal attempt to instantiate abstract class!"); }
 
 // This is used for a class that you want to access (return as an object) but NOT instantiated (like PlayerInfo)
 #define  LUAW_DECLARE_NON_INSTANTIABLE_CLASS(className) \
    LuaProxy<className> *mLuaProxy; \
-   LuaProxy<className> *getLuaProxy() { return mLuaProxy; } \
+   LuaProxy<className> *getLuaProxy(lua_State *L) { return LuaProxy<className>::find(mLuaProxy, L); } \
    virtual void setLuaProxy(LuaProxy<className> *obj) { mLuaProxy = obj; } \
    virtual void push(lua_State *L) { luaW_push(L, this); } \
    className(lua_State *L) { THROW_LUA_EXCEPTION(L, "Illegal attempt to instantiate a non-instantiable class!"); } 
@@ -1230,20 +1298,27 @@ public:
 
 #define LUA_REGISTER_WITH_TRACKER \
 {                                 \
-   LuaObject::trackThisItem();    \
+   LuaObject::trackThisItem(L);   \
 }
 
 
 // And this goes in the destructor of the "wrapped class"
 #define LUAW_DESTRUCTOR_CLEANUP                       \
-   if(mLuaProxy) mLuaProxy->setDefunct(true);   
+   if(mLuaProxy) mLuaProxy->setChainDefunct();   
 
 
 // Runs a method on a proxied object.  Returns nil if the proxied object no longer exists, so Lua scripts may need to check for this.
-// Wraps a standard method (one that takes L as a single parameter) within a proxy check. 
-template <typename T, int (T::*methodName)(lua_State * )>
+// Wraps a standard method (one that takes L as a single parameter) within a proxy check.  Methods that aren't read-only
+// are put off until the world is unlocked.
+template <typename T, int (T::*methodName)(lua_State * ), LuaMethodAccess access>
 int luaW_doMethod(lua_State *L)
 {
+   if(access != READ_ONLY && luaW_isWorldLocked())
+   {
+      luaW_deferCall(L, luaW_doMethod<T, methodName, access>);
+      return 0;
+   }
+
    T *w = luaW_check<T>(L, 1);
    if(w) 
    {
@@ -245,10 +245,10 @@ void PickupItem::doneEditingAttrs(EditorAttributeMenuUI *attributeMenu)
  */
 //               Fn name  Param profiles  Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, isVis,        ARRAYDEF({{          END }}), 1 ) \
-   METHOD(CLASS, setVis,       ARRAYDEF({{ BOOL,    END }}), 1 ) \
-   METHOD(CLASS, setRegenTime, ARRAYDEF({{ INT_GE0, END }}), 1 ) \
-   METHOD(CLASS, getRegenTime, ARRAYDEF({{ INT_GE0, END }}), 1 ) \
+   METHOD(CLASS, isVis,        ARRAYDEF({{          END }}), 1, READ_ONLY )  \
+   METHOD(CLASS, setVis,       ARRAYDEF({{ BOOL,    END }}), 1, READ_WRITE ) \
+   METHOD(CLASS, setRegenTime, ARRAYDEF({{ INT_GE0, END }}), 1, READ_WRITE ) \
+   METHOD(CLASS, getRegenTime, ARRAYDEF({{ INT_GE0, END }}), 1, READ_ONLY )  \
 
 
 GENERATE_LUA_METHODS_TABLE(PickupItem, LUA_METHODS);
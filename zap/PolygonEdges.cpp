@@ -0,0 +1,603 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "PolygonEdges.h"
+
+#include "tnlAssert.h"
+
+#include <math.h>
+
+// Only SSE2 gets vector kernels.  The swept circle test is mostly divides and square roots, which don't go much
+// faster eight at a time than four, so wider instruction sets aren't worth a build of their own.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define POLYGON_EDGES_SSE
+#  include <emmintrin.h>
+#endif
+
+
+namespace Zap
+{
+
+// Each collision test below is written once, as a template over the lane types that follow.  Every lane does
+// the arithmetic the Point-based version in GeomUtils does for one edge, in the same order, so results agree with
+// it to within rounding (findLowestRootInInterval() does part of its work in doubles; we stay in floats).  Picking
+// a winner among the edges is left to plain code afterward, which visits them in the same order the Point-based
+// version does, so ties are broken the same way too.
+
+// One lane; used for the edges left over after the wider lanes are done, and for everything on other CPUs
+struct ScalarLanes
+{
+   enum { Width = 1 };
+
+   typedef F32 Vec;
+   typedef bool Mask;
+
+   static Vec load(const F32 *p)             { return *p; }
+   static void store(F32 *p, Vec v)          { *p = v; }
+   static Vec set(F32 f)                     { return f; }
+
+   static Vec add(Vec a, Vec b)              { return a + b; }
+   static Vec sub(Vec a, Vec b)              { return a - b; }
+   static Vec mul(Vec a, Vec b)              { return a * b; }
+   static Vec div(Vec a, Vec b)              { return a / b; }
+   static Vec sqrt(Vec a)                    { return ::sqrt(a); }
+
+   static Mask lt(Vec a, Vec b)              { return a < b; }
+   static Mask le(Vec a, Vec b)              { return a <= b; }
+   static Mask gt(Vec a, Vec b)              { return a > b; }
+   static Mask ge(Vec a, Vec b)              { return a >= b; }
+   static Mask ne(Vec a, Vec b)              { return a != b; }
+   static Mask both(Mask a, Mask b)          { return a && b; }
+   static Mask either(Mask a, Mask b)        { return a || b; }
+
+   static Vec select(Mask m, Vec a, Vec b)   { return m ? a : b; }
+   static U32 bits(Mask m)                   { return m ? 1 : 0; }
+};
+
+
+#ifdef POLYGON_EDGES_SSE
+struct SseLanes
+{
+   enum { Width = 4 };
+
+   typedef __m128 Vec;
+   typedef __m128 Mask;
+
+   static Vec load(const F32 *p)             { return _mm_loadu_ps(p); }
+   static void store(F32 *p, Vec v)          { _mm_storeu_ps(p, v); }
+   static Vec set(F32 f)                     { return _mm_set1_ps(f); }
+
+   static Vec add(Vec a, Vec b)              { return _mm_add_ps(a, b); }
+   static Vec sub(Vec a, Vec b)              { return _mm_sub_ps(a, b); }
+   static Vec mul(Vec a, Vec b)              { return _mm_mul_ps(a, b); }
+   static Vec div(Vec a, Vec b)              { return _mm_div_ps(a, b); }
+   static Vec sqrt(Vec a)                    { return _mm_sqrt_ps(a); }
+
+   static Mask lt(Vec a, Vec b)              { return _mm_cmplt_ps(a, b); }
+   static Mask le(Vec a, Vec b)              { return _mm_cmple_ps(a, b); }
+   static Mask gt(Vec a, Vec b)              { return _mm_cmpgt_ps(a, b); }
+   static Mask ge(Vec a, Vec b)              { return _mm_cmpge_ps(a, b); }
+   static Mask ne(Vec a, Vec b)              { return _mm_cmpneq_ps(a, b); }
+   static Mask both(Mask a, Mask b)          { return _mm_and_ps(a, b); }
+   static Mask either(Mask a, Mask b)        { return _mm_or_ps(a, b); }
+
+   static Vec select(Mask m, Vec a, Vec b)   { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+   static U32 bits(Mask m)                   { return _mm_movemask_ps(m); }
+};
+#endif
+
+
+#if defined(POLYGON_EDGES_SSE)
+PolygonEdges::KernelSet PolygonEdges::mKernelSet = PolygonEdges::SseKernels;
+#else
+PolygonEdges::KernelSet PolygonEdges::mKernelSet = PolygonEdges::ScalarKernels;
+#endif
+
+
+// Hands kernel the edges a block at a time, widest lanes first, finishing up one edge at a time.  Blocks are
+// handed over in order, so a kernel sees edges in the same order the Point-based functions do.
+template <class Lanes, class Kernel>
+static S32 runBlocks(Kernel &kernel, S32 first, S32 edgeCount)
+{
+   for(; edgeCount - first >= Lanes::Width; first += Lanes::Width)
+      kernel.template runBlock<Lanes>(first);
+
+   return first;
+}
+
+
+template <class Kernel>
+static void runKernel(Kernel &kernel, S32 edgeCount)
+{
+   S32 first = 0;
+
+#ifdef POLYGON_EDGES_SSE
+   if(PolygonEdges::getKernelSet() >= PolygonEdges::SseKernels)
+      first = runBlocks<SseLanes>(kernel, first, edgeCount);
+#endif
+
+   runBlocks<ScalarLanes>(kernel, first, edgeCount);
+}
+
+
+// Lanes version of findLowestRootInInterval() with an upper bound of 1; see there for the details.  Callers
+// wanting a lower bound can compare the root against it afterward: whenever the lowest root in [0, bound] exists,
+// it's the same as the one in [0, 1].
+template <class L>
+static typename L::Mask findLowestRoots(typename L::Vec a, typename L::Vec b, typename L::Vec c, typename L::Vec &root)
+{
+   typedef typename L::Vec Vec;
+   typedef typename L::Mask Mask;
+
+   const Vec zero = L::set(0.0f);
+   const Vec one  = L::set(1.0f);
+
+   Vec determinant = L::sub(L::mul(b, b), L::mul(L::mul(L::set(4.0f), a), c));
+   Mask solvable = L::ge(determinant, zero);
+
+   Vec sign = L::select(L::lt(b, zero), L::set(-1.0f), one);
+   Vec q = L::mul(L::set(-0.5f), L::add(b, L::mul(sign, L::sqrt(determinant))));
+
+   Vec x1 = L::div(q, a);
+   Vec x2 = L::div(c, q);
+
+   Mask swap = L::lt(x2, x1);
+   Vec low  = L::select(swap, x2, x1);
+   Vec high = L::select(swap, x1, x2);
+
+   Mask lowOk  = L::both(L::ge(low,  zero), L::le(low,  one));
+   Mask highOk = L::both(L::ge(high, zero), L::le(high, one));
+
+   root = L::select(lowOk, low, high);
+   return L::both(solvable, L::either(lowOk, highOk));
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+// polygonContainsPoint() -- winding number, as in GeomUtils
+struct WindingKernel
+{
+   const PolygonEdges &edges;
+   Point point;
+   S32 counter;
+
+   WindingKernel(const PolygonEdges &edges, const Point &point) : edges(edges), point(point), counter(0) { }
+
+   template <class L>
+   void runBlock(S32 first)
+   {
+      typedef typename L::Vec Vec;
+      typedef typename L::Mask Mask;
+
+      Vec x1 = L::load(edges.getPrevX() + first);
+      Vec y1 = L::load(edges.getPrevY() + first);
+      Vec x2 = L::load(edges.getX() + first);
+      Vec y2 = L::load(edges.getY() + first);
+
+      Vec px = L::set(point.x);
+      Vec py = L::set(point.y);
+
+      Vec isLeft = L::sub(L::mul(L::sub(x2, x1), L::sub(py, y1)), L::mul(L::sub(px, x1), L::sub(y2, y1)));
+
+      // GeomUtils truncates isLeft to an S32 before checking its sign
+      Mask up   = L::both(L::both(L::le(y1, py), L::gt(y2, py)), L::ge(isLeft, L::set(1.0f)));
+      Mask down = L::both(L::both(L::gt(y1, py), L::le(y2, py)), L::le(isLeft, L::set(-1.0f)));
+
+      U32 upBits = L::bits(up);
+      U32 downBits = L::bits(down);
+
+      for(S32 i = 0; i < L::Width; i++)
+         counter += S32((upBits >> i) & 1) - S32((downBits >> i) & 1);
+   }
+};
+
+
+bool polygonContainsPoint(const PolygonEdges &edges, const Point &point)
+{
+   WindingKernel kernel(edges, point);
+   runKernel(kernel, edges.getEdgeCount());
+
+   return kernel.counter != 0;
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+// polygonCircleIntersect() -- closest point on each edge to a circle that isn't moving yet
+struct CircleKernel
+{
+   const PolygonEdges &edges;
+   Point center;
+   Point velocity;
+   F32 radiusSq;        // Shrinks as closer points are found
+
+   bool collision;
+   Point point;
+
+   CircleKernel(const PolygonEdges &edges, const Point &center, F32 radiusSq, const Point &velocity) :
+      edges(edges), center(center), velocity(velocity), radiusSq(radiusSq), collision(false) { }
+
+   template <class L>
+   void runBlock(S32 first)
+   {
+      typedef typename L::Vec Vec;
+      typedef typename L::Mask Mask;
+
+      const Vec zero = L::set(0.0f);
+
+      Vec x = L::load(edges.getX() + first);
+      Vec y = L::load(edges.getY() + first);
+      Vec dx = L::load(edges.getDx() + first);
+      Vec dy = L::load(edges.getDy() + first);
+      Vec lenSq = L::load(edges.getLenSq() + first);
+
+      Vec cx = L::set(center.x);
+      Vec cy = L::set(center.y);
+      Vec vx = L::set(velocity.x);
+      Vec vy = L::set(velocity.y);
+
+      Vec toCenterX = L::sub(cx, x);
+      Vec toCenterY = L::sub(cy, y);
+      Vec fraction = L::add(L::mul(toCenterX, dx), L::mul(toCenterY, dy));
+
+      // Closest point is vertex i...
+      Mask atVertex = L::lt(fraction, zero);
+      Vec vertexDistSq = L::add(L::mul(toCenterX, toCenterX), L::mul(toCenterY, toCenterY));
+      Vec vertexDot = L::add(L::mul(vx, L::sub(x, cx)), L::mul(vy, L::sub(y, cy)));
+
+      // ...or somewhere along the edge
+      Mask onEdge = L::both(L::ge(fraction, zero), L::le(fraction, lenSq));
+      Vec s = L::div(fraction, lenSq);
+      Vec edgeX = L::add(x, L::mul(dx, s));
+      Vec edgeY = L::add(y, L::mul(dy, s));
+      Vec offsetX = L::sub(edgeX, cx);
+      Vec offsetY = L::sub(edgeY, cy);
+      Vec edgeDistSq = L::add(L::mul(offsetX, offsetX), L::mul(offsetY, offsetY));
+      Vec edgeDot = L::add(L::mul(vx, offsetX), L::mul(vy, offsetY));
+
+      Vec distSq = L::select(atVertex, vertexDistSq, edgeDistSq);
+      Vec dot    = L::select(atVertex, vertexDot, edgeDot);
+
+      Mask hit = L::both(L::either(atVertex, onEdge), L::both(L::le(distSq, L::set(radiusSq)), L::gt(dot, zero)));
+
+      U32 hitBits = L::bits(hit);
+      if(!hitBits)
+         return;
+
+      F32 distSqs[L::Width], pointX[L::Width], pointY[L::Width];
+      L::store(distSqs, distSq);
+      L::store(pointX, L::select(atVertex, x, edgeX));
+      L::store(pointY, L::select(atVertex, y, edgeY));
+
+      for(S32 i = 0; i < L::Width; i++)
+         if(((hitBits >> i) & 1) && distSqs[i] <= radiusSq)
+         {
+            collision = true;
+            point.set(pointX[i], pointY[i]);
+            radiusSq = distSqs[i];
+         }
+   }
+};
+
+
+// SweptCircleEdgeVertexIntersect() -- when a moving circle first touches each vertex, and each edge
+struct SweptCircleKernel
+{
+   const PolygonEdges &edges;
+   Point begin;
+   Point delta;
+   F32 radiusSq;
+
+   F32 upperBound;      // Shrinks as earlier collisions are found
+   bool collision;
+   Point point;
+
+   SweptCircleKernel(const PolygonEdges &edges, const Point &begin, const Point &delta, F32 radiusSq) :
+      edges(edges), begin(begin), delta(delta), radiusSq(radiusSq), upperBound(1.0f), collision(false) { }
+
+   template <class L>
+   void runBlock(S32 first)
+   {
+      typedef typename L::Vec Vec;
+      typedef typename L::Mask Mask;
+
+      const Vec zero = L::set(0.0f);
+
+      Vec x = L::load(edges.getX() + first);
+      Vec y = L::load(edges.getY() + first);
+      Vec dx = L::load(edges.getDx() + first);
+      Vec dy = L::load(edges.getDy() + first);
+      Vec lenSq = L::load(edges.getLenSq() + first);
+
+      Vec deltaX = L::set(delta.x);
+      Vec deltaY = L::set(delta.y);
+
+      // Vertex i
+      Vec bvX = L::sub(x, L::set(begin.x));
+      Vec bvY = L::sub(y, L::set(begin.y));
+      Vec deltaDotBv = L::add(L::mul(deltaX, bvX), L::mul(deltaY, bvY));
+
+      Vec a1 = L::sub(zero, L::set(delta.lenSquared()));
+      Vec b1 = L::add(zero, L::mul(L::set(2.0f), deltaDotBv));
+      Vec c1 = L::sub(L::set(radiusSq), L::add(L::mul(bvX, bvX), L::mul(bvY, bvY)));
+
+      Vec vertexTime;
+      Mask vertexHit = L::both(findLowestRoots<L>(a1, b1, c1, vertexTime), L::gt(deltaDotBv, zero));
+
+      // The edge from vertex i to vertex i - 1
+      Vec edgeDotDelta = L::add(L::mul(dx, deltaX), L::mul(dy, deltaY));
+      Vec edgeDotBv = L::add(L::mul(dx, bvX), L::mul(dy, bvY));
+
+      Vec a2 = L::add(L::mul(lenSq, a1), L::mul(edgeDotDelta, edgeDotDelta));
+      Vec b2 = L::sub(L::mul(lenSq, b1), L::mul(L::mul(L::set(2.0f), edgeDotBv), edgeDotDelta));
+      Vec c2 = L::add(L::mul(lenSq, c1), L::mul(edgeDotBv, edgeDotBv));
+
+      Vec edgeTime;
+      Mask edgeHit = findLowestRoots<L>(a2, b2, c2, edgeTime);
+
+      Vec f = L::sub(L::mul(edgeTime, edgeDotDelta), edgeDotBv);
+      Vec s = L::div(f, lenSq);
+      Vec edgeX = L::add(x, L::mul(dx, s));
+      Vec edgeY = L::add(y, L::mul(dy, s));
+      Vec edgeDot = L::add(L::mul(deltaX, L::sub(edgeX, L::set(begin.x))), L::mul(deltaY, L::sub(edgeY, L::set(begin.y))));
+
+      edgeHit = L::both(edgeHit, L::both(L::both(L::ge(f, zero), L::le(f, lenSq)), L::gt(edgeDot, zero)));
+
+      U32 vertexBits = L::bits(vertexHit);
+      U32 edgeBits = L::bits(edgeHit);
+
+      if(!(vertexBits | edgeBits))
+         return;
+
+      F32 xs[L::Width], ys[L::Width], vertexTimes[L::Width];
+      F32 edgeXs[L::Width], edgeYs[L::Width], edgeTimes[L::Width];
+
+      L::store(xs, x);
+      L::store(ys, y);
+      L::store(vertexTimes, vertexTime);
+      L::store(edgeXs, edgeX);
+      L::store(edgeYs, edgeY);
+      L::store(edgeTimes, edgeTime);
+
+      // GeomUtils checks the vertex, then the edge, then moves on to the next vertex
+      for(S32 i = 0; i < L::Width; i++)
+      {
+         if(((vertexBits >> i) & 1) && vertexTimes[i] <= upperBound)
+         {
+            collision = true;
+            upperBound = vertexTimes[i];
+            point.set(xs[i], ys[i]);
+         }
+
+         if(((edgeBits >> i) & 1) && edgeTimes[i] <= upperBound)
+         {
+            collision = true;
+            upperBound = edgeTimes[i];
+            point.set(edgeXs[i], edgeYs[i]);
+         }
+      }
+   }
+};
+
+
+bool PolygonSweptCircleIntersect(const PolygonEdges &edges, const Point &inBegin, const Point &inDelta, F32 inRadius,
+                                 Point &outPoint, F32 &outFraction)
+{
+   F32 radiusSq = inRadius * inRadius;
+
+   // Test if circle intersects at t = 0
+   if(polygonContainsPoint(edges, inBegin))
+   {
+      outPoint = inBegin;
+      outFraction = 0;
+      return true;
+   }
+
+   CircleKernel circle(edges, inBegin, radiusSq, inDelta);
+   runKernel(circle, edges.getEdgeCount());
+
+   if(circle.collision)
+   {
+      outPoint = circle.point;
+      outFraction = 0;
+      return true;
+   }
+
+   // Test if circle hits one of the edges or vertices on its way
+   SweptCircleKernel swept(edges, inBegin, inDelta, radiusSq);
+   runKernel(swept, edges.getEdgeCount());
+
+   if(!swept.collision)
+      return false;
+
+   outPoint = swept.point;
+   outFraction = swept.upperBound;
+   return true;
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+// polygonIntersectsSegmentDetailed() -- where a segment crosses each edge
+struct SegmentKernel
+{
+   const PolygonEdges &edges;
+   Point start;
+   Point dp;
+
+   F32 collisionTime;   // Earliest so far
+   Point normal;
+
+   SegmentKernel(const PolygonEdges &edges, const Point &start, const Point &end) :
+      edges(edges), start(start), dp(end - start), collisionTime(F32_MAX) { }
+
+   template <class L>
+   void runBlock(S32 first)
+   {
+      typedef typename L::Vec Vec;
+      typedef typename L::Mask Mask;
+
+      const Vec zero = L::set(0.0f);
+      const Vec one  = L::set(1.0f);
+
+      Vec x1 = L::load(edges.getPrevX() + first);
+      Vec y1 = L::load(edges.getPrevY() + first);
+      Vec dvX = L::sub(L::load(edges.getX() + first), x1);
+      Vec dvY = L::sub(L::load(edges.getY() + first), y1);
+
+      Vec dpX = L::set(dp.x);
+      Vec dpY = L::set(dp.y);
+
+      Vec denom = L::sub(L::mul(dpY, dvX), L::mul(dpX, dvY));
+
+      Vec fromStartX = L::sub(L::set(start.x), x1);
+      Vec toStartY = L::sub(y1, L::set(start.y));
+
+      Vec s = L::div(L::add(L::mul(fromStartX, dvY), L::mul(toStartY, dvX)), denom);
+      Vec t = L::div(L::add(L::mul(fromStartX, dpY), L::mul(toStartY, dpX)), denom);
+
+      Mask hit = L::both(L::ne(denom, zero), L::both(L::both(L::ge(s, zero), L::le(s, one)),
+                                                     L::both(L::ge(t, zero), L::le(t, one))));
+
+      U32 hitBits = L::bits(hit);
+      if(!hitBits)
+         return;
+
+      F32 times[L::Width], dvXs[L::Width], dvYs[L::Width];
+      L::store(times, s);
+      L::store(dvXs, dvX);
+      L::store(dvYs, dvY);
+
+      // Strictly earlier, so the first of several equally early edges wins, as in GeomUtils
+      for(S32 i = 0; i < L::Width; i++)
+         if(((hitBits >> i) & 1) && times[i] < collisionTime)
+         {
+            collisionTime = times[i];
+            normal.set(dvYs[i], -dvXs[i]);
+         }
+   }
+};
+
+
+bool polygonIntersectsSegmentDetailed(const PolygonEdges &edges, const Point &start, const Point &end,
+                                      F32 &collisionTime, Point &normal)
+{
+   SegmentKernel kernel(edges, start, end);
+   runKernel(kernel, edges.getEdgeCount());
+
+   if(kernel.collisionTime > 1)
+      return false;
+
+   collisionTime = kernel.collisionTime;
+   normal = kernel.normal;
+   return true;
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+// Constructor
+PolygonEdges::PolygonEdges()
+{
+   // Do nothing
+}
+
+
+// Constructor
+PolygonEdges::PolygonEdges(const Vector<Point> &vertices)
+{
+   set(vertices);
+}
+
+
+void PolygonEdges::set(const Vector<Point> &vertices)
+{
+   set(vertices.address(), vertices.size());
+}
+
+
+void PolygonEdges::set(const Point *vertices, S32 vertexCount)
+{
+   mX.resize(vertexCount);
+   mY.resize(vertexCount);
+   mPrevX.resize(vertexCount);
+   mPrevY.resize(vertexCount);
+   mDx.resize(vertexCount);
+   mDy.resize(vertexCount);
+   mLenSq.resize(vertexCount);
+
+   for(S32 i = 0; i < vertexCount; i++)
+   {
+      const Point &vertex = vertices[i];
+      const Point &prev = vertices[i == 0 ? vertexCount - 1 : i - 1];
+      Point edge = prev - vertex;
+
+      mX[i] = vertex.x;
+      mY[i] = vertex.y;
+      mPrevX[i] = prev.x;
+      mPrevY[i] = prev.y;
+      mDx[i] = edge.x;
+      mDy[i] = edge.y;
+      mLenSq[i] = edge.lenSquared();
+   }
+}
+
+
+S32 PolygonEdges::getEdgeCount() const
+{
+   return mX.size();
+}
+
+
+const F32 *PolygonEdges::getX() const     { return mX.address(); }
+const F32 *PolygonEdges::getY() const     { return mY.address(); }
+const F32 *PolygonEdges::getPrevX() const { return mPrevX.address(); }
+const F32 *PolygonEdges::getPrevY() const { return mPrevY.address(); }
+const F32 *PolygonEdges::getDx() const    { return mDx.address(); }
+const F32 *PolygonEdges::getDy() const    { return mDy.address(); }
+const F32 *PolygonEdges::getLenSq() const { return mLenSq.address(); }
+
+
+PolygonEdges::KernelSet PolygonEdges::getBestKernelSet()
+{
+#if defined(POLYGON_EDGES_SSE)
+   return SseKernels;
+#else
+   return ScalarKernels;
+#endif
+}
+
+
+PolygonEdges::KernelSet PolygonEdges::getKernelSet()
+{
+   return mKernelSet;
+}
+
+
+void PolygonEdges::setKernelSet(KernelSet kernelSet)
+{
+   TNLAssert(kernelSet <= getBestKernelSet(), "This build doesn't have those kernels!");
+   mKernelSet = kernelSet <= getBestKernelSet() ? kernelSet : getBestKernelSet();
+}
+
+
+const char *PolygonEdges::getKernelSetName(KernelSet kernelSet)
+{
+   switch(kernelSet)
+   {
+      case SseKernels:
+         return "SSE2";
+      default:
+         return "scalar";
+   }
+}
+
+
+};
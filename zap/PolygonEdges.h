@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _POLYGON_EDGES_H_
+#define _POLYGON_EDGES_H_
+
+#include "Point.h"
+
+#include "tnlTypes.h"
+#include "tnlVector.h"
+
+using namespace TNL;
+
+namespace Zap
+{
+
+// The edges of a closed polygon, with each coordinate kept in an array of its own, so the collision functions
+// below can test several edges at once.  They give the same answers as the GeomUtils functions of the same names,
+// which work on an array of Points.
+//
+// Filling one in costs about as much as a single test, so keep them for polygons that get tested a lot and never
+// change, like walls.  Edge i runs from vertex i - 1 to vertex i, wrapping around at 0.
+class PolygonEdges
+{
+public:
+   enum KernelSet {
+      ScalarKernels,    // One edge at a time; works everywhere
+      SseKernels        // Four edges at a time, on x86 with SSE2
+   };
+
+private:
+   Vector<F32> mX, mY;           // Vertex i
+   Vector<F32> mPrevX, mPrevY;   // Vertex i - 1
+   Vector<F32> mDx, mDy;         // Vertex i - 1 minus vertex i
+   Vector<F32> mLenSq;           // Squared length of the edge
+
+   static KernelSet mKernelSet;
+
+public:
+   PolygonEdges();                                       // Constructor
+   explicit PolygonEdges(const Vector<Point> &vertices); // Constructor
+
+   void set(const Point *vertices, S32 vertexCount);
+   void set(const Vector<Point> &vertices);
+
+   S32 getEdgeCount() const;
+
+   const F32 *getX() const;
+   const F32 *getY() const;
+   const F32 *getPrevX() const;
+   const F32 *getPrevY() const;
+   const F32 *getDx() const;
+   const F32 *getDy() const;
+   const F32 *getLenSq() const;
+
+   // SSE2 kernels are used by default where we have them.  These let tests and benchmarks pick others, up to the
+   // widest this build has.
+   static KernelSet getBestKernelSet();
+   static KernelSet getKernelSet();
+   static void setKernelSet(KernelSet kernelSet);
+   static const char *getKernelSetName(KernelSet kernelSet);
+};
+
+
+bool polygonContainsPoint(const PolygonEdges &edges, const Point &point);
+
+bool PolygonSweptCircleIntersect(const PolygonEdges &edges, const Point &inBegin, const Point &inDelta, F32 inRadius,
+                                 Point &outPoint, F32 &outFraction);
+
+// Only handles the A-B-C-D format, as PolygonEdges are always closed
+bool polygonIntersectsSegmentDetailed(const PolygonEdges &edges, const Point &start, const Point &end,
+                                      F32 &collisionTime, Point &normal);
+
+};
+
+#endif
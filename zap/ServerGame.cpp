@@ -18,6 +18,7 @@
 #include "BotNavMeshZone.h"      // For zone clearing code
 #include "LevelSource.h"
 #include "LevelDatabase.h"
+#include "LevelGeometryCache.h"
 #include "Level.h"
 #include "WallItem.h"
 
@@ -29,6 +30,10 @@
 
 #include "IniFile.h"
 
+#include "tnlProfiler.h"
+
+#include <time.h>
+
 
 using namespace TNL;
 
@@ -36,18 +41,19 @@ namespace Zap
 {
 
 
-static bool instantiated;           // Just a little something to keep us from creating multiple ServerGames...
+static S32 instanceCount = 0;       // Just a little something to keep us from creating multiple ServerGames... except as arenas
 
 
 // Constructor -- be sure to see Game constructor too!  Lots going on there!
 ServerGame::ServerGame(const Address &address, GameSettingsPtr settings, LevelSourcePtr levelSource, bool testMode, bool dedicated, bool hostOnServer) : 
       Game(address, settings),
-      mRobotManager(this, settings)
+      mRobotManager(this, settings),
+      mBotTickScheduler(this)
 {
-   TNLAssert(!instantiated, "Only one ServerGame at a time, please!  If this trips while testing, "
-      "it is probably because a test failed before another instance could be deleted.  Try disabling "
-      "this assert, see what test fails, and fix it.  Then re-enable it, please!");
-   instantiated = true;
+   TNLAssert(instanceCount == 0 || GameManager::getServerGames()->size() > 0, "Only one ServerGame at a time, please!  "
+      "If this trips while testing, it is probably because a test failed before another instance could be deleted.  "
+      "Try disabling this assert, see what test fails, and fix it.  Then re-enable it, please!");
+   instanceCount++;
 
    mLevelSource = levelSource;
 
@@ -67,6 +73,10 @@ ServerGame::ServerGame(const Address &address, GameSettingsPtr settings, LevelSo
 
    mShuttingDown = false;
 
+   // Applies to levels loaded from here on
+   GridDatabase::setDefaultBucketBackend(mSettings->getSetting<YesNo>(IniKey::ArrayBucketDatabase) ?
+                                         GridDatabase::ArrayBuckets : GridDatabase::LinkedListBuckets);
+
    EventManager::get()->setPaused(false);
 
    mInfoFlags = 0;                           // Currently used to specify test mode and debug builds
@@ -93,6 +103,12 @@ ServerGame::ServerGame(const Address &address, GameSettingsPtr settings, LevelSo
    mTestMode = testMode;
 
    mNetInterface->setAllowsConnections(true);
+   mNetInterface->setPacketWorkerCount(mSettings->getNetWorkerCount());
+   mBotTickScheduler.setWorkerCount(mSettings->getBotWorkerCount());
+   mNetStatsLogTimer.reset(NetStatsLogInterval);
+
+   if(mSettings->getProfileTicks())
+      Profiler::setEnabled(true);
    mMasterUpdateTimer.reset(UpdateServerStatusTime);
 
    // How long will teams stay locked after last admin departs?
@@ -107,6 +123,7 @@ ServerGame::ServerGame(const Address &address, GameSettingsPtr settings, LevelSo
 #endif
 
    mDedicated = dedicated;
+   mArenaIndex = 0;
 
    mGameSuspended = true;                 // Server starts with zero players
 
@@ -131,9 +148,11 @@ ServerGame::~ServerGame()
    if(getConnectionToMaster())   // Prevents errors when ServerGame is gone too soon
       getConnectionToMaster()->disconnect(NetConnection::ReasonSelfDisconnect, "");
 
+   mLevelPipeline.cancel();      // Don't pull the LevelSource out from under the loader
+
    cleanUp();
 
-   instantiated = false;
+   instanceCount--;
 
    delete mGameInfo;
 
@@ -461,10 +480,25 @@ static S32 QSORT_CALLBACK AddOrderSort(RefPtr<ClientInfo> *a, RefPtr<ClientInfo>
 }
 
 
+void ServerGame::cancelLevelPipeline()
+{
+   mLevelPipeline.cancel();
+}
+
+
+// Every arena loads from the same LevelSource, so before it changes, none of them can be loading from it
+void ServerGame::cancelAllLevelPipelines()
+{
+   mLevelPipeline.cancel();               // We may not be one of GameManager's arenas; tests make their own
+   GameManager::cancelLevelPipelines();
+}
+
+
 void ServerGame::receivedLevelFromHoster(S32 levelIndex, const string &filename)
 {
    if(levelIndex >= mLevelSource->getLevelCount())
       return; // out of range
+   cancelAllLevelPipelines();
    mLevelSource->setLevelFileName(levelIndex, filename);
    cycleLevel(levelIndex);
 }
@@ -482,10 +516,18 @@ void ServerGame::makeEmptyLevelIfNoGameType()
 }
 
 
+static F64 getElapsedMs(S64 startTime)
+{
+   return Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - startTime);
+}
+
+
 // Clear, prepare, and load the level given by the index \nextLevel. This
 // function respects meta-indices, and otherwise expects an absolute index.
 void ServerGame::cycleLevel(S32 nextLevel)
 {
+   TNL_PROFILE_SCOPE("ServerGame::cycleLevel");
+
    if(mHostOnServer)
    {
       if(mHoster.isValid())
@@ -523,6 +565,9 @@ void ServerGame::cycleLevel(S32 nextLevel)
       }
    }
 
+   S64 startTime = Platform::getHighPrecisionTimerValue();
+   mLevelLoadStats.clear();
+
    delete mGameRecorderServer;
    mGameRecorderServer = NULL;
 
@@ -596,9 +641,31 @@ void ServerGame::cycleLevel(S32 nextLevel)
 #endif
 
    TNLAssert(getGameType(), "Expect to have a GameType here!");
-   getGameType()->mBotZoneCreationFailed = !BotNavMeshZone::buildBotMeshZones(mLevel->getBotZoneDatabase(), mLevel->getBotZoneList(),
-                                                                              getWorldExtents(), barrierList, turretList,
-                                                                              forceFieldProjectorList, teleporterData, triangulate);
+   S64 navMeshStartTime = Platform::getHighPrecisionTimerValue();
+
+   // Levelgens can add walls, so only levels without any can use a cached nav mesh
+   bool canCacheNavMesh = getGameType()->getScriptName() == "" &&
+                          getSettings()->getSetting<string>(IniKey::GlobalLevelScript) == "";
+
+   bool zoneCreationFailed;
+   mLevelLoadStats.navMeshCached = canCacheNavMesh &&
+         LevelGeometryCache::getNavMesh(mLevel->getHash(), mLevel->getBotZoneDatabase(), mLevel->getBotZoneList(),
+                                        triangulate, zoneCreationFailed);
+
+   if(!mLevelLoadStats.navMeshCached)
+   {
+      zoneCreationFailed = !BotNavMeshZone::buildBotMeshZones(mLevel->getBotZoneDatabase(), mLevel->getBotZoneList(),
+                                                              getWorldExtents(), barrierList, turretList,
+                                                              forceFieldProjectorList, teleporterData, triangulate);
+      if(canCacheNavMesh)
+         LevelGeometryCache::putNavMesh(mLevel->getHash(), mLevel->getBotZoneList(), zoneCreationFailed);
+   }
+
+   getGameType()->mBotZoneCreationFailed = zoneCreationFailed;
+   // New nav mesh, so old routes are no good
+   mBotPathFinder.reset(&mLevel->getBotZoneList(), mSettings->getSetting<YesNo>(IniKey::BotNextHopTable));
+   mLevelLoadStats.navMeshMs = getElapsedMs(navMeshStartTime);
+
    // Clear team info for all clients
    resetAllClientTeams();
 
@@ -663,6 +730,25 @@ void ServerGame::cycleLevel(S32 nextLevel)
    sendLevelStatsToMaster();     // Give the master some information about this level for its database
 
    suspendIfNoActivePlayers();   // Does nothing if we're already suspended
+
+   mLevelLoadStats.totalMs = getElapsedMs(startTime);
+
+   logprintf(LogConsumer::ServerFilter, "Level load times: %s %.1fms, waiting %.1fms, adding objects %.1fms, "
+             "levelgens %.1fms, nav mesh %.1fms%s, total %.1fms",
+             mLevelLoadStats.prepared ? "prepared in background" : "loaded", mLevelLoadStats.prepareMs,
+             mLevelLoadStats.waitMs, mLevelLoadStats.addToGameMs, mLevelLoadStats.levelGenMs,
+             mLevelLoadStats.navMeshMs, mLevelLoadStats.navMeshCached ? " (cached)" : "", mLevelLoadStats.totalMs);
+}
+
+
+// Start loading the level we'll switch to once the level switch timer runs out, so it's ready by the time we need it
+void ServerGame::prepareNextLevel()
+{
+   // Levels from the hoster don't arrive until it's time to play them
+   if(mHostOnServer || mLevelSource->getLevelCount() == 0)
+      return;
+
+   mLevelPipeline.prepare(mLevelSource.get(), getAbsoluteLevelIndex(mNextLevel));
 }
 
 
@@ -721,7 +807,23 @@ bool ServerGame::loadNextLevel(S32 nextLevel)
 // Returns true if the level is successfully loaded, false if it wasn't
 bool ServerGame::loadLevel()
 {
-   mLevel = boost::shared_ptr<Level>(mLevelSource->getLevel(mCurrentLevelIndex));
+   S64 startTime = Platform::getHighPrecisionTimerValue();
+
+   // With any luck, the level was loaded while the last game was wrapping up
+   F64 prepareMs = 0;
+   Level *level = mLevelPipeline.take(mLevelSource.get(), mCurrentLevelIndex, prepareMs);
+   mLevelLoadStats.prepared = (level != NULL);
+
+   if(!level)
+   {
+      level = mLevelSource->getLevel(mCurrentLevelIndex);
+      prepareMs = getElapsedMs(startTime);
+   }
+
+   mLevelLoadStats.prepareMs += prepareMs;
+   mLevelLoadStats.waitMs += getElapsedMs(startTime);
+
+   mLevel = boost::shared_ptr<Level>(level);
 
    TNLAssert(!mLevel->getAddedToGame(), "Can't reuse Levels!");
 
@@ -733,6 +835,8 @@ bool ServerGame::loadLevel()
       return false;
    }
 
+   startTime = Platform::getHighPrecisionTimerValue();
+
    mLevel->onAddedToGame(this);     // Gets the TeamManager up and running and populated, adds bots
 
 
@@ -744,8 +848,9 @@ bool ServerGame::loadLevel()
       addWallItem(static_cast<WallItem *>(walls[i]), NULL);        // Just does this --> Barrier::constructBarriers(this, *wallItem->getOutline(), false, wallItem->getWidth());
 
 
+   // Walls are still as the level file had them (levelgens haven't run yet), so cached edges are good
    Vector<Point> points;
-   mLevel->buildWallEdgeGeometry(points);
+   mLevel->buildCachedWallEdgeGeometry(points);
 
 
    const Vector<DatabaseObject *> objects = *mLevel->findObjects_fast();
@@ -767,6 +872,9 @@ bool ServerGame::loadLevel()
 
    mLevel->addBots(this);
 
+   mLevelLoadStats.addToGameMs += getElapsedMs(startTime);
+   startTime = Platform::getHighPrecisionTimerValue();
+
    // Levelgens:
    // Run level's levelgen script (if any)
    runLevelGenScript(getGameType()->getScriptName());
@@ -778,6 +886,11 @@ bool ServerGame::loadLevel()
    for(S32 i = 0; i < scriptList.size(); i++)
       runLevelGenScript(scriptList[i]);
 
+   mLevelLoadStats.levelGenMs += getElapsedMs(startTime);
+
+   // Walls, forcefields and zones are all in place now; move them out of the way of the things that move
+   mLevel->buildStaticIndex((TestFunc)isStaticGeometryType);
+
    // Fire an update to make sure certain events run on level start (like onShipSpawned)
    EventManager::get()->update();
 
@@ -1398,6 +1511,28 @@ bool ServerGame::isDedicated() const
 }
 
 
+void ServerGame::setArenaIndex(S32 index)
+{
+   mArenaIndex = index;
+}
+
+
+S32 ServerGame::getArenaIndex() const
+{
+   return mArenaIndex;
+}
+
+
+// When one process hosts several arenas, they all share the same settings; number them so players can tell them apart
+string ServerGame::getServerName() const
+{
+   if(mArenaIndex == 0)
+      return mSettings->getHostName();
+
+   return mSettings->getHostName() + " #" + itos(mArenaIndex + 1);
+}
+
+
 void ServerGame::setDedicated(bool dedicated)
 {
    mDedicated = dedicated;
@@ -1457,6 +1592,8 @@ void ServerGame::idle(U32 timeDelta)
    if(GameManager::getHostingModePhase() == GameManager::LoadingLevels)
       return;
 
+   TNL_PROFILE_SCOPE("ServerGame::idle");
+
    Parent::idle(timeDelta);
 
    processSimulatedStutter(timeDelta);
@@ -1477,10 +1614,14 @@ void ServerGame::idle(U32 timeDelta)
    if(timeDelta > MaxTimeDelta)   // Prevents timeDelta from going too high, usually when after the server was frozen
       timeDelta = 100;
 
-   mNetInterface->checkIncomingPackets();
+   {
+      TNL_PROFILE_SCOPE("Incoming packets");
+      mNetInterface->checkIncomingPackets();
+   }
+
    checkConnectionToMaster(timeDelta);                   // Connect to master server if not connected
 
-   mSettings->getBanList()->updateKickList(timeDelta);   // Unban players who's bans have expired
+   mLevelPipeline.update();                              // Let go of the loader thread if it's done
 
    // Periodically update our status on the master, so they know what we're doing...
    if(mMasterUpdateTimer.update(timeDelta))
@@ -1506,6 +1647,8 @@ void ServerGame::idle(U32 timeDelta)
 
    if(mGameSuspended)     // If game is suspended, we need do nothing more
    {
+      TNL_PROFILE_SCOPE("Send updates");
+      getGameType()->updateInterestSets();
       mNetInterface->processConnections();
       return;
    }
@@ -1547,42 +1690,32 @@ void ServerGame::idle(U32 timeDelta)
 
    if(botControlTickTimer.update(timeDelta))
    {
+      TNL_PROFILE_SCOPE("Bot tick");
+
       // Clear all old bot moves, so that if the bot does nothing, it doesn't just continue with what it was doing before
       mRobotManager.clearMoves();
 
-      // Fire TickEvent, in case anyone is listening
-      EventManager::get()->fireEvent(EventManager::TickEvent, botControlTickElapsed + timeDelta);
+      // Fire TickEvent, in case anyone is listening; bots with their own Lua states may run in parallel
+      mBotTickScheduler.fireTickEvent(botControlTickElapsed + timeDelta);
 
       botControlTickTimer.reset();
    }
    
-   const Vector<DatabaseObject *> *gameObjects = mLevel->findObjects_fast();
+   idleObjects(timeDelta);
 
-   // Visit each game object, handling moves and running its idle method
-   for(S32 i = gameObjects->size() - 1; i >= 0; i--)
    {
-      BfObject *obj = static_cast<BfObject *>((*gameObjects)[i]);
-
-      if(obj->isDeleted())
-         continue;
-
-      // Here is where the time gets set for all the various object moves
-      Move thisMove = obj->getCurrentMove();
-      thisMove.time = timeDelta;
-
-      // Give the object its move, then have it idle
-      obj->setCurrentMove(thisMove);
-      obj->idle(BfObject::ServerIdleMainLoop);
+      TNL_PROFILE_SCOPE("GameType::idle");
+      TNLAssert(getGameType(), "Expect a GameType here!");
+      getGameType()->idle(BfObject::ServerIdleMainLoop, timeDelta);
    }
 
-   TNLAssert(getGameType(), "Expect a GameType here!");
-   getGameType()->idle(BfObject::ServerIdleMainLoop, timeDelta);
-
    processDeleteList(timeDelta);
 
    // Load a new level if the time is out on the current one
    if(mLevelSwitchTimer.update(timeDelta))
    {
+      TNL_PROFILE_SCOPE("Level switch");
+
       // Kick any players who were idle the entire previous game.  But DO NOT kick the hosting player!
       for(S32 i = 0; i < getClientCount(); i++)
       {
@@ -1603,7 +1736,13 @@ void ServerGame::idle(U32 timeDelta)
 
       // Normalize ratings for this game
       getGameType()->updateRatings();
-      cycleLevel(mNextLevel);
+
+      // If the next level was picked at random, go with the one we've been loading
+      S32 nextLevel = mNextLevel;
+      if(nextLevel == RANDOM_LEVEL && mLevelPipeline.getPreparedIndex() >= 0)
+         nextLevel = mLevelPipeline.getPreparedIndex();
+
+      cycleLevel(nextLevel);
       mNextLevel = getSettings()->getSetting<YesNo>(IniKey::RandomLevels) ? +RANDOM_LEVEL : +NEXT_LEVEL;
    }
 
@@ -1617,7 +1756,10 @@ void ServerGame::idle(U32 timeDelta)
    }
 
    if(mGameRecorderServer)
+   {
+      TNL_PROFILE_SCOPE("Recorder");
       mGameRecorderServer->idle(timeDelta);
+   }
 
    if(mNoAdminAutoUnlockTeamsTimer.update(timeDelta))
       setTeamsLocked(false);
@@ -1625,7 +1767,78 @@ void ServerGame::idle(U32 timeDelta)
    mTeamHistoryManager.idle(timeDelta);
 
    // Update to other clients right after idling everything else, so clients get more up to date information
-   mNetInterface->processConnections(); 
+   {
+      TNL_PROFILE_SCOPE("Send updates");
+      getGameType()->updateInterestSets();
+      mNetInterface->processConnections(); 
+   }
+
+   if(mNetStatsLogTimer.update(timeDelta))
+   {
+      logNetStats();
+      logProfilerStats();
+      mNetStatsLogTimer.reset();
+   }
+}
+
+
+// Visit each game object, handling moves and running its idle method
+void ServerGame::idleObjects(U32 timeDelta)
+{
+   TNL_PROFILE_SCOPE("Object idle");
+
+   const Vector<DatabaseObject *> *gameObjects = mLevel->findObjects_fast();
+
+   for(S32 i = gameObjects->size() - 1; i >= 0; i--)
+   {
+      BfObject *obj = static_cast<BfObject *>((*gameObjects)[i]);
+
+      if(obj->isDeleted())
+         continue;
+
+      // Here is where the time gets set for all the various object moves
+      Move thisMove = obj->getCurrentMove();
+      thisMove.time = timeDelta;
+
+      // Give the object its move, then have it idle
+      obj->setCurrentMove(thisMove);
+      obj->idle(BfObject::ServerIdleMainLoop);
+   }
+}
+
+
+// Report how long we've been spending on each phase of sending updates to clients
+void ServerGame::logNetStats()
+{
+   const NetInterface::PacketPhaseStats &stats = mNetInterface->getPacketPhaseStats();
+
+   if(stats.processCount > 0)
+   {
+      F64 count = stats.processCount;
+
+      logprintf(LogConsumer::LogNetInterface, "Packets: %d workers, %d sent in %d ticks; per tick: scope %.3fms, write %.3fms, build %.3fms (wall), send %.3fms, "
+                "%.1f dirty objects into %.1f ghosts",
+                mNetInterface->getPacketWorkerCount(), stats.packetsSent, stats.processCount,
+                stats.scopeMs / count, stats.writeMs / count, stats.buildMs / count, stats.sendMs / count,
+                stats.dirtyObjects / count, stats.dirtyRefs / count);
+   }
+
+   mNetInterface->resetPacketPhaseStats();
+}
+
+
+// Report the typical and worst times of each phase the profiler has timed since we last logged
+void ServerGame::logProfilerStats()
+{
+   if(!Profiler::isEnabled())
+      return;
+
+   Vector<Profiler::PhaseStats> stats;
+   Profiler::getPhaseStats(NetStatsLogInterval, stats);
+
+   for(S32 i = 0; i < stats.size(); i++)
+      logprintf(LogConsumer::ServerFilter, "Profile: %s x%d: p50 %.3fms, p99 %.3fms, max %.3fms, total %.1fms",
+                stats[i].name, stats[i].count, stats[i].p50Ms, stats[i].p99Ms, stats[i].maxMs, stats[i].totalMs);
 }
 
 
@@ -1926,6 +2139,7 @@ bool ServerGame::startHosting()
 void ServerGame::gameEnded()
 {
    mLevelSwitchTimer.reset();
+   prepareNextLevel();
 }
 
 
@@ -1951,6 +2165,8 @@ void ServerGame::levelAddedNotifyClients(const LevelInfo &levelInfo)
 // levelInfo should arrive fully populated
 S32 ServerGame::addLevel(const LevelInfo &levelInfo)
 {
+   cancelAllLevelPipelines();    // Adding may shuffle the level list around
+
    pair<S32, bool> ret = mLevelSource->addLevel(levelInfo);
 
    // ret.first is index of level, ret.second is true if the level was added, false if it already existed.
@@ -1965,12 +2181,15 @@ S32 ServerGame::addLevel(const LevelInfo &levelInfo)
 
 void ServerGame::addNewLevel(const LevelInfo &levelInfo)
 {
+   cancelAllLevelPipelines();
    mLevelSource->addNewLevel(levelInfo);
    levelAddedNotifyClients(levelInfo);
 }
 
 void ServerGame::removeLevel(S32 index)
 {
+   cancelAllLevelPipelines();
+
    if(index < 0)
    {
       while(mLevelSource->getLevelCount())
@@ -2033,6 +2252,101 @@ const Vector<BotNavMeshZone *> &ServerGame::getBotZoneList() const
 }
 
 
+BotPathFinder &ServerGame::getBotPathFinder()
+{
+   return mBotPathFinder;
+}
+
+
+const LevelLoadStats &ServerGame::getLevelLoadStats() const
+{
+   return mLevelLoadStats;
+}
+
+
+static S32 QSORT_CALLBACK compareByTotalTime(Profiler::PhaseStats *a, Profiler::PhaseStats *b)
+{
+   return a->totalMs < b->totalMs ? 1 : a->totalMs > b->totalMs ? -1 : 0;
+}
+
+
+// Handles the /profile admin command.  "on" and "off" start and stop the tick profiler; otherwise we save the last
+// few seconds it recorded as a Chrome trace in the log folder, and show the admin where most of the time went.
+void ServerGame::runProfileCommand(GameConnection *conn, const Vector<StringPtr> &args)
+{
+   static const U32 DefaultSeconds = 10;
+   static const U32 MaxSeconds = 60;
+   static const S32 MaxPhasesShown = 6;
+
+   string arg = args.size() > 0 ? lcase(args[0].getString()) : "";
+
+   if(arg == "on")
+   {
+      Profiler::clear();
+      Profiler::setEnabled(true);
+      conn->s2cDisplayMessage(GameConnection::ColorInfo, SFXNone, "Tick profiler on; use /profile [secs] to save what it records");
+      return;
+   }
+
+   if(arg == "off")
+   {
+      Profiler::setEnabled(false);
+      conn->s2cDisplayMessage(GameConnection::ColorInfo, SFXNone, "Tick profiler off");
+      return;
+   }
+
+   if(!Profiler::isEnabled())
+   {
+      conn->s2cDisplayErrorMessage("!!! Tick profiler is off; use /profile on to start it");
+      return;
+   }
+
+   U32 seconds = arg == "" ? 0 : U32(atoi(arg.c_str()));
+   if(seconds == 0)
+      seconds = DefaultSeconds;
+   seconds = min(seconds, MaxSeconds);
+
+   const string &dir = mSettings->getFolderManager()->getLogDir();
+   makeSureFolderExists(dir);
+   string filename = joindir(dir, "tick_profile_" + itos(U32(time(NULL))) + ".json");
+
+   Vector<StringTableEntry> e;
+   Vector<StringPtr> s;
+   Vector<S32> i;
+
+   s.push_back(filename.c_str());
+   i.push_back(seconds);
+
+   if(!Profiler::writeChromeTrace(filename.c_str(), seconds * 1000))
+   {
+      conn->s2cDisplayMessageESI(GameConnection::ColorRed, SFXNone, "!!! Could not write %s0", e, s, i);
+      return;
+   }
+
+   logprintf(LogConsumer::ServerFilter, "Saved the last %d seconds of the tick profile to %s", seconds, filename.c_str());
+   conn->s2cDisplayMessageESI(GameConnection::ColorInfo, SFXNone, "Saved the last %i0 seconds of the tick profile to %s0", e, s, i);
+
+   // Then the phases that took the most time altogether
+   Vector<Profiler::PhaseStats> stats;
+   Profiler::getPhaseStats(seconds * 1000, stats);
+   stats.sort(compareByTotalTime);
+
+   for(S32 j = 0; j < stats.size() && j < MaxPhasesShown; j++)
+   {
+      s.clear();
+      i.clear();
+
+      s.push_back(stats[j].name);
+      s.push_back(ftos(F32(stats[j].p50Ms), 2).c_str());
+      s.push_back(ftos(F32(stats[j].p99Ms), 2).c_str());
+      s.push_back(ftos(F32(stats[j].maxMs), 2).c_str());
+      i.push_back(stats[j].count);
+
+      conn->s2cDisplayMessageESI(GameConnection::ColorInfo, SFXNone, "%s0 x%i0: p50 %s1ms, p99 %s2ms, max %s3ms", e, s, i);
+   }
+}
+
+
 GridDatabase &ServerGame::getBotZoneDatabase() const
 {
    return mLevel->getBotZoneDatabase();
@@ -2042,16 +2356,17 @@ GridDatabase &ServerGame::getBotZoneDatabase() const
 // Returns ID of zone containing specified point
 U16 ServerGame::findZoneContaining(const Point &p) const
 {
-   fillVector.clear();
-   mLevel->getBotZoneDatabase().findObjects(BotNavMeshZoneTypeNumber, fillVector,
+   ScopedDatabaseQuery query;    // Robots ticking in parallel all land here
+
+   mLevel->getBotZoneDatabase().findObjects(BotNavMeshZoneTypeNumber, query->results,
                                 Rect(p - Point(0.1f, 0.1f), p + Point(0.1f, 0.1f)));  // Slightly extend Rect, it can be on the edge of zone
 
-   for(S32 i = 0; i < fillVector.size(); i++)
+   for(S32 i = 0; i < query->results.size(); i++)
    {
       // First a quick, crude elimination check then more comprehensive one
       // Since our zones are convex, we can use the faster method!  Yay!
       // Actually, we can't, as it is not reliable... reverting to more comprehensive (and working) version.
-      BotNavMeshZone *zone = static_cast<BotNavMeshZone *>(fillVector[i]);
+      BotNavMeshZone *zone = static_cast<BotNavMeshZone *>(query->results[i]);
 
       if(zone->getExtent().contains(p) &&
             (polygonContainsPoint(zone->getOutline()->address(), zone->getOutline()->size(), p)))
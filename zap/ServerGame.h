@@ -9,7 +9,9 @@
 #include "game.h"                // Parent class
 
 #include "BotNavMeshZone.h"
+#include "BotTickScheduler.h"
 #include "dataConnection.h"
+#include "LevelPipeline.h"
 #include "LevelSource.h"         // For LevelSourcePtr def
 #include "LevelSpecifierEnum.h"
 #include "RobotManager.h"
@@ -45,6 +47,7 @@ private:
       UpdateServerWhenHostGoesEmpty = FOUR_SECONDS, // How many seconds when host on server when server goes empty or not empty
       CheckServerStatusTime = FIVE_SECONDS,       // If it did not send updates, recheck after ms
       BotControlTickInterval = 33,                // Interval for how often should we let bots fire the onTick event (ms)
+      NetStatsLogInterval = ONE_MINUTE,           // How often we log packet building timings (ms)
    };
 
    bool mTestMode;                        // True if being tested from editor
@@ -52,6 +55,8 @@ private:
    GridDatabase mDatabaseForBotZones;     // Database especially for BotZones to avoid gumming up the regular database with too many objects
 
    LevelSourcePtr mLevelSource;
+   LevelPipeline mLevelPipeline;          // Loads the next level while the current one winds down; declared after mLevelSource
+   LevelLoadStats mLevelLoadStats;        // How long the last level change took
 
    U32 mCurrentLevelIndex;                // Index of level currently being played
    Timer mLevelSwitchTimer;               // Track how long after game has ended before we actually switch levels
@@ -64,6 +69,7 @@ private:
    SafePtr<GameConnection> mShutdownOriginator;   // Who started the shutdown?
 
    bool mDedicated;
+   S32 mArenaIndex;                       // 0 for the first (or only) arena this process hosts
    S32 mLevelLoadIndex;                   // For keeping track of where we are in the level loading process.  NOT CURRENT LEVEL IN PLAY!
 
    SafePtr<GameConnection> mSuspendor;    // Player requesting suspension if game suspended by request
@@ -89,10 +95,13 @@ private:
    Timer mStutterTimer;                   
    Timer mStutterSleepTimer;
    Timer mNoAdminAutoUnlockTeamsTimer;
+   Timer mNetStatsLogTimer;
 
    U32 mAccumulatedSleepTime;
 
    RobotManager mRobotManager;
+   BotTickScheduler mBotTickScheduler;
+   BotPathFinder mBotPathFinder;
 
    Vector<LuaLevelGenerator *> mLevelGens;
    Vector<LuaLevelGenerator *> mLevelGenDeleteList;
@@ -102,6 +111,9 @@ private:
    void updateStatusOnMaster();           // Give master a status report for this server
    void processVoting(U32 timeDelta);     // Manage any ongoing votes
    void processSimulatedStutter(U32 timeDelta);
+   void idleObjects(U32 timeDelta);
+   void logNetStats();                    // Dump packet building timings to the log
+   void logProfilerStats();               // Dump tick profiler timings to the log, if it's running
 
    string getLevelFileNameFromIndex(S32 indx);
 
@@ -114,6 +126,8 @@ private:
    bool loadNextLevel(S32 nextLevel);                 // Find the next valid level, and load it with loadLevel()
    bool loadLevel();                                  // Load the level pointed to by mCurrentLevelIndex
    void runLevelGenScript(const string &scriptName);  // Run any levelgens specified by the level or in the INI
+   void prepareNextLevel();                           // Start loading the next level in the background
+   void cancelAllLevelPipelines();                    // Stop every arena loading from our LevelSource
 
    AbstractTeam *getNewTeam();
 
@@ -164,6 +178,10 @@ public:
    bool isDedicated() const;
    void setDedicated(bool dedicated);
 
+   void setArenaIndex(S32 index);
+   S32 getArenaIndex() const;
+   string getServerName() const;       // As listed; host name plus arena number
+
    bool isFull();      // More room at the inn?
 
    void addClient(ClientInfo *clientInfo);
@@ -179,6 +197,7 @@ public:
    Vector<Vector<S32> > getCategorizedPlayerCountsByTeam() const;
 
    void receivedLevelFromHoster(S32 levelIndex, const string &filename);
+   void cancelLevelPipeline();         // Throw away the level being loaded ahead of time, if any
    void makeEmptyLevelIfNoGameType();
    void cycleLevel(S32 newLevelIndex = NEXT_LEVEL);
    void sendLevelStatsToMaster();
@@ -252,6 +271,9 @@ public:
    void addNewLevel(const LevelInfo &info);
    void removeLevel(S32 index);
 
+   const LevelLoadStats &getLevelLoadStats() const;
+   void runProfileCommand(GameConnection *conn, const Vector<StringPtr> &args);
+
    void setTeamsLocked(bool locked);
 
    // SFX Related -- these will just generate an error, as they should never be called
@@ -265,6 +287,7 @@ public:
    /////
    // BotNavMeshZone management
    const Vector<BotNavMeshZone *> &getBotZoneList() const;
+   BotPathFinder &getBotPathFinder();
    GridDatabase &getBotZoneDatabase() const;
 
    U16 findZoneContaining(const Point &p) const;
@@ -200,7 +200,7 @@ TNL_IMPLEMENT_NETOBJECT(SlipZone);
 //               Fn name         Param profiles     Profile count
 #define LUA_METHODS(CLASS, METHOD) \
 /*
-   METHOD(CLASS, getSlipFactor,       ARRAYDEF({{ END }}), 1 ) \
+   METHOD(CLASS, getSlipFactor,       ARRAYDEF({{ END }}), 1, READ_ONLY ) \
 */
 
 GENERATE_LUA_METHODS_TABLE(SlipZone, LUA_METHODS);
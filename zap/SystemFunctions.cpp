@@ -9,6 +9,8 @@
 #include "GameSettings.h"
 #include "ServerGame.h"
 #include "LevelSource.h"
+#include "LevelGeometryCache.h"
+#include "config.h"           // For FolderManager
 
 #ifndef ZAP_DEDICATED
 #  include "ClientGame.h"
@@ -45,6 +47,12 @@ void initHosting(GameSettingsPtr settings, LevelSourcePtr levelSource, bool test
    Address address(IPProtocol, Address::Any, GameSettings::DEFAULT_GAME_PORT);   // Equivalent to ("IP:Any:28000")
    address.set(settings->getHostAddress());                          // May overwrite parts of address, depending on what getHostAddress contains
 
+   // Geometry cache files live alongside the INI; the server only ever reads files it wrote itself
+   if(settings->getSetting<YesNo>(IniKey::LevelGeometryCache) && settings->getFolderManager()->getIniDir() != "")
+      LevelGeometryCache::setFolder(joindir(settings->getFolderManager()->getIniDir(), "levelcache"));
+   else
+      LevelGeometryCache::setFolder("");
+
    GameManager::setServerGame(new ServerGame(address, settings, levelSource, testMode, dedicatedServer, hostOnServer));
 
    GameManager::getServerGame()->setReadyToConnectToMaster(true);
@@ -68,8 +76,28 @@ void initHosting(GameSettingsPtr settings, LevelSourcePtr levelSource, bool test
       return;
    }
 
+   // Read any level headers we don't already have indexed now, all at once, rather than one per frame while loading
+   levelSource->prefetchLevelInfos();
    GameManager::getServerGame()->resetLevelLoadIndex();
 
+   // Extra arenas share our settings, level list and script cache, so the first arena does all the level loading for them
+   U32 arenas = settings->getSetting<U32>(IniKey::Arenas);
+
+   if(dedicatedServer && !testMode && !hostOnServer)
+      for(U32 i = 1; i < arenas; i++)
+      {
+         Address arenaAddress = address;
+         arenaAddress.port = U16(address.port + i);
+
+         ServerGame *arena = new ServerGame(arenaAddress, settings, levelSource, testMode, dedicatedServer, hostOnServer);
+         arena->setArenaIndex(i);
+         arena->setReadyToConnectToMaster(true);
+
+         GameManager::addArena(arena);
+
+         logprintf(LogConsumer::ServerFilter, "Arena %d listening on %s", i + 1, arenaAddress.toString());
+      }
+
    // Does this actually do anything??
    if(hostOnServer)
       GameManager::setHostingModePhase(GameManager::DoneLoadingLevels);
@@ -974,14 +974,14 @@ bool Teleporter::canBeNeutral() { return false; }
  */
 //               Fn name                       Param profiles         Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, addDest,       ARRAYDEF({ { PT,   END }                }), 1 ) \
-   METHOD(CLASS, delDest,       ARRAYDEF({ { INT,  END }                }), 1 ) \
-   METHOD(CLASS, clearDests,    ARRAYDEF({ {       END }                }), 1 ) \
-   METHOD(CLASS, getDest,       ARRAYDEF({ { INT,  END }                }), 1 ) \
-   METHOD(CLASS, getDestCount,  ARRAYDEF({ {       END }                }), 1 ) \
-   METHOD(CLASS, setGeom,       ARRAYDEF({ { PT,   END }, { LINE, END } }), 2 ) \
-   METHOD(CLASS, getEngineered, ARRAYDEF({ {       END }                }), 1 ) \
-   METHOD(CLASS, setEngineered, ARRAYDEF({ { BOOL, END }                }), 1 ) \
+   METHOD(CLASS, addDest,       ARRAYDEF({ { PT,   END }                }), 1, READ_WRITE ) \
+   METHOD(CLASS, delDest,       ARRAYDEF({ { INT,  END }                }), 1, READ_WRITE ) \
+   METHOD(CLASS, clearDests,    ARRAYDEF({ {       END }                }), 1, READ_WRITE ) \
+   METHOD(CLASS, getDest,       ARRAYDEF({ { INT,  END }                }), 1, READ_ONLY )  \
+   METHOD(CLASS, getDestCount,  ARRAYDEF({ {       END }                }), 1, READ_ONLY )  \
+   METHOD(CLASS, setGeom,       ARRAYDEF({ { PT,   END }, { LINE, END } }), 2, READ_WRITE ) \
+   METHOD(CLASS, getEngineered, ARRAYDEF({ {       END }                }), 1, READ_ONLY )  \
+   METHOD(CLASS, setEngineered, ARRAYDEF({ { BOOL, END }                }), 1, READ_WRITE ) \
 
 GENERATE_LUA_METHODS_TABLE(Teleporter, LUA_METHODS);
 GENERATE_LUA_FUNARGS_TABLE(Teleporter, LUA_METHODS);
@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "TickSchedule.h"
+
+#include <math.h>
+
+namespace Zap
+{
+
+// Constructor
+TickSchedule::TickSchedule()
+{
+   mInterval = 10;
+   mNextTick = 0;
+   mLastTick = 0;
+   mCarry = 0;
+   mStarted = false;
+
+   resetJitterStats();
+}
+
+
+// Takes effect from the next tick, which is rescheduled to be interval after the last one
+void TickSchedule::setInterval(F64 interval)
+{
+   if(interval == mInterval)
+      return;
+
+   mInterval = interval;
+
+   if(mStarted)
+      mNextTick = mLastTick + mInterval;
+}
+
+
+F64 TickSchedule::getInterval() const
+{
+   return mInterval;
+}
+
+
+bool TickSchedule::isTickDue(F64 now) const
+{
+   return !mStarted || now >= mNextTick;
+}
+
+
+F64 TickSchedule::getNextTickTime() const
+{
+   return mStarted ? mNextTick : 0;
+}
+
+
+U32 TickSchedule::tick(F64 now)
+{
+   // First tick: start the schedule here, and pretend a normal tick's worth of time has gone by
+   if(!mStarted)
+   {
+      mStarted = true;
+      mLastTick = now;
+      mNextTick = now + mInterval;
+      mCarry = mInterval - floor(mInterval);
+
+      return U32(mInterval);
+   }
+
+   F64 lateness = now - mNextTick;
+
+   mTickCount++;
+   mLatenessSum += lateness;
+   mLatenessSquaredSum += lateness * lateness;
+
+   if(lateness > mMaxLateness)
+      mMaxLateness = lateness;
+
+   if(lateness > 1)
+      mLateTicks++;
+
+   F64 elapsed = now - mLastTick + mCarry;
+   U32 deltaT = U32(elapsed + 1e-6);      // Don't let rounding errors turn 2ms into 1.9999999ms into 1ms
+
+   mCarry = elapsed - deltaT;
+   mLastTick = now;
+   mNextTick += mInterval;
+
+   // Way behind -- maybe the machine was asleep, or a level took forever to load.  Running a pile of ticks
+   // back-to-back won't help anyone, so start over from here.
+   if(now - mNextTick > MaxTicksBehind * mInterval)
+   {
+      mNextTick = now + mInterval;
+      mResyncCount++;
+   }
+
+   return deltaT;
+}
+
+
+void TickSchedule::getJitterStats(JitterStats &stats) const
+{
+   stats.tickCount = mTickCount;
+   stats.lateTicks = mLateTicks;
+   stats.resyncCount = mResyncCount;
+   stats.maxMs = mMaxLateness;
+
+   if(mTickCount == 0)
+   {
+      stats.meanMs = 0;
+      stats.stdDevMs = 0;
+      return;
+   }
+
+   stats.meanMs = mLatenessSum / mTickCount;
+
+   F64 variance = mLatenessSquaredSum / mTickCount - stats.meanMs * stats.meanMs;
+   stats.stdDevMs = variance > 0 ? sqrt(variance) : 0;
+}
+
+
+void TickSchedule::resetJitterStats()
+{
+   mTickCount = 0;
+   mLateTicks = 0;
+   mResyncCount = 0;
+   mLatenessSum = 0;
+   mLatenessSquaredSum = 0;
+   mMaxLateness = 0;
+}
+
+
+}
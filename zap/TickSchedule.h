@@ -0,0 +1,69 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _TICK_SCHEDULE_H_
+#define _TICK_SCHEDULE_H_
+
+#include "tnlTypes.h"
+
+using namespace TNL;
+
+namespace Zap
+{
+
+// Keeps game ticks on a fixed schedule: tick n is due at n * interval, however late tick n - 1 ran, so lateness
+// doesn't pile up.  The time passed to each tick is rounded to whole milliseconds, with the leftovers carried over
+// to the next one so nothing is lost.  Also keeps track of how far off schedule the ticks actually run.
+//
+// All times are in milliseconds, from any clock that only moves forward.
+class TickSchedule
+{
+public:
+   enum {
+      MaxTicksBehind = 5,     // If we fall further behind than this, give up on catching up and start afresh
+   };
+
+   struct JitterStats
+   {
+      U32 tickCount;
+      U32 lateTicks;          // Ticks that ran more than a millisecond late
+      U32 resyncCount;        // Times we fell so far behind we gave up on the old schedule
+      F64 meanMs;             // How late ticks ran, on average
+      F64 stdDevMs;
+      F64 maxMs;
+   };
+
+private:
+   F64 mInterval;
+   F64 mNextTick;
+   F64 mLastTick;
+   F64 mCarry;                // Fractions of a millisecond not yet handed out
+   bool mStarted;
+
+   // For jitter stats
+   U32 mTickCount;
+   U32 mLateTicks;
+   U32 mResyncCount;
+   F64 mLatenessSum;
+   F64 mLatenessSquaredSum;
+   F64 mMaxLateness;
+
+public:
+   TickSchedule();            // Constructor
+
+   void setInterval(F64 interval);
+   F64 getInterval() const;
+
+   bool isTickDue(F64 now) const;
+   F64 getNextTickTime() const;
+   U32 tick(F64 now);         // Returns the time to pass to the game
+
+   void getJitterStats(JitterStats &stats) const;
+   void resetJitterStats();
+};
+
+}
+
+#endif
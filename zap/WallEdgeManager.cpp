@@ -85,6 +85,14 @@ void WallEdgeManager::rebuildEdgesWithClipper(const Vector<WallSegment const *>
    // Run clipper --> fills wallEdgePoints from wallSegments
    clipAllWallEdges(wallSegments, wallEdgePoints);
 
+   setEdges(wallEdgePoints);
+}
+
+
+// Replace our edges with ones built from wallEdgePoints, which come in pairs, as produced by clipAllWallEdges().  Lets
+// edges computed earlier (and cached) be used without going through clipper again.
+void WallEdgeManager::setEdges(const Vector<Point> &wallEdgePoints)
+{
    // Create a WallEdge object from the clipped wall geometry.  We'll add it to the WallEdgeDatabase, which will 
    // delete the object when it is ulitmately removed.
    mWallEdgeDatabase.removeEverythingFromDatabase();    // Remove the old edges
@@ -233,12 +241,12 @@ void WallEdgeManager::updateAllMountedItems(const GridDatabase *gameObjectDataba
 {
    // First, find any items directly mounted on our wall, and update their location.  Because we don't know where the wall _was_, we 
    // will need to search through all the engineered items, and query each to find which ones where attached to the wall that moved.
-   fillVector.clear();
-   gameObjectDatabase->findObjects((TestFunc)isEngineeredType, fillVector);
+   ScopedDatabaseQuery query;    // Levels can be loaded in the background, so no shared fillVector here
+   gameObjectDatabase->findObjects((TestFunc)isEngineeredType, query->results);
 
-   for(S32 i = 0; i < fillVector.size(); i++)
+   for(S32 i = 0; i < query->results.size(); i++)
    {
-      EngineeredItem *engrItem = static_cast<EngineeredItem *>(fillVector[i]);
+      EngineeredItem *engrItem = static_cast<EngineeredItem *>(query->results[i]);
       engrItem->mountToWall(engrItem->getVert(0), gameObjectDatabase, &mWallEdgeDatabase);
    }
 }
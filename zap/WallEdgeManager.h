@@ -60,6 +60,7 @@ public:
 
    //void rebuildEdges(GridDatabase *database);
    void rebuildEdges(const Vector<WallSegment const *> &wallSegments, Vector<Point> &wallEdgePoints);
+   void setEdges(const Vector<Point> &wallEdgePoints);
    static void buildWallSegmentEdgesAndPoints(DatabaseObject *object);
 
 
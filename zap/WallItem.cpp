@@ -310,8 +310,8 @@ void WallItem::addToGame(Game *game, GridDatabase *database)
  */
 //               Fn name       Param profiles  Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, getWidth,     ARRAYDEF({{      END }}), 1 ) \
-   METHOD(CLASS, setWidth,     ARRAYDEF({{ INT, END }}), 1 ) \
+   METHOD(CLASS, getWidth,     ARRAYDEF({{      END }}), 1, READ_ONLY )  \
+   METHOD(CLASS, setWidth,     ARRAYDEF({{ INT, END }}), 1, READ_WRITE ) \
 
 GENERATE_LUA_METHODS_TABLE(WallItem, LUA_METHODS);
 GENERATE_LUA_FUNARGS_TABLE(WallItem, LUA_METHODS);
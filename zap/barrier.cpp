@@ -164,6 +164,8 @@ Barrier::Barrier(const Vector<Point> &points, F32 width, bool isPolywall)
    mRenderOutlineGeometry = getCollisionPoly(); 
 
    GeomObject::setGeom(*mRenderOutlineGeometry);
+
+   mCollisionEdges.set(*getCollisionPoly());
 }
 
 
@@ -184,6 +186,13 @@ const Vector<Point> *Barrier::getCollisionPoly() const
 }
 
 
+// Invalid barriers bail out of the constructor before the edges are filled in; they get the regular tests
+const PolygonEdges *Barrier::getCollisionEdges() const
+{
+   return mCollisionEdges.getEdgeCount() > 0 ? &mCollisionEdges : NULL;
+}
+
+
 bool Barrier::collide(BfObject *otherObject)
 {
    return true;
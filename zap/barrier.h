@@ -9,6 +9,7 @@
 #include "BfObject.h"
 
 #include "Point.h"
+#include "PolygonEdges.h"
 
 #include "tnlTypes.h"
 #include "tnlVector.h"
@@ -63,6 +64,8 @@ private:
    Vector<Point> mRenderFillGeometry;        // Actual geometry used for rendering fill
    const Vector<Point> *mRenderOutlineGeometry;     // Actual geometry used for rendering outline
 
+   PolygonEdges mCollisionEdges;             // Collision poly again, for the batched collision tests; barriers never change
+
    F32 mWidth;
 
 public:
@@ -90,6 +93,7 @@ public:
 
    // Returns the collision polygon of this barrier, which is the boundary extruded from the start,end line segment
    const Vector<Point> *getCollisionPoly() const;
+   const PolygonEdges *getCollisionEdges() const;
 
    // Collide always returns true for Barrier objects
    bool collide(BfObject *otherObject);
@@ -0,0 +1,52 @@
+#
+# Server benchmark executable; hosts a level in process the same way the test suite does, so it shares its helpers
+#
+
+set(BENCH_SOURCES
+	${CMAKE_SOURCE_DIR}/bitfighter_bench/BenchBitStream.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_bench/BenchBotNavMesh.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_bench/BenchGhostConnection.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_bench/BenchGridDatabase.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_bench/BenchPolygonEdges.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_bench/BenchServerRegistry.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_bench/BenchSocket.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_bench/main_bench.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/BitStreamOpsForTesting.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/GridWorldForTesting.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/LevelFilesForTesting.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/PolygonsForTesting.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/ServerListsForTesting.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/SocketsForTesting.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/TestUtils.cpp
+)
+
+
+add_executable(bitfighter_bench EXCLUDE_FROM_ALL
+	$<TARGET_OBJECTS:bitfighter_client>
+	$<TARGET_OBJECTS:master_lib>
+	${BENCH_SOURCES}
+)
+
+target_link_libraries(bitfighter_bench
+	${CLIENT_LIBS}
+	${SHARED_LIBS}
+	gtest
+)
+
+add_dependencies(bitfighter_bench
+	bitfighter_client
+	master_lib
+	gtest
+)
+
+set_target_properties(bitfighter_bench
+	PROPERTIES
+	RUNTIME_OUTPUT_DIRECTORY ${CMAKE_SOURCE_DIR}/exe
+	COMPILE_DEFINITIONS BITFIGHTER_TEST
+)
+
+set_target_properties(bitfighter_bench PROPERTIES COMPILE_DEFINITIONS_DEBUG "TNL_DEBUG")
+
+BF_PLATFORM_SET_TARGET_PROPERTIES(bitfighter_bench)
+
+BF_PLATFORM_POST_BUILD_INSTALL_RESOURCES(bitfighter_bench)
@@ -4,19 +4,32 @@
 option(BITFIGHTER_COVERAGE "Add coverage information to the test executable and create 'coverage' target" NO)
 
 set(TEST_SOURCES
+	${CMAKE_SOURCE_DIR}/bitfighter_test/BitStreamOpsForTesting.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/GridWorldForTesting.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/LevelFilesForTesting.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/PolygonsForTesting.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/ServerListsForTesting.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/SocketsForTesting.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/TestBanList.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/TestBitStream.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/TestBotNavMesh.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/TestBotTickScheduler.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestColor.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestEditor.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestFileList.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestGame.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/TestGameRecorder.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestGameType.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestGameUserInterface.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestGeomUtils.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/TestGhostConnection.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/TestGridDatabase.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestHelpItemManager.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestHttpRequest.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestINISettings.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestInputCode.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestIntegration.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/TestLevelGeometryCache.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestLevelLoader.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestLevelSource.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestLevelMenuSelectUserInterface.cpp
@@ -25,21 +38,27 @@ set(TEST_SOURCES
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestLuaEnvironment.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestMaster.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestMove.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/TestNetInterface.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestObjectCleanup.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestObjects.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestObjectScope.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/TestPolygonEdges.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestPolylineGeometry.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/TestProfiler.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestRenderUtils.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestRobot.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestRobotManager.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestServerGame.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestSettings.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestShip.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/TestSocket.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestSpawnDelay.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestStringUtils.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestSymbolStrings.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestTeamChanging.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/TestTickSchedule.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/TestUtils.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/TestWorkerPool.cpp
 	${CMAKE_SOURCE_DIR}/bitfighter_test/main_test.cpp
 )
 
@@ -874,6 +874,7 @@ void writeServerBanList(CIniFile *ini, BanList *banList)
       ini->sectionComment("ServerBanList", "   BanItem2=123.123.123.123" + delim + wildcard + delim + "20110131T123000" + delim + "30");
       ini->sectionComment("ServerBanList", " ");
       ini->sectionComment("ServerBanList", " Note: Wildcards (" + wildcard +") may be used for IP address and nickname" );
+      ini->sectionComment("ServerBanList", " Note: Ranges of addresses may be banned with a trailing wildcard (123.123." + wildcard + ") or in CIDR form (123.123.0.0/16)" );
       ini->sectionComment("ServerBanList", " ");
       ini->sectionComment("ServerBanList", " Note: ISO time format is in the following format: YYYYMMDDTHH24MISS");
       ini->sectionComment("ServerBanList", "   YYYY = four digit year, (e.g. 2011)");
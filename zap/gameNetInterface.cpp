@@ -6,6 +6,7 @@
 #include "gameNetInterface.h"
 
 #include "game.h"
+#include "ServerGame.h"
 #include "version.h"
 
 namespace Zap
@@ -113,7 +114,7 @@ static void handleQuery(Game *game, const Address &remoteAddress, Socket &socket
       queryResponse.write(U8(GameNetInterface::QueryResponse));
 
       nonce.write(&queryResponse);
-      queryResponse.writeStringTableEntry(game->getSettings()->getHostName());
+      queryResponse.writeStringTableEntry(static_cast<ServerGame *>(game)->getServerName());
       queryResponse.writeStringTableEntry(game->getSettings()->getHostDescr());
 
       queryResponse.write(game->getPlayerCount());
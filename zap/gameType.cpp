@@ -33,6 +33,8 @@
 
 #include "Colors.h"
 
+#include "tnlProfiler.h"
+
 #include <cmath>
 
 namespace Zap
@@ -1528,9 +1530,26 @@ static void markAllMountedItemsAsBeingInScope(Ship *ship, GameConnection *conn)
 }
 
 
+// Every object a spy bug sees is in scope, regardless of team
+static void scopeSpyBugObjects(const Vector<DatabaseObject *> *objects, GameConnection *conn)
+{
+   if(!objects)
+      return;
+
+   for(S32 i = 0; i < objects->size(); i++)
+   {
+      conn->objectInScope(static_cast<BfObject *>(objects->get(i)));
+      if(isShipType(objects->get(i)->getObjectTypeNumber()))
+         markAllMountedItemsAsBeingInScope(static_cast<Ship *>(objects->get(i)), conn);
+   }
+}
+
+
 // Runs only on server
 void GameType::performScopeQuery(GhostConnection *connection)
 {
+   TNL_PROFILE_SCOPE("GameType::performScopeQuery");
+
    GameConnection *conn = (GameConnection *) connection;
    ClientInfo *clientInfo = conn->getClientInfo();
    BfObject *controlObject = conn->getControlObject();
@@ -1570,36 +1589,18 @@ void GameType::performScopeQuery(GhostConnection *connection)
       conn->objectInScope(controlObject);    
    }
 
-   // What does the spy bug see?
-   bool sameQuery = false;  // helps speed up by not repeatedly finding same objects
-
-
-   const Vector<DatabaseObject *> *spyBugs = mLevel->findObjects_fast(SpyBugTypeNumber);
-   
-   for(S32 i = spyBugs->size()-1; i >= 0; i--)
-   {
-      SpyBug *sb = static_cast<SpyBug *>(spyBugs->get(i));
-
-      if(sb->isVisibleToPlayer(clientInfo, isTeamGame()))
-      {
-         Point pos = sb->getActualPos();
-         Rect queryRect(pos, pos);
-
-         Point scopeRange(SpyBug::SPY_BUG_RANGE, SpyBug::SPY_BUG_RANGE);
-         queryRect.expand(scopeRange);
+   // What do the spy bugs see?  Searches were done once for everyone in updateInterestSets().
+   scopeSpyBugObjects(mInterestManager.getNeutralSpyBugObjects(), conn);
+   scopeSpyBugObjects(mInterestManager.getSpyBugObjects(clientInfo, isTeamGame()), conn);
+}
 
-         fillVector.clear();
-         mLevel->findObjects((TestFunc)isAnyObjectType, fillVector, queryRect, sameQuery);
-         sameQuery = true;
 
-         for(S32 j = 0; j < fillVector.size(); j++)
-         {
-            connection->objectInScope(static_cast<BfObject *>(fillVector[j]));
-            if(isShipType(fillVector[j]->getObjectTypeNumber()))
-               markAllMountedItemsAsBeingInScope(static_cast<Ship *>(fillVector[j]), conn);
-         }
-      }
-   }
+// Work out what each team's spy bugs and commander's maps can see, so that scoping individual players doesn't
+// repeat the same searches for every teammate.  Call once per tick, after everything has moved and before the
+// connections are processed.  Runs only on server.
+void GameType::updateInterestSets()
+{
+   mInterestManager.update(mGame, mLevel, isTeamGame());
 }
 
 
@@ -1631,57 +1632,39 @@ void GameType::performProxyScopeQuery(BfObject *scopeObject, ClientInfo *clientI
    GameConnection *connection = clientInfo->getConnection();
    TNLAssert(connection, "NULL gameConnection!");
 
-   if(isTeamGame() && connection->isInCommanderMap())
-   {
-      S32 teamId = clientInfo->getTeamIndex();
-      fillVector.clear();
-      bool sameQuery = false;  // Helps speed up by not repeatedly finding same objects
+   // Start with the objects within scope range of the ship
+   // Note that if we make mine visibility controlled by server, here's where we'd put the code
+   TNLAssert(dynamic_cast<Ship *>(scopeObject), "Control object is not a ship!");
+   Ship *ship = static_cast<Ship *>(scopeObject);
 
-      for(S32 i = 0; i < mGame->getClientCount(); i++)
-      {
-         ClientInfo *clientInfo = mGame->getClientInfo(i);
+   Point pos = scopeObject->getPos();
+   Rect queryRect(pos, pos);
+   queryRect.expand(Game::getScopeRange(ship->hasModule(ModuleSensor)));
 
-         if(clientInfo->getTeamIndex() != teamId)      // Wrong team
-            continue;
+   ScopedDatabaseQuery query;
+   mLevel->findObjects((TestFunc)isAnyObjectType, query->results, queryRect);
 
-         Ship *ship = clientInfo->getShip();
-         if(!ship)            // Can happen!
-            continue;
+   // Then, if this is a team game and we're looking at the commander's map, add whatever our teammates' ships
+   // show on it.  That part is shared by the whole team, and was gathered in updateInterestSets().
+   if(isTeamGame() && connection->isInCommanderMap())
+   {
+      const Vector<DatabaseObject *> *teamObjects = mInterestManager.getCmdrsMapObjects(clientInfo->getTeamIndex());
 
-         Rect queryRect(ship->getActualPos(), ship->getActualPos());
-         queryRect.expand(Game::getScopeRange(ship->hasModule(ModuleSensor)));
+      if(teamObjects)
+      {
+         S32 first = query->results.size();
 
-         TestFunc testFunc;
-         if(scopeObject == ship)    
-            testFunc = &isAnyObjectType;
-         else
-            if(ship && ship->hasModule(ModuleSensor))
-               testFunc = &isVisibleOnCmdrsMapWithSensorType;
-            else     // No sensor
-               testFunc = &isVisibleOnCmdrsMapType;
+         for(S32 i = 0; i < teamObjects->size(); i++)
+            query->results.push_back(teamObjects->get(i));
 
-         mLevel->findObjects(testFunc, fillVector, queryRect, sameQuery);
-         sameQuery = true;
+         query->removeRepeats(first);     // Skip what we already found ourselves
       }
    }
-   else     // Not a team game OR not in commander's map -- Do a simple query of the objects within scope range of the ship
-   {
-      // Note that if we make mine visibility controlled by server, here's where we'd put the code
-      Point pos = scopeObject->getPos();
-      TNLAssert(dynamic_cast<Ship *>(scopeObject), "Control object is not a ship!");
-      Ship *ship = static_cast<Ship *>(scopeObject);
-
-      Rect queryRect(pos, pos);
-      queryRect.expand(Game::getScopeRange(ship->hasModule(ModuleSensor)));
-
-      fillVector.clear();
-      mLevel->findObjects((TestFunc)isAnyObjectType, fillVector, queryRect);
-   }
 
    // Set object-in-scope for all objects found above
-   for(S32 i = 0; i < fillVector.size(); i++)
+   for(S32 i = 0; i < query->results.size(); i++)
    {
-      BfObject *obj = static_cast<BfObject *>(fillVector[i]);
+      BfObject *obj = static_cast<BfObject *>(query->results[i]);
 
       if(!obj->isVisibleToTeam(connection->getClientInfo()->getTeamIndex()))
          continue;
@@ -1689,7 +1672,7 @@ void GameType::performProxyScopeQuery(BfObject *scopeObject, ClientInfo *clientI
       connection->objectInScope(obj);
 
       // If a ship is in scope, anything it is carrying is also in scope
-      if(isShipType(fillVector[i]->getObjectTypeNumber()))
+      if(isShipType(obj->getObjectTypeNumber()))
          markAllMountedItemsAsBeingInScope(static_cast<Ship *>(obj), connection);
    }
 
@@ -2823,6 +2806,13 @@ void GameType::processServerCommand(ClientInfo *clientInfo, const char *cmd, Vec
       else
          clientInfo->getConnection()->s2cDisplayErrorMessage("!!! Need admin");
    }
+   else if(stricmp(cmd, "profile") == 0)
+   {
+      if(clientInfo->isAdmin())
+         serverGame->runProfileCommand(clientInfo->getConnection(), args);
+      else
+         clientInfo->getConnection()->s2cDisplayErrorMessage("!!! Need admin");
+   }
    else
       clientInfo->getConnection()->s2cDisplayErrorMessage("!!! Invalid Command");
 }
@@ -14,6 +14,7 @@
 #include "gameConnection.h"      // For MessageColors enum
 #include "GameTypesEnum.h"
 #include "DismountModesEnum.h"
+#include "InterestManager.h"
 
 #include "Timer.h"
 
@@ -69,6 +70,8 @@ private:
 
    bool mShowAllBots;
 
+   InterestManager mInterestManager;   // Per-tick spy bug and commander's map visibility, shared by each team
+
    bool mEngineerEnabled;
    bool mEngineerUnrestrictedEnabled;
 
@@ -370,6 +373,7 @@ public:
    virtual void shipTouchZone(Ship *ship, GoalZone *zone);
 
    void performScopeQuery(GhostConnection *connection);
+   void updateInterestSets();
    virtual void performProxyScopeQuery(BfObject *scopeObject, ClientInfo *clientInfo);
 
    virtual void onGhostAvailable(GhostConnection *theConnection);
@@ -505,8 +509,6 @@ public:
    bool addBotFromClient(Vector<StringTableEntry> args);
 
    void announceTeamsLocked(bool locked);
-
-   map <pair<U16,U16>, Vector<Point> > cachedBotFlightPlans;  // cache of zone-to-zone flight plans, shared for all bots
 };
 
 #define GAMETYPE_RPC_S2C(className, methodName, args, argNames) \
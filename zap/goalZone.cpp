@@ -289,7 +289,7 @@ void GoalZone::idle(BfObject::IdleCallPath path)
  */
 //               Fn name       Param profiles  Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, hasFlag,     ARRAYDEF({{ END }}), 1 ) \
+   METHOD(CLASS, hasFlag,     ARRAYDEF({{ END }}), 1, READ_ONLY ) \
 
 GENERATE_LUA_METHODS_TABLE(GoalZone, LUA_METHODS);
 GENERATE_LUA_FUNARGS_TABLE(GoalZone, LUA_METHODS);
@@ -8,19 +8,35 @@
 #include "Level.h"
 
 #include "GeomUtils.h"
+#include "PolygonEdges.h"
 
 #include "tnlLog.h"
 #include "tnlNetBase.h"
+#include "tnlThread.h"
+
+#include <string.h>
 
 namespace Zap
 {
 
 // Statics
-U32 GridDatabase::mQueryId = 0;
 ClassChunker<DatabaseBucketEntry> *GridDatabase::mChunker = NULL;
 U32 GridDatabase::mCountGridDatabase = 0;
+S32 GridDatabase::mThreadSafeCount = 0;
+Mutex GridDatabase::mChunkerLock;
+GridDatabase::BucketBackend GridDatabase::mDefaultBucketBackend = GridDatabase::LinkedListBuckets;
+
+
+// The ArrayBuckets backend tracks which types are present in each bucket with a U64 bitmask
+typedef char TypeNumbersMustFitInBucketTypeMask[TypesNumbers <= 64 ? 1 : -1];
+
+static inline U64 getTypeBit(U8 typeNumber)
+{
+   return U64(1) << typeNumber;
+}
 
 
+// Called with mChunkerLock held when databases are being created on several threads
 static U32 getNextId() 
 {
    static U32 nextId = 0;
@@ -30,16 +46,39 @@ static U32 getNextId()
 // Constructor
 GridDatabase::GridDatabase()
 {
+   bool threadSafe = (mThreadSafeCount > 0);
+   if(threadSafe)
+      mChunkerLock.lock();
+
    if(mChunker == NULL)
       mChunker = new ClassChunker<DatabaseBucketEntry>();        // Static shared by all databases, reference counted and deleted in destructor
 
    mCountGridDatabase++;
+   mDatabaseId = getNextId();
+
+   if(threadSafe)
+      mChunkerLock.unlock();
 
    for(U32 i = 0; i < BucketRowCount; i++)
       for(U32 j = 0; j < BucketRowCount; j++)
          mBuckets[i][j].nextInBucket = NULL;
 
-   mDatabaseId = getNextId();
+   mBucketBackend = mDefaultBucketBackend;
+
+   if(mBucketBackend == ArrayBuckets)
+   {
+      mBucketArrays = new DatabaseBucketArray[BucketRowCount * BucketRowCount];
+
+      for(U32 i = 0; i < BucketRowCount * BucketRowCount; i++)
+      {
+         mBucketArrays[i].typeMask = 0;
+         memset(mBucketArrays[i].typeCounts, 0, sizeof(mBucketArrays[i].typeCounts));
+      }
+   }
+   else
+      mBucketArrays = NULL;
+
+   mStaticObjectCount = 0;
 }
 
 
@@ -48,6 +87,12 @@ GridDatabase::~GridDatabase()
 {
    removeEverythingFromDatabase();
 
+   delete [] mBucketArrays;
+
+   bool threadSafe = (mThreadSafeCount > 0);
+   if(threadSafe)
+      mChunkerLock.lock();
+
    TNLAssert(mChunker != NULL || mCountGridDatabase != 0, "Running GridDatabase destructor without initalizing?");
 
    mCountGridDatabase--;
@@ -57,6 +102,66 @@ GridDatabase::~GridDatabase()
       delete mChunker;
       mChunker = NULL;
    }
+
+   if(threadSafe)
+      mChunkerLock.unlock();
+}
+
+
+void GridDatabase::setThreadSafe(bool threadSafe)
+{
+   if(threadSafe)
+      mThreadSafeCount++;
+   else
+   {
+      TNLAssert(mThreadSafeCount > 0, "Unbalanced GridDatabase::setThreadSafe(false)!");
+      mThreadSafeCount--;
+   }
+}
+
+
+DatabaseBucketEntry *GridDatabase::allocBucketEntry()
+{
+   if(mThreadSafeCount == 0)
+      return mChunker->alloc();
+
+   mChunkerLock.lock();
+   DatabaseBucketEntry *entry = mChunker->alloc();
+   mChunkerLock.unlock();
+
+   return entry;
+}
+
+
+void GridDatabase::freeBucketEntry(DatabaseBucketEntry *entry)
+{
+   if(mThreadSafeCount == 0)
+   {
+      mChunker->free(entry);
+      return;
+   }
+
+   mChunkerLock.lock();
+   mChunker->free(entry);
+   mChunkerLock.unlock();
+}
+
+
+void GridDatabase::setDefaultBucketBackend(BucketBackend backend)
+{
+   mDefaultBucketBackend = backend;
+}
+
+
+GridDatabase::BucketBackend GridDatabase::getDefaultBucketBackend()
+{
+   return mDefaultBucketBackend;
+}
+
+
+GridDatabase::BucketBackend GridDatabase::getBucketBackend() const
+{
+   return mBucketBackend;
 }
 
 
@@ -118,23 +223,7 @@ void GridDatabase::addToDatabase(DatabaseObject *object)
 
    object->mDatabase = this;
 
-   static IntRect bins;
-   fillBins(object->getExtent(), bins);
-
-   for(S32 x = bins.minx; bins.maxx - x >= 0; x++)
-      for(S32 y = bins.miny; bins.maxy - y >= 0; y++)
-      {
-         DatabaseBucketEntry *be = mChunker->alloc();
-         DatabaseBucketEntryBase *base = &mBuckets[x & BucketMask][y & BucketMask];
-         be->theObject = object;
-         if(base->nextInBucket)
-            base->nextInBucket->prevInBucket = be;
-         be->nextInBucket = base->nextInBucket;
-         be->prevInBucket = base;
-         base->nextInBucket = be;
-         be->nextInBucketForThisObject = object->mBucketList;
-         object->mBucketList = be;
-      }
+   addToBuckets(object);
 
    // Add the object to our non-spatial "database" as well
    mAllObjects.push_back(object);
@@ -156,6 +245,59 @@ void GridDatabase::addToDatabase(DatabaseObject *object)
 }
 
 
+// Puts object into every bucket its extent covers
+void GridDatabase::addToBuckets(DatabaseObject *object)
+{
+   IntRect bins;
+   fillBins(object->getExtent(), bins);
+
+   if(mBucketBackend == ArrayBuckets)
+   {
+      addToBucketArrays(object, bins);
+      return;
+   }
+
+   for(S32 x = bins.minx; bins.maxx - x >= 0; x++)
+      for(S32 y = bins.miny; bins.maxy - y >= 0; y++)
+      {
+         DatabaseBucketEntry *be = allocBucketEntry();
+         DatabaseBucketEntryBase *base = &mBuckets[x & BucketMask][y & BucketMask];
+         be->theObject = object;
+         if(base->nextInBucket)
+            base->nextInBucket->prevInBucket = be;
+         be->nextInBucket = base->nextInBucket;
+         be->prevInBucket = base;
+         base->nextInBucket = be;
+         be->nextInBucketForThisObject = object->mBucketList;
+         object->mBucketList = be;
+      }
+}
+
+
+// Takes object out of every bucket it's in, without otherwise removing it from the database
+void GridDatabase::removeFromBuckets(DatabaseObject *object)
+{
+   if(mBucketBackend == ArrayBuckets)
+   {
+      IntRect bins;
+      fillBins(object->mExtent, bins);
+      removeFromBucketArrays(object, bins);
+   }
+
+   while(object->mBucketList)
+   {
+      DatabaseBucketEntry *b = object->mBucketList;
+      TNLAssert(b->theObject == object, "Object mismatch");
+      TNLAssert(b->prevInBucket->nextInBucket == b, "Broken linked list");
+      if(b->nextInBucket)
+         b->nextInBucket->prevInBucket = b->prevInBucket;
+      b->prevInBucket->nextInBucket = b->nextInBucket;
+      object->mBucketList = b->nextInBucketForThisObject;
+      freeBucketEntry(b);
+   }
+}
+
+
 // Bulk add items to database
 void GridDatabase::addToDatabase(const Vector<DatabaseObject *> &objects)
 {
@@ -186,12 +328,34 @@ void GridDatabase::removeEverythingFromDatabase()
             walk->theObject->mDatabase = NULL;  // make sure object don't point to this database anymore
             walk->theObject->mBucketList = NULL;
             walk = rem->nextInBucket;
-            mChunker->free(rem);
+            freeBucketEntry(rem);
          }
          mBuckets[x & BucketMask][y & BucketMask].nextInBucket = NULL;
       }
    }
 
+   if(mBucketArrays)
+      for(S32 i = 0; i < BucketRowCount * BucketRowCount; i++)
+      {
+         Vector<DatabaseBucketRecord> &records = mBucketArrays[i].records;
+
+         for(S32 j = 0; j < records.size(); j++)
+            records[j].theObject->mDatabase = NULL;
+
+         records.clear();
+         mBucketArrays[i].typeMask = 0;
+         memset(mBucketArrays[i].typeCounts, 0, sizeof(mBucketArrays[i].typeCounts));
+      }
+
+   for(S32 i = 0; i < mStaticRecords.size(); i++)
+      if(mStaticRecords[i].theObject)
+      {
+         mStaticRecords[i].theObject->mDatabase = NULL;
+         mStaticRecords[i].theObject->mStaticRecordIndex = -1;
+      }
+
+   clearStaticIndex();
+
    // Clear out our specialty lists -- since objects are also in mAllObjects, they'll be deleted below
    mGoalZones.clear();
    mFlags.clear();
@@ -234,23 +398,12 @@ void GridDatabase::removeFromDatabase(DatabaseObject *object, bool deleteObject)
    if(object->mDatabase != this)
       return;
 
-   const Rect &extents = object->mExtent;
    object->mDatabase = NULL;
 
-   static IntRect bins;
-   fillBins(extents, bins);
-
-   while(object->mBucketList)
-   {
-      DatabaseBucketEntry *b = object->mBucketList;
-      TNLAssert(b->theObject == object, "Object mismatch");
-      TNLAssert(b->prevInBucket->nextInBucket == b, "Broken linked list");
-      if(b->nextInBucket)
-         b->nextInBucket->prevInBucket = b->prevInBucket;
-      b->prevInBucket->nextInBucket = b->nextInBucket;
-      object->mBucketList = b->nextInBucketForThisObject;
-      mChunker->free(b);
-   }
+   if(object->mStaticRecordIndex != -1)
+      removeFromStaticIndex(object);
+   else
+      removeFromBuckets(object);
 
    // Find and delete object from our non-spatial databases
    for(S32 i = 0; i < mAllObjects.size(); i++)
@@ -283,194 +436,775 @@ void GridDatabase::findObjects(Vector<DatabaseObject *> &fillVector) const
 {
    fillVector.resize(mAllObjects.size());
 
-   for(S32 i = 0; i < mAllObjects.size(); i++)
-      fillVector[i] = mAllObjects[i];
+   for(S32 i = 0; i < mAllObjects.size(); i++)
+      fillVector[i] = mAllObjects[i];
+}
+
+
+// Faster than above, but results can't be modified
+const Vector<DatabaseObject *> *GridDatabase::findObjects_fast() const
+{
+   return &mAllObjects;
+}
+
+
+// Faster than above, but results can't be modified, and only works with selected types at the moment
+const Vector<DatabaseObject *> *GridDatabase::findObjects_fast(U8 typeNumber) const
+{
+   if(typeNumber == GoalZoneTypeNumber)
+      return &mGoalZones;
+
+   if(typeNumber == FlagTypeNumber)
+      return &mFlags;
+
+   if(typeNumber == SpyBugTypeNumber)
+      return &mSpyBugs;
+
+   if(typeNumber == PolyWallTypeNumber)
+      return &mPolyWalls;
+
+   if(typeNumber == WallItemTypeNumber)
+      return &mWallitems;
+
+   TNLAssert(false, "This type not currently supported!  Sorry dude!");
+   return NULL;
+}
+
+
+// An object covering several buckets will be encountered once in each of them.  Rather than marking objects as we
+// find them (which would make every search write to shared state), we only report an object from the first bucket,
+// in search order, that it shares with the search area.  Buckets wrap every BucketRowCount, so this is all worked
+// out modulo BucketRowCount.
+static inline S32 getFirstSharedBin(S32 searchMin, S32 objectMin, S32 objectMax)
+{
+   if(((searchMin - objectMin) & GridDatabase::BucketMask) <= objectMax - objectMin)
+      return searchMin;
+
+   return searchMin + ((objectMin - searchMin) & GridDatabase::BucketMask);
+}
+
+
+// Returns true if bucket (x, y) is the one from which a search over bins should report an object with the given extent
+bool GridDatabase::isFirstSharedBin(const Rect &objectExtents, const IntRect &bins, S32 x, S32 y) const
+{
+   if(bins.minx == bins.maxx && bins.miny == bins.maxy)     // Only searching one bucket, so no repeats are possible
+      return true;
+
+   IntRect objectBins;
+   fillBins(objectExtents, objectBins);
+
+   return x == getFirstSharedBin(bins.minx, objectBins.minx, objectBins.maxx) &&
+          y == getFirstSharedBin(bins.miny, objectBins.miny, objectBins.maxy);
+}
+
+
+// Find objects in bins whose type is in typeMask and whose extents overlap ours.  Does not modify the database or the
+// objects, so any number of these can run at once.
+void GridDatabase::findObjectsInBins(U64 typeMask, Vector<DatabaseObject *> &fillVector, const Rect &extents, const IntRect &bins) const
+{
+   if(mBucketBackend == ArrayBuckets)
+   {
+      findObjectsInBucketArrays(typeMask, fillVector, extents, bins);
+      return;
+   }
+
+   for(S32 x = bins.minx; bins.maxx - x >= 0; x++)
+      for(S32 y = bins.miny; bins.maxy - y >= 0; y++)
+         for(DatabaseBucketEntry *walk = mBuckets[x & BucketMask][y & BucketMask].nextInBucket; walk; walk = walk->nextInBucket)
+         {
+            DatabaseObject *theObject = walk->theObject;
+
+            if((getTypeBit(theObject->getObjectTypeNumber()) & typeMask) &&     // Object is of the right type; and
+               theObject->mExtent.intersects(extents) &&                        // overlaps our extents; and
+               isFirstSharedBin(theObject->mExtent, bins, x, y))                // wasn't already found in another bucket
+               fillVector.push_back(theObject);
+         }
+}
+
+
+// Find all objects in database of type typeNumber
+void GridDatabase::findObjects(U8 typeNumber, Vector<DatabaseObject *> &fillVector) const
+{
+   // If the user is looking for a type we maintain a list for, it will be faster to use that list than to cycle through the general item list.
+   TNLAssert(typeNumber != GoalZoneTypeNumber && typeNumber != FlagTypeNumber && 
+             typeNumber != SpyBugTypeNumber   && typeNumber != PolyWallTypeNumber, 
+             "Can use findObjects_fast()?  If not, uncomment the appropriate block below; it will perform better!");
+
+   for(S32 i = 0; i < mAllObjects.size(); i++)
+      if(mAllObjects[i]->getObjectTypeNumber() == typeNumber)
+         fillVector.push_back(mAllObjects[i]);
+}
+
+
+// Translates extents into bins to search
+void GridDatabase::fillBins(const Rect &extents, IntRect &bins) const
+{
+   bins.minx = S32(extents.min.x) >> BucketWidthBitShift;
+   bins.miny = S32(extents.min.y) >> BucketWidthBitShift;
+   bins.maxx = S32(extents.max.x) >> BucketWidthBitShift;
+   bins.maxy = S32(extents.max.y) >> BucketWidthBitShift;
+
+   if(U32(bins.maxx - bins.minx) >= BucketRowCount)
+      bins.maxx = bins.minx + BucketRowCount - 1;
+
+   if(U32(bins.maxy - bins.miny) >= BucketRowCount)
+      bins.maxy = bins.miny + BucketRowCount - 1;
+}
+
+
+// Find all objects in &extents that are of type typeNumber
+void GridDatabase::findObjects(U8 typeNumber, Vector<DatabaseObject *> &fillVector, const Rect &extents) const
+{
+   IntRect bins;
+   fillBins(extents, bins);
+
+   findObjectsInBins(getTypeBit(typeNumber), fillVector, extents, bins);
+   findStaticObjects(getTypeBit(typeNumber), NULL, fillVector, extents);
+}
+
+
+// Same as above, but type is determined by testFunc
+void GridDatabase::findObjectsInBins(TestFunc testFunc, Vector<DatabaseObject *> &fillVector, const Rect &extents, const IntRect &bins) const
+{
+   TNLAssert(this, "findObjects 'this' is NULL");
+
+   if(mBucketBackend == ArrayBuckets)
+   {
+      findObjectsInBucketArrays(testFunc, fillVector, extents, bins);
+      return;
+   }
+
+   for(S32 x = bins.minx; bins.maxx - x >= 0; x++)
+      for(S32 y = bins.miny; bins.maxy - y >= 0; y++)
+         for(DatabaseBucketEntry *walk = mBuckets[x & BucketMask][y & BucketMask].nextInBucket; walk; walk = walk->nextInBucket)
+         {
+            DatabaseObject *theObject = walk->theObject;
+
+            if(testFunc(theObject->getObjectTypeNumber()) &&         // Object is of the right type; and
+               theObject->mExtent.intersects(extents) &&             // overlaps our extents; and
+               isFirstSharedBin(theObject->mExtent, bins, x, y))     // wasn't already found in another bucket
+               fillVector.push_back(theObject);
+         }
+}
+
+
+// Find all objects in database using derived type test function
+void GridDatabase::findObjects(TestFunc testFunc, Vector<DatabaseObject *> &fillVector) const
+{
+   for(S32 i = 0; i < mAllObjects.size(); i++)
+      if(testFunc(mAllObjects[i]->getObjectTypeNumber()))
+         fillVector.push_back(mAllObjects[i]);
+}
+
+
+// Find all objects in &extents with any of the specified types
+void GridDatabase::findObjects(const Vector<U8> &types, Vector<DatabaseObject *> &fillVector, const Rect &extents) const
+{
+   IntRect bins;
+   fillBins(extents, bins);
+
+   U64 typeMask = 0;
+   for(S32 i = 0; i < types.size(); i++)
+      typeMask |= getTypeBit(types[i]);
+
+   findObjectsInBins(typeMask, fillVector, extents, bins);
+   findStaticObjects(typeMask, NULL, fillVector, extents);
+}
+
+
+// Find all objects in database using derived type test function
+void GridDatabase::findObjects(const Vector<U8> &types, Vector<DatabaseObject *> &fillVector) const
+{
+   for(S32 i = 0; i < mAllObjects.size(); i++)
+      if(testTypes(types, mAllObjects[i]->getObjectTypeNumber()))
+         fillVector.push_back(mAllObjects[i]);
+}
+
+
+bool GridDatabase::testTypes(const Vector<U8> &types, U8 objectType) const
+{
+   for(S32 i = 0; i < types.size(); i++)
+      if(types[i] == objectType)
+         return true;
+
+   return false;
+}
+
+
+// Find all objects in &extents derived type test function
+void GridDatabase::findObjects(TestFunc testFunc, Vector<DatabaseObject *> &fillVector, const Rect &extents) const
+{
+   IntRect bins;
+   fillBins(extents, bins);
+
+   findObjectsInBins(testFunc, fillVector, extents, bins);
+   findStaticObjects(getStaticTypeMask(testFunc), testFunc, fillVector, extents);
+}
+
+
+// The DatabaseQuery versions work like those above, but when several searches are made with the same query,
+// objects already found by an earlier search won't be added again
+void GridDatabase::findObjects(DatabaseQuery &query, U8 typeNumber, const Rect &extents) const
+{
+   S32 first = query.results.size();
+   findObjects(typeNumber, query.results, extents);
+   query.removeRepeats(first);
+}
+
+
+void GridDatabase::findObjects(DatabaseQuery &query, TestFunc testFunc, const Rect &extents) const
+{
+   S32 first = query.results.size();
+   findObjects(testFunc, query.results, extents);
+   query.removeRepeats(first);
+}
+
+
+void GridDatabase::findObjects(DatabaseQuery &query, const Vector<U8> &types, const Rect &extents) const
+{
+   S32 first = query.results.size();
+   findObjects(types, query.results, extents);
+   query.removeRepeats(first);
+}
+
+
+void GridDatabase::findObjects(DatabaseQuery &query, TestFunc testFunc) const
+{
+   S32 first = query.results.size();
+   findObjects(testFunc, query.results);
+   query.removeRepeats(first);
+}
+
+
+void GridDatabase::findObjects(DatabaseQuery &query, const Vector<U8> &types) const
+{
+   S32 first = query.results.size();
+   findObjects(types, query.results);
+   query.removeRepeats(first);
+}
+
+
+void GridDatabase::dumpObjects()
+{
+   for(S32 x = 0; x < BucketRowCount; x++)
+      for(S32 y = 0; y < BucketRowCount; y++)
+      {
+         for(DatabaseBucketEntry *walk = mBuckets[x & BucketMask][y & BucketMask].nextInBucket; walk; walk = walk->nextInBucket)
+         {
+            DatabaseObject *object = walk->theObject;
+            logprintf("Found object in (%d,%d) with extents %s", x, y, object->getExtent().toString().c_str());
+            logprintf("Obj coords: %s", static_cast<BfObject *>(object)->getPos().toString().c_str());
+         }
+
+         if(mBucketArrays)
+         {
+            const Vector<DatabaseBucketRecord> &records = getBucketArray(x, y).records;
+
+            for(S32 i = 0; i < records.size(); i++)
+            {
+               DatabaseObject *object = records[i].theObject;
+               logprintf("Found object in (%d,%d) with extents %s", x, y, object->getExtent().toString().c_str());
+               logprintf("Obj coords: %s", static_cast<BfObject *>(object)->getPos().toString().c_str());
+            }
+         }
+      }
+
+   for(S32 i = 0; i < mStaticRecords.size(); i++)
+   {
+      DatabaseObject *object = mStaticRecords[i].theObject;
+      if(!object)
+         continue;
+
+      logprintf("Found object in static index with extents %s", object->getExtent().toString().c_str());
+      logprintf("Obj coords: %s", static_cast<BfObject *>(object)->getPos().toString().c_str());
+   }
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+// ArrayBuckets backend
+
+DatabaseBucketArray &GridDatabase::getBucketArray(S32 x, S32 y) const
+{
+   return mBucketArrays[(x & BucketMask) * BucketRowCount + (y & BucketMask)];
+}
+
+
+// Returns the slot in DatabaseObject::mBucketRecordIndex used for bucket (x, y), or -1 if the object
+// occupying bins is too large to have its record positions tracked
+static S32 getRecordIndexSlot(const IntRect &bins, S32 x, S32 y)
+{
+   if(bins.maxx - bins.minx > 1 || bins.maxy - bins.miny > 1)
+      return -1;
+
+   for(S32 i = 0; bins.maxx - (bins.minx + i) >= 0; i++)
+      for(S32 j = 0; bins.maxy - (bins.miny + j) >= 0; j++)
+         if(((bins.minx + i) & GridDatabase::BucketMask) == (x & GridDatabase::BucketMask) && 
+            ((bins.miny + j) & GridDatabase::BucketMask) == (y & GridDatabase::BucketMask))
+            return i * 2 + j;
+
+   TNLAssert(false, "Bucket not in bins!");
+   return -1;
+}
+
+
+// Returns index of object's record in the specified bucket
+static S32 findRecordIndex(const DatabaseBucketArray &bucket, const DatabaseObject *object, S32 slot, const S32 *recordIndex)
+{
+   if(slot != -1)
+   {
+      TNLAssert(bucket.records[recordIndex[slot]].theObject == object, "Record index out of sync!");
+      return recordIndex[slot];
+   }
+
+   for(S32 i = 0; i < bucket.records.size(); i++)
+      if(bucket.records[i].theObject == object)
+         return i;
+
+   TNLAssert(false, "Object not found in bucket!");
+   return -1;
+}
+
+
+void GridDatabase::addToBucketArrays(DatabaseObject *object, const IntRect &bins)
+{
+   DatabaseBucketRecord record;
+   record.theObject  = object;
+   record.extent     = object->getExtent();
+   record.typeNumber = object->getObjectTypeNumber();
+
+   U64 typeBit = getTypeBit(record.typeNumber);
+
+   for(S32 x = bins.minx; bins.maxx - x >= 0; x++)
+      for(S32 y = bins.miny; bins.maxy - y >= 0; y++)
+      {
+         DatabaseBucketArray &bucket = getBucketArray(x, y);
+
+         S32 slot = getRecordIndexSlot(bins, x, y);
+         if(slot != -1)
+            object->mBucketRecordIndex[slot] = bucket.records.size();
+
+         bucket.records.push_back(record);
+         bucket.typeMask |= typeBit;
+         bucket.typeCounts[record.typeNumber]++;
+      }
+}
+
+
+// Swap-remove object's record from each bucket it occupies
+void GridDatabase::removeFromBucketArrays(DatabaseObject *object, const IntRect &bins)
+{
+   for(S32 x = bins.minx; bins.maxx - x >= 0; x++)
+      for(S32 y = bins.miny; bins.maxy - y >= 0; y++)
+      {
+         DatabaseBucketArray &bucket = getBucketArray(x, y);
+         Vector<DatabaseBucketRecord> &records = bucket.records;
+
+         S32 index = findRecordIndex(bucket, object, getRecordIndexSlot(bins, x, y), object->mBucketRecordIndex);
+         if(index == -1)
+            continue;
+
+         U8 type = records[index].typeNumber;
+         if(--bucket.typeCounts[type] == 0)
+            bucket.typeMask &= ~getTypeBit(type);
+
+         S32 last = records.size() - 1;
+
+         if(index != last)
+         {
+            // Move last record into the hole, and tell its object where it went
+            records[index] = records[last];
+
+            DatabaseObject *moved = records[index].theObject;
+            IntRect movedBins;
+            fillBins(records[index].extent, movedBins);
+
+            S32 slot = getRecordIndexSlot(movedBins, x, y);
+            if(slot != -1)
+               moved->mBucketRecordIndex[slot] = index;
+         }
+
+         records.pop_back();
+      }
+}
+
+
+// Object is staying in the same buckets, so just refresh the copies of its extent
+void GridDatabase::updateBucketArrayExtents(DatabaseObject *object, const IntRect &bins, const Rect &newExtents)
+{
+   for(S32 x = bins.minx; bins.maxx - x >= 0; x++)
+      for(S32 y = bins.miny; bins.maxy - y >= 0; y++)
+      {
+         DatabaseBucketArray &bucket = getBucketArray(x, y);
+
+         S32 index = findRecordIndex(bucket, object, getRecordIndexSlot(bins, x, y), object->mBucketRecordIndex);
+         if(index != -1)
+            bucket.records[index].extent = newExtents;
+      }
+}
+
+
+// Objects get their type changed to DeletedTypeNumber while they are still in the database, so the type stored
+// in the record is only used to reject candidates; anything that passes gets checked against its current type.
+void GridDatabase::findObjectsInBucketArrays(U64 typeMask, Vector<DatabaseObject *> &fillVector, const Rect &extents, const IntRect &bins) const
+{
+   for(S32 x = bins.minx; bins.maxx - x >= 0; x++)
+      for(S32 y = bins.miny; bins.maxy - y >= 0; y++)
+      {
+         const DatabaseBucketArray &bucket = getBucketArray(x, y);
+
+         if(!(bucket.typeMask & typeMask))      // Nothing of interest in this bucket
+            continue;
+
+         const DatabaseBucketRecord *records = bucket.records.address();
+         const S32 count = bucket.records.size();
+
+         for(S32 i = 0; i < count; i++)
+         {
+            const DatabaseBucketRecord &record = records[i];
+
+            if(!(getTypeBit(record.typeNumber) & typeMask))
+               continue;
+
+            if(!record.extent.intersects(extents) || !isFirstSharedBin(record.extent, bins, x, y))
+               continue;
+
+            if(getTypeBit(record.theObject->getObjectTypeNumber()) & typeMask)
+               fillVector.push_back(record.theObject);
+         }
+      }
+}
+
+
+// Same as above, but we only know which types are wanted by asking testFunc.  We do that lazily, once per
+// type number actually encountered, and then use the resulting mask just as in the type-list version.
+void GridDatabase::findObjectsInBucketArrays(TestFunc testFunc, Vector<DatabaseObject *> &fillVector, const Rect &extents, const IntRect &bins) const
+{
+   U64 testedTypes = 0;
+   U64 acceptedTypes = 0;
+
+   for(S32 x = bins.minx; bins.maxx - x >= 0; x++)
+      for(S32 y = bins.miny; bins.maxy - y >= 0; y++)
+      {
+         const DatabaseBucketArray &bucket = getBucketArray(x, y);
+
+         U64 untestedTypes = bucket.typeMask & ~testedTypes;
+
+         for(U8 type = 0; untestedTypes; type++, untestedTypes >>= 1)
+            if(untestedTypes & 1)
+            {
+               testedTypes |= getTypeBit(type);
+               if(testFunc(type))
+                  acceptedTypes |= getTypeBit(type);
+            }
+
+         if(!(bucket.typeMask & acceptedTypes))
+            continue;
+
+         const DatabaseBucketRecord *records = bucket.records.address();
+         const S32 count = bucket.records.size();
+
+         for(S32 i = 0; i < count; i++)
+         {
+            const DatabaseBucketRecord &record = records[i];
+
+            if(!(getTypeBit(record.typeNumber) & acceptedTypes))
+               continue;
+
+            if(!record.extent.intersects(extents) || !isFirstSharedBin(record.extent, bins, x, y))
+               continue;
+
+            if(testFunc(record.theObject->getObjectTypeNumber()))
+               fillVector.push_back(record.theObject);
+         }
+      }
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+// Static geometry index
+
+// Leaves hold at most this many records
+static const S32 StaticIndexLeafSize = 4;
+
+// Nodes are split in half, so the index is never deeper than log2 of its record count; this is plenty
+static const S32 StaticIndexMaxStack = 64;
+
+
+void GridDatabase::buildStaticIndex(TestFunc isStatic)
+{
+   Vector<DatabaseBucketRecord> records;
+
+   // Anything already indexed stays indexed
+   for(S32 i = 0; i < mStaticRecords.size(); i++)
+      if(mStaticRecords[i].theObject)
+         records.push_back(mStaticRecords[i]);
+
+   for(S32 i = 0; i < mAllObjects.size(); i++)
+   {
+      DatabaseObject *object = mAllObjects[i];
+
+      if(object->mStaticRecordIndex != -1 || !isStatic(object->getObjectTypeNumber()))
+         continue;
+
+      removeFromBuckets(object);
+
+      DatabaseBucketRecord record;
+      record.theObject  = object;
+      record.extent     = object->getExtent();
+      record.typeNumber = object->getObjectTypeNumber();
+
+      records.push_back(record);
+   }
+
+   clearStaticIndex();
+
+   if(records.size() == 0)
+      return;
+
+   mStaticRecords = records;
+   mStaticObjectCount = records.size();
+
+   mStaticNodes.reserve(2 * (records.size() / StaticIndexLeafSize + 1));
+   mStaticNodes.resize(1);
+   buildStaticIndexNode(0, 0, records.size());
+
+   for(S32 i = 0; i < mStaticRecords.size(); i++)
+      mStaticRecords[i].theObject->mStaticRecordIndex = i;
+}
+
+
+S32 GridDatabase::getStaticObjectCount() const
+{
+   return mStaticObjectCount;
+}
+
+
+static S32 QSORT_CALLBACK compareRecordCentersX(DatabaseBucketRecord *a, DatabaseBucketRecord *b)
+{
+   F32 ax = a->extent.min.x + a->extent.max.x;
+   F32 bx = b->extent.min.x + b->extent.max.x;
+
+   return ax < bx ? -1 : ax > bx ? 1 : 0;
 }
 
 
-// Faster than above, but results can't be modified
-const Vector<DatabaseObject *> *GridDatabase::findObjects_fast() const
+static S32 QSORT_CALLBACK compareRecordCentersY(DatabaseBucketRecord *a, DatabaseBucketRecord *b)
 {
-   return &mAllObjects;
+   F32 ay = a->extent.min.y + a->extent.max.y;
+   F32 by = b->extent.min.y + b->extent.max.y;
+
+   return ay < by ? -1 : ay > by ? 1 : 0;
 }
 
 
-// Faster than above, but results can't be modified, and only works with selected types at the moment
-const Vector<DatabaseObject *> *GridDatabase::findObjects_fast(U8 typeNumber) const
+// Fills in node nodeIndex to cover count records starting at first, splitting them in half along whichever axis
+// their centers are most spread out on until they fit in a leaf.  Reorders mStaticRecords as it goes.
+void GridDatabase::buildStaticIndexNode(S32 nodeIndex, S32 first, S32 count)
 {
-   if(typeNumber == GoalZoneTypeNumber)
-      return &mGoalZones;
+   Rect bounds = mStaticRecords[first].extent;
+   Rect centers(mStaticRecords[first].extent.getCenter(), mStaticRecords[first].extent.getCenter());
+   U64 typeMask = 0;
 
-   if(typeNumber == FlagTypeNumber)
-      return &mFlags;
+   for(S32 i = first; i < first + count; i++)
+   {
+      bounds.unionRect(mStaticRecords[i].extent);
+      centers.unionPoint(mStaticRecords[i].extent.getCenter());
+      typeMask |= getTypeBit(mStaticRecords[i].typeNumber);
+   }
 
-   if(typeNumber == SpyBugTypeNumber)
-      return &mSpyBugs;
+   // mStaticNodes grows as we recurse, so don't hang on to references into it
+   mStaticNodes[nodeIndex].bounds = bounds;
+   mStaticNodes[nodeIndex].typeMask = typeMask;
 
-   if(typeNumber == PolyWallTypeNumber)
-      return &mPolyWalls;
+   if(count <= StaticIndexLeafSize)
+   {
+      mStaticNodes[nodeIndex].first = first;
+      mStaticNodes[nodeIndex].count = count;
+      return;
+   }
 
-   if(typeNumber == WallItemTypeNumber)
-      return &mWallitems;
+   qsort_compare_func compare = (qsort_compare_func)
+         (centers.getWidth() >= centers.getHeight() ? compareRecordCentersX : compareRecordCentersY);
 
-   TNLAssert(false, "This type not currently supported!  Sorry dude!");
-   return NULL;
+   qsort(&mStaticRecords[first], count, sizeof(DatabaseBucketRecord), compare);
+
+   S32 children = mStaticNodes.size();
+   mStaticNodes.resize(children + 2);
+
+   mStaticNodes[nodeIndex].first = children;
+   mStaticNodes[nodeIndex].count = 0;
+
+   buildStaticIndexNode(children,     first,             count / 2);
+   buildStaticIndexNode(children + 1, first + count / 2, count - count / 2);
 }
 
 
-void GridDatabase::findObjects(U8 typeNumber, Vector<DatabaseObject *> &fillVector, const Rect *extents, const IntRect *bins) const
+// Leaves the node bounds alone -- they're now a little bigger than they need to be, which does no harm
+void GridDatabase::removeFromStaticIndex(DatabaseObject *object)
 {
-   static Vector<U8> types;
-   types.resize(1);
+   TNLAssert(mStaticRecords[object->mStaticRecordIndex].theObject == object, "Static index out of sync!");
+
+   mStaticRecords[object->mStaticRecordIndex].theObject = NULL;
+   object->mStaticRecordIndex = -1;
+   mStaticObjectCount--;
+}
 
-   types[0] = typeNumber;
 
-   findObjects(types, fillVector, extents, bins);
+void GridDatabase::clearStaticIndex()
+{
+   mStaticRecords.clear();
+   mStaticNodes.clear();
+   mStaticObjectCount = 0;
 }
 
 
-void GridDatabase::findObjects(Vector<U8> typeNumbers, Vector<DatabaseObject *> &fillVector, const Rect *extents, const IntRect *bins) const
+// Works out which of the types in the static index testFunc wants, so the index can be searched with a mask
+U64 GridDatabase::getStaticTypeMask(TestFunc testFunc) const
 {
-   mQueryId++;    // Used to prevent the same item from being found in multiple buckets
+   if(mStaticNodes.size() == 0)
+      return 0;
 
-   for(S32 x = bins->minx; bins->maxx - x >= 0; x++)
-      for(S32 y = bins->miny; bins->maxy - y >= 0; y++)
-         for(DatabaseBucketEntry *walk = mBuckets[x & BucketMask][y & BucketMask].nextInBucket; walk; walk = walk->nextInBucket)
-         {
-            DatabaseObject *theObject = walk->theObject;
+   U64 typeMask = 0;
+   U64 indexedTypes = mStaticNodes[0].typeMask;
 
-            if(theObject->mLastQueryId != mQueryId &&                         // Object hasn't been queried; and
-               testTypes(typeNumbers, theObject->getObjectTypeNumber()) &&    // is of the right type; and
-               (!extents || theObject->mExtent.intersects(*extents)) )        // overlaps our extents (if passed)
-            {
-               walk->theObject->mLastQueryId = mQueryId;    // Flag the object so we know we've already visited it
-               fillVector.push_back(walk->theObject);       // And save it as a found item
-            }
-         }
+   for(U8 type = 0; indexedTypes; type++, indexedTypes >>= 1)
+      if((indexedTypes & 1) && testFunc(type))
+         typeMask |= getTypeBit(type);
+
+   return typeMask;
 }
 
 
-// Find all objects in database of type typeNumber
-void GridDatabase::findObjects(U8 typeNumber, Vector<DatabaseObject *> &fillVector) const
+// Slab test.  It's a little generous, so that rounding never costs us something the segment only grazes.
+static bool segmentTouchesRect(const Point &start, const Point &end, const Rect &rect)
 {
-   // If the user is looking for a type we maintain a list for, it will be faster to use that list than to cycle through the general item list.
-   TNLAssert(typeNumber != GoalZoneTypeNumber && typeNumber != FlagTypeNumber && 
-             typeNumber != SpyBugTypeNumber   && typeNumber != PolyWallTypeNumber, 
-             "Can use findObjects_fast()?  If not, uncomment the appropriate block below; it will perform better!");
+   const F32 Tolerance = 0.01f;
 
-   for(S32 i = 0; i < mAllObjects.size(); i++)
-      if(mAllObjects[i]->getObjectTypeNumber() == typeNumber)
-         fillVector.push_back(mAllObjects[i]);
-}
+   const F32 starts[2] = { start.x, start.y };
+   const F32 deltas[2] = { end.x - start.x, end.y - start.y };
+   const F32 mins[2]   = { rect.min.x - Tolerance, rect.min.y - Tolerance };
+   const F32 maxs[2]   = { rect.max.x + Tolerance, rect.max.y + Tolerance };
 
+   F32 enter = 0;
+   F32 exit = 1;
 
-// Translates extents into bins to search
-void GridDatabase::fillBins(const Rect &extents, IntRect &bins) const
-{
-   bins.minx = S32(extents.min.x) >> BucketWidthBitShift;
-   bins.miny = S32(extents.min.y) >> BucketWidthBitShift;
-   bins.maxx = S32(extents.max.x) >> BucketWidthBitShift;
-   bins.maxy = S32(extents.max.y) >> BucketWidthBitShift;
+   for(S32 i = 0; i < 2; i++)
+   {
+      if(deltas[i] == 0)
+      {
+         if(starts[i] < mins[i] || starts[i] > maxs[i])
+            return false;
 
-   if(U32(bins.maxx - bins.minx) >= BucketRowCount)
-      bins.maxx = bins.minx + BucketRowCount - 1;
+         continue;
+      }
 
-   if(U32(bins.maxy - bins.miny) >= BucketRowCount)
-      bins.maxy = bins.miny + BucketRowCount - 1;
-}
+      F32 t1 = (mins[i] - starts[i]) / deltas[i];
+      F32 t2 = (maxs[i] - starts[i]) / deltas[i];
 
+      if(t1 > t2)
+      {
+         F32 temp = t1;
+         t1 = t2;
+         t2 = temp;
+      }
 
-// Find all objects in &extents that are of type typeNumber
-void GridDatabase::findObjects(U8 typeNumber, Vector<DatabaseObject *> &fillVector, const Rect &extents) const
-{
-   static IntRect bins;
-   fillBins(extents, bins);
+      if(t1 > enter)  enter = t1;
+      if(t2 < exit)   exit = t2;
+
+      if(enter > exit)
+         return false;
+   }
 
-   findObjects(typeNumber, fillVector, &extents, &bins);
+   return true;
 }
 
 
-void GridDatabase::findObjects(TestFunc testFunc, Vector<DatabaseObject *> &fillVector, const Rect *extents, const IntRect *bins, bool sameQuery) const
+// As with the ArrayBuckets backend, types stored in the records are only used to reject candidates, since objects
+// get their type changed to DeletedTypeNumber while still in the database.  If testFunc is given, it has the final
+// say; otherwise typeMask does.  If ray is given, anything the segment from ray[0] to ray[1] misses is skipped.
+static void searchStaticIndex(const Vector<StaticIndexNode> &nodes, const Vector<DatabaseBucketRecord> &records,
+                              U64 typeMask, TestFunc testFunc, const Rect &extents, const Point *ray,
+                              Vector<DatabaseObject *> &fillVector)
 {
-   TNLAssert(this, "findObjects 'this' is NULL");
-   if(!sameQuery)
-      mQueryId++;    // Used to prevent the same item from being found in multiple buckets
+   if(nodes.size() == 0 || !typeMask)
+      return;
 
-   for(S32 x = bins->minx; bins->maxx - x >= 0; x++)
-      for(S32 y = bins->miny; bins->maxy - y >= 0; y++)
-         for(DatabaseBucketEntry *walk = mBuckets[x & BucketMask][y & BucketMask].nextInBucket; walk; walk = walk->nextInBucket)
-         {
-            DatabaseObject *theObject = walk->theObject;
+   S32 stack[StaticIndexMaxStack];
+   S32 stackSize = 0;
 
-            if(theObject->mLastQueryId != mQueryId &&                      // Object hasn't been queried; and
-               (testFunc(theObject->getObjectTypeNumber())) &&             // is of the right type; and
-               (!extents || theObject->mExtent.intersects(*extents)) )     // overlaps our extents (if passed)
-            {
-               walk->theObject->mLastQueryId = mQueryId;    // Flag the object so we know we've already visited it
-               fillVector.push_back(walk->theObject);       // And save it as a found item
-            }
-         }
-}
+   stack[stackSize++] = 0;
 
+   while(stackSize > 0)
+   {
+      const StaticIndexNode &node = nodes[stack[--stackSize]];
 
-// Find all objects in database using derived type test function
-void GridDatabase::findObjects(TestFunc testFunc, Vector<DatabaseObject *> &fillVector) const
-{
-   for(S32 i = 0; i < mAllObjects.size(); i++)
-      if(testFunc(mAllObjects[i]->getObjectTypeNumber()))
-         fillVector.push_back(mAllObjects[i]);
-}
+      if(!(node.typeMask & typeMask) || !node.bounds.intersects(extents))
+         continue;
 
+      if(ray && !segmentTouchesRect(ray[0], ray[1], node.bounds))
+         continue;
 
-// Find all objects in database using derived type test function
-void GridDatabase::findObjects(const Vector<U8> &types, Vector<DatabaseObject *> &fillVector, const Rect &extents) const
-{
-   static IntRect bins;
-   fillBins(extents, bins);
+      if(node.count == 0)
+      {
+         TNLAssert(stackSize + 2 <= StaticIndexMaxStack, "Static index too deep!");
+         stack[stackSize++] = node.first + 1;
+         stack[stackSize++] = node.first;
+         continue;
+      }
+
+      for(S32 i = node.first; i < node.first + node.count; i++)
+      {
+         const DatabaseBucketRecord &record = records[i];
+
+         if(!record.theObject || !(getTypeBit(record.typeNumber) & typeMask) || !record.extent.intersects(extents))
+            continue;
 
-   findObjects(types, fillVector, &extents, &bins);
+         if(ray && !segmentTouchesRect(ray[0], ray[1], record.extent))
+            continue;
+
+         U8 type = record.theObject->getObjectTypeNumber();
+
+         if(testFunc ? testFunc(type) : (getTypeBit(type) & typeMask) != 0)
+            fillVector.push_back(record.theObject);
+      }
+   }
 }
 
 
-// Find all objects in database using derived type test function
-void GridDatabase::findObjects(const Vector<U8> &types, Vector<DatabaseObject *> &fillVector) const
+void GridDatabase::findStaticObjects(U64 typeMask, TestFunc testFunc, Vector<DatabaseObject *> &fillVector, const Rect &extents) const
 {
-   for(S32 i = 0; i < mAllObjects.size(); i++)
-      if(testTypes(types, mAllObjects[i]->getObjectTypeNumber()))
-         fillVector.push_back(mAllObjects[i]);
+   searchStaticIndex(mStaticNodes, mStaticRecords, typeMask, testFunc, extents, NULL, fillVector);
 }
 
 
-bool GridDatabase::testTypes(const Vector<U8> &types, U8 objectType) const
+void GridDatabase::findStaticObjectsAlongRay(U64 typeMask, TestFunc testFunc, Vector<DatabaseObject *> &fillVector,
+                                             const Point &rayStart, const Point &rayEnd) const
 {
-   for(S32 i = 0; i < types.size(); i++)
-      if(types[i] == objectType)
-         return true;
-
-   return false;
+   const Point ray[2] = { rayStart, rayEnd };
+   searchStaticIndex(mStaticNodes, mStaticRecords, typeMask, testFunc, Rect(rayStart, rayEnd), ray, fillVector);
 }
 
 
-// Find all objects in &extents derived type test function
-void GridDatabase::findObjects(TestFunc testFunc, Vector<DatabaseObject *> &fillVector, const Rect &extents, bool sameQuery) const
+// Candidates for a line of sight check: everything whose extent overlaps the ray's bounding box, less any static
+// geometry the ray doesn't actually pass through.  When testFunc is given, typeMask only needs to cover the types
+// in the static index.
+void GridDatabase::findObjectsAlongRay(U64 typeMask, TestFunc testFunc, Vector<DatabaseObject *> &fillVector,
+                                       const Point &rayStart, const Point &rayEnd) const
 {
-   static IntRect bins;
-   fillBins(extents, bins);
+   Rect queryRect(rayStart, rayEnd);
 
-   findObjects(testFunc, fillVector, &extents, &bins, sameQuery);
-}
+   IntRect bins;
+   fillBins(queryRect, bins);
 
+   if(testFunc)
+      findObjectsInBins(testFunc, fillVector, queryRect, bins);
+   else
+      findObjectsInBins(typeMask, fillVector, queryRect, bins);
 
-void GridDatabase::dumpObjects()
-{
-   for(S32 x = 0; x < BucketRowCount; x++)
-      for(S32 y = 0; y < BucketRowCount; y++)
-         for(DatabaseBucketEntry *walk = mBuckets[x & BucketMask][y & BucketMask].nextInBucket; walk; walk = walk->nextInBucket)
-         {
-            DatabaseObject *object = walk->theObject;
-            logprintf("Found object in (%d,%d) with extents %s", x, y, object->getExtent().toString().c_str());
-            logprintf("Obj coords: %s", static_cast<BfObject *>(object)->getPos().toString().c_str());
-         }
+   findStaticObjectsAlongRay(typeMask, testFunc, fillVector, rayStart, rayEnd);
 }
 
 
@@ -528,6 +1262,189 @@ Rect GridDatabase::getExtents()
 ////////////////////////////////////////
 ////////////////////////////////////////
 
+// Constructor
+DatabaseQuery::DatabaseQuery()
+{
+   mVisitStamp = 1;
+   mVisitedCount = 0;
+   mRecordedCount = 0;
+}
+
+
+void DatabaseQuery::clear()
+{
+   results.clear();
+   resetVisited();
+}
+
+
+void DatabaseQuery::resetVisited()
+{
+   mVisitStamp++;
+   if(mVisitStamp == 0)    // Wrapped -- old stamps could now look current, so wipe them
+   {
+      for(S32 i = 0; i < mVisitStamps.size(); i++)
+         mVisitStamps[i] = 0;
+      mVisitStamp = 1;
+   }
+
+   mVisitedCount = 0;
+   mRecordedCount = 0;
+}
+
+
+static inline U32 hashObjectPointer(const DatabaseObject *object)
+{
+   return U32(size_t(object) >> 3) * 2654435761u;
+}
+
+
+// Open-addressed set of objects, where a slot is only in use if its stamp matches mVisitStamp
+bool DatabaseQuery::markVisited(DatabaseObject *object)
+{
+   if((mVisitedCount + 1) * 2 > mVisitKeys.size())
+      growVisitTable();
+
+   U32 mask = U32(mVisitKeys.size() - 1);
+
+   for(U32 slot = hashObjectPointer(object) & mask; ; slot = (slot + 1) & mask)
+   {
+      if(mVisitStamps[slot] != mVisitStamp)
+      {
+         mVisitStamps[slot] = mVisitStamp;
+         mVisitKeys[slot] = object;
+         mVisitedCount++;
+         return true;
+      }
+
+      if(mVisitKeys[slot] == object)
+         return false;
+   }
+}
+
+
+void DatabaseQuery::growVisitTable()
+{
+   Vector<DatabaseObject *> oldKeys = mVisitKeys;
+   Vector<U32> oldStamps = mVisitStamps;
+   U32 oldStamp = mVisitStamp;
+
+   S32 size = mVisitKeys.size() ? mVisitKeys.size() * 2 : 64;    // Must stay a power of 2
+
+   mVisitKeys.resize(size);
+   mVisitStamps.resize(size);
+
+   for(S32 i = 0; i < size; i++)
+      mVisitStamps[i] = 0;
+
+   mVisitStamp = 1;
+   mVisitedCount = 0;
+
+   for(S32 i = 0; i < oldKeys.size(); i++)
+      if(oldStamps[i] == oldStamp)
+         markVisited(oldKeys[i]);
+}
+
+
+// A single search never returns the same object twice, so there's nothing to do until a second search is
+// appended to the same results.  At that point we record what the earlier searches found, then filter the rest.
+void DatabaseQuery::removeRepeats(S32 first)
+{
+   if(mRecordedCount > first)    // Someone cleared results without calling clear()
+      resetVisited();
+
+   if(first == 0)
+      return;
+
+   for(; mRecordedCount < first; mRecordedCount++)
+      markVisited(results[mRecordedCount]);
+
+   S32 kept = first;
+   for(S32 i = first; i < results.size(); i++)
+      if(markVisited(results[i]))
+         results[kept++] = results[i];
+
+   results.resize(kept);
+   mRecordedCount = kept;
+}
+
+
+// Each thread gets its own stack of spare queries
+struct DatabaseQueryPool
+{
+   Vector<DatabaseQuery *> freeQueries;
+};
+
+static ThreadStorage gDatabaseQueryPool;
+
+
+static DatabaseQueryPool *getDatabaseQueryPool()
+{
+   DatabaseQueryPool *pool = (DatabaseQueryPool *)gDatabaseQueryPool.get();
+
+   if(!pool)
+   {
+      pool = new DatabaseQueryPool;      // Lives until the thread calls DatabaseQuery::releaseThread()
+      gDatabaseQueryPool.set(pool);
+   }
+
+   return pool;
+}
+
+
+void DatabaseQuery::releaseThread()
+{
+   DatabaseQueryPool *pool = (DatabaseQueryPool *)gDatabaseQueryPool.get();
+   if(!pool)
+      return;
+
+   for(S32 i = 0; i < pool->freeQueries.size(); i++)
+      delete pool->freeQueries[i];
+
+   delete pool;
+   gDatabaseQueryPool.set(NULL);
+}
+
+// Background level loads and worker threads come and go, and each would otherwise leave its pool behind
+static Thread::ExitFunctionRegistration gReleaseDatabaseQueries(&DatabaseQuery::releaseThread);
+
+
+// Constructor
+ScopedDatabaseQuery::ScopedDatabaseQuery()
+{
+   DatabaseQueryPool *pool = getDatabaseQueryPool();
+
+   if(pool->freeQueries.size() > 0)
+   {
+      mQuery = pool->freeQueries.last();
+      pool->freeQueries.pop_back();
+   }
+   else
+      mQuery = new DatabaseQuery;
+
+   mQuery->clear();
+}
+
+
+// Destructor
+ScopedDatabaseQuery::~ScopedDatabaseQuery()
+{
+   getDatabaseQueryPool()->freeQueries.push_back(mQuery);
+}
+
+
+DatabaseQuery *ScopedDatabaseQuery::operator->() const
+{
+   return mQuery;
+}
+
+
+DatabaseQuery &ScopedDatabaseQuery::operator*() const
+{
+   return *mQuery;
+}
+
+
 // Constructor
 DatabaseObject::DatabaseObject() 
 {
@@ -556,11 +1473,15 @@ DatabaseObject::~DatabaseObject()
 // Code that needs to run for both constructor and copy constructor
 void DatabaseObject::initialize() 
 {
-   mLastQueryId = 0; 
    mExtent = Rect(); 
    mExtentSet = false;
    mDatabase = NULL;
    mBucketList = NULL;
+
+   for(S32 i = 0; i < 4; i++)
+      mBucketRecordIndex[i] = -1;
+
+   mStaticRecordIndex = -1;
 }
 
 
@@ -580,15 +1501,10 @@ DatabaseObject *GridDatabase::findObjectLOS(U8 typeNumber, U32 stateIndex, bool
                                             const Point &rayStart, const Point &rayEnd,
                                             float &collisionTime, Point &surfaceNormal) const
 {
-   Rect queryRect(rayStart, rayEnd);
+   ScopedDatabaseQuery query;
+   findObjectsAlongRay(getTypeBit(typeNumber), NULL, query->results, rayStart, rayEnd);
 
-   // Use a local copy here, most callers expect our global fillVector to remain unchanged
-   static Vector<DatabaseObject *> fillVector;  
-   fillVector.clear();
-
-   findObjects(typeNumber, fillVector, queryRect);
-
-   return findObjectLOS(fillVector, stateIndex, format, rayStart, rayEnd, collisionTime, surfaceNormal);
+   return findObjectLOS(query->results, stateIndex, format, rayStart, rayEnd, collisionTime, surfaceNormal);
 }
 
 
@@ -596,15 +1512,10 @@ DatabaseObject *GridDatabase::findObjectLOS(TestFunc testFunc, U32 stateIndex, b
                                             const Point &rayStart, const Point &rayEnd, 
                                             F32 &collisionTime, Point &surfaceNormal) const
 {
-   Rect queryRect(rayStart, rayEnd);
-
-   // Use a local copy here, most callers expect our global fillVector to remain unchanged
-   static Vector<DatabaseObject *> fillVector;  
-   fillVector.clear();
+   ScopedDatabaseQuery query;
+   findObjectsAlongRay(getStaticTypeMask(testFunc), testFunc, query->results, rayStart, rayEnd);
 
-   findObjects(testFunc, fillVector, queryRect);
-
-   return findObjectLOS(fillVector, stateIndex, format, rayStart, rayEnd, collisionTime, surfaceNormal);
+   return findObjectLOS(query->results, stateIndex, format, rayStart, rayEnd, collisionTime, surfaceNormal);
 }
 
 
@@ -766,6 +1677,38 @@ void GridDatabase::updateExtents(DatabaseObject *object, const Rect &newExtents)
    // removeFromDatabase();    
    // addToDatabase();
 
+   // Static geometry that moves isn't static any more
+   if(object->mStaticRecordIndex != -1)
+   {
+      removeFromStaticIndex(object);
+
+      // Buckets take their extent from the object, which our caller hasn't updated yet
+      object->mExtent = newExtents;
+      addToBuckets(object);
+      return;
+   }
+
+   if(mBucketBackend == ArrayBuckets)
+   {
+      IntRect oldBins, newBins;
+      fillBins(object->getExtent(), oldBins);
+      fillBins(newExtents, newBins);
+
+      if(oldBins.minx == newBins.minx && oldBins.miny == newBins.miny && 
+         oldBins.maxx == newBins.maxx && oldBins.maxy == newBins.maxy)
+         updateBucketArrayExtents(object, newBins, newExtents);
+      else
+      {
+         removeFromBucketArrays(object, oldBins);
+
+         // Records take their extent from the object, which our caller hasn't updated yet
+         object->mExtent = newExtents;
+         addToBucketArrays(object, newBins);
+      }
+
+      return;
+   }
+
    S32 minxold, minyold, maxxold, maxyold;
    S32 minx, miny, maxx, maxy;
 
@@ -804,14 +1747,14 @@ void GridDatabase::updateExtents(DatabaseObject *object, const Rect &newExtents)
             b->nextInBucket->prevInBucket = b->prevInBucket;
          b->prevInBucket->nextInBucket = b->nextInBucket;
          object->mBucketList = b->nextInBucketForThisObject;
-         mChunker->free(b);
+         freeBucketEntry(b);
       }
 
       // ...and re-add for the new extent
       for(S32 x = minx; maxx - x >= 0; x++)
          for(S32 y = miny; maxy - y >= 0; y++)
          {
-            DatabaseBucketEntry *be = mChunker->alloc();
+            DatabaseBucketEntry *be = allocBucketEntry();
             DatabaseBucketEntryBase *base = &mBuckets[x & BucketMask][y & BucketMask];
             be->theObject = object;
             if(base->nextInBucket)
@@ -871,6 +1814,13 @@ const Vector<Point> *DatabaseObject::getCollisionPoly() const
 }
 
 
+// Overridden by objects whose collision poly never changes
+const PolygonEdges *DatabaseObject::getCollisionEdges() const
+{
+   return NULL;
+}
+
+
 // Overridden by BfObject
 void DatabaseObject::deleteThyself()
 {
@@ -892,6 +1842,10 @@ bool DatabaseObject::checkForCollision(const Point &rayStart, const Point &rayEn
          return true;
       }
 
+      const PolygonEdges *edges = getCollisionEdges();
+      if(edges && format)
+         return polygonIntersectsSegmentDetailed(*edges, rayStart, rayEnd, collisionTime, surfaceNormal);
+
       return polygonIntersectsSegmentDetailed(&poly->get(0), poly->size(), format, rayStart, rayEnd, collisionTime, surfaceNormal);
    }
 
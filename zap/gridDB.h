@@ -10,6 +10,7 @@
 
 #include "tnlTypes.h"
 #include "tnlDataChunker.h"
+#include "tnlThread.h"
 #include "tnlVector.h"
 
 #include "Rect.h"
@@ -27,8 +28,10 @@ class BfObject;
 class GridDatabase;
 class EditorObjectDatabase;
 class Level;
+class PolygonEdges;
 struct DatabaseBucketEntry;
 class DatabaseObject;
+class DatabaseQuery;
 
 
 struct DatabaseBucketEntryBase
@@ -45,6 +48,34 @@ struct DatabaseBucketEntry : public DatabaseBucketEntryBase
 };
 
 
+// Used by the ArrayBuckets backend -- one record per object per bucket, stored contiguously so that
+// queries can reject most candidates without touching the object itself
+struct DatabaseBucketRecord
+{
+   DatabaseObject *theObject;
+   Rect extent;               // Copy of theObject's extent, kept in sync by updateExtents()
+   U8 typeNumber;
+};
+
+
+struct DatabaseBucketArray
+{
+   Vector<DatabaseBucketRecord> records;
+   U64 typeMask;              // Bit n is set if bucket contains an object with type number n
+   U16 typeCounts[64];        // Number of records of each type, so typeMask can be maintained on removal
+};
+
+
+// One node of the static geometry index, a bounding volume hierarchy over DatabaseBucketRecords
+struct StaticIndexNode
+{
+   Rect bounds;               // Covers the extents of everything below this node
+   U64 typeMask;              // Types of everything below this node
+   S32 first;                 // Leaf: first record; interior: first of our two children, which are adjacent
+   S32 count;                 // Leaf: number of records; 0 for interior nodes
+};
+
+
 class DatabaseObject : public GeomObject
 {
    typedef GeomObject Parent;
@@ -53,12 +84,17 @@ class DatabaseObject : public GeomObject
    friend class EditorObjectDatabase;
 
 private:
-   U32 mLastQueryId;
    Rect mExtent;
    bool mExtentSet;     // A flag to mark whether extent has been set on this object
    GridDatabase *mDatabase;
    DatabaseBucketEntry *mBucketList;
 
+   // ArrayBuckets backend: position of this object's record in each bucket it occupies.  Only maintained for
+   // objects spanning at most 2x2 buckets (i.e. anything that moves); larger objects get found by searching.
+   S32 mBucketRecordIndex[4];
+
+   S32 mStaticRecordIndex;    // Position of our record in the static geometry index, -1 if we're in the buckets
+
 protected:
    U8 mObjectTypeNumber;
 
@@ -77,6 +113,7 @@ public:
    void setExtent(const Rect &extentRect);
    
    virtual const Vector<Point> *getCollisionPoly() const;
+   virtual const PolygonEdges *getCollisionEdges() const;   // Same polygon, laid out for the batched tests; NULL if not kept
    virtual bool checkForCollision(const Point &rayStart, const Point &rayEnd, bool format, U32 stateIndex,
                                   F32 &collisionTime, Point &surfaceNormal) const;
 
@@ -101,6 +138,60 @@ public:
 };
 
 
+////////////////////////////////////////
+////////////////////////////////////////
+
+// Results of one or more searches of a GridDatabase.  Searches never modify the database or the objects in it,
+// so any number of them can run at once, on any threads, as long as nothing is being added, moved or removed.
+// Several searches can share a query; each object will appear in results only once.
+class DatabaseQuery
+{
+private:
+   U32 mVisitStamp;              // Bumped by clear(), so we never have to wipe mVisitStamps
+   Vector<DatabaseObject *> mVisitKeys;
+   Vector<U32> mVisitStamps;
+   S32 mVisitedCount;
+   S32 mRecordedCount;           // Number of entries in results that have been added to the visited table
+
+   bool markVisited(DatabaseObject *object);    // Returns false if object was already marked
+   void resetVisited();
+   void growVisitTable();
+
+public:
+   Vector<DatabaseObject *> results;
+
+   DatabaseQuery();     // Constructor
+
+   void clear();
+   void removeRepeats(S32 first);   // Drop anything in results at or after first that appears earlier
+
+   static void releaseThread();     // Frees the calling thread's spare queries; runs as a Thread exit function
+};
+
+
+// Borrows a DatabaseQuery from a small per-thread pool for the lifetime of this object, so searches can be
+// nested (or run on several threads) without allocating anything once the pool has warmed up.
+//
+//    ScopedDatabaseQuery query;
+//    database->findObjects((TestFunc)isShipType, query->results, rect);
+class ScopedDatabaseQuery
+{
+private:
+   DatabaseQuery *mQuery;
+
+   // Not copyable
+   ScopedDatabaseQuery(const ScopedDatabaseQuery &);
+   ScopedDatabaseQuery &operator=(const ScopedDatabaseQuery &);
+
+public:
+   ScopedDatabaseQuery();     // Constructor
+   ~ScopedDatabaseQuery();    // Destructor
+
+   DatabaseQuery *operator->() const;
+   DatabaseQuery &operator*() const;
+};
+
+
 ////////////////////////////////////////
 ////////////////////////////////////////
 
@@ -109,10 +200,22 @@ class GoalZone;
 
 class GridDatabase
 {
+public:
+   enum BucketBackend {
+      LinkedListBuckets,      // Doubly linked lists of entries allocated from the shared mChunker (original implementation)
+      ArrayBuckets            // Contiguous per-bucket record arrays with swap-remove and per-bucket type masks
+   };
+
 private:
    U32 mDatabaseId;
-   static U32 mQueryId;
+   BucketBackend mBucketBackend;
+   static BucketBackend mDefaultBucketBackend;
    static U32 mCountGridDatabase;      // Reference counter for destruction of mChunker
+   static S32 mThreadSafeCount;        // Outstanding setThreadSafe(true) calls
+   static Mutex mChunkerLock;          // Guards mChunker and mCountGridDatabase while mThreadSafeCount > 0
+
+   static DatabaseBucketEntry *allocBucketEntry();
+   static void freeBucketEntry(DatabaseBucketEntry *entry);
 
    Vector<DatabaseObject *> mAllObjects;
    Vector<DatabaseObject *> mGoalZones;
@@ -121,11 +224,40 @@ private:
    Vector<DatabaseObject *> mPolyWalls;
    Vector<DatabaseObject *> mWallitems;
 
-   void findObjects(U8 typeNumber, Vector<DatabaseObject *> &fillVector, const Rect *extents, const IntRect *bins) const;
-   void findObjects(Vector<U8> typeNumbers, Vector<DatabaseObject *> &fillVector, const Rect *extents, const IntRect *bins) const;
-   void findObjects(TestFunc testFunc, Vector<DatabaseObject *> &fillVector, const Rect *extents, const IntRect *bins, bool sameQuery = false) const;
+   void findObjectsInBins(U64 typeMask, Vector<DatabaseObject *> &fillVector, const Rect &extents, const IntRect &bins) const;
+   void findObjectsInBins(TestFunc testFunc, Vector<DatabaseObject *> &fillVector, const Rect &extents, const IntRect &bins) const;
 
    void fillBins(const Rect &extents, IntRect &bins) const;    // Helper function -- translates extents into bins to search
+   bool isFirstSharedBin(const Rect &objectExtents, const IntRect &bins, S32 x, S32 y) const;
+
+   void addToBuckets(DatabaseObject *object);
+   void removeFromBuckets(DatabaseObject *object);
+
+   // ArrayBuckets backend
+   DatabaseBucketArray *mBucketArrays;    // BucketRowCount * BucketRowCount buckets, NULL when using LinkedListBuckets
+
+   DatabaseBucketArray &getBucketArray(S32 x, S32 y) const;
+   void addToBucketArrays(DatabaseObject *object, const IntRect &bins);
+   void removeFromBucketArrays(DatabaseObject *object, const IntRect &bins);
+   void updateBucketArrayExtents(DatabaseObject *object, const IntRect &bins, const Rect &newExtents);
+   void findObjectsInBucketArrays(U64 typeMask, Vector<DatabaseObject *> &fillVector, const Rect &extents, const IntRect &bins) const;
+   void findObjectsInBucketArrays(TestFunc testFunc, Vector<DatabaseObject *> &fillVector, const Rect &extents, const IntRect &bins) const;
+
+   // Static geometry index -- objects in here are not in the buckets
+   Vector<DatabaseBucketRecord> mStaticRecords;    // Grouped by leaf; theObject is NULL once an object has left the index
+   Vector<StaticIndexNode> mStaticNodes;           // Root first, empty if there is no index
+   S32 mStaticObjectCount;
+
+   void buildStaticIndexNode(S32 nodeIndex, S32 first, S32 count);
+   void removeFromStaticIndex(DatabaseObject *object);
+   void clearStaticIndex();
+   U64 getStaticTypeMask(TestFunc testFunc) const;
+   void findStaticObjects(U64 typeMask, TestFunc testFunc, Vector<DatabaseObject *> &fillVector, const Rect &extents) const;
+   void findStaticObjectsAlongRay(U64 typeMask, TestFunc testFunc, Vector<DatabaseObject *> &fillVector,
+                                  const Point &rayStart, const Point &rayEnd) const;
+
+   void findObjectsAlongRay(U64 typeMask, TestFunc testFunc, Vector<DatabaseObject *> &fillVector,
+                            const Point &rayStart, const Point &rayEnd) const;
 
 public:
    enum {
@@ -140,6 +272,22 @@ public:
    explicit GridDatabase();   // Constructor
    virtual ~GridDatabase();   // Destructor
 
+   // Backend used by databases created from here on; existing databases are not affected
+   static void setDefaultBucketBackend(BucketBackend backend);
+   static BucketBackend getDefaultBucketBackend();
+
+   // While enabled, databases can be created, filled and destroyed on several threads at once, as long as each
+   // database is only used by one thread at a time.  Calls nest; only change this from the main thread.
+   static void setThreadSafe(bool threadSafe);
+   BucketBackend getBucketBackend() const;
+
+   // Moves every object for which isStatic returns true out of the buckets and into a bounding volume hierarchy,
+   // which spatial searches check alongside the buckets.  Meant to be called once the level is loaded, for
+   // geometry that isn't going to move.  Objects added later go into the buckets as usual; an indexed object
+   // that does move gets put back into the buckets.
+   void buildStaticIndex(TestFunc isStatic);
+   S32 getStaticObjectCount() const;      // Number of objects currently in the static index
+
 
    static const S32 BucketWidthBitShift = 8;    // Width/height of each bucket in pixels, in a form of 2 ^ n, 8 is 256 pixels
 
@@ -167,11 +315,18 @@ public:
    void findObjects(U8 typeNumber, Vector<DatabaseObject *> &fillVector, const Rect &extents) const;
 
    void findObjects(TestFunc testFunc, Vector<DatabaseObject *> &fillVector) const;
-   void findObjects(TestFunc testFunc, Vector<DatabaseObject *> &fillVector, const Rect &extents, bool sameQuery = false) const;
+   void findObjects(TestFunc testFunc, Vector<DatabaseObject *> &fillVector, const Rect &extents) const;
 
    void findObjects(const Vector<U8> &types, Vector<DatabaseObject *> &fillVector) const;
    void findObjects(const Vector<U8> &types, Vector<DatabaseObject *> &fillVector, const Rect &extents) const;
 
+   // Append to query.results, skipping anything an earlier search with the same query already found
+   void findObjects(DatabaseQuery &query, U8 typeNumber, const Rect &extents) const;
+   void findObjects(DatabaseQuery &query, TestFunc testFunc, const Rect &extents) const;
+   void findObjects(DatabaseQuery &query, const Vector<U8> &types, const Rect &extents) const;
+   void findObjects(DatabaseQuery &query, TestFunc testFunc) const;
+   void findObjects(DatabaseQuery &query, const Vector<U8> &types) const;
+
    void copyObjects(const GridDatabase *source);
 
    bool testTypes(const Vector<U8> &types, U8 objectType) const;
@@ -203,8 +358,9 @@ public:
 }
 
 
-// Reusable container for searching gridDatabases
-// putting it outside of Zap namespace seems to help with visual C++ debugging showing whats inside fillVector  (debugger forgets to add Zap::)
+// Reusable container for searching gridDatabases -- only for use on the main game thread.  Code that may run
+// concurrently or recursively (collision, scoping, scripting) should use a ScopedDatabaseQuery instead.
+// Putting it outside of Zap namespace seems to help with visual C++ debugging showing whats inside fillVector  (debugger forgets to add Zap::)
 extern Vector<Zap::DatabaseObject *> fillVector;
 extern Vector<Zap::DatabaseObject *> fillVector2;
 
@@ -213,10 +213,10 @@ Rect Item::calcExtents() const
 // Standard methods available to all Items:
 //               Fn name           Param profiles  Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, getRad,           ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, getShip,          ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, isInCaptureZone,  ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, getCaptureZone,   ARRAYDEF({{ END }}), 1 ) \
+   METHOD(CLASS, getRad,           ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getShip,          ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, isInCaptureZone,  ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getCaptureZone,   ARRAYDEF({{ END }}), 1, READ_ONLY ) \
 
 GENERATE_LUA_METHODS_TABLE(Item, LUA_METHODS);
 GENERATE_LUA_FUNARGS_TABLE(Item, LUA_METHODS);
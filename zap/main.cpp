@@ -89,6 +89,8 @@ using namespace TNL;
 #endif
 
 #include "ServerGame.h"
+#include "gameNetInterface.h"
+#include "TickSchedule.h"
 #include "version.h"       // For BUILD_VERSION def
 #include "Colors.h"
 #include "DisplayManager.h"
@@ -232,6 +234,17 @@ void checkIfServerGameIsShuttingDown(U32 timeDelta)
    ServerGame *serverGame = GameManager::getServerGame();
 
    string shutdownReason;
+
+   // An additional arena shutting down just closes that arena; the others carry on
+   const Vector<ServerGame *> *arenas = GameManager::getServerGames();
+
+   for(S32 i = arenas->size() - 1; i >= 1; i--)
+      if(arenas->get(i)->isReadyToShutdown(timeDelta, shutdownReason))
+      {
+         logprintf(LogConsumer::ServerFilter, "Arena %d shut down", arenas->get(i)->getArenaIndex() + 1);
+         GameManager::deleteArena(arenas->get(i));
+      }
+
    if(serverGame && serverGame->isReadyToShutdown(timeDelta, shutdownReason))
    {
 #ifndef ZAP_DEDICATED
@@ -349,8 +362,8 @@ void idle()
    // sleep(0) helps reduce the impact of OpenGL on windows.
 
    // If there are no players, set sleepTime to 40 to further reduce impact on the server.
-   // We'll only go into this longer sleep on dedicated servers when there are no players.
-   if(dedicated && GameManager::getServerGame()->isSuspended())
+   // We'll only go into this longer sleep on dedicated servers when there are no players in any arena.
+   if(dedicated && GameManager::areAllArenasSuspended())
       sleepTime = 40;     // The higher this number, the less accurate the ping is on server lobby when empty, but the less power consumed.
 
    Platform::sleep(sleepTime);
@@ -358,8 +371,83 @@ void idle()
 }  // end idle()
 
 
+// Used by dedicated servers with EventDrivenLoop set.  Rather than waking up every millisecond to see if there's
+// anything to do, we sleep on every arena's socket until either a packet arrives or the next tick is due.  Ticks are
+// kept on a fixed schedule, and every so often we log how well we're keeping to it.
+static void eventDrivenServerLoop()
+{
+   static const U32 JitterReportInterval = 60 * 1000;    // ms
+
+   TickSchedule schedule;
+   F64 lastReport = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue());
+
+   for(;;)
+   {
+      loadAnotherLevelOrStartHosting();
+
+      ServerGame *serverGame = GameManager::getServerGame();
+
+      if(!serverGame)      // Shouldn't happen, but the old way copes with anything
+      {
+         idle();
+         continue;
+      }
+
+      // Nothing much happens when nobody's around in any arena, so tick less often -- same as the regular loop
+      if(GameManager::areAllArenasSuspended())
+         schedule.setInterval(40);
+      else
+      {
+         U32 maxFPS = serverGame->getSettings()->getSetting<U32>(IniKey::MaxFpsServer);     // Arenas share settings
+         schedule.setInterval(maxFPS == 0 ? 1 : 1000.0 / maxFPS);
+      }
+
+      F64 now = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue());
+
+      if(schedule.isTickDue(now))
+      {
+         U32 deltaT = schedule.tick(now);
+
+         checkIfServerGameIsShuttingDown(deltaT);
+         GameManager::idle(deltaT);
+      }
+
+      // Still working through the level list; get straight back to it
+      else if(GameManager::getHostingModePhase() == GameManager::LoadingLevels)
+         continue;
+
+      else
+      {
+         U32 waitMicros = U32((schedule.getNextTickTime() - now) * 1000);
+
+         // Deal with whatever came in, for whichever arena, right away; the rest of the tick can wait
+         if(GameManager::waitForIncomingPackets(waitMicros))
+            GameManager::checkIncomingPackets();
+      }
+
+      if(now - lastReport >= JitterReportInterval)
+      {
+         TickSchedule::JitterStats stats;
+         schedule.getJitterStats(stats);
+
+         logprintf(LogConsumer::ServerFilter, "Tick timing: %d ticks, %d late, %d resyncs; lateness mean %.2fms, "
+                   "std dev %.2fms, max %.2fms", stats.tickCount, stats.lateTicks, stats.resyncCount, stats.meanMs,
+                   stats.stdDevMs, stats.maxMs);
+
+         schedule.resetJitterStats();
+         lastReport = now;
+      }
+   }
+}
+
+
 void dedicatedServerLoop()
 {
+   ServerGame *serverGame = GameManager::getServerGame();
+
+   if(serverGame && serverGame->isDedicated() && serverGame->getSettings()->getSetting<YesNo>(IniKey::EventDrivenLoop))
+      eventDrivenServerLoop();
+
    for(;;)        // Loop forever!
       idle();     // Idly!
 }
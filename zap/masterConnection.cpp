@@ -33,8 +33,12 @@ MasterServerConnection::MasterServerConnection(Game *game)
    // This id is sent out with ping and query responses in order to identify servers that may have a different
    // internal and external ip address.
    mClientId = 0;
+   mMasterProtocolVersion = 0;
 
    mCurrentQueryId = 0;
+   mKnownServersVersion = 0;
+   mKnownServersHostOnly = false;
+   mWaitingForFirstDelta = false;
 
    // Determine connection type based on Game that is running
    // An anonymous connection can be set with setConnectionType()
@@ -75,12 +79,33 @@ void MasterServerConnection::startServerQuery(bool hostOnServer)
    // Invalidate old queries
    mCurrentQueryId++;
 
-   // And automatically do a server query as well - you may not want to do things
-   // in this order in your own clients.
-   if(hostOnServer)
-      c2mQueryHostServers(mCurrentQueryId);
-   else
-      c2mQueryServers(mCurrentQueryId);
+   // Our list is no help if it's of the other kind of server
+   if(hostOnServer != mKnownServersHostOnly)
+   {
+      mKnownServers.clear();
+      mKnownServersVersion = 0;
+      mKnownServersHostOnly = hostOnServer;
+   }
+
+   mServerList.clear();
+
+   // Older masters only know how to send the whole list
+   if(mMasterProtocolVersion < 9)
+   {
+      mWaitingForFirstDelta = false;
+
+      if(hostOnServer)
+         c2mQueryHostServers(mCurrentQueryId);
+      else
+         c2mQueryServers(mCurrentQueryId);
+
+      return;
+   }
+
+   mWaitingForFirstDelta = true;
+
+   // Only ask for what has changed since our last query
+   c2mQueryServersSince(mCurrentQueryId, hostOnServer, mKnownServersVersion);
 }
 
 
@@ -149,6 +174,65 @@ TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, m2cQueryServersResponse_019a,
       mServerList.clear();
    }
 }
+
+
+static void removeServerWithId(Vector<ServerAddr> &serverList, S32 serverId)
+{
+   for(S32 i = 0; i < serverList.size(); i++)
+      if(serverList[i].second == serverId)
+      {
+         serverList.erase_fast(i);
+         return;
+      }
+}
+
+
+TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, m2cQueryServersDelta, 
+                           (U32 queryId, U32 listVersion, bool fullList, Vector<IPAddress> ipList,
+                            Vector<S32> serverIdList, Vector<S32> removedIdList, bool done))
+{
+   if(mGame->isServer())
+      return;
+
+   // Only process results from current query, ignoring anything older...
+   if(queryId != mCurrentQueryId)
+      return;
+
+   TNLAssert(ipList.size() == serverIdList.size(), "Expect the same number of elements!");
+   if(ipList.size() != serverIdList.size())
+      return;
+
+   // Start from what we already know, unless the master is sending it all again
+   if(mWaitingForFirstDelta)
+   {
+      if(fullList)
+         mServerList.clear();
+      else
+         mServerList = mKnownServers;
+
+      mWaitingForFirstDelta = false;
+   }
+
+   for(S32 i = 0; i < removedIdList.size(); i++)
+      removeServerWithId(mServerList, removedIdList[i]);
+
+   for(S32 i = 0; i < ipList.size(); i++)
+   {
+      removeServerWithId(mServerList, serverIdList[i]);     // In case it moved
+      mServerList.push_back(ServerAddr(ipList[i], serverIdList[i]));
+   }
+
+   // As with the other responses, the UI needs the whole list at once
+   if(done)
+   {
+      mKnownServers = mServerList;
+      mKnownServersVersion = listVersion;
+
+      static_cast<ClientGame *>(mGame)->gotServerListFromMaster(mServerList);
+
+      mServerList.clear();
+   }
+}
 #endif
 
 
@@ -544,7 +628,7 @@ void MasterServerConnection::writeConnectRequest(BitStream *bstream)
       bstream->writeString(levelName.c_str());                     // Level name
       bstream->writeString(GameType::getGameTypeName(serverGame->getGameType()->getGameTypeId())); // Level type
 
-      bstream->writeString(serverGame->getSettings()->getHostName().c_str());       // Server name
+      bstream->writeString(serverGame->getServerName().c_str());                    // Server name
       bstream->writeString(serverGame->getSettings()->getHostDescr().c_str());      // Server description
    }
 
@@ -583,6 +667,12 @@ bool MasterServerConnection::readConnectAccept(BitStream *stream, NetConnection:
 
    stream->read(&mClientId);     // This ID is guaranteed unique across all clients/servers
 
+   // Masters from 021 on follow that with their protocol version; older ones have nothing more to say
+   if(stream->getMaxReadBitPosition() - stream->getBitPosition() >= 32)
+      stream->read(&mMasterProtocolVersion);
+   else
+      mMasterProtocolVersion = 8;
+
    return true;
 }
 
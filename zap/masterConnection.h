@@ -27,11 +27,17 @@ class MasterServerConnection : public MasterServerInterface
 private:
    U32 mCurrentQueryId;    // ID of our current query
 
+   Vector<ServerAddr> mKnownServers;   // Server list from our last completed query, so we can ask for just what's changed
+   U32 mKnownServersVersion;           // Master's version of that list, 0 if we don't have one
+   bool mKnownServersHostOnly;         // Whether the list is of host servers
+   bool mWaitingForFirstDelta;         // Haven't heard anything back from the current query yet
+
    Game *mGame;
    string mMasterName;
 
    S32 mClientId;
    bool mHostOnServerAvailable;
+   U32 mMasterProtocolVersion;         // Masters older than 9 can't answer c2mQueryServersSince
 
    void terminateIfAnonymous();
 
@@ -68,6 +74,8 @@ public:
 
    TNL_DECLARE_RPC_OVERRIDE(m2cQueryServersResponse, (U32 queryId, Vector<IPAddress> ipList));
    TNL_DECLARE_RPC_OVERRIDE(m2cQueryServersResponse_019a, (U32 queryId, Vector<IPAddress> ipList, Vector<S32> clientIdList));
+   TNL_DECLARE_RPC_OVERRIDE(m2cQueryServersDelta, (U32 queryId, U32 listVersion, bool fullList, Vector<IPAddress> ipList,
+                                                   Vector<S32> serverIdList, Vector<S32> removedIdList, bool done));
 #endif
 
    TNL_DECLARE_RPC_OVERRIDE(m2sClientRequestedArrangedConnection, (U32 requestId, Vector<IPAddress> possibleAddresses,
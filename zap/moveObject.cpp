@@ -15,6 +15,7 @@
 
 #include "Colors.h"
 #include "GeomUtils.h"
+#include "PolygonEdges.h"
 #include "stringUtils.h"
 #include "MathUtils.h"     // For findLowestRootIninterval()
 
@@ -458,19 +459,21 @@ BfObject *MoveObject::findFirstCollision(U32 stateIndex, F32 &collisionTime, Poi
    Rect queryRect(getPos(stateIndex), getPos(stateIndex) + delta);
    queryRect.expand(Point(mRadius, mRadius));
 
-   fillVector.clear();
+   // collide() handlers may run their own searches (e.g. SpeedZones), so we can't use the global fillVector here
+   ScopedDatabaseQuery query;
+   Vector<DatabaseObject *> &foundObjects = query->results;
 
-   findObjects(collideTypes(), fillVector, queryRect);   // Free CPU for finding only the ones we care about
+   findObjects(collideTypes(), foundObjects, queryRect);   // Free CPU for finding only the ones we care about
 
-   fillVector.sort(sortBarriersFirst);  // Sort to do Barriers::Collide first, to prevent picking up flag (FlagItem::Collide) through Barriers, especially when client does /maxfps 10
+   foundObjects.sort(sortBarriersFirst);  // Sort to do Barriers::Collide first, to prevent picking up flag (FlagItem::Collide) through Barriers, especially when client does /maxfps 10
 
    F32 collisionFraction;
 
    BfObject *collisionObject = NULL;
 
-   for(S32 i = 0; i < fillVector.size(); i++)
+   for(S32 i = 0; i < foundObjects.size(); i++)
    {
-      BfObject *foundObject = static_cast<BfObject *>(fillVector[i]);
+      BfObject *foundObject = static_cast<BfObject *>(foundObjects[i]);
 
       if(!foundObject->isCollisionEnabled())
          continue;
@@ -480,9 +483,12 @@ BfObject *MoveObject::findFirstCollision(U32 stateIndex, F32 &collisionTime, Poi
       if(poly)
       {
          Point cp;
+         const PolygonEdges *edges = foundObject->getCollisionEdges();
 
-         if(PolygonSweptCircleIntersect(&poly->first(), poly->size(), getPos(stateIndex),
-                                        delta, mRadius, cp, collisionFraction))
+         bool hit = edges ? PolygonSweptCircleIntersect(*edges, getPos(stateIndex), delta, mRadius, cp, collisionFraction) :
+                            PolygonSweptCircleIntersect(&poly->first(), poly->size(), getPos(stateIndex),
+                                                        delta, mRadius, cp, collisionFraction);
+         if(hit)
          {
             if(cp != getPos(stateIndex) || !isCollideableType(foundObject->getObjectTypeNumber()))   // Avoid getting stuck inside polygon wall
             {
@@ -805,8 +811,8 @@ void MoveObject::computeImpulseDirection(DamageInfo *damageInfo)
  */
 //               Fn name Param profiles  Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, getVel, ARRAYDEF({{     END }}), 1 ) \
-   METHOD(CLASS, setVel, ARRAYDEF({{ PT, END }}), 1 ) \
+   METHOD(CLASS, getVel, ARRAYDEF({{     END }}), 1, READ_ONLY )  \
+   METHOD(CLASS, setVel, ARRAYDEF({{ PT, END }}), 1, READ_WRITE ) \
 
 GENERATE_LUA_METHODS_TABLE(MoveObject, LUA_METHODS);
 GENERATE_LUA_FUNARGS_TABLE(MoveObject, LUA_METHODS);
@@ -1275,8 +1281,8 @@ bool MountableItem::isItemThatMakesYouVisibleWhileCloaked() { return true; }
  */
 //               Fn name       Param profiles  Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, getShip,  ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, isOnShip, ARRAYDEF({{ END }}), 1 ) \
+   METHOD(CLASS, getShip,  ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, isOnShip, ARRAYDEF({{ END }}), 1, READ_ONLY ) \
 
 GENERATE_LUA_METHODS_TABLE(MountableItem, LUA_METHODS);
 GENERATE_LUA_FUNARGS_TABLE(MountableItem, LUA_METHODS);
@@ -1688,9 +1694,9 @@ void Asteroid::fillAttributesVectors(Vector<string> &keys, Vector<string> &value
  */
 //               Fn name       Param profiles  Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, getSizeIndex, ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, getSizeCount, ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, setSize,      ARRAYDEF({{ INT, END }}), 1 ) \
+   METHOD(CLASS, getSizeIndex, ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getSizeCount, ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, setSize,      ARRAYDEF({{ INT, END }}), 1, READ_WRITE ) \
 
 GENERATE_LUA_METHODS_TABLE(Asteroid, LUA_METHODS);
 GENERATE_LUA_FUNARGS_TABLE(Asteroid, LUA_METHODS);
@@ -33,14 +33,14 @@ LuaPlayerInfo::~LuaPlayerInfo()
  */
 //                Fn name                  Param profiles            Profile count
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, getName,             ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, getShip,             ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, getTeamIndx,         ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, getTeamIndex,        ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, getRating,               ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, getScore,                ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, isRobot,                 ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, getScriptName,           ARRAYDEF({{ END }}), 1 ) \
+   METHOD(CLASS, getName,             ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getShip,             ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getTeamIndx,         ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getTeamIndex,        ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getRating,               ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getScore,                ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, isRobot,                 ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getScriptName,           ARRAYDEF({{ END }}), 1, READ_ONLY ) \
 
 GENERATE_LUA_FUNARGS_TABLE(LuaPlayerInfo, LUA_METHODS);
 GENERATE_LUA_METHODS_TABLE(LuaPlayerInfo, LUA_METHODS);
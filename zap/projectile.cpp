@@ -458,10 +458,10 @@ bool Projectile::shouldRender() const
  */
 //               Fn name    Param profiles  Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, getRad,    ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, getWeapon, ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, getVel,    ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, setVel,    ARRAYDEF({{ PT,  END }}), 1 ) \
+   METHOD(CLASS, getRad,    ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getWeapon, ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getVel,    ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, setVel,    ARRAYDEF({{ PT,  END }}), 1, READ_WRITE ) \
 
 GENERATE_LUA_METHODS_TABLE(Projectile, LUA_METHODS);
 GENERATE_LUA_FUNARGS_TABLE(Projectile, LUA_METHODS);
@@ -785,7 +785,7 @@ bool Burst::shouldRender() const
  */
 //               Fn name    Param profiles  Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, getWeapon, ARRAYDEF({{ END }}), 1 ) \
+   METHOD(CLASS, getWeapon, ARRAYDEF({{ END }}), 1, READ_ONLY ) \
 
 GENERATE_LUA_METHODS_TABLE(Burst, LUA_METHODS);
 GENERATE_LUA_FUNARGS_TABLE(Burst, LUA_METHODS);
@@ -1867,7 +1867,7 @@ bool Seeker::canAddToEditor() { return false; }    // No seekers in the editor!
  */
 //               Fn name    Param profiles  Profile count
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, getWeapon, ARRAYDEF({{ END }}), 1 ) \
+   METHOD(CLASS, getWeapon, ARRAYDEF({{ END }}), 1, READ_ONLY ) \
 
 GENERATE_LUA_METHODS_TABLE(Seeker, LUA_METHODS);
 GENERATE_LUA_FUNARGS_TABLE(Seeker, LUA_METHODS);
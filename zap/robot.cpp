@@ -166,7 +166,14 @@ const char *Robot::getErrorMessagePrefix() { return "***ROBOT ERROR***"; }
 // Server only
 bool Robot::start()
 {
-   if(!getGame() || !runScript(!getGame()->isTestServer()))   // Load the script, execute the chunk to get it in memory, then run its main() function
+   if(!getGame())
+      return false;
+
+   // When bots tick on worker threads, each needs a Lua state of its own
+   if(getGame()->getSettings()->getBotWorkerCount() > 0 && !createLuaState())
+      return false;
+
+   if(!runScript(!getGame()->isTestServer()))   // Load the script, execute the chunk to get it in memory, then run its main() function
       return false;
 
    // Pass true so that if this bot doesn't have a TickEvent handler, we don't print a message
@@ -498,12 +505,13 @@ bool Robot::canSeePoint(Point point, bool wallOnly)
 
    Rect queryRect(thisPoints);
 
-   fillVector.clear();
-   mGame->getLevel()->findObjects(wallOnly ? (TestFunc)isWallType : (TestFunc)isCollideableType, fillVector, queryRect);
+   ScopedDatabaseQuery query;
+   Vector<DatabaseObject *> &foundObjects = query->results;
+   mGame->getLevel()->findObjects(wallOnly ? (TestFunc)isWallType : (TestFunc)isCollideableType, foundObjects, queryRect);
 
-   for(S32 i = 0; i < fillVector.size(); i++)
+   for(S32 i = 0; i < foundObjects.size(); i++)
    {
-      const Vector<Point> *otherPoints = fillVector[i]->getCollisionPoly();
+      const Vector<Point> *otherPoints = foundObjects[i]->getCollisionPoly();
       if(otherPoints && polygonsIntersect(thisPoints, *otherPoints))
          return false;
    }
@@ -646,37 +654,37 @@ U16 Robot::findClosestZone(const Point &point)
 
 //                Fn name               Param profiles                  Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS,  setAngle,             ARRAYDEF({{ PT, END }, { NUM, END }}), 2 )           \
-   METHOD(CLASS,  getAnglePt,           ARRAYDEF({{ PT, END }              }), 1 )           \
-   METHOD(CLASS,  canSeePoint,          ARRAYDEF({{ PT, END }              }), 1 )           \
-                                                                                             \
-   METHOD(CLASS,  getWaypoint,          ARRAYDEF({{ PT, END }}), 1 )                         \
-                                                                                             \
-   METHOD(CLASS,  setThrust,            ARRAYDEF({{ NUM, NUM, END }, { NUM, PT, END}}), 2 )  \
-   METHOD(CLASS,  setThrustToPt,        ARRAYDEF({{ PT,       END }                 }), 1 )  \
-                                                                                             \
-   METHOD(CLASS,  fireWeapon,           ARRAYDEF({{ WEAP_ENUM, END }}), 1 )                  \
-   METHOD(CLASS,  hasWeapon,            ARRAYDEF({{ WEAP_ENUM, END }}), 1 )                  \
-                                                                                             \
-   METHOD(CLASS,  fireModule,           ARRAYDEF({{ MOD_ENUM, END }}), 1 )                   \
-   METHOD(CLASS,  hasModule,            ARRAYDEF({{ MOD_ENUM, END }}), 1 )                   \
-                                                                                             \
-   METHOD(CLASS,  setLoadoutWeapon,     ARRAYDEF({{ WEAP_SLOT, WEAP_ENUM, END }}), 1 )       \
-   METHOD(CLASS,  setLoadoutModule,     ARRAYDEF({{ MOD_SLOT,  MOD_ENUM,  END }}), 1 )       \
-                                                                                             \
-   METHOD(CLASS,  globalMsg,            ARRAYDEF({{ STR, END }}), 1 )                        \
-   METHOD(CLASS,  teamMsg,              ARRAYDEF({{ STR, END }}), 1 )                        \
-   METHOD(CLASS,  privateMsg,           ARRAYDEF({{ STR, STR, END }}), 1 )                   \
-                                                                                             \
-   METHOD(CLASS,  findVisibleObjects,   ARRAYDEF({{ TABLE, INTS, END }, { INTS, END }}), 2 ) \
-   METHOD(CLASS,  findClosestEnemy,     ARRAYDEF({{              END }, { NUM,  END }}), 2 ) \
-                                                                                             \
-   METHOD(CLASS,  getFiringSolution,    ARRAYDEF({{ BFOBJ, END }}), 1 )                      \
-   METHOD(CLASS,  getInterceptCourse,   ARRAYDEF({{ BFOBJ, END }}), 1 )                      \
-                                                                                             \
-   METHOD(CLASS,  engineerDeployObject, ARRAYDEF({{ INT,    END }}), 1 )                     \
-   METHOD(CLASS,  dropItem,             ARRAYDEF({{         END }}), 1 )                     \
-   METHOD(CLASS,  copyMoveFromObject,   ARRAYDEF({{ MOVOBJ, END }}), 1 )                     \
+   METHOD(CLASS,  setAngle,             ARRAYDEF({{ PT, END }, { NUM, END }}), 2, READ_WRITE )          \
+   METHOD(CLASS,  getAnglePt,           ARRAYDEF({{ PT, END }              }), 1, READ_ONLY )           \
+   METHOD(CLASS,  canSeePoint,          ARRAYDEF({{ PT, END }              }), 1, READ_ONLY )           \
+                                                                                                        \
+   METHOD(CLASS,  getWaypoint,          ARRAYDEF({{ PT, END }}), 1, READ_ONLY )                         \
+                                                                                                        \
+   METHOD(CLASS,  setThrust,            ARRAYDEF({{ NUM, NUM, END }, { NUM, PT, END}}), 2, READ_WRITE ) \
+   METHOD(CLASS,  setThrustToPt,        ARRAYDEF({{ PT,       END }                 }), 1, READ_WRITE ) \
+                                                                                                        \
+   METHOD(CLASS,  fireWeapon,           ARRAYDEF({{ WEAP_ENUM, END }}), 1, READ_WRITE )                 \
+   METHOD(CLASS,  hasWeapon,            ARRAYDEF({{ WEAP_ENUM, END }}), 1, READ_ONLY )                  \
+                                                                                                        \
+   METHOD(CLASS,  fireModule,           ARRAYDEF({{ MOD_ENUM, END }}), 1, READ_WRITE )                  \
+   METHOD(CLASS,  hasModule,            ARRAYDEF({{ MOD_ENUM, END }}), 1, READ_ONLY )                   \
+                                                                                                        \
+   METHOD(CLASS,  setLoadoutWeapon,     ARRAYDEF({{ WEAP_SLOT, WEAP_ENUM, END }}), 1, READ_WRITE )      \
+   METHOD(CLASS,  setLoadoutModule,     ARRAYDEF({{ MOD_SLOT,  MOD_ENUM,  END }}), 1, READ_WRITE )      \
+                                                                                                        \
+   METHOD(CLASS,  globalMsg,            ARRAYDEF({{ STR, END }}), 1, READ_WRITE )                       \
+   METHOD(CLASS,  teamMsg,              ARRAYDEF({{ STR, END }}), 1, READ_WRITE )                       \
+   METHOD(CLASS,  privateMsg,           ARRAYDEF({{ STR, STR, END }}), 1, READ_WRITE )                  \
+                                                                                                        \
+   METHOD(CLASS,  findVisibleObjects,   ARRAYDEF({{ TABLE, INTS, END }, { INTS, END }}), 2, READ_ONLY ) \
+   METHOD(CLASS,  findClosestEnemy,     ARRAYDEF({{              END }, { NUM,  END }}), 2, READ_ONLY ) \
+                                                                                                        \
+   METHOD(CLASS,  getFiringSolution,    ARRAYDEF({{ BFOBJ, END }}), 1, READ_ONLY )                      \
+   METHOD(CLASS,  getInterceptCourse,   ARRAYDEF({{ BFOBJ, END }}), 1, READ_ONLY )                      \
+                                                                                                        \
+   METHOD(CLASS,  engineerDeployObject, ARRAYDEF({{ INT,    END }}), 1, READ_WRITE )                    \
+   METHOD(CLASS,  dropItem,             ARRAYDEF({{         END }}), 1, READ_WRITE )                    \
+   METHOD(CLASS,  copyMoveFromObject,   ARRAYDEF({{ MOVOBJ, END }}), 1, READ_WRITE )                    \
 
 
 GENERATE_LUA_METHODS_TABLE(Robot, LUA_METHODS);
@@ -884,21 +892,8 @@ S32 Robot::lua_getWaypoint(lua_State *L)
    // or the path we had no longer applied to our current location
    flightPlanTo = targetZone;
 
-   // check cache for path first
-   pair<S32,S32> pathIndex = pair<S32,S32>(currentZone, targetZone);
-
-   const Vector<BotNavMeshZone *> &zones = static_cast<ServerGame *>(getGame())->getBotZoneList();  // Our pre-cached list of nav zones
-
-   if(getGame()->getGameType()->cachedBotFlightPlans.find(pathIndex) == getGame()->getGameType()->cachedBotFlightPlans.end())
-   {
-      // Not found so calculate flight plan
-      flightPlan = AStar::findPath(&zones, currentZone, targetZone, target);
-
-      // Add to cache
-      getGame()->getGameType()->cachedBotFlightPlans[pathIndex] = flightPlan;
-   }
-   else
-      flightPlan = getGame()->getGameType()->cachedBotFlightPlans[pathIndex];
+   // Routes are cached, so this is usually just a lookup
+   static_cast<ServerGame *>(getGame())->getBotPathFinder().findPath(currentZone, targetZone, target, flightPlan);
 
    if(flightPlan.size() > 0)
       return returnPoint(L, flightPlan.last());
@@ -946,21 +941,22 @@ S32 Robot::lua_findClosestEnemy(lua_State *L)
    F32 minDist = F32_MAX;
    Ship *closest = NULL;
 
-   fillVector.clear();
+   ScopedDatabaseQuery query;
+   Vector<DatabaseObject *> &foundObjects = query->results;
 
    if(useRange)
-      getGame()->getLevel()->findObjects((TestFunc)isShipType, fillVector, queryRect);   
+      getGame()->getLevel()->findObjects((TestFunc)isShipType, foundObjects, queryRect);   
    else
-      getGame()->getLevel()->findObjects((TestFunc)isShipType, fillVector);   
+      getGame()->getLevel()->findObjects((TestFunc)isShipType, foundObjects);   
 
-   for(S32 i = 0; i < fillVector.size(); i++)
+   for(S32 i = 0; i < foundObjects.size(); i++)
    {
       // Ignore self 
-      if(fillVector[i] == this) 
+      if(foundObjects[i] == this) 
          continue;
 
       // Ignore ship/robot if it's dead or cloaked
-      Ship *ship = static_cast<Ship *>(fillVector[i]);
+      Ship *ship = static_cast<Ship *>(foundObjects[i]);
       if(ship->mHasExploded || !ship->isVisible(hasModule(ModuleSensor)))
          continue;
 
@@ -1357,10 +1353,9 @@ S32 Robot::lua_findVisibleObjects(lua_State *L)
    Rect queryRect(pos, pos);
    queryRect.expand(getGame()->computePlayerVisArea(this));
 
-   fillVector.clear();
-   static Vector<U8> types;
-
-   types.clear();
+   ScopedDatabaseQuery query;
+   Vector<DatabaseObject *> &foundObjects = query->results;
+   Vector<U8> types;
 
    // We expect the stack to look like this: -- [fillTable], objType1, objType2, ...
    // We'll work our way down from the top of the stack (element -1) until we find something that is not a number.
@@ -1371,17 +1366,17 @@ S32 Robot::lua_findVisibleObjects(lua_State *L)
       U8 typenum = (U8)lua_tointeger(L, -1);
 
       // Requests for botzones have to be handled separately; not a problem, we'll just do the search here, and add them to
-      // fillVector, where they'll be merged with the rest of our search results.
+      // foundObjects, where they'll be merged with the rest of our search results.
       if(typenum != BotNavMeshZoneTypeNumber)
          types.push_back(typenum);
       else
-         getGame()->getBotZoneDatabase().findObjects(BotNavMeshZoneTypeNumber, fillVector, queryRect);
+         getGame()->getBotZoneDatabase().findObjects(BotNavMeshZoneTypeNumber, foundObjects, queryRect);
 
       lua_pop(L, 1);
    }
 
    // Get other objects on screen-visible area only
-   getGame()->getLevel()->findObjects(types, fillVector, queryRect);
+   getGame()->getLevel()->findObjects(types, foundObjects, queryRect);
 
 
    // We are expecting a table to be on top of the stack when we get here.  If not, we can add one.
@@ -1391,7 +1386,7 @@ S32 Robot::lua_findVisibleObjects(lua_State *L)
 
       logprintf(LogConsumer::LogWarning,
                   "Finding objects will be far more efficient if your script provides a table -- see scripting docs for details!");
-      lua_createtable(L, fillVector.size(), 0);    // Create a table, with enough slots pre-allocated for our data
+      lua_createtable(L, foundObjects.size(), 0);    // Create a table, with enough slots pre-allocated for our data
    }
 
    TNLAssert((lua_gettop(L) == 1 && lua_istable(L, -1)) || dumpStack(L), "Should only have table!");
@@ -1399,21 +1394,21 @@ S32 Robot::lua_findVisibleObjects(lua_State *L)
 
    S32 pushed = 0;      // Count of items we put into our table
 
-   for(S32 i = 0; i < fillVector.size(); i++)
+   for(S32 i = 0; i < foundObjects.size(); i++)
    {
-      if(isShipType(fillVector[i]->getObjectTypeNumber()))
+      if(isShipType(foundObjects[i]->getObjectTypeNumber()))
       {
-         if(fillVector[i] == this)  // Don't add this bot to the list of found objects!
+         if(foundObjects[i] == this)  // Don't add this bot to the list of found objects!
             continue;
 
          // Ignore ship/robot if it's dead or cloaked (unless bot has sensor)
-         Ship *ship = static_cast<Ship *>(fillVector[i]);
+         Ship *ship = static_cast<Ship *>(foundObjects[i]);
          bool callerHasSensor = this->hasModule(ModuleSensor);
          if(!ship->isVisible(callerHasSensor) || ship->mHasExploded)
             continue;
       }
 
-      static_cast<BfObject *>(fillVector[i])->push(L);
+      static_cast<BfObject *>(foundObjects[i])->push(L);
       pushed++;      // Increment pushed before using it because Lua uses 1-based arrays
       lua_rawseti(L, 1, pushed);
    }
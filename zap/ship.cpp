@@ -356,8 +356,10 @@ F32 Ship::processMove(U32 stateIndex)
 // If ship is in multiple zones, an aribtrary one will be returned, and the level designer will be flogged.
 BfObject *Ship::isInAnyZone() const
 {
-   findObjectsUnderShip((TestFunc)isZoneType);  // Fills fillVector
-   return doIsInZone(fillVector);
+   ScopedDatabaseQuery query;    // Robots may ask from several threads at once
+
+   findObjectsUnderShip((TestFunc)isZoneType, query->results);
+   return doIsInZone(query->results);
 }
 
 
@@ -365,12 +367,14 @@ BfObject *Ship::isInAnyZone() const
 // If ship is in multiple zones of type zoneTypeNumber, an aribtrary one will be returned, and the level designer will be flogged.
 BfObject *Ship::isInZone(U8 zoneTypeNumber) const
 {
-   findObjectsUnderShip(zoneTypeNumber);        // Fills fillVector
-   return doIsInZone(fillVector);
+   ScopedDatabaseQuery query;    // Robots may ask from several threads at once
+
+   findObjectsUnderShip(zoneTypeNumber, query->results);
+   return doIsInZone(query->results);
 }
 
 
-// Private helper for isInZone() and isInAnyZone() -- these fill fillVector, and we operate on it below
+// Private helper for isInZone() and isInAnyZone() -- these find the candidates, and we operate on them below
 BfObject *Ship::doIsInZone(const Vector<DatabaseObject *> &objects) const
 {
    if(objects.size() == 0)  // Ship isn't in extent of any objectType objects, can bail here
@@ -395,7 +399,7 @@ BfObject *Ship::doIsInZone(const Vector<DatabaseObject *> &objects) const
 // Returns the object in question if this ship is on an object of type objectType
 DatabaseObject *Ship::isOnObject(U8 objectType, U32 stateIndex)
 {
-   findObjectsUnderShip(objectType);
+   findObjectsUnderShip(objectType, fillVector);
 
    if(fillVector.size() == 0)  // Ship isn't in extent of any objectType objects, can bail here
       return NULL;
@@ -1375,8 +1379,23 @@ void Ship::setMove(const Move &move)
 }
 
 
+// Lets other players' connections share one packed copy of our updates when they don't include our position
+U32 Ship::getConnectionDependentMask(GhostConnection *connection)
+{
+   GameConnection *gameConnection = (GameConnection *) connection;
+
+   // Our owner gets our move and modules left out, and the recorder gets the energy meter put in
+   if(gameConnection->getControlObject() == this || gameConnection->mPackUnpackShipEnergyMeter)
+      return 0xFFFFFFFF;
+
+   // Positions are written relative to each connection's own ship
+   return InitialMask | PositionMask;
+}
+
+
 // Transmit ship status from server to client
 // Any changes here need to be reflected in Ship::unpackUpdate
+// ...and in Ship::getConnectionDependentMask
 U32 Ship::packUpdate(GhostConnection *connection, U32 updateMask, BitStream *stream)
 {
    GameConnection *gameConnection = (GameConnection *) connection;
@@ -2384,23 +2403,23 @@ void Ship::removeMountedItem(MountableItem *item)
 
 //               Fn name           Param profiles  Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, isAlive,         ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, getPlayerInfo,   ARRAYDEF({{ END }}), 1 ) \
+   METHOD(CLASS, isAlive,         ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getPlayerInfo,   ARRAYDEF({{ END }}), 1, READ_ONLY ) \
                                                            \
-   METHOD(CLASS, isModActive,     ARRAYDEF({{ MOD_ENUM, END }}), 1 ) \
-   METHOD(CLASS, getEnergy,       ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, setEnergy,       ARRAYDEF({{ NUM, END }}), 1 ) \
-   METHOD(CLASS, getHealth,       ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, setHealth,       ARRAYDEF({{ NUM, END }}), 1 ) \
-   METHOD(CLASS, hasFlag,         ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, getFlagCount,    ARRAYDEF({{ END }}), 1 ) \
+   METHOD(CLASS, isModActive,     ARRAYDEF({{ MOD_ENUM, END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getEnergy,       ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, setEnergy,       ARRAYDEF({{ NUM, END }}), 1, READ_WRITE ) \
+   METHOD(CLASS, getHealth,       ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, setHealth,       ARRAYDEF({{ NUM, END }}), 1, READ_WRITE ) \
+   METHOD(CLASS, hasFlag,         ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getFlagCount,    ARRAYDEF({{ END }}), 1, READ_ONLY ) \
                                                            \
-   METHOD(CLASS, getAngle,        ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, getActiveWeapon, ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, getMountedItems, ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, getLoadout,      ARRAYDEF({{ END }}), 1 ) \
-   METHOD(CLASS, setLoadout,      ARRAYDEF({{ TABLE, END }, { INT, INT, INT, INT, INT, END }}), 2 ) \
-   METHOD(CLASS, setLoadoutNow,   ARRAYDEF({{ TABLE, END }, { INT, INT, INT, INT, INT, END }}), 2 ) \
+   METHOD(CLASS, getAngle,        ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getActiveWeapon, ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getMountedItems, ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, getLoadout,      ARRAYDEF({{ END }}), 1, READ_ONLY ) \
+   METHOD(CLASS, setLoadout,      ARRAYDEF({{ TABLE, END }, { INT, INT, INT, INT, INT, END }}), 2, READ_WRITE ) \
+   METHOD(CLASS, setLoadoutNow,   ARRAYDEF({{ TABLE, END }, { INT, INT, INT, INT, INT, END }}), 2, READ_WRITE ) \
 
 
 GENERATE_LUA_METHODS_TABLE(Ship, LUA_METHODS);
@@ -52,16 +52,16 @@ private:
 
    Teleporter *mEngineeredTeleporter;
 
-   // Find objects of specified type that may be under the ship, and put them in fillVector.  This is a private helper
+   // Find objects of specified type that may be under the ship, and put them in objects.  This is a private helper
    // for isInZone() and isInAnyZone().
    template <typename T>
-   void findObjectsUnderShip(T typeNumberOrFunction) const
+   void findObjectsUnderShip(T typeNumberOrFunction, Vector<DatabaseObject *> &objects) const
    {
       Rect rect(getActualPos(), getActualPos());
       rect.expand(Point(CollisionRadius, CollisionRadius));
 
-      fillVector.clear();           // This vector will hold any matching zones
-      findObjects(typeNumberOrFunction, fillVector, rect);
+      objects.clear();              // This vector will hold any matching zones
+      findObjects(typeNumberOrFunction, objects, rect);
    }
 
 
@@ -292,6 +292,7 @@ public:
    void writeControlState(BitStream *stream);
    void readControlState(BitStream *stream);
 
+   U32 getConnectionDependentMask(GhostConnection *connection);
    U32 packUpdate(GhostConnection *connection, U32 updateMask, BitStream *stream);
    void findClientInfoFromName();
    void unpackUpdate(GhostConnection *connection, BitStream *stream);
@@ -574,12 +574,12 @@ bool SpeedZone::canBeNeutral() { return false; }
  */
 //               Fn name     Param profiles       Profile count                           
 #define LUA_METHODS(CLASS, METHOD) \
-   METHOD(CLASS, setDir,      ARRAYDEF({{ PT,      END }}), 1 ) \
-   METHOD(CLASS, getDir,      ARRAYDEF({{          END }}), 1 ) \
-   METHOD(CLASS, setSpeed,    ARRAYDEF({{ INT_GE0, END }}), 1 ) \
-   METHOD(CLASS, getSpeed,    ARRAYDEF({{          END }}), 1 ) \
-   METHOD(CLASS, setSnapping, ARRAYDEF({{ BOOL,    END }}), 1 ) \
-   METHOD(CLASS, getSnapping, ARRAYDEF({{          END }}), 1 ) \
+   METHOD(CLASS, setDir,      ARRAYDEF({{ PT,      END }}), 1, READ_WRITE ) \
+   METHOD(CLASS, getDir,      ARRAYDEF({{          END }}), 1, READ_ONLY )  \
+   METHOD(CLASS, setSpeed,    ARRAYDEF({{ INT_GE0, END }}), 1, READ_WRITE ) \
+   METHOD(CLASS, getSpeed,    ARRAYDEF({{          END }}), 1, READ_ONLY )  \
+   METHOD(CLASS, setSnapping, ARRAYDEF({{ BOOL,    END }}), 1, READ_WRITE ) \
+   METHOD(CLASS, getSnapping, ARRAYDEF({{          END }}), 1, READ_ONLY )  \
 
 GENERATE_LUA_METHODS_TABLE(SpeedZone, LUA_METHODS);
 GENERATE_LUA_FUNARGS_TABLE(SpeedZone, LUA_METHODS);
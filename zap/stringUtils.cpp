@@ -588,6 +588,20 @@ bool fileExists(const string &path)
 }
 
 
+// Gets a file's modification time and size, which together are a cheap way of telling if it has changed since we
+// last looked at it.  Returns false if the file can't be found.
+bool getFileStamp(const string &path, S64 &modTime, S64 &size)
+{
+   struct stat st;
+   if(stat(path.c_str(), &st) != 0)
+      return false;
+
+   modTime = S64(st.st_mtime);
+   size = S64(st.st_size);
+   return true;
+}
+
+
 // Checks if specified folder exists; creates it if not
 bool makeSureFolderExists(const string &folder)
 {
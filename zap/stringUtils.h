@@ -93,6 +93,7 @@ bool caseInsensitiveStringCompare(const string &str1, const string &str2);
 // File utils
 string getFileSeparator();
 bool fileExists(const string &path);               // Does file exist?
+bool getFileStamp(const string &path, S64 &modTime, S64 &size);  // Modification time and size of file
 bool makeSureFolderExists(const string &dir);      // Like the man said: Make sure folder exists
 bool getFilesFromFolder(const string &dir, Vector<string> &files, bool returnFullPaths, const string extensions[] = 0, S32 extensionCount = 0);
 bool safeFilename(const char *str);